@@ -18,6 +18,8 @@
 #include <caf/meta/type_name.hpp>
 
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace vast {
 
@@ -50,11 +52,28 @@ struct arrow_table_slice_state<fbs::table_slice::arrow::v2> {
   /// The deserialized table layout.
   type layout;
 
-  /// The deserialized Arrow Record Batch.
+  /// The deserialized Arrow Record Batch, which may contain
+  /// dictionary-encoded columns.
   std::shared_ptr<arrow::RecordBatch> record_batch;
 
-  /// Mapping from column offset to nested Arrow array
+  /// Mapping from column offset to nested Arrow array, which may be
+  /// dictionary-encoded.
   arrow::ArrayVector flat_columns;
+
+  /// Whether any column of the record batch is dictionary-encoded.
+  bool dictionary_encoded = false;
+
+  /// The restored dictionary-encoded flat columns, created on first access.
+  mutable arrow::ArrayVector decoded_columns;
+
+  /// Ensures that every flat column is restored at most once.
+  mutable std::vector<std::once_flag> decoded_column_flags;
+
+  /// The record batch with all columns restored, created on first access.
+  mutable std::shared_ptr<arrow::RecordBatch> decoded_record_batch;
+
+  /// Ensures that the record batch is restored at most once.
+  mutable std::once_flag decoded_record_batch_flag;
 };
 
 /// A table slice that stores elements encoded in the [Arrow](https://arrow.org)
@@ -100,6 +119,12 @@ public:
   void append_column_to_index(id offset, table_slice::size_type column,
                               value_index& index) const;
 
+  /// Retrieves all values in column `column`, including null values.
+  /// @param column The column offset.
+  /// @pre `column < columns()`
+  [[nodiscard]] detail::generator<data_view>
+  values(table_slice::size_type column) const;
+
   /// Retrieves data by specifying 2D-coordinates via row and column.
   /// @param row The row offset.
   /// @param column The column offset.
@@ -122,13 +147,21 @@ public:
   /// Sets the import timestamp.
   void import_time(time import_time) noexcept;
 
-  /// @returns A shared pointer to the underlying Arrow Record Batch.
+  /// @returns A shared pointer to the underlying Arrow Record Batch, or
+  /// nullptr if restoring its dictionary-encoded columns failed.
   [[nodiscard]] std::shared_ptr<arrow::RecordBatch>
   record_batch() const noexcept;
 
 private:
   // -- implementation details -------------------------------------------------
 
+  /// Retrieves the array of a flat column, restoring it on first access if it
+  /// is dictionary-encoded.
+  /// @param column The column offset.
+  /// @pre `column < columns()`
+  [[nodiscard]] const std::shared_ptr<arrow::Array>&
+  flat_column(table_slice::size_type column) const noexcept;
+
   /// A const-reference to the underlying FlatBuffers table.
   const FlatBuffer& slice_;
 
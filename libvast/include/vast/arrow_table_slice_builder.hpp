@@ -47,6 +47,18 @@ public:
     const std::shared_ptr<arrow::RecordBatch>& record_batch,
     size_t initial_buffer_size = default_buffer_size);
 
+  /// Creates table slices from consecutive row ranges of a record batch. The
+  /// record batch is verified and encoded once, and every table slice is
+  /// serialized from a zero-copy slice of it.
+  /// @param record_batch The record batch to split.
+  /// @param max_slice_size The maximum number of rows per table slice.
+  /// @param initial_buffer_size The buffer size the builder starts with.
+  /// @pre `record_batch->schema()->Equals(make_experimental_schema(layout))``
+  /// @pre `max_slice_size > 0`
+  [[nodiscard]] std::vector<table_slice> static create_slices(
+    const std::shared_ptr<arrow::RecordBatch>& record_batch,
+    size_t max_slice_size, size_t initial_buffer_size = default_buffer_size);
+
   /// @returns The number of columns in the table slice.
   size_t columns() const noexcept;
 
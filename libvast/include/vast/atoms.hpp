@@ -73,6 +73,7 @@ CAF_BEGIN_TYPE_ID_BLOCK(vast_atoms, caf::id_block::vast_types::end)
   VAST_ADD_ATOM(supervise, "supervise")
   VAST_ADD_ATOM(taxonomies, "taxonomies")
   VAST_ADD_ATOM(telemetry, "telemetry")
+  VAST_ADD_ATOM(trace, "trace")
   VAST_ADD_ATOM(update, "update")
   VAST_ADD_ATOM(version, "version")
   VAST_ADD_ATOM(wakeup, "wakeup")
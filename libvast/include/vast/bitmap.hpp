@@ -14,6 +14,7 @@
 #include "vast/detail/type_traits.hpp"
 #include "vast/ewah_bitmap.hpp"
 #include "vast/null_bitmap.hpp"
+#include "vast/roaring_bitmap.hpp"
 #include "vast/wah_bitmap.hpp"
 
 #include <caf/detail/type_list.hpp>
@@ -30,7 +31,8 @@ class bitmap : public bitmap_base<bitmap>, detail::equality_comparable<bitmap> {
   friend bitmap_bit_range;
 
 public:
-  using types = caf::detail::type_list<ewah_bitmap, null_bitmap, wah_bitmap>;
+  using types = caf::detail::type_list<ewah_bitmap, null_bitmap, wah_bitmap,
+                                       roaring_bitmap>;
 
   using variant = caf::detail::tl_apply_t<types, caf::variant>;
 
@@ -104,13 +106,30 @@ public:
 
 private:
   using range_variant
-    = caf::variant<ewah_bitmap_range, null_bitmap_range, wah_bitmap_range>;
+    = caf::variant<ewah_bitmap_range, null_bitmap_range, wah_bitmap_range,
+                   roaring_bitmap_range>;
 
   range_variant range_;
 };
 
 bitmap_bit_range bit_range(const bitmap& bm);
 
+// The following overloads use the specialized algorithms of EWAH and Roaring
+// bitmaps if both operands hold the same one, and fall back to the generic
+// algorithms otherwise.
+
+/// @relates bitmap
+bitmap binary_and(const bitmap& lhs, const bitmap& rhs);
+
+/// @relates bitmap
+bitmap binary_or(const bitmap& lhs, const bitmap& rhs);
+
+/// @relates bitmap
+bitmap binary_xor(const bitmap& lhs, const bitmap& rhs);
+
+/// @relates bitmap
+bitmap binary_nand(const bitmap& lhs, const bitmap& rhs);
+
 } // namespace vast
 
 namespace caf {
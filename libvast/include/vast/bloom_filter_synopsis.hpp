@@ -43,6 +43,12 @@ public:
     bloom_filter_.add(caf::get<view<T>>(x));
   }
 
+  void add_column(const table_slice& slice, size_t column) override {
+    for (auto&& x : slice.values(column))
+      if (const auto* y = caf::get_if<view<T>>(&x))
+        bloom_filter_.add(*y);
+  }
+
   [[nodiscard]] std::optional<bool>
   lookup(relational_operator op, data_view rhs) const override {
     switch (op) {
@@ -62,6 +68,9 @@ public:
           for (auto x : **xs) {
             if (caf::holds_alternative<view<caf::none_t>>(x))
               return {};
+            // A subnet may contain addresses that we cannot enumerate.
+            if (caf::holds_alternative<view<subnet>>(x))
+              return {};
             if (!caf::holds_alternative<view<T>>(x))
               continue;
             if (bloom_filter_.lookup(caf::get<view<T>>(x)))
@@ -24,6 +24,8 @@ public:
 
   void add(data_view x) override;
 
+  void add_column(const table_slice& slice, size_t column) override;
+
   [[nodiscard]] std::optional<bool>
   lookup(relational_operator op, data_view rhs) const override;
 
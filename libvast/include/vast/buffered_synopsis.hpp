@@ -16,6 +16,9 @@
 
 #include <caf/fwd.hpp>
 
+#include <optional>
+#include <unordered_set>
+
 namespace vast {
 
 // TODO: Turn this into a concept when we support C++20.
@@ -81,6 +84,20 @@ public:
     data_.insert(materialize(*v));
   }
 
+  void add_column(const table_slice& slice, size_t column) override {
+    // Columns frequently contain runs of the same value, e.g., in
+    // dictionary-encoded string columns, so we skip materializing repeated
+    // values altogether.
+    auto last = std::optional<view_type>{};
+    for (auto&& x : slice.values(column)) {
+      const auto* v = caf::get_if<view_type>(&x);
+      if (!v || (last && *last == *v))
+        continue;
+      data_.insert(materialize(*v));
+      last = *v;
+    }
+  }
+
   [[nodiscard]] size_t memusage() const override {
     return sizeof(p_) + buffered_synopsis_traits<T>::memusage(data_);
   }
@@ -95,9 +112,15 @@ public:
         return data_.count(materialize(caf::get<view_type>(rhs)));
       case relational_operator::in: {
         if (auto xs = caf::get_if<view<list>>(&rhs)) {
-          for (auto x : **xs)
+          for (auto x : **xs) {
+            // A subnet may contain addresses that we cannot enumerate.
+            if (caf::holds_alternative<view<subnet>>(x))
+              return {};
+            if (!caf::holds_alternative<view_type>(x))
+              continue;
             if (data_.count(materialize(caf::get<view_type>(x))))
               return true;
+          }
           return false;
         }
         return {};
@@ -19,10 +19,13 @@
 #include <caf/intrusive_ptr.hpp>
 #include <caf/ref_counted.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstring>
 #include <filesystem>
 #include <span>
+#include <string>
 #include <utility>
 
 namespace vast {
@@ -128,6 +131,46 @@ public:
   mmap(const std::filesystem::path& filename, size_type size = 0,
        size_type offset = 0);
 
+  /// Copies a buffer into a new POSIX shared memory object. Serializing the
+  /// returned chunk transfers only the name of the shared memory object
+  /// instead of its contents, which allows for handing off data to another
+  /// process on the same host without copying it through a socket.
+  /// @param view The bytes to copy.
+  /// @param cleanup_timeout How long the receiving process has to adopt the
+  /// shared memory object after the chunk got serialized and released.
+  /// @returns A chunk pointer or an error on failure.
+  /// @note The receiving process unlinks the shared memory object when
+  /// deserializing the chunk. If the chunk never gets serialized, its
+  /// deleter unlinks the shared memory object instead. If the receiving
+  /// process does not adopt the object within *cleanup_timeout*, e.g., because
+  /// the message carrying the chunk got lost, the sending process unlinks it.
+  /// The sending process also unlinks all remaining objects when it exits.
+  static caf::expected<chunk_ptr>
+  make_shared_memory(view_type view,
+                     std::chrono::steady_clock::duration cleanup_timeout);
+
+  /// Memory-maps a chunk from a shared memory object that was created by
+  /// `make_shared_memory` in another process, and unlinks the object.
+  /// @param name The name of the shared memory object.
+  /// @param size The number of bytes to map.
+  /// @returns A chunk pointer or an error on failure.
+  static caf::expected<chunk_ptr>
+  adopt_shared_memory(const std::string& name, size_type size);
+
+  /// Adopts a probe that a peer created with `make_shared_memory` to negotiate
+  /// handing off chunks via shared memory. On success, deserializing chunks
+  /// may adopt all further shared memory objects that the peer's process
+  /// creates; deserializing any other chunk backed by shared memory fails.
+  /// @param name The name of the shared memory object holding the probe.
+  /// @param size The number of bytes to map.
+  /// @returns The adopted probe or an error on failure.
+  static caf::expected<chunk_ptr>
+  accept_shared_memory(const std::string& name, size_type size);
+
+  /// @returns The name of the shared memory object backing the chunk, or the
+  /// empty string if the chunk is not backed by shared memory.
+  const std::string& shared_memory_name() const noexcept;
+
   // -- container facade -------------------------------------------------------
 
   /// @returns The pointer to the chunk.
@@ -213,6 +256,13 @@ private:
 
   /// The function to delete the data.
   deleter_type deleter_;
+
+  /// The name of the shared memory object backing the chunk, if any.
+  std::string shared_memory_name_ = {};
+
+  /// Whether serializing the chunk handed off the shared memory object to
+  /// another process, which is then responsible for unlinking it.
+  mutable std::atomic<bool> shared_memory_handed_off_ = false;
 };
 
 } // namespace vast
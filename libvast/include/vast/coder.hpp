@@ -97,6 +97,15 @@ public:
   using size_type = typename Bitmap::size_type;
   using value_type = bool;
 
+  singleton_coder() = default;
+
+  /// Constructs a singleton coder that appends to a given bitmap.
+  /// @param prototype The initial bitmap, which selects the concrete bitmap
+  ///        type for type-erased bitmaps.
+  explicit singleton_coder(Bitmap prototype) : bitmap_{std::move(prototype)} {
+    // nop
+  }
+
   [[nodiscard]] size_t bitmap_count() const noexcept {
     return 1;
   }
@@ -171,8 +180,12 @@ public:
         std::is_same_v<Bitmap, ewah_bitmap>, fbs::bitmap::EWAHBitmap,
         std::conditional_t<std::is_same_v<Bitmap, null_bitmap>,
                            fbs::bitmap::NullBitmap,
-                           std::conditional_t<std::is_same_v<Bitmap, wah_bitmap>,
-                                              fbs::bitmap::WAHBitmap, void>>>;
+                           std::conditional_t<
+                             std::is_same_v<Bitmap, wah_bitmap>,
+                             fbs::bitmap::WAHBitmap,
+                             std::conditional_t<
+                               std::is_same_v<Bitmap, roaring_bitmap>,
+                               fbs::bitmap::RoaringBitmap, void>>>>;
       static_assert(!std::is_void_v<concrete_bitmap_type>);
       if (const auto* from_concrete
           = from.bitmap()->bitmap_as<concrete_bitmap_type>())
@@ -204,6 +217,14 @@ public:
     // nop
   }
 
+  /// Constructs a vector coder with copies of a given bitmap.
+  /// @param n The number of bitmaps.
+  /// @param prototype The initial bitmap, which selects the concrete bitmap
+  ///        type for type-erased bitmaps.
+  vector_coder(size_t n, const Bitmap& prototype) : bitmaps_(n, prototype) {
+    // nop
+  }
+
   size_t bitmap_count() const noexcept {
     return bitmaps_.size();
   }
@@ -258,8 +279,10 @@ public:
           std::is_same_v<Bitmap, ewah_bitmap>, fbs::bitmap::EWAHBitmap,
           std::conditional_t<
             std::is_same_v<Bitmap, null_bitmap>, fbs::bitmap::NullBitmap,
-            std::conditional_t<std::is_same_v<Bitmap, wah_bitmap>,
-                               fbs::bitmap::WAHBitmap, void>>>;
+            std::conditional_t<
+              std::is_same_v<Bitmap, wah_bitmap>, fbs::bitmap::WAHBitmap,
+              std::conditional_t<std::is_same_v<Bitmap, roaring_bitmap>,
+                                 fbs::bitmap::RoaringBitmap, void>>>>;
         static_assert(!std::is_void_v<concrete_bitmap_type>);
         const auto* from_concrete
           = from_bitmap->bitmap_as<concrete_bitmap_type>();
@@ -650,6 +673,15 @@ public:
     init();
   }
 
+  /// Constructs a multi-level coder from a given base and bitmap.
+  /// @param b The base to initialize this coder with.
+  /// @param prototype The initial bitmap of all coders, which selects the
+  ///        concrete bitmap type for type-erased bitmaps.
+  multi_level_coder(base b, bitmap_type prototype)
+    : base_{std::move(b)}, prototype_{std::move(prototype)} {
+    init();
+  }
+
   void encode(value_type x, size_type n = 1) {
     if (xs_.empty())
       init();
@@ -781,14 +813,14 @@ private:
     // For range coders it suffices to use b-1 bitmaps because the last
     // bitmap always consists of all 1s and is hence superfluous.
     for (auto i = 0u; i < base_.size(); ++i)
-      coders[i] = range_coder<bitmap_type>{base_[i] - 1};
+      coders[i] = range_coder<bitmap_type>{base_[i] - 1, prototype_};
   }
 
   template <class C>
   void init_coders(std::vector<C>& coders) {
     // All other multi-bitmap coders use one bitmap per unique value.
     for (auto i = 0u; i < base_.size(); ++i)
-      coders[i] = C{base_[i]};
+      coders[i] = C{base_[i], prototype_};
   }
 
   // Range-Eval-Opt
@@ -872,6 +904,7 @@ private:
   base base_ = {};
   mutable std::vector<value_type> xs_ = {};
   std::vector<coder_type> coders_ = {};
+  bitmap_type prototype_ = {};
 };
 
 template <class T>
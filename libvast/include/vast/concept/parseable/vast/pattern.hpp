@@ -13,6 +13,8 @@
 #include "vast/concept/parseable/string/quoted_string.hpp"
 #include "vast/pattern.hpp"
 
+#include <string>
+
 namespace vast {
 
 using pattern_parser = quoted_string_parser<'/', '\\'>;
@@ -29,7 +31,11 @@ struct access::parser_base<pattern>
 
   template <class Iterator>
   bool parse(Iterator& f, const Iterator& l, pattern& a) const {
-    return pattern_parser{}(f, l, a.str_);
+    auto str = std::string{};
+    if (!pattern_parser{}(f, l, str))
+      return false;
+    a = pattern{std::move(str)};
+    return true;
   }
 };
 
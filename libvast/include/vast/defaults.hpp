@@ -50,6 +50,28 @@ constexpr std::chrono::milliseconds read_timeout
 /// Path for reading input events or `-` for reading from STDIN.
 constexpr std::string_view read = "-";
 
+/// Timeout after which the import process unlinks a shared memory object that
+/// it handed off to the node, but that the node did not adopt.
+constexpr std::chrono::milliseconds shared_memory_timeout
+  = std::chrono::minutes{1};
+
+/// Timeout for the node to confirm that it can adopt shared memory objects
+/// from the import process.
+constexpr std::chrono::milliseconds shared_memory_probe_timeout
+  = std::chrono::seconds{5};
+
+/// Minimum number of rows of a table slice for which VAST considers
+/// dictionary-encoding its string columns.
+constexpr size_t dictionary_encoding_min_rows = 64;
+
+/// Number of leading values of a string column that VAST samples for
+/// estimating its cardinality.
+constexpr size_t dictionary_encoding_sample_size = 256;
+
+/// Maximum ratio of distinct to total values of a string column for which
+/// dictionary encoding pays off.
+constexpr double dictionary_encoding_max_cardinality = 0.25;
+
 /// Contains settings for the csv subcommand.
 struct csv {
   static constexpr char separator = ',';
@@ -114,6 +136,15 @@ struct csv {
 
 } // namespace export_
 
+// -- constants for the pivot command ------------------------------------------
+
+namespace pivot {
+
+/// Maximum number of edge values in a single query for the target type.
+constexpr size_t max_values_per_query = 65'536;
+
+} // namespace pivot
+
 // -- constants for the infer command -----------------------------------------
 
 /// Contains settings for the csv subcommand.
@@ -212,6 +243,18 @@ constexpr size_t max_partition_size = 1'048'576; // 1_Mi
 /// Timeout after which an active partition is forcibly flushed.
 constexpr caf::timespan active_partition_timeout = std::chrono::hours{1};
 
+/// Minimum number of events per INDEX partition; smaller persisted partitions
+/// get merged, and adaptively sized partitions never get smaller.
+constexpr size_t min_partition_size = 65'536; // 64_Ki
+
+/// Interval between two attempts to merge small INDEX partitions. Merging is
+/// disabled by default.
+constexpr caf::timespan partition_merge_interval = caf::timespan::zero();
+
+/// Maximum number of bytes that all active INDEX partitions may occupy
+/// together; zero means no limit.
+constexpr uint64_t active_partition_memory_budget = 0;
+
 /// Maximum number of in-memory INDEX partitions.
 constexpr size_t max_in_mem_partitions = 10;
 
@@ -221,6 +264,15 @@ constexpr size_t taste_partitions = 5;
 /// Maximum number of concurrent INDEX queries.
 constexpr size_t num_query_supervisors = 10;
 
+/// Number of INGEST WORKERs that feed the active partitions of the INDEX.
+constexpr size_t num_ingest_workers = 4;
+
+/// Number of threads that read from and memory-map files.
+constexpr size_t filesystem_read_workers = 4;
+
+/// Number of threads that write and erase files.
+constexpr size_t filesystem_write_workers = 2;
+
 /// The store backend to use.
 constexpr const char* store_backend = "segment-store";
 
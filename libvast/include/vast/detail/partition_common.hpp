@@ -117,6 +117,9 @@ fetch_indexer(const PartitionState& state, const meta_extractor& ex,
       [=](const curried_predicate&) {
         return row_ids;
       },
+      [=](const curried_predicate&, const ids& selection) {
+        return row_ids & selection;
+      },
       [](atom::shutdown) {
         VAST_DEBUG("one-shot indexer received shutdown request");
       },
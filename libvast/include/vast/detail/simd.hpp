@@ -0,0 +1,35 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// Vectorized bitwise operations over arrays of 64-bit blocks. On x86-64 with
+/// glibc, each function exists in an AVX-512, an AVX2, and a baseline variant,
+/// and the dynamic loader picks the widest one that the CPU supports.
+namespace vast::detail::simd {
+
+/// Computes `out[i] = lhs[i] & rhs[i]` for all *i* in *[0, n)*.
+void bitwise_and(const uint64_t* lhs, const uint64_t* rhs, uint64_t* out,
+                 size_t n);
+
+/// Computes `out[i] = lhs[i] | rhs[i]` for all *i* in *[0, n)*.
+void bitwise_or(const uint64_t* lhs, const uint64_t* rhs, uint64_t* out,
+                size_t n);
+
+/// Computes `out[i] = lhs[i] ^ rhs[i]` for all *i* in *[0, n)*.
+void bitwise_xor(const uint64_t* lhs, const uint64_t* rhs, uint64_t* out,
+                 size_t n);
+
+/// Computes `out[i] = lhs[i] & ~rhs[i]` for all *i* in *[0, n)*.
+void bitwise_nand(const uint64_t* lhs, const uint64_t* rhs, uint64_t* out,
+                  size_t n);
+
+} // namespace vast::detail::simd
@@ -126,6 +126,21 @@ public:
   friend auto unpack(const fbs::bitmap::EWAHBitmap& from, ewah_bitmap& to)
     -> caf::error;
 
+  // -- bitwise operations ---------------------------------------------------
+
+  // The following overloads take precedence over the generic algorithms in
+  // bitmap_algorithms.hpp when both operands are EWAH bitmaps. They combine
+  // consecutive dirty blocks of both sides with vector instructions.
+
+  friend ewah_bitmap binary_and(const ewah_bitmap& lhs, const ewah_bitmap& rhs);
+
+  friend ewah_bitmap binary_or(const ewah_bitmap& lhs, const ewah_bitmap& rhs);
+
+  friend ewah_bitmap binary_xor(const ewah_bitmap& lhs, const ewah_bitmap& rhs);
+
+  friend ewah_bitmap
+  binary_nand(const ewah_bitmap& lhs, const ewah_bitmap& rhs);
+
 private:
   /// Incorporates the most recent (complete) dirty block.
   /// @pre `num_bits_ % word_type::width == 0`
@@ -71,6 +71,21 @@ struct deduplicator {
   expression operator()(const predicate& p) const;
 };
 
+/// Collapses equality and membership predicates in a disjunction into a
+/// single membership predicate over a list, provided that they share the same
+/// type or data extractor and that all values fit its type. For extractors of
+/// addresses, the list may contain both addresses and subnets. The catalog,
+/// the indexes, and the candidate check can then answer the whole list at
+/// once instead of computing and combining a result for every predicate.
+/// @note Field extractors only get batched after type resolution.
+struct membership_batcher {
+  expression operator()(caf::none_t) const;
+  expression operator()(const conjunction& c) const;
+  expression operator()(const disjunction& d) const;
+  expression operator()(const negation& n) const;
+  expression operator()(const predicate& p) const;
+};
+
 /// Extracts all predicates from an expression.
 struct predicatizer {
   std::vector<predicate> operator()(caf::none_t) const;
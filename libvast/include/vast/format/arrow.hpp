@@ -11,19 +11,42 @@
 #include "vast/fwd.hpp"
 
 #include "vast/defaults.hpp"
+#include "vast/format/reader.hpp"
 #include "vast/format/writer.hpp"
+#include "vast/module.hpp"
 #include "vast/type.hpp"
 
 #include <arrow/io/api.h>
+#include <arrow/ipc/reader.h>
 #include <arrow/ipc/writer.h>
 #include <caf/error.hpp>
 #include <caf/expected.hpp>
 
+#include <iosfwd>
 #include <memory>
 #include <vector>
 
 namespace vast::format::arrow {
 
+/// Recovers the layout of a record batch schema that was produced by VAST.
+/// @param schema The Arrow schema carrying VAST type metadata.
+/// @returns The layout, or an error if the schema lacks VAST type metadata or
+/// does not map back to the same Arrow schema.
+caf::expected<type> layout_from_schema(const ::arrow::Schema& schema);
+
+/// Creates table slices from a record batch without converting rows, i.e.,
+/// by slicing the record batch into chunks of at most `max_slice_size` rows.
+/// @param batch The record batch to convert.
+/// @param offset The first row of *batch* to consider.
+/// @param max_rows The maximum number of rows to consume from *batch*.
+/// @param max_slice_size The maximum number of rows per table slice.
+/// @param f The consumer for the produced table slices.
+/// @returns The number of consumed rows.
+size_t slice_record_batch(const std::shared_ptr<::arrow::RecordBatch>& batch,
+                          int64_t offset, size_t max_rows,
+                          size_t max_slice_size,
+                          format::reader::consumer& f);
+
 /// An Arrow writer.
 class writer : public format::writer {
 public:
@@ -36,10 +59,17 @@ public:
   writer& operator=(writer&&) = default;
   ~writer() override;
 
-  explicit writer(const caf::settings& options);
+  /// Creates an Arrow writer that writes to the path given by
+  /// `vast.export.write`, or to STDOUT if the path is `-`.
+  /// @param options The configuration options for the writer.
+  /// @returns The writer, or an error if the output file cannot be opened.
+  static caf::expected<std::unique_ptr<format::writer>>
+  make(const caf::settings& options);
 
   caf::error write(const table_slice& x) override;
 
+  caf::expected<void> flush() override;
+
   const char* name() const override;
 
   void out(output_stream_ptr ptr) {
@@ -55,4 +85,45 @@ private:
   batch_writer_ptr current_batch_writer_;
 };
 
+/// An Arrow IPC stream reader. The input may consist of multiple consecutive
+/// IPC streams, e.g., as produced by the writer for results of different
+/// layouts. Record batches become table slices directly, i.e., without
+/// converting them row by row.
+class reader final : public format::reader {
+public:
+  using batch_reader_ptr = std::shared_ptr<::arrow::ipc::RecordBatchReader>;
+
+  /// Constructs an Arrow reader.
+  /// @param options Additional options.
+  /// @param in The stream of Arrow IPC data.
+  explicit reader(const caf::settings& options,
+                  std::unique_ptr<std::istream> in = nullptr);
+
+  ~reader() override;
+
+  void reset(std::unique_ptr<std::istream> in) override;
+
+  caf::error module(vast::module x) override;
+
+  [[nodiscard]] vast::module module() const override;
+
+  [[nodiscard]] const char* name() const override;
+
+protected:
+  caf::error
+  read_impl(size_t max_events, size_t max_slice_size, consumer& f) override;
+
+private:
+  /// Advances to the next record batch, opening the next IPC stream if the
+  /// current one is exhausted.
+  caf::error next_batch();
+
+  std::unique_ptr<std::istream> input_;
+  std::shared_ptr<::arrow::io::InputStream> stream_;
+  batch_reader_ptr batch_reader_;
+  std::shared_ptr<::arrow::RecordBatch> current_batch_;
+  int64_t current_offset_ = 0;
+  vast::module module_;
+};
+
 } // namespace vast::format::arrow
@@ -122,6 +122,9 @@ public:
     = vast::defaults::import::table_slice_type;
   reader_clock::duration batch_timeout_ = vast::defaults::import::batch_timeout;
   reader_clock::duration read_timeout_ = vast::defaults::import::read_timeout;
+  bool shared_memory_ = false;
+  reader_clock::duration shared_memory_timeout_
+    = vast::defaults::import::shared_memory_timeout;
 
 protected:
   size_t batch_events_ = 0;
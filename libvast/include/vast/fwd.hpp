@@ -110,11 +110,13 @@ class plugin_ptr;
 class port;
 class real_type;
 class record_type;
+class roaring_bitmap;
 class module;
 class segment;
 class segment_builder;
 class segment_store;
 class store;
+class store_plugin;
 class string_type;
 class subnet;
 class subnet_type;
@@ -162,6 +164,7 @@ struct legacy_pattern_type;
 struct predicate;
 struct qualified_record_field;
 struct query;
+struct query_span;
 struct layout_statistics;
 struct legacy_real_type;
 struct legacy_record_type;
@@ -172,6 +175,7 @@ struct taxonomies;
 struct legacy_time_type;
 struct type_extractor;
 struct type_set;
+struct zone_map;
 
 enum class arithmetic_operator : uint8_t;
 enum class bool_operator : uint8_t;
@@ -246,6 +250,7 @@ namespace bitmap {
 
 struct EWAHBitmap;
 struct NullBitmap;
+struct RoaringBitmap;
 struct WAHBitmap;
 
 } // namespace bitmap
@@ -376,6 +381,7 @@ CAF_BEGIN_TYPE_ID_BLOCK(vast_types, first_vast_type_id)
   VAST_ADD_TYPE_ID((vast::ec))
   VAST_ADD_TYPE_ID((vast::expression))
   VAST_ADD_TYPE_ID((vast::field_extractor))
+  VAST_ADD_TYPE_ID((vast::index_statistics))
   VAST_ADD_TYPE_ID((vast::integer))
   VAST_ADD_TYPE_ID((vast::invocation))
   VAST_ADD_TYPE_ID((vast::negation))
@@ -387,6 +393,7 @@ CAF_BEGIN_TYPE_ID_BLOCK(vast_types, first_vast_type_id)
   VAST_ADD_TYPE_ID((vast::qualified_record_field))
   VAST_ADD_TYPE_ID((vast::query))
   VAST_ADD_TYPE_ID((vast::query_options))
+  VAST_ADD_TYPE_ID((vast::query_span))
   VAST_ADD_TYPE_ID((vast::relational_operator))
   VAST_ADD_TYPE_ID((vast::module))
   VAST_ADD_TYPE_ID((vast::subnet))
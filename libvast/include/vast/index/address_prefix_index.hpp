@@ -0,0 +1,65 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "vast/address.hpp"
+#include "vast/detail/legacy_deserialize.hpp"
+#include "vast/error.hpp"
+#include "vast/ewah_bitmap.hpp"
+#include "vast/ids.hpp"
+#include "vast/value_index.hpp"
+#include "vast/view.hpp"
+
+#include <caf/error.hpp>
+#include <caf/expected.hpp>
+#include <caf/fwd.hpp>
+
+#include <map>
+
+namespace vast {
+
+/// An index for IP addresses that keeps the distinct addresses in sorted
+/// order, each with the positions of the values equal to it. Every subnet
+/// covers a contiguous range of this order, so a membership lookup visits
+/// only the addresses inside the subnet instead of combining bitmaps for each
+/// byte of the network prefix. A list of addresses and subnets resolves in a
+/// single pass over the sorted addresses, which makes this index a good fit
+/// for matching against large lists of indicators.
+class address_prefix_index : public value_index {
+public:
+  /// Constructs an address prefix index.
+  /// @param t An instance of `address_type`.
+  /// @param opts Runtime context for index parameterization.
+  explicit address_prefix_index(vast::type t, caf::settings opts = {});
+
+  caf::error serialize(caf::serializer& sink) const override;
+
+  caf::error deserialize(caf::deserializer& source) override;
+
+  bool deserialize(detail::legacy_deserializer& source) override;
+
+private:
+  bool append_impl(data_view x, id pos) override;
+
+  caf::expected<ids>
+  lookup_impl(relational_operator op, data_view x) const override;
+
+  size_t memusage_impl() const override;
+
+  flatbuffers::Offset<fbs::ValueIndex>
+  pack_impl(flatbuffers::FlatBufferBuilder& builder,
+            flatbuffers::Offset<fbs::value_index::detail::ValueIndexBase>
+              base_offset) override;
+
+  caf::error unpack_impl(const fbs::ValueIndex& from) override;
+
+  std::map<address, ewah_bitmap> postings_;
+};
+
+} // namespace vast
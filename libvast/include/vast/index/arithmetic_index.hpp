@@ -97,18 +97,28 @@ public:
   /// @param opts Runtime context for index parameterization.
   explicit arithmetic_index(vast::type t, caf::settings opts = {})
     : value_index{std::move(t), std::move(opts)} {
+    // The coders copy this bitmap, so its concrete type determines the
+    // bitmap type of the entire index.
+    auto prototype = bitmap{};
+    if (auto i = options().find("bitmap"); i != options().end()) {
+      // pre-condition is that this was validated
+      if (caf::get<caf::config_value::string>(i->second) == "roaring")
+        prototype = roaring_bitmap{};
+    }
     if constexpr (std::is_same_v<coder_type, multi_level_range_coder>) {
       auto i = options().find("base");
       if (i == options().end()) {
         // Some early experiments found that 8 yields the best average
         // performance, presumably because it's a power of 2.
-        bmi_ = bitmap_index_type{base::uniform<64>(8)};
+        bmi_ = bitmap_index_type{base::uniform<64>(8), std::move(prototype)};
       } else {
         auto str = caf::get<caf::config_value::string>(i->second);
         auto b = to<base>(str);
         VAST_ASSERT(b); // pre-condition is that this was validated
-        bmi_ = bitmap_index_type{base{std::move(*b)}};
+        bmi_ = bitmap_index_type{base{std::move(*b)}, std::move(prototype)};
       }
+    } else {
+      bmi_ = bitmap_index_type{std::move(prototype)};
     }
   }
 
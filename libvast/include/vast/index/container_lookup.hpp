@@ -12,6 +12,7 @@
 #include "vast/error.hpp"
 #include "vast/ids.hpp"
 #include "vast/operator.hpp"
+#include "vast/type.hpp"
 #include "vast/view.hpp"
 
 #include <caf/error.hpp>
@@ -27,11 +28,19 @@ template <class Index, class Sequence>
 caf::expected<ids>
 container_lookup_impl(const Index& idx, relational_operator op,
                       const Sequence& xs) {
+  // An address is in a list if it equals one of the addresses or lies in one
+  // of the subnets of the list.
+  auto element_op = [&](const auto& x) {
+    if (caf::holds_alternative<view<subnet>>(x)
+        && caf::holds_alternative<address_type>(idx.type()))
+      return relational_operator::in;
+    return relational_operator::equal;
+  };
   ids result;
   if (op == relational_operator::in) {
     result = ids{idx.offset(), false};
     for (auto x : xs) {
-      auto r = idx.lookup(relational_operator::equal, x);
+      auto r = idx.lookup(element_op(x), x);
       if (r)
         result |= *r;
       else
@@ -42,7 +51,7 @@ container_lookup_impl(const Index& idx, relational_operator op,
   } else if (op == relational_operator::not_in) {
     result = ids{idx.offset(), true};
     for (auto x : xs) {
-      auto r = idx.lookup(relational_operator::equal, x);
+      auto r = idx.lookup(element_op(x), x);
       if (r)
         result -= *r;
       else
@@ -228,6 +228,47 @@ private:
       }
       return result;
     };
+    return lookup_with(op, x, scan);
+  }
+
+  [[nodiscard]] caf::expected<ids>
+  lookup_selection_impl(relational_operator op, data_view x,
+                        const ids& candidates) const override {
+    VAST_ASSERT(rank(this->mask()) == digests_.size());
+    // Only compare the digests at the candidate positions. The i-th digest
+    // belongs to the i-th ID in the mask, so we walk the mask and the
+    // candidates together in a single pass to find the digest for each
+    // candidate.
+    auto scan = [&](auto predicate) -> ids {
+      ewah_bitmap result;
+      auto rng = select(this->mask());
+      auto i = size_t{0};
+      for (auto id : select(candidates)) {
+        while (rng && rng.get() < id) {
+          rng.next();
+          ++i;
+        }
+        if (!rng)
+          break;
+        // Candidates without a value cannot match.
+        if (rng.get() != id)
+          continue;
+        VAST_ASSERT(i < digests_.size());
+        if (predicate(digests_[i])) {
+          result.append_bits(false, id - result.size());
+          result.append_bit(true);
+        }
+      }
+      return result;
+    };
+    return lookup_with(op, x, scan);
+  }
+
+  /// Creates the predicate for a lookup and passes it to *scan*, which
+  /// computes the resulting ID set.
+  template <class Scan>
+  caf::expected<ids>
+  lookup_with(relational_operator op, data_view x, Scan scan) const {
     if (op == relational_operator::equal
         || op == relational_operator::not_equal) {
       auto k = find_digest(x);
@@ -240,16 +281,25 @@ private:
       return op == relational_operator::equal ? scan(eq) : scan(ne);
     }
     if (op == relational_operator::in || op == relational_operator::not_in) {
-      // Ensure that the RHS is a list of strings.
+      // Ensure that the RHS is a list and collect the digests of its
+      // elements in a set, such that the scan takes a single pass over the
+      // digests regardless of the size of the list.
       auto keys = caf::visit(
         detail::overload{
-          [&](auto xs) -> caf::expected<std::vector<key>> {
+          [&](auto xs) -> caf::expected<std::unordered_set<key, key_hasher>> {
             using view_type = decltype(xs);
             if constexpr (std::is_same_v<view_type, view<list>>) {
-              std::vector<key> result;
+              std::unordered_set<key, key_hasher> result;
               result.reserve(xs.size());
-              for (auto x : xs)
-                result.emplace_back(find_digest(x));
+              for (auto x : xs) {
+                // Hashing cannot tell whether an address lies in a subnet.
+                if (caf::holds_alternative<view<subnet>>(x)
+                    && caf::holds_alternative<address_type>(type()))
+                  return caf::make_error(ec::unsupported_operator,
+                                         "cannot look up subnets in a hash "
+                                         "index");
+                result.insert(find_digest(x));
+              }
               return result;
             } else {
               return caf::make_error(ec::type_clash, "expected list on RHS",
@@ -262,16 +312,10 @@ private:
         return keys.error();
       // We're good to go with: create the set predicates an run the scan.
       auto in_pred = [&](const digest_type& digest) {
-        auto cmp = [=](auto& k) {
-          return k == digest;
-        };
-        return std::any_of(keys->begin(), keys->end(), cmp);
+        return keys->count(key{digest}) > 0;
       };
       auto not_in_pred = [&](const digest_type& digest) {
-        auto cmp = [=](auto& k) {
-          return k == digest;
-        };
-        return std::none_of(keys->begin(), keys->end(), cmp);
+        return keys->count(key{digest}) == 0;
       };
       return op == relational_operator::in ? scan(in_pred) : scan(not_in_pred);
     }
@@ -0,0 +1,84 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "vast/detail/legacy_deserialize.hpp"
+#include "vast/error.hpp"
+#include "vast/ewah_bitmap.hpp"
+#include "vast/ids.hpp"
+#include "vast/value_index.hpp"
+#include "vast/view.hpp"
+
+#include <caf/error.hpp>
+#include <caf/expected.hpp>
+#include <caf/fwd.hpp>
+#include <tsl/robin_map.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vast {
+
+/// An index for strings that additionally maintains an inverted index from
+/// every trigram to the positions of the strings containing it. Substring
+/// and pattern lookups intersect the lists of the trigrams that a match
+/// requires instead of testing every offset of every string.
+///
+/// Lookups for substrings and patterns yield *candidates*, i.e., a superset
+/// of the exact result that the candidate check narrows down later. All
+/// other lookups, as well as substrings shorter than a trigram, are exact
+/// and go through a nested string index.
+class ngram_index : public value_index {
+public:
+  /// The number of characters per n-gram.
+  static constexpr size_t ngram_size = 3;
+
+  /// An n-gram packed into an integer.
+  using ngram_type = uint32_t;
+
+  /// Constructs an n-gram index.
+  /// @param t An instance of `string_type`.
+  /// @param opts Runtime context for index parameterization.
+  explicit ngram_index(vast::type t, caf::settings opts = {});
+
+  caf::error serialize(caf::serializer& sink) const override;
+
+  caf::error deserialize(caf::deserializer& source) override;
+
+  bool deserialize(detail::legacy_deserializer& source) override;
+
+private:
+  bool append_impl(data_view x, id pos) override;
+
+  caf::expected<ids>
+  lookup_impl(relational_operator op, data_view x) const override;
+
+  size_t memusage_impl() const override;
+
+  flatbuffers::Offset<fbs::ValueIndex>
+  pack_impl(flatbuffers::FlatBufferBuilder& builder,
+            flatbuffers::Offset<fbs::value_index::detail::ValueIndexBase>
+              base_offset) override;
+
+  caf::error unpack_impl(const fbs::ValueIndex& from) override;
+
+  /// Computes the positions of strings that may contain all given literals.
+  /// @param literals The literals that every match contains.
+  [[nodiscard]] ids candidates(const std::vector<std::string>& literals) const;
+
+  size_t max_length_;
+  value_index_ptr strings_;
+  tsl::robin_map<ngram_type, ewah_bitmap> postings_;
+  ewah_bitmap truncated_;
+};
+
+} // namespace vast
@@ -9,6 +9,7 @@
 #include "vast/fwd.hpp"
 
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <span>
 
@@ -21,4 +22,14 @@ namespace vast::io {
 caf::error
 write(const std::filesystem::path& filename, std::span<const std::byte> xs);
 
+/// Writes an immutable buffer into a file at a given position, leaving the
+/// remaining contents of the file intact. Creates the file if it does not
+/// exist yet.
+/// @param filename The file to write to.
+/// @param offset The position in the file to start writing at.
+/// @param xs The buffer to read from.
+/// @returns An error if the operation failed.
+caf::error write(const std::filesystem::path& filename, uint64_t offset,
+                 std::span<const std::byte> xs);
+
 } // namespace vast::io
@@ -16,6 +16,8 @@
 #include <caf/serializer.hpp>
 #include <caf/sum_type.hpp>
 
+#include <algorithm>
+
 namespace vast {
 
 /// A synopsis structure that keeps track of the minimum and maximum value.
@@ -36,6 +38,21 @@ public:
       max_ = *y;
   }
 
+  void add_column(const table_slice& slice, size_t column) override {
+    // Accumulate in local variables so that the compiler can keep them in
+    // registers for the entire column.
+    auto min = min_;
+    auto max = max_;
+    for (auto&& x : slice.values(column)) {
+      if (const auto* y = caf::get_if<view<T>>(&x)) {
+        min = std::min(min, *y);
+        max = std::max(max, *y);
+      }
+    }
+    min_ = min;
+    max_ = max;
+  }
+
   [[nodiscard]] std::optional<bool>
   lookup(relational_operator op, data_view rhs) const override {
     auto do_lookup
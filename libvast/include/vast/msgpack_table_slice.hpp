@@ -79,6 +79,12 @@ public:
   void append_column_to_index(id offset, table_slice::size_type column,
                               value_index& index) const;
 
+  /// Retrieves all values in column `column`, including null values.
+  /// @param column The column offset.
+  /// @pre `column < columns()`
+  [[nodiscard]] detail::generator<data_view>
+  values(table_slice::size_type column) const;
+
   /// Retrieves data by specifying 2D-coordinates via row and column.
   /// @param row The row offset.
   /// @param column The column offset.
@@ -10,14 +10,21 @@
 
 #include "vast/detail/operators.hpp"
 
+#include <caf/error.hpp>
+#include <caf/meta/load_callback.hpp>
+
+#include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace vast {
 
 struct access;
 class data;
 
-/// A regular expression.
+/// A regular expression. A pattern compiles its expression once upon
+/// construction, and all copies of a pattern share the compiled form.
 class pattern : detail::totally_ordered<pattern>,
                 detail::addable<pattern>,
                 detail::orable<pattern>,
@@ -37,7 +44,7 @@ public:
   static pattern glob(std::string_view str);
 
   /// Default-constructs an empty pattern.
-  pattern() = default;
+  pattern();
 
   /// Constructs a pattern from a string.
   /// @param str The string containing the pattern.
@@ -83,13 +90,30 @@ public:
 
   template <class Inspector>
   friend auto inspect(Inspector& f, pattern& p) {
-    return f(p.str_);
+    auto load_callback = caf::meta::load_callback([&]() -> caf::error {
+      p.compile();
+      return caf::none;
+    });
+    return f(p.str_, std::move(load_callback));
   }
 
   friend bool convert(const pattern& p, data& d);
 
 private:
+  struct compiled;
+
+  /// Compiles the expression after a change.
+  void compile();
+
   std::string str_;
+  std::shared_ptr<const compiled> compiled_;
 };
 
+/// Extracts literals that every string matching a regular expression must
+/// contain. The extraction is conservative: it may miss literals, but never
+/// yields one that a match does not contain.
+/// @param rx The regular expression in ECMAScript syntax.
+/// @returns The required literals, or an empty list if there are none.
+std::vector<std::string> required_literals(std::string_view rx);
+
 } // namespace vast
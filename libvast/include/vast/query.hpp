@@ -11,6 +11,7 @@
 #include "vast/bitmap.hpp"
 #include "vast/detail/overload.hpp"
 #include "vast/expression.hpp"
+#include "vast/query_trace.hpp"
 #include "vast/system/actors.hpp"
 #include "vast/uuid.hpp"
 
@@ -99,7 +100,7 @@ struct query {
   template <class Inspector>
   friend auto inspect(Inspector& f, query& q) {
     return f(caf::meta::type_name("vast.query"), q.id, q.cmd, q.expr, q.ids,
-             q.priority);
+             q.priority, q.tracer);
   }
 
   // -- data members -----------------------------------------------------------
@@ -124,6 +125,9 @@ struct query {
 
   /// The query priority.
   uint8_t priority = priority::normal;
+
+  /// The actor that collects the spans of the query, if the query is traced.
+  system::receiver_actor<query_span> tracer = {};
 };
 
 } // namespace vast
@@ -20,7 +20,8 @@ enum class query_options : uint32_t {
   historical = 0x01,
   continuous = 0x02,
   preserve_ids = 0x04,
-  low_priority = 0x08
+  low_priority = 0x08,
+  trace = 0x10
 };
 
 /// Concatenates two query options.
@@ -36,6 +37,7 @@ constexpr query_options continuous = query_options::continuous;
 constexpr query_options unified = historical + continuous;
 constexpr query_options preserve_ids = query_options::preserve_ids;
 constexpr query_options low_priority = query_options::low_priority;
+constexpr query_options trace = query_options::trace;
 
 constexpr bool has_query_option(query_options haystack, query_options needle) {
   return (static_cast<uint32_t>(haystack) & static_cast<uint32_t>(needle)) != 0;
@@ -62,4 +64,8 @@ constexpr bool has_low_priority_option(query_options opts) {
   return has_query_option(opts, low_priority);
 }
 
+constexpr bool has_trace_option(query_options opts) {
+  return has_query_option(opts, trace);
+}
+
 } // namespace vast
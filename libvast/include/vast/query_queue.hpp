@@ -14,6 +14,7 @@
 #include "vast/system/actors.hpp"
 #include "vast/uuid.hpp"
 
+#include <chrono>
 #include <vector>
 
 namespace vast {
@@ -37,6 +38,10 @@ struct query_state {
   /// The number of partitions that are processed already.
   uint32_t completed_partitions = 0;
 
+  /// The time at which the client last requested more partitions. Allows for
+  /// measuring how long partitions wait in the queue.
+  std::chrono::steady_clock::time_point activated = {};
+
   template <class Inspector>
   friend auto inspect(Inspector& f, query_state& x) {
     return f(caf::meta::type_name("query_state"), x.query, x.client,
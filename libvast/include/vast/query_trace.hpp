@@ -0,0 +1,75 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2022 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/data.hpp"
+#include "vast/time.hpp"
+#include "vast/uuid.hpp"
+
+#include <caf/meta/type_name.hpp>
+
+#include <string>
+#include <vector>
+
+namespace vast {
+
+/// A measurement of a single step in the execution of a query. The actors
+/// that execute a query report spans to the tracer of the query, if it has
+/// one. The following spans exist:
+/// - `catalog`: The INDEX looked up the candidate partitions in the catalog.
+/// - `lookup`: The INDEX queried a partition, which it acquired from the
+///   `source` active, unpersisted, cache, or disk, after the query waited for
+///   `queue-wait` in the query queue.
+/// - `load`: A passive partition loaded its state from disk.
+/// - `evaluation`: A partition evaluated the expression.
+/// - `predicate`: A partition looked up a predicate in an INDEXER.
+/// - `store`: A store performed the candidate check.
+struct query_span {
+  /// The partition that the span belongs to, or nil for spans that concern
+  /// the query as a whole.
+  uuid partition = uuid::nil();
+
+  /// The name of the step.
+  std::string name = {};
+
+  /// The time the step took.
+  duration runtime = {};
+
+  /// Additional measurements, e.g., the number of hits.
+  record values = {};
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, query_span& x) {
+    return f(caf::meta::type_name("vast.query_span"), x.partition, x.name,
+             x.runtime, x.values);
+  }
+};
+
+/// Collects the spans of a query and summarizes them.
+class query_trace {
+public:
+  /// Adds a span to the trace.
+  void add(query_span span);
+
+  /// @returns the number of spans in the trace.
+  [[nodiscard]] size_t size() const;
+
+  /// Summarizes the spans as a tree. The top level contains the spans summed
+  /// up over all partitions, the predicates sorted by their total runtime,
+  /// and the spans of every partition. Counts and durations are summed up,
+  /// and strings are counted per value.
+  [[nodiscard]] record summarize() const;
+
+private:
+  std::vector<query_span> spans_ = {};
+};
+
+} // namespace vast
@@ -0,0 +1,169 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/bitmap_base.hpp"
+#include "vast/detail/operators.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace vast {
+
+class roaring_bitmap_range;
+
+/// A bitmap that splits the bit space into chunks of 2^16 bits and stores
+/// only the set bits of each non-empty chunk in a *container*. Each container
+/// picks the representation that needs the least space: a sorted array of
+/// positions for sparse chunks, runs for clustered chunks, and an
+/// uncompressed bitset for dense chunks. Bitwise operations between two
+/// Roaring bitmaps proceed container by container, skipping chunks that
+/// only one side populates.
+/// @note This bitmap does not support random access, and only the last
+/// container changes when appending bits.
+class roaring_bitmap : public bitmap_base<roaring_bitmap>,
+                       detail::equality_comparable<roaring_bitmap> {
+  friend roaring_bitmap_range;
+
+public:
+  /// The set bits of a chunk of 2^16 consecutive bits.
+  struct container {
+    /// The representation of a container.
+    enum class kind : uint8_t { array, bitset, runs };
+
+    /// The chunk number, i.e., the position of the first bit divided by 2^16.
+    uint64_t key = 0;
+
+    /// The representation of the set bits.
+    kind type = kind::runs;
+
+    /// The number of set bits.
+    uint32_t cardinality = 0;
+
+    /// The sorted offsets of all set bits for arrays, and alternating offsets
+    /// and lengths minus one for runs.
+    std::vector<uint16_t> values = {};
+
+    /// The blocks of a bitset.
+    std::vector<block_type> blocks = {};
+
+    template <class Inspector>
+    friend auto inspect(Inspector& f, container& x) {
+      return f(x.key, x.type, x.cardinality, x.values, x.blocks);
+    }
+  };
+
+  roaring_bitmap() = default;
+
+  explicit roaring_bitmap(size_type n, bool bit = false);
+
+  // -- inspectors -----------------------------------------------------------
+
+  [[nodiscard]] bool empty() const;
+
+  [[nodiscard]] size_type size() const;
+
+  [[nodiscard]] size_t memusage() const;
+
+  /// @returns the non-empty containers in ascending order of their keys.
+  [[nodiscard]] const std::vector<container>& containers() const;
+
+  // -- modifiers ------------------------------------------------------------
+
+  void append_bit(bool bit);
+
+  void append_bits(bool bit, size_type n);
+
+  void append_block(block_type bits, size_type n = word_type::width);
+
+  void flip();
+
+  /// Converts all containers into their most compact representation. Only
+  /// the last container may need this, because appending a bit in a new
+  /// chunk optimizes the previous container.
+  void optimize();
+
+  // -- concepts -------------------------------------------------------------
+
+  friend bool operator==(const roaring_bitmap& x, const roaring_bitmap& y);
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, roaring_bitmap& bm) {
+    return f(bm.size_, bm.containers_);
+  }
+
+  friend roaring_bitmap_range bit_range(const roaring_bitmap& bm);
+
+  friend auto
+  pack(flatbuffers::FlatBufferBuilder& builder, const roaring_bitmap& from)
+    -> flatbuffers::Offset<fbs::bitmap::RoaringBitmap>;
+
+  friend auto unpack(const fbs::bitmap::RoaringBitmap& from, roaring_bitmap& to)
+    -> caf::error;
+
+  // -- bitwise operations ---------------------------------------------------
+
+  // The following overloads take precedence over the generic algorithms in
+  // bitmap_algorithms.hpp when both operands are Roaring bitmaps.
+
+  friend roaring_bitmap
+  binary_and(const roaring_bitmap& lhs, const roaring_bitmap& rhs);
+
+  friend roaring_bitmap
+  binary_or(const roaring_bitmap& lhs, const roaring_bitmap& rhs);
+
+  friend roaring_bitmap
+  binary_xor(const roaring_bitmap& lhs, const roaring_bitmap& rhs);
+
+  friend roaring_bitmap
+  binary_nand(const roaring_bitmap& lhs, const roaring_bitmap& rhs);
+
+private:
+  /// Sets the bits in *[first, last)*.
+  /// @pre `first >= size()`
+  void add_range(size_type first, size_type last);
+
+  /// Applies a bitwise operation container by container.
+  /// @tparam FillLHS Whether to keep containers that only *lhs* has.
+  /// @tparam FillRHS Whether to keep containers that only *rhs* has.
+  template <bool FillLHS, bool FillRHS, class Operation>
+  static roaring_bitmap
+  eval(const roaring_bitmap& lhs, const roaring_bitmap& rhs, Operation op);
+
+  size_type size_ = 0;
+  std::vector<container> containers_ = {};
+};
+
+class roaring_bitmap_range
+  : public bit_range_base<roaring_bitmap_range, roaring_bitmap::block_type> {
+public:
+  using word_type = roaring_bitmap::word_type;
+
+  explicit roaring_bitmap_range(const roaring_bitmap& bm);
+
+  void next();
+  [[nodiscard]] bool done() const;
+
+private:
+  void scan();
+  void next_interval();
+
+  const roaring_bitmap* bm_;
+  size_t container_ = 0;
+  bool entered_ = false;
+  roaring_bitmap::size_type position_ = 0;
+  size_t value_ = 0;
+  bool has_interval_ = false;
+  uint32_t first_ = 0;
+  uint32_t last_ = 0;
+};
+
+} // namespace vast
@@ -59,6 +59,14 @@ public:
   [[nodiscard]] caf::expected<std::vector<table_slice>>
   lookup(const vast::ids& xs) const;
 
+  /// Locates the table slices for a given set of IDs, skipping table slices
+  /// whose zone maps rule out all matches for an expression.
+  /// @param xs The IDs to lookup.
+  /// @param expr The expression to check the zone maps against.
+  /// @returns The table slices according to *xs* and *expr*.
+  [[nodiscard]] caf::expected<std::vector<table_slice>>
+  lookup(const vast::ids& xs, const expression& expr) const;
+
   /// Creates new table slices that contain all events *not*
   /// included in `xs`.
   /// @param xs The IDs to exclude.
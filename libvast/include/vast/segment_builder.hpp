@@ -13,6 +13,7 @@
 #include "vast/fbs/table_slice.hpp"
 #include "vast/segment.hpp"
 #include "vast/uuid.hpp"
+#include "vast/zone_map.hpp"
 
 #include <caf/expected.hpp>
 #include <caf/fwd.hpp>
@@ -49,6 +50,14 @@ public:
   [[nodiscard]] caf::expected<std::vector<table_slice>>
   lookup(const vast::ids& xs) const;
 
+  /// Locates previously added table slices for a given set of IDs, skipping
+  /// table slices whose zone maps rule out all matches for an expression.
+  /// @param xs The IDs to lookup.
+  /// @param expr The expression to check the zone maps against.
+  /// @returns The table slices according to *xs* and *expr*.
+  [[nodiscard]] caf::expected<std::vector<table_slice>>
+  lookup(const vast::ids& xs, const expression& expr) const;
+
   /// @returns The UUID for the segment under construction.
   [[nodiscard]] const uuid& id() const;
 
@@ -74,6 +83,7 @@ private:
   std::vector<flatbuffers::Offset<fbs::FlatTableSlice>> flat_slices_;
   std::vector<table_slice> slices_; // For queries to an unfinished segment.
   std::vector<fbs::uinterval> intervals_;
+  std::vector<zone_map> zone_maps_;
 };
 
 } // namespace vast
@@ -14,6 +14,7 @@
 #include "vast/detail/legacy_deserialize.hpp"
 #include "vast/fbs/synopsis.hpp"
 #include "vast/operator.hpp"
+#include "vast/table_slice.hpp"
 #include "vast/type.hpp"
 #include "vast/view.hpp"
 
@@ -48,6 +49,15 @@ public:
   /// @pre `type_check(type(), x)`
   virtual void add(data_view x) = 0;
 
+  /// Adds all values of a table slice column, skipping null values. The
+  /// default implementation calls `add` for every value; synopses override
+  /// this to process the entire column in one pass.
+  /// @param slice The table slice to process.
+  /// @param column The offset of the column within *slice*.
+  /// @pre `column < slice.columns()`
+  /// @pre The type of the column is congruent to `type()`.
+  virtual void add_column(const table_slice& slice, size_t column);
+
   /// Tests whether a predicate matches. The synopsis is implicitly the LHS of
   /// the predicate.
   /// @param op The operator of the predicate.
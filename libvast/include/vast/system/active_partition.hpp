@@ -87,6 +87,13 @@ struct active_partition_state {
     /// A mapping from qualified field name to serialized indexer state
     /// for each indexer in the partition.
     std::vector<std::pair<std::string, chunk_ptr>> indexer_chunks = {};
+
+    /// A mapping from qualified field name to the location of the serialized
+    /// indexer state in the partition file for each indexer in the partition.
+    /// Used instead of `indexer_chunks` when the indexer states were already
+    /// written in sections.
+    std::vector<std::pair<std::string, fbs::value_index::detail::FileSection>>
+      indexer_sections = {};
   };
 
   // -- utility functions ------------------------------------------------------
@@ -150,14 +157,17 @@ struct active_partition_state {
   /// with a serialized chunk.
   size_t persisted_indexers = {};
 
+  /// Counts how many serialized indexers were already written to the
+  /// partition file.
+  size_t written_sections = {};
+
+  /// The position in the partition file where the next section starts.
+  uint64_t next_section_offset = {};
+
   /// The store to retrieve the data from. Either the legacy global archive or a
   /// local component that holds the data for this partition.
   store_actor store = {};
 
-  /// Temporary storage for the serialized indexers of this partition, before
-  /// they get written into the flatbuffer.
-  std::map<caf::actor_id, vast::chunk_ptr> chunks = {};
-
   /// A once_flag for things that need to be done only once at shutdown.
   std::once_flag shutdown_once = {};
 
@@ -172,6 +182,34 @@ pack(flatbuffers::FlatBufferBuilder& builder,
      const active_partition_state::serialization_data& x,
      const record_type& combined_layout);
 
+// -- partition files ----------------------------------------------------------
+
+// A partition file written in sections has the following layout:
+//
+//   +--------+-----------+-----+-----------+----------------------+
+//   | header | section 0 | ... | section n | partition flatbuffer |
+//   +--------+-----------+-----+-----------+----------------------+
+//
+// Every section contains one serialized value index, and the `Partition`
+// flatbuffer at the end refers to the sections by their position. The header
+// has the same layout as the beginning of a flatbuffer, i.e., it holds the
+// offset of the root table followed by the file identifier, so readers can
+// treat the entire file as a single `Partition` flatbuffer.
+
+/// The size of the header of a partition file.
+inline constexpr uint64_t partition_header_size = 8;
+
+/// The alignment of all sections in a partition file, which must satisfy the
+/// alignment requirements of the trailing flatbuffer.
+inline constexpr uint64_t partition_section_alignment = 8;
+
+/// Creates the header for a partition file written in sections.
+/// @param flatbuffer The finished `Partition` flatbuffer.
+/// @param flatbuffer_offset The position of *flatbuffer* in the file.
+/// @pre `flatbuffer_offset % partition_section_alignment == 0`
+chunk_ptr make_partition_header(const chunk& flatbuffer,
+                                uint64_t flatbuffer_offset);
+
 // -- behavior -----------------------------------------------------------------
 
 /// Spawns a partition.
@@ -158,6 +158,8 @@ using evaluator_actor = typed_actor_fwd<
 using indexer_actor = typed_actor_fwd<
   // Returns the ids for the given predicate.
   caf::replies_to<curried_predicate>::with<ids>,
+  // Returns the ids for the given predicate, considering only the given ids.
+  caf::replies_to<curried_predicate, ids>::with<ids>,
   // Requests the INDEXER to shut down.
   caf::reacts_to<atom::shutdown>>::unwrap;
 
@@ -239,6 +241,27 @@ using idspace_distributor_actor = typed_actor_fwd<
   // Request a part of the id space.
   caf::replies_to<atom::reserve, uint64_t>::with<vast::id>>::unwrap;
 
+/// The CONTINUOUS QUERY SUBSCRIBER actor interface.
+using continuous_query_subscriber_actor = typed_actor_fwd<
+  // Add the number of events that were checked against the query.
+  caf::reacts_to<atom::update, uint64_t>>
+  // Receive the matching events of the continuous query.
+  ::extend_with<stream_sink_actor<table_slice, atom::subscribe>>::unwrap;
+
+/// The CONTINUOUS QUERY ENGINE actor interface.
+using continuous_query_engine_actor = typed_actor_fwd<
+  // Register the ACCOUNTANT actor.
+  caf::reacts_to<accountant_actor>,
+  // Register a continuous query whose matching events go to the subscriber.
+  caf::reacts_to<atom::subscribe, expression,
+                 continuous_query_subscriber_actor>,
+  // The internal telemetry loop of the CONTINUOUS QUERY ENGINE.
+  caf::reacts_to<atom::telemetry>>
+  // Conform to the protocol of the STREAM SINK actor for table slices.
+  ::extend_with<stream_sink_actor<table_slice>>
+  // Conform to the protocol of the STATUS CLIENT actor.
+  ::extend_with<status_client_actor>::unwrap;
+
 /// The interface of an IMPORTER actor.
 using importer_actor = typed_actor_fwd<
   // Register the ACCOUNTANT actor.
@@ -246,8 +269,14 @@ using importer_actor = typed_actor_fwd<
   // Add a new sink.
   caf::replies_to<stream_sink_actor<table_slice>>::with< //
     caf::outbound_stream_slot<table_slice>>,
+  // Register a continuous query whose matching events go to the subscriber.
+  caf::reacts_to<atom::subscribe, expression,
+                 continuous_query_subscriber_actor>,
   // Register a FLUSH LISTENER actor.
   caf::reacts_to<atom::subscribe, atom::flush, flush_listener_actor>,
+  // Confirm that the IMPORTER can adopt a chunk in shared memory, given the
+  // name and size of a probe.
+  caf::replies_to<atom::ping, std::string, uint64_t>::with<atom::ok>,
   // The internal telemetry loop of the IMPORTER.
   caf::reacts_to<atom::telemetry>>
   // Conform to the protocol of the IDSPACE DISTRIBUTOR actor.
@@ -260,6 +289,33 @@ using importer_actor = typed_actor_fwd<
   // Conform to the protocol of the STATUS CLIENT actor.
   ::extend_with<status_client_actor>::unwrap;
 
+/// The interface of an ACTIVE PARTITION actor.
+using active_partition_actor = typed_actor_fwd<
+  caf::reacts_to<atom::subscribe, atom::flush, flush_listener_actor>,
+  // Persists the active partition at the specified path.
+  caf::replies_to<atom::persist, std::filesystem::path,
+                  std::filesystem::path> //
+  ::with<partition_synopsis_ptr>,
+  // INTERNAL: A repeatedly called continuation of the persist request.
+  caf::reacts_to<atom::internal, atom::persist, atom::resume>>
+  // Conform to the protocol of the STREAM SINK actor for table slices.
+  ::extend_with<stream_sink_actor<table_slice>>
+  // Conform to the protocol of the PARTITION actor.
+  ::extend_with<partition_actor>::unwrap;
+
+/// The INGEST WORKER actor interface.
+using ingest_worker_actor = typed_actor_fwd<
+  // Subscribes a FLUSH LISTENER to the INGEST WORKER.
+  caf::reacts_to<atom::subscribe, atom::flush, flush_listener_actor>,
+  // INTERNAL: Telemetry loop handler.
+  caf::reacts_to<atom::telemetry>,
+  // INTERNAL: Quits once all buffered table slices left the INGEST WORKER.
+  caf::reacts_to<atom::internal, atom::shutdown>>
+  // Conform to the protocol of the STREAM SINK actor for table slices.
+  ::extend_with<stream_sink_actor<table_slice>>
+  // Conform to the protocol of the STATUS CLIENT actor.
+  ::extend_with<status_client_actor>::unwrap;
+
 /// The INDEX actor interface.
 using index_actor = typed_actor_fwd<
   // Triggered when the INDEX finished querying a PARTITION.
@@ -296,7 +352,19 @@ using index_actor = typed_actor_fwd<
   caf::replies_to<atom::apply, transform_ptr, std::vector<uuid>,
                   keep_original_partition>::with<partition_info>,
   // Makes the identity of the importer known to the index.
-  caf::reacts_to<atom::importer, idspace_distributor_actor>>
+  caf::reacts_to<atom::importer, idspace_distributor_actor>,
+  // Returns the INGEST WORKER actors that accept table slices directly, i.e.,
+  // without passing through the mailbox of the INDEX.
+  caf::replies_to<atom::get, atom::worker>::with< //
+    std::vector<ingest_worker_actor>>,
+  // Registers an active partition that an INGEST WORKER spawned.
+  caf::replies_to<atom::add, uuid, active_partition_actor>::with<atom::ok>,
+  // Hands over a decommissioned active partition for persisting.
+  caf::reacts_to<atom::persist, uuid>,
+  // Adds the event counts of an INGEST WORKER to the index statistics.
+  caf::reacts_to<atom::statistics, index_statistics>,
+  // INTERNAL: Merges small partitions of the same layout periodically.
+  caf::reacts_to<atom::internal, atom::merge>>
   // Conform to the protocol of the STREAM SINK actor for table slices.
   ::extend_with<stream_sink_actor<table_slice>>
   // Conform to the protocol of the QUERY SUPERVISOR MASTER actor.
@@ -359,6 +427,12 @@ using filesystem_actor = typed_actor_fwd<
   // if needed.
   caf::replies_to<atom::write, std::filesystem::path, chunk_ptr>::with< //
     atom::ok>,
+  // Writes a chunk of data at a given offset of the file at a given path,
+  // leaving the rest of the file intact. Creates the file and intermediate
+  // directories if needed.
+  caf::replies_to<atom::write, std::filesystem::path, uint64_t,
+                  chunk_ptr>::with< //
+    atom::ok>,
   // Reads a chunk of data from a given path and returns the chunk.
   caf::replies_to<atom::read, std::filesystem::path>::with< //
     chunk_ptr>,
@@ -383,20 +457,6 @@ using partition_transformer_actor = typed_actor_fwd<
   // Receive a completion signal for the input stream.
   ::extend_with<receiver_actor<atom::done>>::unwrap;
 
-/// The interface of an ACTIVE PARTITION actor.
-using active_partition_actor = typed_actor_fwd<
-  caf::reacts_to<atom::subscribe, atom::flush, flush_listener_actor>,
-  // Persists the active partition at the specified path.
-  caf::replies_to<atom::persist, std::filesystem::path,
-                  std::filesystem::path> //
-  ::with<partition_synopsis_ptr>,
-  // INTERNAL: A repeatedly called continuation of the persist request.
-  caf::reacts_to<atom::internal, atom::persist, atom::resume>>
-  // Conform to the protocol of the STREAM SINK actor for table slices.
-  ::extend_with<stream_sink_actor<table_slice>>
-  // Conform to the protocol of the PARTITION actor.
-  ::extend_with<partition_actor>::unwrap;
-
 /// The interface of the EXPORTER actor.
 using exporter_actor = typed_actor_fwd<
   // Request extraction of all events.
@@ -416,9 +476,16 @@ using exporter_actor = typed_actor_fwd<
   // Execute previously registered query.
   caf::reacts_to<table_slice>,
   // Register a STATISTICS SUBSCRIBER actor.
-  caf::reacts_to<atom::statistics, caf::actor>>
+  caf::reacts_to<atom::statistics, caf::actor>,
+  // Register a TRACE SUBSCRIBER actor that receives the summary of a traced
+  // query when the EXPORTER terminates.
+  caf::reacts_to<atom::trace, caf::actor>>
+  // Collects the spans of a traced query.
+  ::extend_with<receiver_actor<query_span>>
   // Conform to the protocol of the STREAM SINK actor for table slices.
   ::extend_with<stream_sink_actor<table_slice>>
+  // Conform to the protocol of the CONTINUOUS QUERY SUBSCRIBER actor.
+  ::extend_with<continuous_query_subscriber_actor>
   // Conform to the protocol of the STATUS CLIENT actor.
   ::extend_with<status_client_actor>::unwrap;
 
@@ -467,7 +534,11 @@ using transformer_actor = typed_actor_fwd<
     caf::outbound_stream_slot<table_slice>>,
   // Send transformed slices to this sink; pass the string through along with
   // the stream handshake.
-  caf::reacts_to<stream_sink_actor<table_slice, std::string>, std::string>>
+  caf::reacts_to<stream_sink_actor<table_slice, std::string>, std::string>,
+  // Send only the transformed slices whose layouts an INGEST WORKER owns to
+  // it, given the position of the worker and the total number of workers.
+  caf::replies_to<ingest_worker_actor, size_t, size_t>::with< //
+    caf::outbound_stream_slot<table_slice>>>
   // Conform to the protocol of the STREAM SINK actor for framed table slices
   ::extend_with<stream_sink_actor<detail::framed<table_slice>>>
   // Conform to the protocol of the STATUS CLIENT actor.
@@ -523,20 +594,26 @@ CAF_BEGIN_TYPE_ID_BLOCK(vast_actors, caf::id_block::vast_atoms::end)
   VAST_ADD_TYPE_ID((vast::system::idspace_distributor_actor))
   VAST_ADD_TYPE_ID((vast::system::importer_actor))
   VAST_ADD_TYPE_ID((vast::system::index_actor))
+  VAST_ADD_TYPE_ID((vast::system::ingest_worker_actor))
   VAST_ADD_TYPE_ID((vast::system::indexer_actor))
   VAST_ADD_TYPE_ID((vast::system::catalog_actor))
+  VAST_ADD_TYPE_ID((vast::system::continuous_query_engine_actor))
+  VAST_ADD_TYPE_ID((vast::system::continuous_query_subscriber_actor))
   VAST_ADD_TYPE_ID((vast::system::node_actor))
   VAST_ADD_TYPE_ID((vast::system::partition_actor))
   VAST_ADD_TYPE_ID((vast::system::query_map))
   VAST_ADD_TYPE_ID((vast::system::query_supervisor_actor))
   VAST_ADD_TYPE_ID((vast::system::query_supervisor_master_actor))
   VAST_ADD_TYPE_ID((vast::system::receiver_actor<vast::atom::done>))
+  VAST_ADD_TYPE_ID((vast::system::receiver_actor<vast::table_slice>))
   VAST_ADD_TYPE_ID((vast::system::status_client_actor))
   VAST_ADD_TYPE_ID((vast::system::stream_sink_actor<vast::table_slice>))
   VAST_ADD_TYPE_ID(
     (vast::system::stream_sink_actor<vast::table_slice, std::string>))
   VAST_ADD_TYPE_ID((vast::system::type_registry_actor))
 
+  VAST_ADD_TYPE_ID((std::vector<vast::system::ingest_worker_actor>))
+
 CAF_END_TYPE_ID_BLOCK(vast_actors)
 
 // Used in the interface of the catalog actor.
@@ -26,6 +26,7 @@
 
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace vast::system {
@@ -65,6 +66,16 @@ public:
 
   [[nodiscard]] std::vector<uuid> lookup_impl(const expression& expr) const;
 
+  /// Counts the matching events of candidate partitions from their metadata
+  /// alone, i.e., their layouts, import time bounds, and number of events.
+  /// Moves all candidates for which that suffices from `result.partitions`
+  /// to `result.counts`; the remaining candidates straddle a bound of the
+  /// expression and need to be evaluated by the partition itself.
+  /// @param expr The expression to count.
+  /// @param result The candidates for *expr*.
+  void count_from_metadata(const expression& expr,
+                           catalog_result& result) const;
+
   /// @returns A best-effort estimate of the amount of memory used for this
   /// catalog (in bytes).
   [[nodiscard]] size_t memusage() const;
@@ -97,10 +108,14 @@ struct catalog_result {
 
   std::vector<uuid> partitions;
 
+  /// Partitions whose number of matching events is known from the catalog
+  /// alone, together with that number. Only filled for estimate counts.
+  std::vector<std::pair<uuid, uint64_t>> counts = {};
+
   template <class Inspector>
   friend auto inspect(Inspector& f, catalog_result& x) {
     return f(caf::meta::type_name("vast.system.catalog_result"), x.kind,
-             x.partitions);
+             x.partitions, x.counts);
   }
 };
 
@@ -0,0 +1,108 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/system/actors.hpp"
+#include "vast/system/filesystem_statistics.hpp"
+
+#include <caf/typed_event_based_actor.hpp>
+
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace vast::system {
+
+struct concurrent_filesystem_state {
+  // -- member types -----------------------------------------------------------
+
+  /// A filesystem operation that waits for an idle worker.
+  using job = std::function<void(filesystem_actor worker)>;
+
+  /// The priority of an operation within its lane.
+  enum class priority { urgent, normal };
+
+  /// A pool of workers that handles one class of operations, such that slow
+  /// writes never delay reads and vice versa.
+  struct lane {
+    /// Workers that currently do not handle an operation.
+    std::vector<filesystem_actor> idle = {};
+
+    /// Operations that run before all normal operations.
+    std::deque<job> urgent = {};
+
+    /// Operations that run once no urgent operations are pending.
+    std::deque<job> normal = {};
+
+    /// The number of operations currently in progress.
+    size_t busy = 0;
+
+    /// Whether operations on the same path run one after another in the order
+    /// of their arrival, rather than concurrently on different workers.
+    bool exclusive = false;
+
+    /// For exclusive lanes, the operations that wait for an earlier operation
+    /// on the same path. A path has an entry while an operation on it is
+    /// queued or in progress.
+    std::map<std::filesystem::path, std::deque<std::pair<priority, job>>>
+      blocked = {};
+  };
+
+  // -- scheduling -------------------------------------------------------------
+
+  /// Runs a job on an idle worker of the lane, or queues it until a worker
+  /// becomes idle. In exclusive lanes, the job additionally waits for all
+  /// earlier jobs on the same path to finish.
+  void schedule(lane& l, priority p, const std::filesystem::path& path, job f);
+
+  /// Marks a worker as idle again and starts the next queued job, and
+  /// unblocks the next job on the same path in exclusive lanes.
+  void
+  release(lane& l, filesystem_actor worker, const std::filesystem::path& path);
+
+  // -- data members -----------------------------------------------------------
+
+  /// Statistics about filesystem operations, including the time spent
+  /// waiting for a worker.
+  filesystem_statistics stats;
+
+  /// The filesystem root.
+  std::filesystem::path root;
+
+  /// Handles reads and memory-maps. Memory-maps are urgent, because passive
+  /// partitions need them to answer queries.
+  lane read_lane;
+
+  /// Handles writes and erasures. Writes are urgent, because active
+  /// partitions wait for them to finish persisting. Operations on the same
+  /// path are exclusive, so that the last write always wins.
+  lane write_lane;
+
+  /// The actor name.
+  static inline const char* name = "concurrent-filesystem";
+};
+
+/// A filesystem that handles operations concurrently in pools of detached
+/// POSIX FILESYSTEM workers, with separate pools for reads and writes.
+/// @param self The actor handle.
+/// @param root The filesystem root.
+/// @param read_workers The number of workers for reads and memory-maps.
+/// @param write_workers The number of workers for writes and erasures.
+/// @pre `read_workers > 0 && write_workers > 0`
+filesystem_actor::behavior_type concurrent_filesystem(
+  filesystem_actor::stateful_pointer<concurrent_filesystem_state> self,
+  const std::filesystem::path& root, size_t read_workers,
+  size_t write_workers);
+
+} // namespace vast::system
@@ -0,0 +1,120 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/expression.hpp"
+#include "vast/system/actors.hpp"
+#include "vast/system/instrumentation.hpp"
+#include "vast/type.hpp"
+
+#include <caf/broadcast_downstream_manager.hpp>
+#include <caf/stream_stage.hpp>
+#include <caf/typed_event_based_actor.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace vast::system {
+
+/// A continuous query along with the actor that receives its results.
+struct continuous_query {
+  /// The query expression.
+  expression expr = {};
+
+  /// The actor that receives the matching events.
+  continuous_query_subscriber_actor subscriber = {};
+
+  /// The outbound stream slot of the subscriber.
+  caf::stream_slot slot = {};
+
+  /// Caches the expression tailored to each layout.
+  std::unordered_map<type, expression> checkers = {};
+
+  /// The number of events checked against the query since the last progress
+  /// update to the subscriber.
+  uint64_t checked = {};
+
+  /// The number of matching events since the last metrics report.
+  uint64_t events = {};
+
+  /// The total number of matching events.
+  uint64_t total_events = {};
+};
+
+/// The state of the CONTINUOUS QUERY ENGINE actor.
+struct continuous_query_engine_state {
+  // -- query handling ---------------------------------------------------------
+
+  /// Registers a continuous query.
+  /// @param expr The query expression.
+  /// @param subscriber The actor that receives the matching events.
+  void
+  subscribe(expression expr, continuous_query_subscriber_actor subscriber);
+
+  /// Evaluates all continuous queries against a table slice and pushes the
+  /// matching events into the outbound paths of the respective subscribers.
+  /// Predicates are only evaluated for rows that may still affect the result
+  /// of a query, and predicates that occur in multiple queries are evaluated
+  /// at most once per row.
+  void handle_slice(const table_slice& slice);
+
+  /// Tells every subscriber how many events were checked against its query.
+  void send_progress();
+
+  // -- introspection ----------------------------------------------------------
+
+  /// Flushes collected metrics to the accountant.
+  void send_report();
+
+  /// @returns various status metrics.
+  [[nodiscard]] record status(status_verbosity v) const;
+
+  // -- data members -----------------------------------------------------------
+
+  /// Pointer to the parent actor.
+  continuous_query_engine_actor::pointer self = {};
+
+  /// The stream stage that feeds the subscribers. Every subscriber has its
+  /// own outbound path, so a slow subscriber throttles the import stream.
+  caf::stream_stage_ptr<table_slice,
+                        caf::broadcast_downstream_manager<table_slice>>
+    stage = {};
+
+  /// The registered continuous queries.
+  std::vector<continuous_query> queries = {};
+
+  /// The ACCOUNTANT actor.
+  accountant_actor accountant = {};
+
+  /// The time spent evaluating queries and the number of events evaluated.
+  measurement measurement_ = {};
+
+  /// The number of predicates in the tailored queries since the last metrics
+  /// report.
+  uint64_t predicates = {};
+
+  /// The number of distinct predicates that were evaluated for at least one
+  /// row since the last metrics report.
+  uint64_t evaluated_predicates = {};
+
+  /// Name of this actor in log events.
+  static inline const char* name = "continuous-query-engine";
+};
+
+/// Evaluates all continuous queries against the events of the IMPORTER in a
+/// single pass, instead of streaming every event to every EXPORTER.
+/// @param self The actor handle.
+continuous_query_engine_actor::behavior_type continuous_query_engine(
+  continuous_query_engine_actor::stateful_pointer<continuous_query_engine_state>
+    self);
+
+} // namespace vast::system
@@ -12,11 +12,13 @@
 
 #include "vast/expression.hpp"
 #include "vast/ids.hpp"
+#include "vast/query_trace.hpp"
 #include "vast/system/actors.hpp"
 #include "vast/system/evaluation_triple.hpp"
 
 #include <caf/typed_event_based_actor.hpp>
 
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -28,21 +30,29 @@ struct evaluator_state {
 
   evaluator_state(evaluator_actor::stateful_pointer<evaluator_state> self);
 
-  /// Updates `predicate_hits` and may trigger re-evaluation of the expression
-  /// tree.
+  /// Updates `predicate_hits` and may trigger the next stage.
   void handle_result(const offset& position, const ids& result);
 
-  /// Updates `predicate_hits` and may trigger re-evaluation of the expression
-  /// tree.
+  /// Updates `predicate_hits` and may trigger the next stage.
   void handle_missing_result(const offset& position, const caf::error& err);
 
-  /// Evaluates the predicate-tree and may produces new deltas.
+  /// Evaluates the predicate-tree and stores the result in `hits`.
   void evaluate();
 
-  /// Decrements the `pending_responses` and sends 'done' to the client when it
-  /// reaches 0.
+  /// Decrements the `pending_responses` and, when it reaches 0, schedules the
+  /// next stage or sends 'done' to the client.
   void decrement_pending();
 
+  /// Marks all predicates as skipped whose result no longer affects the
+  /// result of the expression.
+  void skip_unneeded_predicates();
+
+  /// Sends the next stage of predicates to their INDEXER actors. A stage
+  /// consists of the cheapest remaining predicates that are not skipped. The
+  /// first stage additionally contains all predicates that are not deferrable.
+  /// @returns `false` if there were no more predicates to evaluate.
+  bool run_next_stage();
+
   /// Returns the `predicate_hits` entry for `pred` or `nullptr`.
   predicate_hits_map::mapped_type* hits_for(const offset& position);
 
@@ -64,18 +74,66 @@ struct evaluator_state {
   /// Stores the original evaluation triples.
   std::vector<evaluation_triple> eval;
 
+  /// Indexes into `eval`, sorted by the estimated priority of the predicates.
+  std::vector<size_t> schedule;
+
+  /// The estimated priority of each evaluation triple in `eval`.
+  std::vector<double> priorities;
+
+  /// Whether a conjunction encloses each evaluation triple in `eval`, so that
+  /// evaluating it in a later stage may save work.
+  std::vector<bool> deferrable;
+
+  /// The number of stages sent so far.
+  size_t stages = 0;
+
+  /// The position in `schedule` of the next predicate to evaluate.
+  size_t next = 0;
+
+  /// Stores the positions of predicates that do not need to be evaluated.
+  std::set<offset> skipped;
+
   /// Allows us to respond to the COLLECTOR after finishing a lookup.
   caf::typed_response_promise<ids> promise;
 
+  /// Receives a span for every predicate lookup, if set.
+  receiver_actor<query_span> tracer;
+
+  /// The partition that the INDEXER actors belong to.
+  uuid partition = uuid::nil();
+
   /// Gives this actor a recognizable name in logging output.
   static inline const char* name = "evaluator";
 };
 
-/// Wraps a query expression in an actor. Upon receiving hits from INDEXER
-/// actors, re-evaluates the expression and relays new hits to the INDEX CLIENT.
+/// Estimates the relative cost of looking up a predicate in a value index,
+/// based on the operator and the type of the operand. An equality lookup in an
+/// arithmetic index has a cost of 1.
+/// @param pred The predicate to look up.
+/// @returns The estimated cost of the lookup.
+double estimate_cost(const curried_predicate& pred);
+
+/// Estimates the fraction of rows that match a predicate.
+/// @param pred The predicate to look up.
+/// @returns The estimated selectivity in the range (0, 1).
+double estimate_selectivity(const curried_predicate& pred);
+
+/// Wraps a query expression in an actor. Sends the predicates to the INDEXER
+/// actors in stages, cheapest and most selective first, and skips predicates
+/// that no longer affect the result, e.g., because another operand of the
+/// same conjunction has no hits. Predicates outside of conjunctions all go
+/// out in the first stage. Later stages only look up the positions
+/// where the operands of the enclosing conjunctions have hits. Delivers the
+/// hits for the whole expression to the INDEX CLIENT.
+/// @param self The actor handle.
+/// @param expr The expression to evaluate.
+/// @param eval The predicates of the expression and their INDEXER actors.
+/// @param tracer Receives a span for every predicate lookup, if set.
+/// @param partition The partition that the INDEXER actors belong to.
 /// @pre `!eval.empty()`
 evaluator_actor::behavior_type
 evaluator(evaluator_actor::stateful_pointer<evaluator_state> self,
-          expression expr, std::vector<evaluation_triple> eval);
+          expression expr, std::vector<evaluation_triple> eval,
+          receiver_actor<query_span> tracer, uuid partition);
 
 } // namespace vast::system
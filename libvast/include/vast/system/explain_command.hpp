@@ -0,0 +1,21 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2022 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/aliases.hpp"
+
+namespace vast::system {
+
+/// Runs a query with tracing enabled and prints where its execution spent
+/// time, from the catalog lookup down to the candidate check in the stores.
+caf::message explain_command(const invocation& inv, caf::actor_system& sys);
+
+} // namespace vast::system
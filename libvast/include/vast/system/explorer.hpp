@@ -10,18 +10,45 @@
 
 #include "vast/fwd.hpp"
 
+#include "vast/data.hpp"
 #include "vast/expression.hpp"
 #include "vast/system/node.hpp"
+#include "vast/time.hpp"
 
 #include <caf/actor.hpp>
 #include <caf/fwd.hpp>
 
+#include <map>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace vast::system {
 
+/// A set of disjoint, closed time intervals.
+class time_window_set {
+public:
+  /// A closed time interval.
+  using window = std::pair<vast::time, vast::time>;
+
+  /// Adds a time interval to the set.
+  /// @param first The start of the interval.
+  /// @param last The end of the interval.
+  /// @returns The parts of [*first*, *last*] that the set did not cover yet,
+  /// in ascending order. Adjacent parts share their boundaries with the
+  /// intervals that were already in the set.
+  std::vector<window> add(vast::time first, vast::time last);
+
+  /// @returns The number of disjoint intervals in the set.
+  [[nodiscard]] size_t size() const noexcept;
+
+private:
+  /// Maps the start of each interval to its end.
+  std::map<vast::time, vast::time> windows_ = {};
+};
+
 struct explorer_state {
   struct event_limits {
     uint64_t total;
@@ -55,6 +82,16 @@ struct explorer_state {
   /// for the purpose of deduplication.
   std::unordered_set<size_t> returned_ids;
 
+  /// The time windows that were already queried for each value of the `by`
+  /// field. Without a `by` field, all windows belong to the value `caf::none`.
+  std::unordered_map<data, time_window_set> queried_windows;
+
+  /// The number of time windows around the results of the initial query.
+  size_t num_windows = 0;
+
+  /// The number of queries issued for the coalesced time windows.
+  size_t num_queries = 0;
+
   /// A tracking counter of spawned exporters. Used for lifetime management.
   size_t running_exporters = 0;
 
@@ -17,6 +17,7 @@
 #include "vast/system/actors.hpp"
 #include "vast/system/query_status.hpp"
 #include "vast/system/transformer.hpp"
+#include "vast/query_trace.hpp"
 #include "vast/table_slice.hpp"
 #include "vast/uuid.hpp"
 
@@ -24,6 +25,8 @@
 #include <caf/scheduled_actor.hpp>
 #include <caf/typed_event_based_actor.hpp>
 
+#include <optional>
+
 namespace vast::system {
 
 struct exporter_state {
@@ -53,6 +56,10 @@ struct exporter_state {
   /// statistics.
   caf::actor statistics_subscriber = {};
 
+  /// Stores a handle to the TRACE_SUBSCRIBER that receives the summary of the
+  /// trace when the query has the trace option.
+  caf::actor trace_subscriber = {};
+
   /// Stores a handle to the ACCOUNTANT that collects various statistics.
   accountant_actor accountant = {};
 
@@ -74,6 +81,9 @@ struct exporter_state {
 
   /// Stores the query ID we receive from the INDEX.
   uuid id = {};
+
+  /// Collects the spans of the query if it has the trace option.
+  std::optional<query_trace> trace = {};
 };
 
 /// The EXPORTER gradually requests more results from the index until no more
@@ -10,24 +10,53 @@
 
 #include "vast/fwd.hpp"
 
+#include "vast/aliases.hpp"
+
 #include <caf/meta/type_name.hpp>
 
+#include <array>
 #include <cstdint>
 
 namespace vast::system {
 
 /// Statistics about filesystem operations.
 struct filesystem_statistics {
+  /// A histogram of operation latencies with exponentially growing buckets.
+  /// Bucket *i* counts latencies below 2^i microseconds that do not fit into
+  /// a smaller bucket; the last bucket counts everything beyond.
+  struct latency_histogram {
+    static constexpr size_t num_buckets = 32;
+
+    std::array<uint64_t, num_buckets> buckets = {};
+
+    /// Records the latency of a single operation.
+    void add(duration latency);
+
+    /// @returns the upper bound of the bucket that contains the given
+    /// quantile, or zero if the histogram is empty.
+    /// @pre `0.0 <= q && q <= 1.0`
+    [[nodiscard]] duration quantile(double q) const;
+
+    template <class Inspector>
+    friend auto inspect(Inspector& f, latency_histogram& x) ->
+      typename Inspector::result_type {
+      return f(caf::meta::type_name("vast.system.filesystem_statistics."
+                                    "latency_histogram"),
+               x.buckets);
+    }
+  };
+
   struct ops {
     uint64_t successful = 0;
     uint64_t failed = 0;
     uint64_t bytes = 0;
+    latency_histogram latency = {};
 
     template <class Inspector>
     friend auto inspect(Inspector& f, ops& x) ->
       typename Inspector::result_type {
       return f(caf::meta::type_name("vast.system.filesystem_statistics.ops"),
-               x.successful, x.failed, x.bytes);
+               x.successful, x.failed, x.bytes, x.latency);
     }
   };
 
@@ -41,8 +70,14 @@ struct filesystem_statistics {
   friend auto inspect(Inspector& f, filesystem_statistics& x) ->
     typename Inspector::result_type {
     return f(caf::meta::type_name("vast.system.filesystem_statistics"),
-             x.checks, x.writes, x.reads, x.mmaps);
+             x.checks, x.writes, x.reads, x.mmaps, x.erases);
   }
 };
 
+/// Renders filesystem statistics for the status of a filesystem actor.
+/// @param stats The statistics to render.
+/// @param v The verbosity of the status request; latency histograms are only
+/// included at debug verbosity.
+record to_record(const filesystem_statistics& stats, status_verbosity v);
+
 } // namespace vast::system
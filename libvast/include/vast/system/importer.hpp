@@ -89,6 +89,9 @@ struct importer_state {
 
   transformer_actor transformer;
 
+  /// Evaluates all continuous queries, spawned on the first subscription.
+  continuous_query_engine_actor continuous_queries;
+
   /// Pointer to the owning actor.
   importer_actor::pointer self;
 
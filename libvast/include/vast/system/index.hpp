@@ -21,6 +21,7 @@
 #include "vast/system/actors.hpp"
 #include "vast/system/catalog.hpp"
 #include "vast/system/importer.hpp"
+#include "vast/system/ingest_worker.hpp"
 #include "vast/system/query_cursor.hpp"
 #include "vast/uuid.hpp"
 
@@ -52,12 +53,6 @@ enum class send_initial_dbstate : bool {
   no = false,
 };
 
-/// Helper class used to route table slice columns to the correct indexer
-/// in the CAF stream stage.
-struct i_partition_selector {
-  bool operator()(const type& filter, const table_slice& slice) const;
-};
-
 /// Extract a partition synopsis from the partition at `partition_path`
 /// and write it to `partition_synopsis_path`.
 //  TODO: Move into separate header.
@@ -72,39 +67,13 @@ extract_partition_synopsis(const std::filesystem::path& partition_path,
 caf::expected<flatbuffers::Offset<fbs::Index>>
 pack(flatbuffers::FlatBufferBuilder& builder, const index_state& state);
 
-/// The state of the active partition.
-struct active_partition_info {
+/// An active partition as seen from the INDEX.
+struct active_partition_handle {
   /// The partition actor.
   active_partition_actor actor = {};
 
-  /// The slot ID that identifies the partition in the stream.
-  caf::stream_slot stream_slot = {};
-
-  /// The store actor that holds the segments for this partition.
-  // NOTE: Logically this should belong inside the active partition, but the way
-  // the CAF streaming api works makes it really annoying to have the partition
-  // stream both whole table_slices to the store and table_slice_columns to
-  // the indexers. So barring a major refactoring, we just have the partition
-  // do the streaming.
-  store_builder_actor store = {};
-
-  // The slot ID that identifies the store in the stream.
-  caf::stream_slot store_slot = {};
-
-  /// The remaining free capacity of the partition.
-  size_t capacity = {};
-
-  /// The UUID of the partition.
-  uuid id = {};
-
-  /// The spawn timestamp of the partition.
-  std::chrono::steady_clock::time_point spawn_time = {};
-
-  template <class Inspector>
-  friend auto inspect(Inspector& f, active_partition_info& x) {
-    return f(caf::meta::type_name("active_partition_info"), x.actor,
-             x.stream_slot, x.capacity, x.id, x.spawn_time);
-  }
+  /// The INGEST WORKER that feeds the partition.
+  ingest_worker_actor worker = {};
 };
 
 /// Loads partitions from disk by UUID.
@@ -146,8 +115,9 @@ struct index_state {
   // -- type aliases -----------------------------------------------------------
 
   using index_stream_stage_ptr = caf::stream_stage_ptr<
-    table_slice, caf::broadcast_downstream_manager<table_slice, vast::type,
-                                                   i_partition_selector>>;
+    table_slice,
+    caf::broadcast_downstream_manager<table_slice, ingest_worker_filter,
+                                      ingest_worker_selector>>;
 
   // -- constructor ------------------------------------------------------------
 
@@ -174,7 +144,8 @@ struct index_state {
   /// Adds a new flush listener.
   void add_flush_listener(flush_listener_actor listener);
 
-  /// Sends a notification to all listeners and clears the listeners list.
+  /// Forwards all listeners to the INGEST WORKERs that feed active partitions
+  /// and clears the listeners list.
   void notify_flush_listeners();
 
   // -- partition handling -----------------------------------------------------
@@ -182,16 +153,20 @@ struct index_state {
   /// Generates a unique query id.
   vast::uuid create_query_id();
 
-  /// Creates a new active partition.
-  void create_active_partition(const type& layout);
-
-  /// Decommissions the active partition.
-  void decomission_active_partition(const type& layout);
+  /// Persists an active partition that an INGEST WORKER decommissioned.
+  void decomission_active_partition(const uuid& id);
 
   /// Adds a new partition creation listener.
   void
   add_partition_creation_listener(partition_creation_listener_actor listener);
 
+  /// Merges persisted partitions with fewer than `min_partition_size` events
+  /// into larger partitions of the same layout.
+  void merge_small_partitions();
+
+  /// Merges the next batch of partitions, one batch at a time.
+  void merge_partitions(std::vector<std::vector<uuid>> batches);
+
   // -- query handling ---------------------------------------------------------
 
   void schedule_lookups();
@@ -210,11 +185,15 @@ struct index_state {
   /// Pointer to the parent actor.
   index_actor::pointer self;
 
-  /// The streaming stage.
+  /// The streaming stage. Only relays table slices to the INGEST WORKERs for
+  /// sources that stream into the INDEX directly.
   index_stream_stage_ptr stage;
 
-  /// One active (read/write) partition per layout.
-  std::unordered_map<type, active_partition_info> active_partitions = {};
+  /// The INGEST WORKERs that feed the active partitions.
+  std::vector<ingest_worker_actor> ingest_workers = {};
+
+  /// The active (read/write) partitions of all INGEST WORKERs.
+  std::unordered_map<uuid, active_partition_handle> active_partitions = {};
 
   /// Partitions that are currently in the process of persisting.
   // TODO: An alternative to keeping an explicit set of unpersisted partitions
@@ -245,6 +224,17 @@ struct index_state {
   /// Timeout after which an active partition is forcibly flushed.
   duration active_partition_timeout = {};
 
+  /// Persisted partitions with fewer events get merged with others of the
+  /// same layout.
+  size_t min_partition_size = {};
+
+  /// The interval between two attempts to merge small partitions, or zero if
+  /// merging is disabled.
+  duration partition_merge_interval = {};
+
+  /// Whether a merge of small partitions is currently in progress.
+  bool merging_partitions = {};
+
   /// The maximum size of the partition LRU cache (or the maximum number of
   /// read-only partition loaded to memory).
   size_t max_inmem_partitions = {};
@@ -296,7 +286,8 @@ struct index_state {
   /// Handle of the accountant.
   accountant_actor accountant = {};
 
-  /// List of actors that wait for the next flush event.
+  /// List of actors that wait for the next flush event, but could not yet be
+  /// forwarded to an INGEST WORKER because no active partition exists.
   std::vector<flush_listener_actor> flush_listeners = {};
 
   /// List of actors that want to be notified about new partitions.
@@ -342,10 +333,17 @@ struct index_state {
 /// @param taste_partitions How many lookup partitions to schedule immediately.
 /// @param max_concurrent_partition_lookups The maximum amount of concurrent
 /// lookups.
+/// @param num_workers The number of INGEST WORKERs that feed active partitions.
+/// @param memory_budget The maximum number of bytes that all active partitions
+/// may occupy together, or zero for no limit.
+/// @param min_partition_size The number of events below which persisted
+/// partitions get merged.
+/// @param partition_merge_interval The interval between two attempts to merge
+/// small partitions, or zero to disable merging.
 /// @param catalog_dir The directory used by the catalog.
 /// @param index_config The meta-index configuration of the false-positives
 /// rates for the types and fields.
-/// @pre `partition_capacity > 0
+/// @pre `partition_capacity > 0 && num_workers > 0`
 //  TODO: Use a settings struct for the various parameters.
 index_actor::behavior_type
 index(index_actor::stateful_pointer<index_state> self,
@@ -355,6 +353,8 @@ index(index_actor::stateful_pointer<index_state> self,
       std::string store_backend, size_t partition_capacity,
       duration active_partition_timeout, size_t max_inmem_partitions,
       size_t taste_partitions, size_t max_concurrent_partition_lookups,
+      size_t num_workers, size_t memory_budget, size_t min_partition_size,
+      duration partition_merge_interval,
       const std::filesystem::path& catalog_dir, index_config);
 
 } // namespace vast::system
@@ -0,0 +1,286 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/index_config.hpp"
+#include "vast/index_statistics.hpp"
+#include "vast/system/actors.hpp"
+#include "vast/time.hpp"
+#include "vast/type.hpp"
+#include "vast/uuid.hpp"
+
+#include <caf/broadcast_downstream_manager.hpp>
+#include <caf/settings.hpp>
+#include <caf/stream_slot.hpp>
+#include <caf/stream_stage.hpp>
+#include <caf/typed_event_based_actor.hpp>
+
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+
+namespace vast::system {
+
+/// Helper class used to route table slices to the active partition of their
+/// layout in the CAF stream stage.
+struct i_partition_selector {
+  bool operator()(const type& filter, const table_slice& slice) const;
+};
+
+/// @returns the position of the INGEST WORKER that owns a layout.
+/// @param layout The layout of a table slice.
+/// @param num_workers The total number of INGEST WORKERs.
+/// @pre `num_workers > 0`
+size_t ingest_worker_for(const type& layout, size_t num_workers);
+
+/// Restricts an outbound stream path to the table slices whose layouts the
+/// INGEST WORKER at the given position owns. The default-constructed filter
+/// lets all table slices pass.
+struct ingest_worker_filter {
+  /// The position of the INGEST WORKER.
+  size_t id = {};
+
+  /// The total number of INGEST WORKERs, or zero for no restriction.
+  size_t num_workers = {};
+
+  friend bool
+  operator==(const ingest_worker_filter&, const ingest_worker_filter&)
+    = default;
+};
+
+/// Helper class used to route table slices to the INGEST WORKER that owns
+/// their layout in the CAF stream stages that feed the workers.
+struct ingest_worker_selector {
+  bool operator()(const ingest_worker_filter& filter,
+                  const table_slice& slice) const;
+};
+
+/// The state of the active partition.
+struct active_partition_info {
+  /// The partition actor.
+  active_partition_actor actor = {};
+
+  /// The slot ID that identifies the partition in the stream.
+  caf::stream_slot stream_slot = {};
+
+  /// The store actor that holds the segments for this partition.
+  // NOTE: Logically this should belong inside the active partition, but the way
+  // the CAF streaming api works makes it really annoying to have the partition
+  // stream both whole table_slices to the store and table_slice_columns to
+  // the indexers. So barring a major refactoring, we just have the partition
+  // do the streaming.
+  store_builder_actor store = {};
+
+  // The slot ID that identifies the store in the stream.
+  caf::stream_slot store_slot = {};
+
+  /// The remaining free capacity of the partition.
+  size_t capacity = {};
+
+  /// The number of events in the partition.
+  size_t events = {};
+
+  /// The last measured memory footprint of the partition in bytes.
+  size_t memory_usage = {};
+
+  /// The UUID of the partition.
+  uuid id = {};
+
+  /// The spawn timestamp of the partition.
+  std::chrono::steady_clock::time_point spawn_time = {};
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, active_partition_info& x) {
+    return f(caf::meta::type_name("active_partition_info"), x.actor,
+             x.stream_slot, x.capacity, x.events, x.memory_usage, x.id,
+             x.spawn_time);
+  }
+};
+
+/// Observations about the ingest of a single layout that drive the sizing of
+/// its active partitions.
+struct layout_ingest_profile {
+  /// The number of events received since the last telemetry tick.
+  size_t pending_events = {};
+
+  /// A moving average of the event rate in events per second.
+  double event_rate = {};
+
+  /// The memory footprint per event of the most recently measured active
+  /// partition of the layout in bytes.
+  double bytes_per_event = {};
+};
+
+/// The state of the INGEST WORKER actor.
+struct ingest_worker_state {
+  // -- type aliases -----------------------------------------------------------
+
+  using ingest_worker_stream_stage_ptr = caf::stream_stage_ptr<
+    table_slice, caf::broadcast_downstream_manager<table_slice, vast::type,
+                                                   i_partition_selector>>;
+
+  // -- constructor ------------------------------------------------------------
+
+  ingest_worker_state() = default;
+
+  // -- flush handling ---------------------------------------------------------
+
+  /// Adds a new flush listener.
+  void add_flush_listener(flush_listener_actor listener);
+
+  /// Sends a notification to all listeners and clears the listeners list.
+  void notify_flush_listeners();
+
+  // -- partition handling -----------------------------------------------------
+
+  /// @returns whether this worker is responsible for the given layout.
+  [[nodiscard]] bool owns(const type& layout) const;
+
+  /// Creates a new active partition and registers it with the INDEX.
+  void create_active_partition(const type& layout);
+
+  /// Removes the active partition from the stream and hands it over to the
+  /// INDEX for persisting.
+  void decomission_active_partition(const type& layout);
+
+  /// Computes the capacity for the next active partition of a layout. With a
+  /// memory budget, the budget is split between the layouts in proportion to
+  /// their event rates, and the capacity follows from the measured memory
+  /// footprint per event.
+  [[nodiscard]] size_t adaptive_capacity(const type& layout) const;
+
+  /// Updates the event rates of all layouts.
+  void update_event_rates();
+
+  /// Requests the memory footprint of all active partitions, and enforces the
+  /// memory budget once the responses arrive.
+  void measure_memory_usage();
+
+  /// Decommissions the active partitions with the largest memory footprint
+  /// until all active partitions together fit into the memory budget.
+  void enforce_memory_budget();
+
+  // -- introspection ----------------------------------------------------------
+
+  /// Sends the event counts accumulated since the last call to the INDEX.
+  void send_statistics();
+
+  /// Flushes collected metrics to the accountant.
+  void send_report();
+
+  /// @returns various status metrics.
+  [[nodiscard]] record status(status_verbosity v) const;
+
+  // -- data members -----------------------------------------------------------
+
+  /// Pointer to the parent actor.
+  ingest_worker_actor::pointer self = {};
+
+  /// The INDEX that spawned this worker.
+  index_actor index = {};
+
+  /// The position of this worker among all workers of the INDEX.
+  size_t id = {};
+
+  /// The total number of workers of the INDEX.
+  size_t num_workers = {};
+
+  /// The streaming stage.
+  ingest_worker_stream_stage_ptr stage = {};
+
+  /// One active (read/write) partition per owned layout.
+  std::unordered_map<type, active_partition_info> active_partitions = {};
+
+  /// The ingest profiles of all owned layouts.
+  std::unordered_map<type, layout_ingest_profile> profiles = {};
+
+  /// The time of the last update of the event rates.
+  std::chrono::steady_clock::time_point last_rate_update = {};
+
+  /// List of actors that wait for the next flush event.
+  std::vector<flush_listener_actor> flush_listeners = {};
+
+  /// The number of active partitions that the INDEX did not confirm yet.
+  size_t pending_registrations = {};
+
+  /// Event counts that the INDEX did not see yet.
+  index_statistics stats = {};
+
+  /// The number of events received since the last metrics report.
+  size_t events = {};
+
+  /// The maximum number of events that a partition can hold.
+  size_t partition_capacity = {};
+
+  /// The minimum capacity of a partition when sizing it adaptively.
+  size_t min_partition_size = {};
+
+  /// The maximum number of bytes that the active partitions of this worker
+  /// may occupy together, or zero for no limit.
+  size_t memory_budget = {};
+
+  /// Timeout after which an active partition is forcibly flushed.
+  duration active_partition_timeout = {};
+
+  /// Handle of the accountant.
+  accountant_actor accountant = {};
+
+  /// Actor handle of the filesystem actor.
+  filesystem_actor filesystem = {};
+
+  /// Actor handle of the store actor.
+  archive_actor global_store = {};
+
+  /// Plugin responsible for spawning new partition-local stores, or nullptr
+  /// if the worker uses the global store.
+  const vast::store_plugin* store_plugin = {};
+
+  /// Config options to be used for new synopses; passed to active partitions.
+  index_config synopsis_opts = {};
+
+  /// Config options for the index.
+  caf::settings index_opts = {};
+
+  constexpr static inline auto name = "ingest-worker";
+};
+
+/// Feeds the active partitions for a subset of all layouts, such that table
+/// slices never enter the mailbox of the INDEX.
+/// @param self The actor handle.
+/// @param index The INDEX that spawned the worker.
+/// @param id The position of this worker among all workers of the INDEX.
+/// @param num_workers The total number of workers of the INDEX.
+/// @param accountant The accountant actor.
+/// @param filesystem The filesystem actor.
+/// @param global_store The legacy archive actor.
+/// @param store_plugin The plugin for partition-local stores, or nullptr if
+/// the worker shall use the global store.
+/// @param partition_capacity The maximum number of events per partition.
+/// @param min_partition_size The minimum capacity of a partition when sizing
+/// it adaptively.
+/// @param memory_budget The maximum number of bytes that the active partitions
+/// of this worker may occupy together, or zero for no limit.
+/// @param active_partition_timeout Timeout after which an active partition is
+/// forcibly flushed.
+/// @param index_opts Config options for the partitions.
+/// @param synopsis_opts Config options for the partition synopses.
+/// @pre `id < num_workers`
+ingest_worker_actor::behavior_type
+ingest_worker(ingest_worker_actor::stateful_pointer<ingest_worker_state> self,
+              index_actor index, size_t id, size_t num_workers,
+              accountant_actor accountant, filesystem_actor filesystem,
+              archive_actor global_store,
+              const vast::store_plugin* store_plugin,
+              size_t partition_capacity, size_t min_partition_size,
+              size_t memory_budget, duration active_partition_timeout,
+              caf::settings index_opts, index_config synopsis_opts);
+
+} // namespace vast::system
@@ -121,6 +121,17 @@ struct passive_partition_state {
 
 // -- flatbuffers --------------------------------------------------------------
 
+/// Locates the serialized state of a value index in a partition file. The
+/// state is either embedded in the flatbuffer, or stored in a separate section
+/// of the file.
+/// @param partition The contents of the partition file.
+/// @param index The value index to locate.
+/// @returns The serialized value index, or an error if its section lies
+/// outside of the partition file.
+caf::expected<std::span<const std::byte>>
+value_index_bytes(std::span<const std::byte> partition,
+                  const fbs::value_index::detail::LegacyValueIndex& index);
+
 [[nodiscard]] caf::error
 unpack(const fbs::partition::LegacyPartition& x, passive_partition_state& y);
 
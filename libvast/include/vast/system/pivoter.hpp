@@ -10,23 +10,43 @@
 
 #include "vast/fwd.hpp"
 
+#include "vast/data.hpp"
+#include "vast/defaults.hpp"
 #include "vast/expression.hpp"
-#include "vast/system/node.hpp"
+#include "vast/system/actors.hpp"
 #include "vast/type.hpp"
+#include "vast/uuid.hpp"
 
 #include <caf/actor.hpp>
 #include <caf/fwd.hpp>
 
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace vast::system {
 
 struct pivoter_state {
   // -- member types -----------------------------------------------------------
 
+  /// The progress of the query for the target type that is currently running.
+  struct running_query {
+    /// The handle of the query at the INDEX.
+    uuid id = {};
+
+    /// The number of partitions that qualify for the query.
+    uint32_t expected = 0;
+
+    /// The number of partitions that completed.
+    uint32_t received = 0;
+
+    /// The number of partitions that the INDEX currently evaluates.
+    uint32_t scheduled = 0;
+  };
+
   // -- constants --------------------------------------------------------------
 
   static inline constexpr const char* name = "pivoter";
@@ -45,21 +65,29 @@ struct pivoter_state {
   ///       generated queries with them. This depends on ECS support.
   expression expr;
 
-  /// Keeps a record of the generic ids that were already queried, for the
-  /// purpose of deduplication.
-  /// TODO: We only need to query for membership, so this could be made more
-  ///       efficient by storing the hash itself. Additionally, it is possible
-  ///       for the field that represents the edge to be of another type than
-  ///       string.
-  std::unordered_set<std::string> requested_ids;
+  /// Keeps a digest of the edge values that were already queried or are
+  /// pending, for the purpose of deduplication.
+  std::unordered_set<uint64_t> requested_ids;
+
+  /// The edge values that still need to be queried, grouped by the name of the
+  /// edge field.
+  std::vector<std::pair<std::string, list>> pending;
+
+  /// The maximum number of edge values in a single query.
+  size_t max_values_per_query = defaults::pivot::max_values_per_query;
 
   /// A cache for the connections between a source type and the target type,
   /// to avoid multiple computations of those.
   mutable std::unordered_map<record_type, std::optional<record_type::field_view>>
     cache;
 
-  /// A tracking counter of spawned exporters. Used for lifetime management.
-  size_t running_exporters = 0;
+  /// The query that currently runs at the INDEX, if any. We run one query at
+  /// a time and collect the edge values that arrive in the meantime into the
+  /// next query.
+  std::optional<running_query> running;
+
+  /// The number of queries issued for the target type.
+  size_t num_queries = 0;
 
   /// Flag that stores if the input source is done sending table slices. Used
   /// for lifetime management.
@@ -68,8 +96,8 @@ struct pivoter_state {
   /// Pointer to the parent actor.
   caf::stateful_actor<pivoter_state>* self;
 
-  /// A handle to the parent node for spawning new EXPORTERs.
-  node_actor node;
+  /// A handle to the INDEX for evaluating the queries for the target type.
+  index_actor index;
 
   /// A handle to the sink for the resulting table silces.
   caf::actor sink;
@@ -78,10 +106,14 @@ struct pivoter_state {
 /// The PIVOTER receives table slices and constructs new queries for the target
 /// type.
 /// @param self The actor handle.
-/// @param node The node actor to spawn exporters in.
+/// @param index The INDEX actor to query for the target type.
 /// @param target The type filter for the subsequent queries.
 /// @param expression The query of the original command.
-caf::behavior pivoter(caf::stateful_actor<pivoter_state>* self, node_actor node,
-                      std::string target, expression expr);
+/// @param max_values_per_query The maximum number of edge values to combine in
+/// a single query.
+caf::behavior
+pivoter(caf::stateful_actor<pivoter_state>* self, index_actor index,
+        std::string target, expression expr,
+        size_t max_values_per_query = defaults::pivot::max_values_per_query);
 
 } // namespace vast::system
@@ -11,6 +11,7 @@
 #include "vast/fwd.hpp"
 
 #include "vast/system/actors.hpp"
+#include "vast/system/ingest_worker.hpp"
 #include "vast/system/sink.hpp"
 #include "vast/table_slice.hpp"
 #include "vast/transform.hpp"
@@ -23,9 +24,10 @@
 
 namespace vast::system {
 
-using transformer_stream_stage_ptr
-  = caf::stream_stage_ptr<detail::framed<table_slice>,
-                          caf::broadcast_downstream_manager<table_slice>>;
+using transformer_stream_stage_ptr = caf::stream_stage_ptr<
+  detail::framed<table_slice>,
+  caf::broadcast_downstream_manager<table_slice, ingest_worker_filter,
+                                    ingest_worker_selector>>;
 
 struct transformer_state {
   /// The transforms that can be applied.
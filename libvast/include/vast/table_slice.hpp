@@ -16,9 +16,11 @@
 #include "vast/type.hpp"
 #include "vast/view.hpp"
 
+#include <caf/expected.hpp>
 #include <caf/meta/load_callback.hpp>
 #include <caf/meta/type_name.hpp>
 
+#include <chrono>
 #include <cstddef>
 #include <span>
 #include <vector>
@@ -146,6 +148,13 @@ public:
   /// @pre `offset() != invalid_id`
   void append_column_to_index(size_type column, value_index& index) const;
 
+  /// Retrieves all values in column `column`, including null values. This is
+  /// considerably cheaper than calling `at` for every row, because the
+  /// encoding resolves the column and its type only once.
+  /// @param column The column offset.
+  /// @pre `column < columns()`
+  [[nodiscard]] detail::generator<data_view> values(size_type column) const;
+
   /// Retrieves data by specifying 2D-coordinates via row and column.
   /// @param row The row offset.
   /// @param column The column offset.
@@ -327,12 +336,34 @@ split(table_slice slice, size_t partition_point);
 /// @returns The sum of rows across *slices*.
 uint64_t rows(const std::vector<table_slice>& slices);
 
+/// Copies a table slice into a POSIX shared memory object. Sending the returned
+/// table slice to another process on the same host transfers only a handle to
+/// the shared memory object instead of the serialized table slice.
+/// @param slice The input table slice.
+/// @param cleanup_timeout How long the receiving process has to adopt the
+/// shared memory object after the sending process released the table slice.
+/// @returns A copy of *slice* backed by shared memory, or an error on failure.
+/// @pre `slice.encoding() != table_slice_encoding::none`
+caf::expected<table_slice>
+copy_to_shared_memory(const table_slice& slice,
+                      std::chrono::steady_clock::duration cleanup_timeout);
+
 /// Evaluates an expression over a table slice by applying it row-wise.
 /// @param expr The expression to evaluate.
 /// @param slice The table slice to apply *expr* on.
 /// @returns The set of row IDs in *slice* for which *expr* yields true.
 ids evaluate(const expression& expr, const table_slice& slice);
 
+/// Evaluates an expression over the rows of a table slice that are included
+/// in `hints`, skipping all other rows.
+/// @param expr The expression to evaluate.
+/// @param slice The table slice to apply *expr* on.
+/// @param hints The IDs of the rows to consider.
+/// @returns The set of row IDs in *slice* and *hints* for which *expr* yields
+/// true.
+ids evaluate(const expression& expr, const table_slice& slice,
+             const ids& hints);
+
 // Attribute-specifier-seqs are not allowed in friend function declarations, so
 // we re-declare the filter functions with nodiscard here.
 [[nodiscard]] std::optional<table_slice>
@@ -60,6 +60,17 @@ public:
   [[nodiscard]] caf::expected<ids>
   lookup(relational_operator op, data_view x) const;
 
+  /// Looks up data under a relational operator, but only at the positions
+  /// in *selection*. This allows for evaluating a predicate only where a
+  /// previous lookup already produced a hit.
+  /// @param op The relation operator.
+  /// @param x The value to lookup.
+  /// @param selection The positions to consider.
+  /// @returns The result of the lookup restricted to *selection* or an error
+  ///          upon failure.
+  [[nodiscard]] caf::expected<ids>
+  lookup(relational_operator op, data_view x, const ids& selection) const;
+
   [[nodiscard]] size_t memusage() const;
 
   /// Merges another value index with this one.
@@ -100,6 +111,13 @@ private:
   [[nodiscard]] virtual caf::expected<ids>
   lookup_impl(relational_operator op, data_view x) const = 0;
 
+  /// Looks up a non-nil value at the positions in *candidates* only, which is
+  /// a subset of the non-nil positions. The result may contain hits outside
+  /// of *candidates*. The default implementation performs a full lookup.
+  [[nodiscard]] virtual caf::expected<ids>
+  lookup_selection_impl(relational_operator op, data_view x,
+                        const ids& candidates) const;
+
   [[nodiscard]] virtual size_t memusage_impl() const = 0;
 
   [[nodiscard]] virtual flatbuffers::Offset<fbs::ValueIndex> pack_impl(
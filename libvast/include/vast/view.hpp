@@ -94,6 +94,9 @@ public:
 
 private:
   std::string_view pattern_;
+
+  /// The viewed pattern, whose compiled form we use for matching.
+  const pattern* source_ = nullptr;
 };
 
 /// @relates pattern_view
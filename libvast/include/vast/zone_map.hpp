@@ -0,0 +1,77 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/expression.hpp"
+#include "vast/time.hpp"
+#include "vast/type.hpp"
+
+#include <caf/meta/type_name.hpp>
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace vast {
+
+/// The bounds of the time columns of a table slice. Since events arrive
+/// roughly ordered by time, this allows for skipping most table slices when
+/// looking for events in a narrow time window.
+struct zone_map {
+  /// The smallest and largest value of a single time column.
+  struct time_range {
+    size_t column = 0;
+    time min = {};
+    time max = {};
+
+    template <class Inspector>
+    friend auto inspect(Inspector& f, time_range& x) {
+      return f(caf::meta::type_name("vast.zone_map.time_range"), x.column,
+               x.min, x.max);
+    }
+  };
+
+  /// Records the bounds of all time columns of a table slice. Columns that
+  /// contain only null values have no bounds.
+  static zone_map make(const table_slice& slice);
+
+  /// Checks whether a table slice with this zone map may contain events that
+  /// match an expression.
+  /// @param expr The expression tailored to the layout of the table slice.
+  /// @returns `false` if the zone map rules out all events of the slice.
+  [[nodiscard]] bool may_match(const expression& expr) const;
+
+  /// The bounds of the time columns, ordered by column.
+  std::vector<time_range> time_ranges = {};
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, zone_map& x) {
+    return f(caf::meta::type_name("vast.zone_map"), x.time_ranges);
+  }
+};
+
+/// Checks table slices against the zone maps for an expression, tailoring the
+/// expression only once per layout.
+class zone_map_filter {
+public:
+  /// Constructs a filter for an expression.
+  /// @param expr The expression; empty expressions never skip a table slice.
+  explicit zone_map_filter(expression expr);
+
+  /// @returns `false` if the zone map rules out all events of the slice.
+  bool operator()(const table_slice& slice, const zone_map& zones);
+
+private:
+  expression expr_;
+  std::unordered_map<type, expression> tailored_ = {};
+};
+
+} // namespace vast
@@ -173,6 +173,28 @@ caf::expected<uint64_t> handle_lookup(Actor& self, const vast::query& query,
   return num_hits;
 }
 
+// Reports the candidate check of a traced query to its tracer.
+template <typename Actor>
+void trace_lookup(Actor& self, const vast::query& query,
+                  const std::vector<table_slice>& slices, uint64_t num_hits,
+                  duration runtime) {
+  if (!query.tracer)
+    return;
+  auto rows = uint64_t{0};
+  auto bytes = uint64_t{0};
+  for (const auto& slice : slices) {
+    rows += slice.rows();
+    bytes += as_bytes(slice).size();
+  }
+  self->send(query.tracer, query_span{
+                             .name = "store",
+                             .runtime = runtime,
+                             .values = {{"rows-scanned", count{rows}},
+                                        {"rows-returned", count{num_hits}},
+                                        {"bytes", count{bytes}}},
+                           });
+}
+
 std::filesystem::path
 store_path_from_header(std::span<const std::byte> header) {
   std::string_view sv{reinterpret_cast<const char*>(header.data()),
@@ -240,13 +262,14 @@ system::store_actor::behavior_type passive_local_store(
         return rp;
       }
       auto start = std::chrono::steady_clock::now();
-      auto slices = self->state.segment->lookup(query.ids);
+      auto slices = self->state.segment->lookup(query.ids, query.expr);
       if (!slices)
         return slices.error();
       auto num_hits = handle_lookup(self, query, *slices);
       if (!num_hits)
         return num_hits.error();
       duration runtime = std::chrono::steady_clock::now() - start;
+      trace_lookup(self, query, *slices, *num_hits, runtime);
       auto id_str = fmt::to_string(query.id);
       self->send(
         self->state.accountant, "segment-store.lookup.runtime", runtime,
@@ -348,10 +371,10 @@ active_local_store(local_store_actor::stateful_pointer<active_store_state> self,
       auto start = std::chrono::steady_clock::now();
       caf::expected<std::vector<table_slice>> slices = caf::error{};
       if (self->state.builder) {
-        slices = self->state.builder->lookup(query.ids);
+        slices = self->state.builder->lookup(query.ids, query.expr);
       } else {
         VAST_ASSERT(self->state.segment.has_value());
-        slices = self->state.segment->lookup(query.ids);
+        slices = self->state.segment->lookup(query.ids, query.expr);
       }
       if (!slices)
         return slices.error();
@@ -359,6 +382,7 @@ active_local_store(local_store_actor::stateful_pointer<active_store_state> self,
       if (!num_hits)
         return num_hits.error();
       duration runtime = std::chrono::steady_clock::now() - start;
+      trace_lookup(self, query, *slices, *num_hits, runtime);
       auto id_str = fmt::to_string(query.id);
       self->send(
         self->state.accountant, "segment_store.lookup.runtime", runtime,
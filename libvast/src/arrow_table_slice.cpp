@@ -28,6 +28,7 @@
 #include <arrow/ipc/api.h>
 #include <arrow/status.h>
 
+#include <algorithm>
 #include <type_traits>
 #include <utility>
 
@@ -725,6 +726,99 @@ private:
   std::shared_ptr<arrow::RecordBatch> record_batch_ = nullptr;
 };
 
+/// Restores the dictionary-encoded columns of an array, which the Arrow table
+/// slice builder creates for low-cardinality string columns.
+/// @returns *array* itself if it contains no dictionary-encoded columns.
+caf::expected<std::shared_ptr<arrow::Array>>
+dictionary_decode(const std::shared_ptr<arrow::Array>& array) {
+  switch (array->type_id()) {
+    case arrow::Type::DICTIONARY: {
+      const auto& dictionary_array
+        = static_cast<const arrow::DictionaryArray&>(*array);
+      auto decoded = arrow::compute::Take(*dictionary_array.dictionary(),
+                                          *dictionary_array.indices());
+      if (!decoded.ok())
+        return caf::make_error(ec::format_error,
+                               fmt::format("failed to restore "
+                                           "dictionary-encoded column: {}",
+                                           decoded.status().ToString()));
+      return std::move(*decoded);
+    }
+    case arrow::Type::STRUCT: {
+      auto data = array->data()->Copy();
+      auto fields = array->type()->fields();
+      auto changed = false;
+      for (size_t index = 0; index < fields.size(); ++index) {
+        auto child = arrow::MakeArray(data->child_data[index]);
+        auto decoded_child = dictionary_decode(child);
+        if (!decoded_child)
+          return decoded_child.error();
+        if (*decoded_child != child) {
+          data->child_data[index] = (*decoded_child)->data();
+          fields[index] = fields[index]->WithType((*decoded_child)->type());
+          changed = true;
+        }
+      }
+      if (!changed)
+        return array;
+      data->type = arrow::struct_(std::move(fields));
+      return arrow::MakeArray(std::move(data));
+    }
+    default:
+      return array;
+  }
+}
+
+caf::expected<std::shared_ptr<arrow::RecordBatch>>
+dictionary_decode(const std::shared_ptr<arrow::RecordBatch>& record_batch) {
+  auto struct_array = record_batch->ToStructArray();
+  if (!struct_array.ok())
+    return caf::make_error(ec::format_error,
+                           struct_array.status().ToString());
+  auto decoded = dictionary_decode(*struct_array);
+  if (!decoded)
+    return decoded.error();
+  if (*decoded == *struct_array)
+    return record_batch;
+  auto result = arrow::RecordBatch::FromStructArray(*decoded);
+  if (!result.ok())
+    return caf::make_error(ec::format_error, result.status().ToString());
+  return (*result)->ReplaceSchemaMetadata(record_batch->schema()->metadata());
+}
+
+/// Returns the type that `dictionary_decode` produces for an array of type
+/// *t*, without restoring any data.
+std::shared_ptr<arrow::DataType>
+decoded_type(const std::shared_ptr<arrow::DataType>& t) {
+  switch (t->id()) {
+    case arrow::Type::DICTIONARY:
+      return static_cast<const arrow::DictionaryType&>(*t).value_type();
+    case arrow::Type::STRUCT: {
+      auto fields = t->fields();
+      auto changed = false;
+      for (auto& field : fields) {
+        auto field_type = decoded_type(field->type());
+        if (field_type != field->type()) {
+          field = field->WithType(std::move(field_type));
+          changed = true;
+        }
+      }
+      return changed ? arrow::struct_(std::move(fields)) : t;
+    }
+    default:
+      return t;
+  }
+}
+
+/// Returns the schema of a record batch after `dictionary_decode`.
+std::shared_ptr<arrow::Schema>
+decoded_schema(const std::shared_ptr<arrow::Schema>& schema) {
+  auto fields = schema->fields();
+  for (auto& field : fields)
+    field = field->WithType(decoded_type(field->type()));
+  return arrow::schema(std::move(fields), schema->metadata());
+}
+
 /// Compute position for each array by traversing the schema tree breadth-first.
 void index_column_arrays(const std::shared_ptr<arrow::Array>& arr,
                          arrow::ArrayVector& out) {
@@ -793,11 +887,24 @@ arrow_table_slice<FlatBuffer>::arrow_table_slice(
     auto decoder = record_batch_decoder{};
     state_.record_batch = decoder.decode(
       as_arrow_buffer(parent->slice(as_bytes(*slice.arrow_ipc()))));
-    state_.layout = type::from_arrow(*state_.record_batch->schema());
+    // Dictionary-encoded columns are restored lazily on first access, so
+    // slices that are only forwarded or partially read don't pay for it.
+    state_.layout
+      = type::from_arrow(*decoded_schema(state_.record_batch->schema()));
     VAST_ASSERT(caf::holds_alternative<record_type>(state_.layout));
     state_.flat_columns = index_column_arrays(state_.record_batch);
     VAST_ASSERT(state_.flat_columns.size()
                 == caf::get<record_type>(state_.layout).num_leaves());
+    state_.dictionary_encoded
+      = std::any_of(state_.flat_columns.begin(), state_.flat_columns.end(),
+                    [](const auto& array) {
+                      return array->type_id() == arrow::Type::DICTIONARY;
+                    });
+    if (state_.dictionary_encoded) {
+      state_.decoded_columns.resize(state_.flat_columns.size());
+      state_.decoded_column_flags
+        = std::vector<std::once_flag>(state_.flat_columns.size());
+    }
   } else {
     static_assert(detail::always_false_v<FlatBuffer>, "unhandled arrow table "
                                                       "slice version");
@@ -822,7 +929,7 @@ const type& arrow_table_slice<FlatBuffer>::layout() const noexcept {
 
 template <class FlatBuffer>
 table_slice::size_type arrow_table_slice<FlatBuffer>::rows() const noexcept {
-  if (auto&& batch = record_batch())
+  if (auto&& batch = state_.record_batch)
     return batch->num_rows();
   return 0;
 }
@@ -834,7 +941,7 @@ table_slice::size_type arrow_table_slice<FlatBuffer>::columns() const noexcept {
     if (auto&& batch = record_batch())
       return batch->num_columns();
   } else if constexpr (std::is_same_v<FlatBuffer, fbs::table_slice::arrow::v2>) {
-    if (auto&& batch = record_batch())
+    if (auto&& batch = state_.record_batch)
       return state_.flat_columns.size();
   } else {
     static_assert(detail::always_false_v<FlatBuffer>, "unhandled arrow table "
@@ -861,8 +968,8 @@ void arrow_table_slice<FlatBuffer>::append_column_to_index(
     }
     VAST_DIAGNOSTIC_POP
   } else if constexpr (std::is_same_v<FlatBuffer, fbs::table_slice::arrow::v2>) {
-    if (auto&& batch = record_batch()) {
-      auto&& array = state_.flat_columns[column];
+    if (auto&& batch = state_.record_batch) {
+      auto&& array = flat_column(column);
       const auto& layout = caf::get<record_type>(this->layout());
       auto type = layout.field(layout.resolve_flat_index(column)).type;
       for (size_t row = 0; auto&& value : values(type, *array)) {
@@ -877,6 +984,36 @@ void arrow_table_slice<FlatBuffer>::append_column_to_index(
   }
 }
 
+template <class FlatBuffer>
+detail::generator<data_view>
+arrow_table_slice<FlatBuffer>::values(table_slice::size_type column) const {
+  if constexpr (detail::is_any_v<FlatBuffer, fbs::table_slice::arrow::v0,
+                                 fbs::table_slice::arrow::v1>) {
+    const auto& layout = caf::get<record_type>(this->layout());
+    auto type = layout.field(layout.resolve_flat_index(column)).type;
+    auto impl = [](const arrow_table_slice* self, table_slice::size_type column,
+                   vast::type type) -> detail::generator<data_view> {
+      for (table_slice::size_type row = 0; row < self->rows(); ++row)
+        co_yield self->at(row, column, type);
+    };
+    return impl(this, column, std::move(type));
+  } else if constexpr (std::is_same_v<FlatBuffer, fbs::table_slice::arrow::v2>) {
+    const auto& layout = caf::get<record_type>(this->layout());
+    auto type = layout.field(layout.resolve_flat_index(column)).type;
+    // The generator returned by `values` refers to the type and the array, so
+    // we must keep both alive for as long as it runs.
+    auto impl = [](vast::type type, std::shared_ptr<arrow::Array> array)
+      -> detail::generator<data_view> {
+      for (auto&& value : vast::values(type, *array))
+        co_yield std::move(value);
+    };
+    return impl(std::move(type), flat_column(column));
+  } else {
+    static_assert(detail::always_false_v<FlatBuffer>, "unhandled arrow table "
+                                                      "slice version");
+  }
+}
+
 template <class FlatBuffer>
 data_view
 arrow_table_slice<FlatBuffer>::at(table_slice::size_type row,
@@ -893,7 +1030,7 @@ arrow_table_slice<FlatBuffer>::at(table_slice::size_type row,
     return legacy::value_at(layout.field(offset).type, *array, row);
     VAST_DIAGNOSTIC_POP
   } else if constexpr (std::is_same_v<FlatBuffer, fbs::table_slice::arrow::v2>) {
-    auto&& array = state_.flat_columns[column];
+    auto&& array = flat_column(column);
     const auto& layout = caf::get<record_type>(this->layout());
     auto offset = layout.resolve_flat_index(column);
     return value_at(layout.field(offset).type, *array, row);
@@ -927,7 +1064,7 @@ data_view arrow_table_slice<FlatBuffer>::at(table_slice::size_type row,
         .field(caf::get<record_type>(this->layout()).resolve_flat_index(column))
         .type,
       t));
-    auto&& array = state_.flat_columns[column];
+    auto&& array = flat_column(column);
     return value_at(t, *array, row);
   } else {
     static_assert(detail::always_false_v<FlatBuffer>, "unhandled arrow table "
@@ -967,7 +1104,55 @@ void arrow_table_slice<FlatBuffer>::import_time(
 template <class FlatBuffer>
 std::shared_ptr<arrow::RecordBatch>
 arrow_table_slice<FlatBuffer>::record_batch() const noexcept {
-  return state_.record_batch;
+  if constexpr (std::is_same_v<FlatBuffer, fbs::table_slice::arrow::v2>) {
+    if (!state_.dictionary_encoded)
+      return state_.record_batch;
+    std::call_once(state_.decoded_record_batch_flag, [this] {
+      auto decoded = dictionary_decode(state_.record_batch);
+      if (!decoded) {
+        VAST_ERROR("{} failed to restore record batch: {}", __func__,
+                   decoded.error());
+        return;
+      }
+      state_.decoded_record_batch = std::move(*decoded);
+    });
+    return state_.decoded_record_batch;
+  } else {
+    return state_.record_batch;
+  }
+}
+
+template <class FlatBuffer>
+const std::shared_ptr<arrow::Array>&
+arrow_table_slice<FlatBuffer>::flat_column(
+  table_slice::size_type column) const noexcept {
+  if constexpr (std::is_same_v<FlatBuffer, fbs::table_slice::arrow::v2>) {
+    const auto& array = state_.flat_columns[column];
+    if (array->type_id() != arrow::Type::DICTIONARY)
+      return array;
+    std::call_once(state_.decoded_column_flags[column], [&] {
+      auto decoded = dictionary_decode(array);
+      if (decoded) {
+        state_.decoded_columns[column] = std::move(*decoded);
+        return;
+      }
+      // We cannot report errors through the data access functions, so we
+      // treat the values of a column that we fail to restore as missing.
+      VAST_ERROR("{} failed to restore column {}: {}", __func__, column,
+                 decoded.error());
+      const auto& value_type
+        = static_cast<const arrow::DictionaryType&>(*array->type())
+            .value_type();
+      auto nulls = arrow::MakeArrayOfNull(value_type, array->length());
+      if (!nulls.ok())
+        die(fmt::format("failed to allocate {} null values: {}",
+                        array->length(), nulls.status().ToString()));
+      state_.decoded_columns[column] = std::move(*nulls);
+    });
+    return state_.decoded_columns[column];
+  } else {
+    die("flat columns are only available for arrow.v2 table slices");
+  }
 }
 
 // -- utility functions -------------------------------------------------------
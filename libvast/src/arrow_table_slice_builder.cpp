@@ -11,6 +11,7 @@
 #include "vast/concept/parseable/core.hpp"
 #include "vast/concept/parseable/numeric.hpp"
 #include "vast/config.hpp"
+#include "vast/defaults.hpp"
 #include "vast/detail/byte_swap.hpp"
 #include "vast/detail/narrow.hpp"
 #include "vast/detail/overload.hpp"
@@ -22,10 +23,15 @@
 #include "vast/type.hpp"
 
 #include <arrow/api.h>
+#include <arrow/compute/api.h>
 #include <arrow/io/api.h>
 #include <arrow/ipc/writer.h>
 
 #include <simdjson.h>
+#include <tsl/robin_set.h>
+
+#include <algorithm>
+#include <string_view>
 
 namespace vast {
 
@@ -91,6 +97,103 @@ table_slice create_table_slice(const arrow::RecordBatch& record_batch,
   return result;
 }
 
+/// Decides whether to dictionary-encode a string column. Types with the
+/// `#dictionary` attribute opt in or out explicitly; for all other columns we
+/// estimate the cardinality from a sample of the leading values.
+bool should_dictionary_encode(const type& t, const arrow::StringArray& array) {
+  if (array.length() == 0)
+    return false;
+  if (auto attribute = t.attribute("dictionary"))
+    return *attribute != "false";
+  const auto length = detail::narrow_cast<size_t>(array.length());
+  if (length < defaults::import::dictionary_encoding_min_rows)
+    return false;
+  const auto sample_size
+    = std::min(length, defaults::import::dictionary_encoding_sample_size);
+  const auto max_distinct = static_cast<size_t>(
+    static_cast<double>(sample_size)
+    * defaults::import::dictionary_encoding_max_cardinality);
+  auto distinct = tsl::robin_set<std::string_view>{};
+  for (size_t row = 0; row < sample_size; ++row) {
+    if (array.IsNull(detail::narrow_cast<int64_t>(row)))
+      continue;
+    const auto value = array.GetView(detail::narrow_cast<int64_t>(row));
+    distinct.emplace(value.data(), value.size());
+    if (distinct.size() > max_distinct)
+      return false;
+  }
+  return true;
+}
+
+/// Replaces low-cardinality string columns with dictionary-encoded columns.
+/// Only string columns that are reachable through nested records are
+/// considered, i.e., we do not descend into lists and maps.
+/// @returns *array* itself if no column was encoded.
+std::shared_ptr<arrow::Array>
+dictionary_encode(const type& t, const std::shared_ptr<arrow::Array>& array) {
+  auto f = detail::overload{
+    [&](const string_type&) -> std::shared_ptr<arrow::Array> {
+      if (!should_dictionary_encode(
+            t, caf::get<type_to_arrow_array_t<string_type>>(*array)))
+        return array;
+      auto encoded = arrow::compute::DictionaryEncode(array);
+      if (!encoded.ok()) {
+        VAST_WARN("failed to dictionary-encode string column: {}",
+                  encoded.status().ToString());
+        return array;
+      }
+      auto result = encoded->make_array();
+      // The sample may have been misleading, in which case we rather keep the
+      // plain representation.
+      const auto& dictionary
+        = static_cast<const arrow::DictionaryArray&>(*result).dictionary();
+      if (!t.attribute("dictionary")
+          && static_cast<double>(dictionary->length())
+               > static_cast<double>(array->length())
+                   * defaults::import::dictionary_encoding_max_cardinality)
+        return array;
+      return result;
+    },
+    [&](const record_type& rt) -> std::shared_ptr<arrow::Array> {
+      auto data = array->data()->Copy();
+      auto fields = array->type()->fields();
+      auto changed = false;
+      for (size_t index = 0; const auto& field : rt.fields()) {
+        auto child = arrow::MakeArray(data->child_data[index]);
+        auto encoded_child = dictionary_encode(field.type, child);
+        if (encoded_child != child) {
+          data->child_data[index] = encoded_child->data();
+          fields[index] = fields[index]->WithType(encoded_child->type());
+          changed = true;
+        }
+        ++index;
+      }
+      if (!changed)
+        return array;
+      data->type = arrow::struct_(std::move(fields));
+      return arrow::MakeArray(std::move(data));
+    },
+    [&](const auto&) -> std::shared_ptr<arrow::Array> {
+      return array;
+    },
+  };
+  return caf::visit(f, t);
+}
+
+/// Dictionary-encodes the low-cardinality string columns of a record batch.
+/// This only affects the serialized representation; Arrow-encoded table slices
+/// restore the original columns when decoding the record batch.
+std::shared_ptr<arrow::RecordBatch>
+dictionary_encode(const type& layout,
+                  const std::shared_ptr<arrow::RecordBatch>& record_batch) {
+  auto struct_array = record_batch->ToStructArray().ValueOrDie();
+  auto encoded = dictionary_encode(layout, struct_array);
+  if (encoded == struct_array)
+    return record_batch;
+  auto result = arrow::RecordBatch::FromStructArray(encoded).ValueOrDie();
+  return result->ReplaceSchemaMetadata(record_batch->schema()->metadata());
+}
+
 void verify_record_batch(const arrow::RecordBatch& record_batch) {
   auto check_col
     = [](auto&& check_col, const arrow::Array& column) noexcept -> void {
@@ -127,7 +230,8 @@ table_slice arrow_table_slice_builder::finish() {
     caf::get<type_to_arrow_array_t<record_type>>(*combined_array).fields());
   // Reset the builder state.
   num_rows_ = {};
-  return create_table_slice(*record_batch, this->builder_);
+  return create_table_slice(*dictionary_encode(layout(), record_batch),
+                            this->builder_);
 }
 
 table_slice arrow_table_slice_builder::create(
@@ -135,7 +239,31 @@ table_slice arrow_table_slice_builder::create(
   size_t initial_buffer_size) {
   verify_record_batch(*record_batch);
   auto builder = flatbuffers::FlatBufferBuilder{initial_buffer_size};
-  return create_table_slice(*record_batch, builder);
+  const auto layout = type::from_arrow(*record_batch->schema());
+  return create_table_slice(*dictionary_encode(layout, record_batch), builder);
+}
+
+std::vector<table_slice> arrow_table_slice_builder::create_slices(
+  const std::shared_ptr<arrow::RecordBatch>& record_batch,
+  size_t max_slice_size, size_t initial_buffer_size) {
+  VAST_ASSERT(max_slice_size > 0);
+  verify_record_batch(*record_batch);
+  const auto layout = type::from_arrow(*record_batch->schema());
+  const auto encoded = dictionary_encode(layout, record_batch);
+  const auto num_rows = detail::narrow_cast<size_t>(encoded->num_rows());
+  auto result = std::vector<table_slice>{};
+  result.reserve((num_rows + max_slice_size - 1) / max_slice_size);
+  for (size_t offset = 0; offset < num_rows; offset += max_slice_size) {
+    const auto rows = std::min(num_rows - offset, max_slice_size);
+    auto builder = flatbuffers::FlatBufferBuilder{initial_buffer_size};
+    const auto slice
+      = rows == num_rows
+          ? encoded
+          : encoded->Slice(detail::narrow_cast<int64_t>(offset),
+                           detail::narrow_cast<int64_t>(rows));
+    result.push_back(create_table_slice(*slice, builder));
+  }
+  return result;
 }
 
 size_t arrow_table_slice_builder::rows() const noexcept {
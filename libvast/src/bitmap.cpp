@@ -14,6 +14,22 @@
 
 namespace vast {
 
+namespace {
+
+template <bool FillLHS, bool FillRHS, class Operation, class Fallback>
+bitmap eval(const bitmap& lhs, const bitmap& rhs, Operation op,
+            Fallback fallback) {
+  if (const auto* x = caf::get_if<ewah_bitmap>(&lhs.get_data()))
+    if (const auto* y = caf::get_if<ewah_bitmap>(&rhs.get_data()))
+      return op(*x, *y);
+  if (const auto* x = caf::get_if<roaring_bitmap>(&lhs.get_data()))
+    if (const auto* y = caf::get_if<roaring_bitmap>(&rhs.get_data()))
+      return op(*x, *y);
+  return binary_eval<FillLHS, FillRHS>(lhs, rhs, fallback);
+}
+
+} // namespace
+
 bitmap::bitmap() : bitmap_{default_bitmap{}} {
 }
 
@@ -107,6 +123,11 @@ auto pack(flatbuffers::FlatBufferBuilder& builder, const bitmap& from)
       return fbs::CreateBitmap(builder, fbs::bitmap::Bitmap::wah,
                                wah_offset.Union());
     },
+    [&](const roaring_bitmap& roaring) {
+      const auto roaring_offset = pack(builder, roaring).Union();
+      return fbs::CreateBitmap(builder, fbs::bitmap::Bitmap::roaring,
+                               roaring_offset.Union());
+    },
   };
   return caf::visit(f, from.bitmap_);
 }
@@ -128,6 +149,8 @@ auto unpack(const fbs::Bitmap& from, bitmap& to) -> caf::error {
       return do_unpack(*from.bitmap_as_null(), null_bitmap{});
     case fbs::bitmap::Bitmap::wah:
       return do_unpack(*from.bitmap_as_wah(), wah_bitmap{});
+    case fbs::bitmap::Bitmap::roaring:
+      return do_unpack(*from.bitmap_as_roaring(), roaring_bitmap{});
   }
   __builtin_unreachable();
 }
@@ -162,4 +185,48 @@ bitmap_bit_range bit_range(const bitmap& bm) {
   return bitmap_bit_range{bm};
 }
 
+bitmap binary_and(const bitmap& lhs, const bitmap& rhs) {
+  return eval<false, false>(
+    lhs, rhs,
+    [](const auto& x, const auto& y) {
+      return x & y;
+    },
+    [](auto x, auto y) {
+      return x & y;
+    });
+}
+
+bitmap binary_or(const bitmap& lhs, const bitmap& rhs) {
+  return eval<true, true>(
+    lhs, rhs,
+    [](const auto& x, const auto& y) {
+      return x | y;
+    },
+    [](auto x, auto y) {
+      return x | y;
+    });
+}
+
+bitmap binary_xor(const bitmap& lhs, const bitmap& rhs) {
+  return eval<true, true>(
+    lhs, rhs,
+    [](const auto& x, const auto& y) {
+      return x ^ y;
+    },
+    [](auto x, auto y) {
+      return x ^ y;
+    });
+}
+
+bitmap binary_nand(const bitmap& lhs, const bitmap& rhs) {
+  return eval<true, false>(
+    lhs, rhs,
+    [](const auto& x, const auto& y) {
+      return x - y;
+    },
+    [](auto x, auto y) {
+      return x & ~y;
+    });
+}
+
 } // namespace vast
@@ -36,6 +36,22 @@ void bool_synopsis::add(data_view x) {
     false_ = true;
 }
 
+void bool_synopsis::add_column(const table_slice& slice, size_t column) {
+  // Once we have seen both values, no further value can change the synopsis.
+  if (true_ && false_)
+    return;
+  for (auto&& x : slice.values(column)) {
+    if (const auto* b = caf::get_if<view<bool>>(&x)) {
+      if (*b)
+        true_ = true;
+      else
+        false_ = true;
+      if (true_ && false_)
+        return;
+    }
+  }
+}
+
 size_t bool_synopsis::memusage() const {
   return sizeof(bool_synopsis);
 }
@@ -23,12 +23,21 @@
 #include <sys/mman.h>
 #include <sys/stat.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstddef>
 #include <cstring>
 #include <fcntl.h>
 #include <filesystem>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <span>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <tuple>
 #include <unistd.h>
 
@@ -89,6 +98,257 @@ caf::expected<chunk_ptr> chunk::mmap(const std::filesystem::path& filename,
   return make(map, size, std::move(deleter));
 }
 
+namespace {
+
+/// Shared memory objects created by VAST carry this prefix. We only ever adopt
+/// shared memory objects with this prefix when deserializing chunks.
+constexpr std::string_view shared_memory_prefix = "/vast-";
+
+/// Denotes how a serialized chunk transfers its contents.
+enum class chunk_kind : uint8_t {
+  /// The contents follow inline, preceded by their size.
+  bytes,
+  /// Only the size and the name of a shared memory object follow.
+  shared_memory,
+};
+
+/// Returns the part of a shared memory object's name that identifies the
+/// process that created it, i.e., `/vast-<pid>-`.
+std::string_view shared_memory_creator(std::string_view name) {
+  auto pos = name.rfind('-');
+  if (pos == std::string_view::npos || pos < shared_memory_prefix.size())
+    return {};
+  return name.substr(0, pos + 1);
+}
+
+/// Keeps track of the processes that negotiated handing off chunks via shared
+/// memory. We refuse to adopt shared memory objects of all other processes
+/// when deserializing chunks, as adopting an object unlinks it.
+class shared_memory_registry {
+public:
+  static shared_memory_registry& instance() {
+    static shared_memory_registry result;
+    return result;
+  }
+
+  shared_memory_registry(const shared_memory_registry&) = delete;
+  shared_memory_registry& operator=(const shared_memory_registry&) = delete;
+
+  void accept(std::string_view name) {
+    auto creator = shared_memory_creator(name);
+    if (creator.empty())
+      return;
+    auto lock = std::unique_lock{mutex_};
+    creators_.emplace(creator);
+  }
+
+  bool accepts(std::string_view name) const {
+    auto creator = shared_memory_creator(name);
+    if (creator.empty())
+      return false;
+    auto lock = std::unique_lock{mutex_};
+    return creators_.find(creator) != creators_.end();
+  }
+
+private:
+  shared_memory_registry() = default;
+
+  mutable std::mutex mutex_ = {};
+  std::set<std::string, std::less<>> creators_ = {};
+};
+
+/// Adopts a shared memory object when deserializing a chunk, provided that the
+/// process that created it negotiated shared memory.
+caf::expected<chunk_ptr>
+adopt_negotiated_shared_memory(const std::string& name, uint64_t size) {
+  if (!shared_memory_registry::instance().accepts(name))
+    return caf::make_error(ec::invalid_argument,
+                           fmt::format("refusing to adopt shared memory "
+                                       "object {} of a peer that did not "
+                                       "negotiate shared memory",
+                                       name));
+  return chunk::adopt_shared_memory(
+    name, detail::narrow_cast<chunk::size_type>(size));
+}
+
+/// Unlinks shared memory objects that were handed off to another process, but
+/// that the other process may never adopt, e.g., because the message carrying
+/// them got dropped. Unlinking an object that the receiver already adopted is
+/// harmless, as the receiver unlinks it when adopting it.
+class shared_memory_reaper {
+public:
+  using clock_type = std::chrono::steady_clock;
+
+  static shared_memory_reaper& instance() {
+    static shared_memory_reaper result;
+    return result;
+  }
+
+  shared_memory_reaper(const shared_memory_reaper&) = delete;
+  shared_memory_reaper& operator=(const shared_memory_reaper&) = delete;
+
+  /// Stops the background thread and unlinks all objects that are still
+  /// pending. This runs when the sending process exits, at which point the
+  /// receiver had the chance to adopt all objects that it acknowledged.
+  ~shared_memory_reaper() noexcept {
+    {
+      auto lock = std::unique_lock{mutex_};
+      stop_ = true;
+    }
+    cv_.notify_one();
+    if (thread_.joinable())
+      thread_.join();
+    for (const auto& [_, name] : pending_)
+      ::shm_unlink(name.c_str());
+  }
+
+  /// Schedules a shared memory object for unlinking after a timeout.
+  void schedule(std::string name, clock_type::duration timeout) {
+    {
+      auto lock = std::unique_lock{mutex_};
+      pending_.emplace(clock_type::now() + timeout, std::move(name));
+      if (!thread_.joinable())
+        thread_ = std::thread{[this] {
+          run();
+        }};
+    }
+    cv_.notify_one();
+  }
+
+private:
+  shared_memory_reaper() = default;
+
+  void run() {
+    auto lock = std::unique_lock{mutex_};
+    while (!stop_) {
+      if (pending_.empty()) {
+        cv_.wait(lock);
+        continue;
+      }
+      auto next = pending_.begin();
+      if (next->first > clock_type::now()) {
+        cv_.wait_until(lock, next->first);
+        continue;
+      }
+      ::shm_unlink(next->second.c_str());
+      pending_.erase(next);
+    }
+  }
+
+  std::mutex mutex_ = {};
+  std::condition_variable cv_ = {};
+  std::multimap<clock_type::time_point, std::string> pending_ = {};
+  bool stop_ = false;
+  std::thread thread_ = {};
+};
+
+} // namespace
+
+caf::expected<chunk_ptr>
+chunk::make_shared_memory(view_type view,
+                          std::chrono::steady_clock::duration cleanup_timeout) {
+  static auto counter = std::atomic<size_t>{0};
+  auto name = fmt::format("{}{}-{}", shared_memory_prefix, ::getpid(),
+                          counter.fetch_add(1, std::memory_order_relaxed));
+  auto fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd == -1)
+    return caf::make_error(ec::system_error,
+                           fmt::format("failed to create shared memory object "
+                                       "{}: {}",
+                                       name, std::strerror(errno)));
+  auto fail = [&](const char* what) {
+    auto error = caf::make_error(ec::system_error,
+                                 fmt::format("failed to {} shared memory "
+                                             "object {}: {}",
+                                             what, name, std::strerror(errno)));
+    ::close(fd);
+    ::shm_unlink(name.c_str());
+    return error;
+  };
+  // Mapping zero bytes is not possible, so we always map at least one byte.
+  const auto map_size = std::max(view.size(), size_type{1});
+  if (::ftruncate(fd, detail::narrow_cast<off_t>(map_size)) != 0)
+    return fail("resize");
+  auto map
+    = ::mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED)
+    return fail("mmap");
+  ::close(fd);
+  std::memcpy(map, view.data(), view.size());
+  auto result = make(map, view.size(), [=]() noexcept {
+    ::munmap(map, map_size);
+  });
+  result->shared_memory_name_ = name;
+  result->add_deletion_step([chunk = result.get(), name,
+                             cleanup_timeout]() noexcept {
+    if (!chunk->shared_memory_handed_off_) {
+      ::shm_unlink(name.c_str());
+      return;
+    }
+    try {
+      shared_memory_reaper::instance().schedule(name, cleanup_timeout);
+    } catch (const std::exception& e) {
+      VAST_WARN("failed to schedule cleanup of shared memory object {}: {}",
+                name, e.what());
+    }
+  });
+  return result;
+}
+
+caf::expected<chunk_ptr>
+chunk::adopt_shared_memory(const std::string& name, size_type size) {
+  if (!name.starts_with(shared_memory_prefix)
+      || name.find('/', 1) != std::string::npos)
+    return caf::make_error(ec::invalid_argument,
+                           fmt::format("refusing to adopt foreign shared "
+                                       "memory object {}",
+                                       name));
+  auto fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd == -1)
+    return caf::make_error(ec::system_error,
+                           fmt::format("failed to open shared memory object "
+                                       "{}: {}",
+                                       name, std::strerror(errno)));
+  // Nobody else needs the name anymore, so we unlink the object right away.
+  // The memory is released once we unmap it.
+  ::shm_unlink(name.c_str());
+  const auto map_size = std::max(size, size_type{1});
+  struct ::stat st {};
+  if (::fstat(fd, &st) != 0 || static_cast<size_type>(st.st_size) < map_size) {
+    ::close(fd);
+    return caf::make_error(ec::system_error,
+                           fmt::format("shared memory object {} is smaller "
+                                       "than {} bytes",
+                                       name, size));
+  }
+  // We map the object privately and writable, because table slices mutate
+  // their import time in place. This only copies the touched pages.
+  auto map
+    = ::mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  auto mmap_errno = errno;
+  ::close(fd);
+  if (map == MAP_FAILED)
+    return caf::make_error(ec::system_error,
+                           fmt::format("failed to mmap shared memory object "
+                                       "{}: {}",
+                                       name, std::strerror(mmap_errno)));
+  return make(map, size, [=]() noexcept {
+    ::munmap(map, map_size);
+  });
+}
+
+caf::expected<chunk_ptr>
+chunk::accept_shared_memory(const std::string& name, size_type size) {
+  auto result = adopt_shared_memory(name, size);
+  if (result)
+    shared_memory_registry::instance().accept(name);
+  return result;
+}
+
+const std::string& chunk::shared_memory_name() const noexcept {
+  return shared_memory_name_;
+}
+
 // -- container facade ---------------------------------------------------------
 
 chunk::pointer chunk::data() const noexcept {
@@ -203,6 +463,21 @@ caf::error read(const std::filesystem::path& filename, chunk_ptr& x) {
 
 caf::error inspect(caf::serializer& sink, const chunk_ptr& x) {
   using vast::detail::narrow;
+  if (x != nullptr && !x->shared_memory_name_.empty()) {
+    x->shared_memory_handed_off_ = true;
+    return caf::error::eval(
+      [&] {
+        return sink(static_cast<uint8_t>(chunk_kind::shared_memory));
+      },
+      [&] {
+        return sink(uint64_t{x->size()});
+      },
+      [&] {
+        return sink(x->shared_memory_name_);
+      });
+  }
+  if (auto err = sink(static_cast<uint8_t>(chunk_kind::bytes)))
+    return err;
   if (x == nullptr)
     return sink(uint32_t{0});
   return caf::error::eval(
@@ -215,6 +490,35 @@ caf::error inspect(caf::serializer& sink, const chunk_ptr& x) {
 }
 
 caf::error inspect(caf::deserializer& source, chunk_ptr& x) {
+  auto kind = uint8_t{0};
+  if (auto err = source(kind))
+    return err;
+  if (kind == static_cast<uint8_t>(chunk_kind::shared_memory)) {
+    auto shared_memory_size = uint64_t{0};
+    auto name = std::string{};
+    if (auto err = caf::error::eval(
+          [&] {
+            return source(shared_memory_size);
+          },
+          [&] {
+            return source(name);
+          })) {
+      x = nullptr;
+      return err;
+    }
+    auto result = adopt_negotiated_shared_memory(name, shared_memory_size);
+    if (!result) {
+      x = nullptr;
+      return std::move(result.error());
+    }
+    x = std::move(*result);
+    return caf::none;
+  }
+  if (kind != static_cast<uint8_t>(chunk_kind::bytes)) {
+    x = nullptr;
+    return caf::make_error(ec::format_error,
+                           fmt::format("invalid chunk kind {}", kind));
+  }
   uint32_t size = 0;
   if (auto err = source(size))
     return err;
@@ -235,6 +539,17 @@ caf::error inspect(caf::deserializer& source, chunk_ptr& x) {
 }
 
 bool inspect(detail::legacy_deserializer& source, chunk_ptr& x) {
+  // The legacy deserializer only reads persisted state, which never refers to
+  // shared memory objects.
+  auto kind = uint8_t{0};
+  if (!source(kind))
+    return false;
+  if (kind != static_cast<uint8_t>(chunk_kind::bytes)) {
+    VAST_WARN("refusing to deserialize chunk of kind {} from persisted state",
+              kind);
+    x = nullptr;
+    return false;
+  }
   uint32_t size = 0;
   if (!source(size))
     return false;
@@ -320,6 +320,14 @@ bool evaluate(const data& lhs, relational_operator op, const data& rhs) {
                           return std::find(rhs.begin(), rhs.end(), lhs)
                                  != rhs.end();
                         },
+                        [](const address& lhs, const list& rhs) {
+                          auto pred = [&](const data& x) {
+                            if (auto sn = caf::get_if<subnet>(&x))
+                              return sn->contains(lhs);
+                            return x == lhs;
+                          };
+                          return std::any_of(rhs.begin(), rhs.end(), pred);
+                        },
                       },
                       x, y);
   };
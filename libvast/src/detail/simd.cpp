@@ -0,0 +1,94 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vast/detail/simd.hpp"
+
+#include <cstring>
+
+// Function multi-versioning relies on ifuncs, which only glibc provides.
+#if defined(__x86_64__) && defined(__GLIBC__) && defined(__has_attribute)
+#  if __has_attribute(target_clones)
+#    define VAST_SIMD_TARGET_CLONES                                            \
+      __attribute__((target_clones("avx512f", "avx2", "default")))
+#  endif
+#endif
+#ifndef VAST_SIMD_TARGET_CLONES
+#  define VAST_SIMD_TARGET_CLONES
+#endif
+
+namespace vast::detail::simd {
+
+namespace {
+
+/// Eight blocks, i.e., one AVX-512 register, two AVX2 registers, or four
+/// SSE2 registers. The compiler lowers operations on this type to the
+/// instructions of the calling function's target.
+using block_vector = uint64_t __attribute__((vector_size(64)));
+
+constexpr auto lanes = sizeof(block_vector) / sizeof(uint64_t);
+
+enum class operation { conjunction, disjunction, exclusive, difference };
+
+// Vectors only ever pass by reference to avoid ABI differences between
+// targets.
+template <operation Op, class T>
+[[gnu::always_inline]] inline void combine(const T& x, const T& y, T& z) {
+  if constexpr (Op == operation::conjunction)
+    z = x & y;
+  else if constexpr (Op == operation::disjunction)
+    z = x | y;
+  else if constexpr (Op == operation::exclusive)
+    z = x ^ y;
+  else
+    z = x & ~y;
+}
+
+template <operation Op>
+[[gnu::always_inline]] inline void
+apply(const uint64_t* lhs, const uint64_t* rhs, uint64_t* out, size_t n) {
+  auto i = size_t{0};
+  for (; i + lanes <= n; i += lanes) {
+    block_vector x;
+    block_vector y;
+    block_vector z;
+    std::memcpy(&x, lhs + i, sizeof(x));
+    std::memcpy(&y, rhs + i, sizeof(y));
+    combine<Op>(x, y, z);
+    std::memcpy(out + i, &z, sizeof(z));
+  }
+  for (; i < n; ++i)
+    combine<Op>(lhs[i], rhs[i], out[i]);
+}
+
+} // namespace
+
+VAST_SIMD_TARGET_CLONES
+void bitwise_and(const uint64_t* lhs, const uint64_t* rhs, uint64_t* out,
+                 size_t n) {
+  apply<operation::conjunction>(lhs, rhs, out, n);
+}
+
+VAST_SIMD_TARGET_CLONES
+void bitwise_or(const uint64_t* lhs, const uint64_t* rhs, uint64_t* out,
+                size_t n) {
+  apply<operation::disjunction>(lhs, rhs, out, n);
+}
+
+VAST_SIMD_TARGET_CLONES
+void bitwise_xor(const uint64_t* lhs, const uint64_t* rhs, uint64_t* out,
+                 size_t n) {
+  apply<operation::exclusive>(lhs, rhs, out, n);
+}
+
+VAST_SIMD_TARGET_CLONES
+void bitwise_nand(const uint64_t* lhs, const uint64_t* rhs, uint64_t* out,
+                  size_t n) {
+  apply<operation::difference>(lhs, rhs, out, n);
+}
+
+} // namespace vast::detail::simd
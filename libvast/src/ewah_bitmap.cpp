@@ -8,10 +8,144 @@
 
 #include "vast/ewah_bitmap.hpp"
 
+#include "vast/detail/simd.hpp"
 #include "vast/fbs/bitmap.hpp"
 
+#include <algorithm>
+#include <limits>
+
 namespace vast {
 
+namespace {
+
+using word_type = ewah_bitmap::word_type;
+using block_type = ewah_bitmap::block_type;
+
+/// Walks over the blocks of an EWAH bitmap in segments of either clean blocks
+/// or consecutive dirty blocks. Past the end of the bitmap, the cursor yields
+/// an endless segment of clean zero blocks.
+class segment_cursor {
+public:
+  explicit segment_cursor(const ewah_bitmap::block_vector& blocks)
+    : blocks_{blocks} {
+    load();
+  }
+
+  /// @returns whether the current segment consists of clean blocks.
+  [[nodiscard]] bool clean() const {
+    return num_clean_ > 0;
+  }
+
+  /// @returns the value of the clean blocks in the current segment.
+  [[nodiscard]] block_type fill() const {
+    return fill_;
+  }
+
+  /// @returns the dirty blocks of the current segment.
+  [[nodiscard]] const block_type* dirty() const {
+    return blocks_.data() + next_;
+  }
+
+  /// @returns the number of blocks in the current segment.
+  [[nodiscard]] uint64_t length() const {
+    return clean() ? num_clean_ : num_dirty_;
+  }
+
+  /// Advances the cursor by a number of blocks.
+  /// @pre `n <= length()`
+  void skip(uint64_t n) {
+    if (clean()) {
+      num_clean_ -= n;
+    } else {
+      next_ += n;
+      num_dirty_ -= n;
+    }
+    load();
+  }
+
+private:
+  void load() {
+    while (num_clean_ == 0 && num_dirty_ == 0) {
+      if (next_ == blocks_.size()) {
+        fill_ = word_type::none;
+        num_clean_ = std::numeric_limits<uint64_t>::max();
+      } else if (next_ + 1 == blocks_.size()) {
+        // The last block is always dirty, but no marker accounts for it.
+        num_dirty_ = 1;
+      } else {
+        auto marker = blocks_[next_++];
+        fill_ = word_type::marker_type(marker) ? word_type::all
+                                               : word_type::none;
+        num_clean_ = word_type::marker_num_clean(marker);
+        num_dirty_ = word_type::marker_num_dirty(marker);
+      }
+    }
+  }
+
+  const ewah_bitmap::block_vector& blocks_;
+  size_t next_ = 0;
+  block_type fill_ = word_type::none;
+  uint64_t num_clean_ = 0;
+  uint64_t num_dirty_ = 0;
+};
+
+/// Applies a bitwise operation to two EWAH bitmaps segment by segment. Runs of
+/// clean blocks remain runs whenever the operation maps them to a constant,
+/// and consecutive dirty blocks on both sides go through a vectorized kernel.
+/// Like the generic algorithm, the shorter operand counts as padded with
+/// zeros.
+template <class Operation, class Kernel>
+ewah_bitmap eval(const ewah_bitmap& lhs, const ewah_bitmap& rhs, Operation op,
+                 Kernel kernel) {
+  auto result = ewah_bitmap{};
+  auto remaining = std::max(lhs.size(), rhs.size());
+  if (remaining == 0)
+    return result;
+  auto x = segment_cursor{lhs.blocks()};
+  auto y = segment_cursor{rhs.blocks()};
+  auto scratch = std::vector<block_type>{};
+  // Appends a single block, truncated to the remaining bits.
+  auto append = [&](block_type block) {
+    auto n = std::min<uint64_t>(word_type::width, remaining);
+    result.append_block(block, n);
+    remaining -= n;
+  };
+  while (remaining > 0) {
+    auto blocks = (remaining + word_type::width - 1) / word_type::width;
+    auto n = std::min({x.length(), y.length(), blocks});
+    if (x.clean() && y.clean()) {
+      auto bits = std::min(n * word_type::width, remaining);
+      result.append_bits(op(x.fill(), y.fill()) != word_type::none, bits);
+      remaining -= bits;
+    } else if (x.clean() || y.clean()) {
+      auto fill = x.clean() ? x.fill() : y.fill();
+      const auto* dirty = x.clean() ? y.dirty() : x.dirty();
+      auto apply = [&](block_type block) {
+        return x.clean() ? op(fill, block) : op(block, fill);
+      };
+      auto constant = apply(word_type::none);
+      if (constant == apply(word_type::all)) {
+        auto bits = std::min(n * word_type::width, remaining);
+        result.append_bits(constant != word_type::none, bits);
+        remaining -= bits;
+      } else {
+        for (uint64_t i = 0; i < n; ++i)
+          append(apply(dirty[i]));
+      }
+    } else {
+      scratch.resize(n);
+      kernel(x.dirty(), y.dirty(), scratch.data(), n);
+      for (auto block : scratch)
+        append(block);
+    }
+    x.skip(n);
+    y.skip(n);
+  }
+  return result;
+}
+
+} // namespace
+
 ewah_bitmap::ewah_bitmap(size_type n, bool bit) {
   append_bits(bit, n);
 }
@@ -244,6 +378,30 @@ bool operator==(const ewah_bitmap& x, const ewah_bitmap& y) {
   return x.blocks_ == y.blocks_ && x.num_bits_ == y.num_bits_;
 }
 
+ewah_bitmap binary_and(const ewah_bitmap& lhs, const ewah_bitmap& rhs) {
+  return eval(
+    lhs, rhs, [](block_type x, block_type y) { return x & y; },
+    detail::simd::bitwise_and);
+}
+
+ewah_bitmap binary_or(const ewah_bitmap& lhs, const ewah_bitmap& rhs) {
+  return eval(
+    lhs, rhs, [](block_type x, block_type y) { return x | y; },
+    detail::simd::bitwise_or);
+}
+
+ewah_bitmap binary_xor(const ewah_bitmap& lhs, const ewah_bitmap& rhs) {
+  return eval(
+    lhs, rhs, [](block_type x, block_type y) { return x ^ y; },
+    detail::simd::bitwise_xor);
+}
+
+ewah_bitmap binary_nand(const ewah_bitmap& lhs, const ewah_bitmap& rhs) {
+  return eval(
+    lhs, rhs, [](block_type x, block_type y) { return x & ~y; },
+    detail::simd::bitwise_nand);
+}
+
 auto pack(flatbuffers::FlatBufferBuilder& builder, const ewah_bitmap& from)
   -> flatbuffers::Offset<fbs::bitmap::EWAHBitmap> {
   return fbs::bitmap::CreateEWAHBitmapDirect(builder, &from.blocks_,
@@ -187,6 +187,7 @@ expression normalize(expression expr) {
   expr = caf::visit(aligner{}, std::move(expr));
   expr = caf::visit(denegator{}, std::move(expr));
   expr = caf::visit(deduplicator{}, std::move(expr));
+  expr = caf::visit(membership_batcher{}, std::move(expr));
   expr = caf::visit(hoister{}, std::move(expr));
   return expr;
 }
@@ -205,7 +206,11 @@ caf::expected<expression> tailor(expression expr, const type& layout) {
                                                         "expression {} for "
                                                         "layout {}",
                                                         expr, layout));
-  return caf::visit(type_resolver{layout}, std::move(expr));
+  auto result = caf::visit(type_resolver{layout}, std::move(expr));
+  if (!result)
+    return result;
+  // Resolving field extractors reveals which predicates operate on addresses.
+  return caf::visit(membership_batcher{}, std::move(*result));
 }
 
 namespace {
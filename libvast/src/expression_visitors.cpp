@@ -17,6 +17,7 @@
 #include "vast/concept/printable/vast/operator.hpp"
 #include "vast/data.hpp"
 #include "vast/detail/assert.hpp"
+#include "vast/detail/overload.hpp"
 #include "vast/die.hpp"
 #include "vast/ids.hpp"
 #include "vast/logger.hpp"
@@ -25,6 +26,7 @@
 #include "vast/view.hpp"
 
 #include <algorithm>
+#include <optional>
 #include <regex>
 
 namespace vast {
@@ -212,6 +214,154 @@ expression deduplicator::operator()(const predicate& p) const {
 
 namespace {
 
+/// Checks whether equality with a value means the same as membership in a
+/// list that contains the value.
+bool is_batchable(const data& x) {
+  return caf::visit(detail::overload{
+                      [](const auto&) {
+                        return true;
+                      },
+                      [](caf::none_t) {
+                        return false;
+                      },
+                      // Equality with a pattern is a match.
+                      [](const pattern&) {
+                        return false;
+                      },
+                      [](const list&) {
+                        return false;
+                      },
+                      [](const map&) {
+                        return false;
+                      },
+                      [](const record&) {
+                        return false;
+                      },
+                    },
+                    x);
+}
+
+/// Retrieves the values that a predicate tests for membership in, if any.
+std::optional<list> membership_elements(const predicate& p) {
+  // We must know the type of the field to tell whether the values fit into
+  // it. Otherwise, the batched predicate could resolve to fields that none of
+  // the original predicates applied to, e.g., `x == "foo" || x == "bar"`
+  // would also resolve to a field `x` of type count.
+  const type* t = nullptr;
+  if (auto ex = caf::get_if<type_extractor>(&p.lhs))
+    t = &ex->type;
+  else if (auto ex = caf::get_if<data_extractor>(&p.lhs))
+    t = &ex->type;
+  else
+    return std::nullopt;
+  auto x = caf::get_if<data>(&p.rhs);
+  if (!x)
+    return std::nullopt;
+  // Addresses are also members of the subnets that contain them.
+  if (caf::holds_alternative<address_type>(*t)) {
+    if (p.op == relational_operator::equal
+        && caf::holds_alternative<address>(*x))
+      return list{*x};
+    if (p.op != relational_operator::in)
+      return std::nullopt;
+    if (caf::holds_alternative<subnet>(*x))
+      return list{*x};
+    if (auto xs = caf::get_if<list>(x)) {
+      auto is_element = [](const data& y) {
+        return caf::holds_alternative<address>(y)
+               || caf::holds_alternative<subnet>(y);
+      };
+      if (std::all_of(xs->begin(), xs->end(), is_element))
+        return *xs;
+    }
+    return std::nullopt;
+  }
+  auto is_element = [&](const data& y) {
+    return is_batchable(y) && type_check(*t, y);
+  };
+  if (p.op == relational_operator::equal && is_element(*x))
+    return list{*x};
+  if (p.op != relational_operator::in)
+    return std::nullopt;
+  if (auto xs = caf::get_if<list>(x); xs && !xs->empty())
+    if (std::all_of(xs->begin(), xs->end(), is_element))
+      return *xs;
+  return std::nullopt;
+}
+
+} // namespace
+
+expression membership_batcher::operator()(caf::none_t) const {
+  return caf::none;
+}
+
+expression membership_batcher::operator()(const conjunction& c) const {
+  conjunction result;
+  for (auto& op : c)
+    result.push_back(caf::visit(*this, op));
+  return result;
+}
+
+expression membership_batcher::operator()(const disjunction& d) const {
+  struct batch {
+    predicate::operand lhs;
+    list elements;
+    size_t position;
+    size_t size;
+  };
+  std::vector<batch> batches;
+  disjunction result;
+  auto add = [&](expression x) {
+    if (auto p = caf::get_if<predicate>(&x)) {
+      if (auto elements = membership_elements(*p)) {
+        auto same_batch = [&](const batch& b) {
+          return b.lhs == p->lhs;
+        };
+        auto i = std::find_if(batches.begin(), batches.end(), same_batch);
+        if (i != batches.end()) {
+          i->elements.insert(i->elements.end(),
+                             std::make_move_iterator(elements->begin()),
+                             std::make_move_iterator(elements->end()));
+          ++i->size;
+          return;
+        }
+        batches.push_back({p->lhs, std::move(*elements), result.size(), 1});
+      }
+    }
+    result.push_back(std::move(x));
+  };
+  for (auto& op : d) {
+    auto x = caf::visit(*this, op);
+    // Nested disjunctions commonly stem from predicate expansion, e.g., a
+    // bare subnet turns into a disjunction of two predicates. We flatten them
+    // so that their operands can join a batch.
+    if (auto xs = caf::get_if<disjunction>(&x))
+      for (auto& y : *xs)
+        add(std::move(y));
+    else
+      add(std::move(x));
+  }
+  // Replace the first predicate of every batch with the collapsed predicate;
+  // the others never made it into the result.
+  for (auto& b : batches)
+    if (b.size > 1)
+      result[b.position] = predicate{std::move(b.lhs), relational_operator::in,
+                                     data{std::move(b.elements)}};
+  if (result.size() == 1)
+    return std::move(result.front());
+  return result;
+}
+
+expression membership_batcher::operator()(const negation& n) const {
+  return negation{caf::visit(*this, n.expr())};
+}
+
+expression membership_batcher::operator()(const predicate& p) const {
+  return p;
+}
+
+namespace {
+
 template <class Ts, class Us>
 auto inplace_union(Ts& xs, const Us& ys) {
   auto mid = xs.size();
@@ -14,41 +14,151 @@
 #include "vast/detail/assert.hpp"
 #include "vast/detail/byte_swap.hpp"
 #include "vast/detail/fdoutbuf.hpp"
+#include "vast/detail/narrow.hpp"
 #include "vast/detail/string.hpp"
 #include "vast/error.hpp"
+#include "vast/logger.hpp"
 #include "vast/table_slice_builder.hpp"
 #include "vast/type.hpp"
 
 #include <arrow/api.h>
+#include <arrow/io/file.h>
 #include <arrow/io/stdio.h>
 #include <caf/none.hpp>
+#include <caf/settings.hpp>
 
+#include <istream>
 #include <stdexcept>
 
 namespace vast::format::arrow {
 
+namespace {
+
+/// An Arrow input stream that reads from a `std::istream`.
+class istream_input_stream final : public ::arrow::io::InputStream {
+public:
+  explicit istream_input_stream(std::istream& in) : in_{in} {
+    // nop
+  }
+
+  ::arrow::Status Close() override {
+    closed_ = true;
+    return ::arrow::Status::OK();
+  }
+
+  [[nodiscard]] bool closed() const override {
+    return closed_;
+  }
+
+  [[nodiscard]] ::arrow::Result<int64_t> Tell() const override {
+    return position_;
+  }
+
+  ::arrow::Result<int64_t> Read(int64_t nbytes, void* out) override {
+    in_.read(static_cast<char*>(out), nbytes);
+    if (in_.bad())
+      return ::arrow::Status::IOError("failed to read from input stream");
+    auto bytes_read = static_cast<int64_t>(in_.gcount());
+    position_ += bytes_read;
+    return bytes_read;
+  }
+
+  ::arrow::Result<std::shared_ptr<::arrow::Buffer>>
+  Read(int64_t nbytes) override {
+    ARROW_ASSIGN_OR_RAISE(auto buffer, ::arrow::AllocateResizableBuffer(nbytes));
+    ARROW_ASSIGN_OR_RAISE(auto bytes_read, Read(nbytes, buffer->mutable_data()));
+    ARROW_RETURN_NOT_OK(buffer->Resize(bytes_read, false));
+    return std::shared_ptr<::arrow::Buffer>{std::move(buffer)};
+  }
+
+private:
+  std::istream& in_;
+  int64_t position_ = 0;
+  bool closed_ = false;
+};
+
+} // namespace
+
+caf::expected<type> layout_from_schema(const ::arrow::Schema& schema) {
+  const auto& metadata = schema.metadata();
+  if (!metadata || !metadata->Contains("VAST:name:0"))
+    return caf::make_error(ec::format_error,
+                           fmt::format("Arrow schema lacks VAST type metadata: "
+                                       "{}",
+                                       schema.ToString()));
+  auto layout = type::from_arrow(schema);
+  if (!layout.to_arrow_schema()->Equals(schema))
+    return caf::make_error(ec::format_error,
+                           fmt::format("Arrow schema does not match the "
+                                       "schema of layout {}",
+                                       layout));
+  return layout;
+}
+
+size_t slice_record_batch(const std::shared_ptr<::arrow::RecordBatch>& batch,
+                          int64_t offset, size_t max_rows,
+                          size_t max_slice_size, format::reader::consumer& f) {
+  VAST_ASSERT(offset <= batch->num_rows());
+  VAST_ASSERT(max_slice_size > 0);
+  auto remaining = std::min(
+    detail::narrow_cast<size_t>(batch->num_rows() - offset), max_rows);
+  if (remaining == 0)
+    return 0;
+  // Slicing a record batch is zero-copy; whole batches are taken as is.
+  auto range
+    = offset == 0 && remaining == detail::narrow_cast<size_t>(batch->num_rows())
+        ? batch
+        : batch->Slice(offset, detail::narrow_cast<int64_t>(remaining));
+  for (auto& slice :
+       arrow_table_slice_builder::create_slices(range, max_slice_size))
+    f(std::move(slice));
+  return remaining;
+}
+
+// -- writer -------------------------------------------------------------------
+
 writer::writer() {
   out_ = std::make_shared<::arrow::io::StdoutStream>();
 }
 
-writer::writer(const caf::settings&) {
-  out_ = std::make_shared<::arrow::io::StdoutStream>();
+caf::expected<std::unique_ptr<format::writer>>
+writer::make(const caf::settings& options) {
+  auto result = std::make_unique<writer>();
+  auto output = std::string{
+    get_or(options, "vast.export.write", defaults::export_::write)};
+  if (output == "-")
+    return result;
+  auto file = ::arrow::io::FileOutputStream::Open(output);
+  if (!file.ok())
+    return caf::make_error(ec::filesystem_error,
+                           fmt::format("{} failed to open {}: {}",
+                                       result->name(), output,
+                                       file.status().ToString()));
+  result->out(std::move(*file));
+  return result;
 }
 
 writer::~writer() {
-  // nop
+  if (current_batch_writer_ != nullptr)
+    if (auto status = current_batch_writer_->Close(); !status.ok())
+      VAST_DEBUG("{} failed to close record batch writer: {}", name(),
+                 status.ToString());
 }
 
 caf::error writer::write(const table_slice& slice) {
   if (out_ == nullptr)
     return caf::make_error(ec::logic_error, "invalid arrow output stream");
+  // For Arrow-encoded table slices this is a zero-copy view into the slice's
+  // chunk, so we write record batches without re-encoding them.
   auto batch = to_record_batch(slice);
+  if (!batch)
+    return caf::make_error(ec::format_error,
+                           "failed to convert table slice to record batch");
   if (const auto& layout = slice.layout(); current_layout_ != layout) {
     if (!this->layout(batch->schema()))
       return caf::make_error(ec::logic_error, "failed to update layout");
     current_layout_ = layout;
   }
-  VAST_ASSERT(batch != nullptr);
   if (auto status = current_batch_writer_->WriteRecordBatch(*batch);
       !status.ok())
     return caf::make_error(ec::unspecified, "failed to write record batch",
@@ -56,6 +166,16 @@ caf::error writer::write(const table_slice& slice) {
   return caf::none;
 }
 
+caf::expected<void> writer::flush() {
+  if (out_ == nullptr)
+    return caf::make_error(ec::logic_error, "invalid arrow output stream");
+  if (auto status = out_->Flush(); !status.ok())
+    return caf::make_error(ec::filesystem_error,
+                           "failed to flush arrow output stream",
+                           status.ToString());
+  return {};
+}
+
 const char* writer::name() const {
   return "arrow-writer";
 }
@@ -74,4 +194,92 @@ bool writer::layout(const std::shared_ptr<::arrow::Schema>& schema) {
   return false;
 }
 
+// -- reader -------------------------------------------------------------------
+
+reader::reader(const caf::settings& options, std::unique_ptr<std::istream> in)
+  : format::reader(options) {
+  if (in != nullptr)
+    reset(std::move(in));
+}
+
+reader::~reader() {
+  // nop
+}
+
+void reader::reset(std::unique_ptr<std::istream> in) {
+  VAST_ASSERT(in != nullptr);
+  input_ = std::move(in);
+  stream_ = std::make_shared<istream_input_stream>(*input_);
+  batch_reader_ = nullptr;
+  current_batch_ = nullptr;
+  current_offset_ = 0;
+}
+
+caf::error reader::module(vast::module x) {
+  // The layouts are part of the Arrow IPC stream, so there's nothing to
+  // replace here.
+  module_ = std::move(x);
+  return caf::none;
+}
+
+vast::module reader::module() const {
+  return module_;
+}
+
+const char* reader::name() const {
+  return "arrow-reader";
+}
+
+caf::error reader::next_batch() {
+  while (true) {
+    if (batch_reader_ == nullptr) {
+      // Multiple IPC streams may follow each other, e.g., one per layout. We
+      // only reach the end of input once no further stream starts.
+      if (input_->peek() == std::istream::traits_type::eof())
+        return caf::make_error(ec::end_of_input, "input exhausted");
+      auto batch_reader
+        = ::arrow::ipc::RecordBatchStreamReader::Open(stream_.get());
+      if (!batch_reader.ok())
+        return caf::make_error(ec::format_error,
+                               fmt::format("{} failed to open Arrow IPC "
+                                           "stream: {}",
+                                           name(),
+                                           batch_reader.status().ToString()));
+      auto layout = layout_from_schema(*(*batch_reader)->schema());
+      if (!layout)
+        return layout.error();
+      if (!module_.find(layout->name()))
+        module_.add(*layout);
+      batch_reader_ = std::move(*batch_reader);
+    }
+    current_offset_ = 0;
+    if (auto status = batch_reader_->ReadNext(&current_batch_); !status.ok())
+      return caf::make_error(ec::format_error,
+                             fmt::format("{} failed to read record batch: {}",
+                                         name(), status.ToString()));
+    if (current_batch_ != nullptr)
+      return caf::none;
+    // The current IPC stream is exhausted.
+    batch_reader_ = nullptr;
+  }
+}
+
+caf::error
+reader::read_impl(size_t max_events, size_t max_slice_size, consumer& f) {
+  VAST_ASSERT(input_ != nullptr);
+  size_t produced = 0;
+  while (produced < max_events) {
+    if (current_batch_ == nullptr
+        || current_offset_ == current_batch_->num_rows())
+      if (auto err = next_batch())
+        return err;
+    auto consumed
+      = slice_record_batch(current_batch_, current_offset_,
+                           max_events - produced, max_slice_size, f);
+    current_offset_ += detail::narrow_cast<int64_t>(consumed);
+    produced += consumed;
+  }
+  return caf::none;
+}
+
 } // namespace vast::format::arrow
@@ -55,6 +55,18 @@ reader::reader(const caf::settings& options) {
                 "not a valid duration",
                 detail::pretty_type_name(this), *read_timeout_arg);
   }
+  shared_memory_
+    = caf::get_or(options, "vast.import.shared-memory", shared_memory_);
+  if (auto shared_memory_timeout_arg = caf::get_if<std::string>(
+        &options, "vast.import.shared-memory-timeout")) {
+    if (auto shared_memory_timeout
+        = to<decltype(shared_memory_timeout_)>(*shared_memory_timeout_arg))
+      shared_memory_timeout_ = *shared_memory_timeout;
+    else
+      VAST_WARN("{} cannot set vast.import.shared-memory-timeout to {} as it "
+                "is not a valid duration",
+                detail::pretty_type_name(this), *shared_memory_timeout_arg);
+  }
   last_batch_sent_ = reader_clock::now();
 }
 
@@ -44,7 +44,7 @@ void factory_traits<format::writer>::initialize() {
   fac::add("json", make_writer<format::json::writer>);
   fac::add("null", make_writer<null::writer>);
   fac::add("zeek", make_writer<zeek::writer>);
-  fac::add("arrow", make_writer<arrow::writer>);
+  fac::add("arrow", arrow::writer::make);
   for (const auto& plugin : plugins::get()) {
     if (const auto* reader = plugin.as<writer_plugin>()) {
       fac::add(
@@ -0,0 +1,232 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vast/index/address_prefix_index.hpp"
+
+#include "vast/detail/assert.hpp"
+#include "vast/detail/legacy_deserialize.hpp"
+#include "vast/detail/overload.hpp"
+#include "vast/fbs/value_index.hpp"
+#include "vast/subnet.hpp"
+#include "vast/type.hpp"
+
+#include <caf/serializer.hpp>
+#include <caf/settings.hpp>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace vast {
+
+namespace {
+
+/// An inclusive range of addresses.
+using address_range = std::pair<address, address>;
+
+address_range to_range(const subnet& sn) {
+  auto length = sn.length() + (sn.network().is_v4() ? 96u : 0u);
+  auto last = static_cast<address::byte_array>(sn.network());
+  for (auto i = length; i < 128; ++i)
+    last[i / 8] |= 1u << (7 - i % 8);
+  return {sn.network(), address{last}};
+}
+
+/// Computes the union of many bitmaps by combining them pairwise in a
+/// balanced tree, such that every bitmap takes part in a logarithmic number
+/// of operations only.
+ewah_bitmap unite(const std::vector<const ewah_bitmap*>& xs) {
+  if (xs.empty())
+    return {};
+  auto level = std::vector<ewah_bitmap>{};
+  level.reserve(xs.size() / 2 + 1);
+  for (size_t i = 0; i + 1 < xs.size(); i += 2)
+    level.push_back(*xs[i] | *xs[i + 1]);
+  if (xs.size() % 2 == 1)
+    level.push_back(*xs.back());
+  while (level.size() > 1) {
+    auto next = std::vector<ewah_bitmap>{};
+    next.reserve(level.size() / 2 + 1);
+    for (size_t i = 0; i + 1 < level.size(); i += 2)
+      next.push_back(level[i] | level[i + 1]);
+    if (level.size() % 2 == 1)
+      next.push_back(std::move(level.back()));
+    level = std::move(next);
+  }
+  return std::move(level.front());
+}
+
+} // namespace
+
+address_prefix_index::address_prefix_index(vast::type t, caf::settings opts)
+  : value_index{std::move(t), std::move(opts)} {
+  // nop
+}
+
+caf::error address_prefix_index::serialize(caf::serializer& sink) const {
+  return caf::error::eval(
+    [&] {
+      return value_index::serialize(sink);
+    },
+    [&] {
+      return sink(postings_);
+    });
+}
+
+caf::error address_prefix_index::deserialize(caf::deserializer& source) {
+  return caf::error::eval(
+    [&] {
+      return value_index::deserialize(source);
+    },
+    [&] {
+      return source(postings_);
+    });
+}
+
+bool address_prefix_index::deserialize(detail::legacy_deserializer& source) {
+  if (!value_index::deserialize(source))
+    return false;
+  // The keys of a map are immutable, so we read the entries into a sequence
+  // with the same wire format first.
+  auto entries = std::vector<std::pair<address, ewah_bitmap>>{};
+  if (!source(entries))
+    return false;
+  postings_.clear();
+  for (auto& [addr, posting] : entries)
+    postings_.emplace_hint(postings_.end(), addr, std::move(posting));
+  return true;
+}
+
+bool address_prefix_index::append_impl(data_view x, id pos) {
+  auto addr = caf::get_if<view<address>>(&x);
+  if (!addr)
+    return false;
+  auto& posting = postings_[*addr];
+  posting.append_bits(false, pos - posting.size());
+  posting.append_bit(true);
+  return true;
+}
+
+caf::expected<ids>
+address_prefix_index::lookup_impl(relational_operator op, data_view d) const {
+  auto ranges = std::vector<address_range>{};
+  auto negate = false;
+  auto f = detail::overload{
+    [&](auto x) -> caf::error {
+      return caf::make_error(ec::type_clash, materialize(x));
+    },
+    [&](view<address> x) -> caf::error {
+      if (!(op == relational_operator::equal
+            || op == relational_operator::not_equal))
+        return caf::make_error(ec::unsupported_operator, op);
+      ranges.emplace_back(x, x);
+      negate = op == relational_operator::not_equal;
+      return caf::none;
+    },
+    [&](view<subnet> x) -> caf::error {
+      if (!(op == relational_operator::in
+            || op == relational_operator::not_in))
+        return caf::make_error(ec::unsupported_operator, op);
+      ranges.push_back(to_range(x));
+      negate = op == relational_operator::not_in;
+      return caf::none;
+    },
+    [&](view<list> xs) -> caf::error {
+      if (!(op == relational_operator::in
+            || op == relational_operator::not_in))
+        return caf::make_error(ec::unsupported_operator, op);
+      // Elements of other types cannot be equal to an address, so we skip
+      // them.
+      for (auto x : *xs) {
+        if (auto addr = caf::get_if<view<address>>(&x))
+          ranges.emplace_back(*addr, *addr);
+        else if (auto sn = caf::get_if<view<subnet>>(&x))
+          ranges.push_back(to_range(*sn));
+      }
+      negate = op == relational_operator::not_in;
+      return caf::none;
+    },
+  };
+  if (auto err = caf::visit(f, d))
+    return err;
+  // Visit the sorted ranges in a single pass. The iterator only moves
+  // forward, so addresses in overlapping ranges count only once.
+  std::sort(ranges.begin(), ranges.end());
+  auto matches = std::vector<const ewah_bitmap*>{};
+  auto it = postings_.begin();
+  for (const auto& [first, last] : ranges) {
+    if (it != postings_.end() && it->first < first)
+      it = postings_.lower_bound(first);
+    for (; it != postings_.end() && !(last < it->first); ++it)
+      matches.push_back(&it->second);
+  }
+  auto result = unite(matches);
+  result.append_bits(false, offset() - result.size());
+  if (negate)
+    result.flip();
+  return result;
+}
+
+size_t address_prefix_index::memusage_impl() const {
+  auto result = postings_.size() * sizeof(address);
+  for (const auto& [_, posting] : postings_)
+    result += posting.memusage();
+  return result;
+}
+
+flatbuffers::Offset<fbs::ValueIndex> address_prefix_index::pack_impl(
+  flatbuffers::FlatBufferBuilder& builder,
+  flatbuffers::Offset<fbs::value_index::detail::ValueIndexBase> base_offset) {
+  auto address_bytes = std::vector<uint8_t>{};
+  address_bytes.reserve(postings_.size() * sizeof(address::byte_array));
+  auto posting_offsets
+    = std::vector<flatbuffers::Offset<fbs::bitmap::EWAHBitmap>>{};
+  posting_offsets.reserve(postings_.size());
+  for (const auto& [addr, posting] : postings_) {
+    auto bytes = static_cast<address::byte_array>(addr);
+    address_bytes.insert(address_bytes.end(), bytes.begin(), bytes.end());
+    posting_offsets.emplace_back(pack(builder, posting));
+  }
+  const auto address_prefix_index_offset
+    = fbs::value_index::CreateAddressPrefixIndexDirect(
+      builder, base_offset, &address_bytes, &posting_offsets);
+  return fbs::CreateValueIndex(builder,
+                               fbs::value_index::ValueIndex::address_prefix,
+                               address_prefix_index_offset.Union());
+}
+
+caf::error address_prefix_index::unpack_impl(const fbs::ValueIndex& from) {
+  const auto* from_prefix = from.value_index_as_address_prefix();
+  VAST_ASSERT(from_prefix);
+  const auto* addresses = from_prefix->addresses();
+  const auto* postings = from_prefix->postings();
+  if (addresses->size() != postings->size() * sizeof(address::byte_array))
+    return caf::make_error(ec::format_error,
+                           fmt::format("unexpected number of address bytes in "
+                                       "address prefix index: expected {}, "
+                                       "got {}",
+                                       postings->size()
+                                         * sizeof(address::byte_array),
+                                       addresses->size()));
+  postings_.clear();
+  for (size_t i = 0; i < postings->size(); ++i) {
+    auto bytes = address::byte_array{};
+    std::memcpy(bytes.data(), addresses->data() + i * bytes.size(),
+                bytes.size());
+    auto posting = ewah_bitmap{};
+    if (auto err = unpack(*postings->Get(i), posting))
+      return err;
+    postings_.emplace_hint(postings_.end(), address{bytes},
+                           std::move(posting));
+  }
+  return caf::none;
+}
+
+} // namespace vast
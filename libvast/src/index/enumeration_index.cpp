@@ -9,6 +9,7 @@
 #include "vast/index/enumeration_index.hpp"
 
 #include "vast/detail/legacy_deserialize.hpp"
+#include "vast/detail/narrow.hpp"
 #include "vast/detail/overload.hpp"
 #include "vast/fbs/value_index.hpp"
 #include "vast/index/container_lookup.hpp"
@@ -17,6 +18,8 @@
 #include <caf/serializer.hpp>
 #include <caf/settings.hpp>
 
+#include <vector>
+
 namespace vast {
 
 enumeration_index::enumeration_index(vast::type t, caf::settings opts)
@@ -71,8 +74,22 @@ enumeration_index::lookup_impl(relational_operator op, data_view d) const {
         return caf::make_error(ec::unsupported_operator, op);
       return index_.lookup(op, x);
     },
-    [&](view<list> xs) {
-      return detail::container_lookup(*this, op, xs);
+    [&](view<list> xs) -> caf::expected<ids> {
+      // Lists still hold the names of the enumeration values, because
+      // `to_internal` only converts scalar values. Names that the enumeration
+      // does not know match nothing.
+      const auto& t = caf::get<enumeration_type>(type());
+      auto elements = std::vector<data_view>{};
+      elements.reserve(xs->size());
+      for (auto x : *xs) {
+        if (const auto* name = caf::get_if<view<std::string>>(&x)) {
+          if (auto key = t.resolve(*name))
+            elements.emplace_back(detail::narrow_cast<enumeration>(*key));
+        } else {
+          elements.push_back(std::move(x));
+        }
+      }
+      return detail::container_lookup_impl(*this, op, elements);
     },
   };
   return caf::visit(f, d);
@@ -0,0 +1,224 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vast/index/ngram_index.hpp"
+
+#include "vast/bitmap_algorithms.hpp"
+#include "vast/defaults.hpp"
+#include "vast/detail/assert.hpp"
+#include "vast/detail/legacy_deserialize.hpp"
+#include "vast/detail/overload.hpp"
+#include "vast/fbs/value_index.hpp"
+#include "vast/index/container_lookup.hpp"
+#include "vast/index/string_index.hpp"
+#include "vast/pattern.hpp"
+#include "vast/type.hpp"
+#include "vast/value_index_factory.hpp"
+
+#include <caf/serializer.hpp>
+#include <caf/settings.hpp>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace vast {
+
+namespace {
+
+/// Collects the distinct n-grams of a string in ascending order.
+std::vector<ngram_index::ngram_type> ngrams(std::string_view str) {
+  auto result = std::vector<ngram_index::ngram_type>{};
+  if (str.size() < ngram_index::ngram_size)
+    return result;
+  result.reserve(str.size() - ngram_index::ngram_size + 1);
+  for (size_t i = 0; i + ngram_index::ngram_size <= str.size(); ++i) {
+    auto ngram = ngram_index::ngram_type{0};
+    for (size_t j = 0; j < ngram_index::ngram_size; ++j)
+      ngram = (ngram << 8) | static_cast<uint8_t>(str[i + j]);
+    result.push_back(ngram);
+  }
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
+}
+
+} // namespace
+
+ngram_index::ngram_index(vast::type t, caf::settings opts)
+  : value_index{std::move(t), std::move(opts)},
+    strings_{factory<value_index>::make(vast::type{string_type{}}, options())} {
+  max_length_
+    = caf::get_or(options(), "max-size", defaults::index::max_string_size);
+}
+
+caf::error ngram_index::serialize(caf::serializer& sink) const {
+  return caf::error::eval(
+    [&] {
+      return value_index::serialize(sink);
+    },
+    [&] {
+      auto* strings = dynamic_cast<string_index*>(strings_.get());
+      VAST_ASSERT(strings);
+      return sink(*strings, max_length_, postings_, truncated_);
+    });
+}
+
+caf::error ngram_index::deserialize(caf::deserializer& source) {
+  return caf::error::eval(
+    [&] {
+      return value_index::deserialize(source);
+    },
+    [&] {
+      auto* strings = dynamic_cast<string_index*>(strings_.get());
+      VAST_ASSERT(strings);
+      return source(*strings, max_length_, postings_, truncated_);
+    });
+}
+
+bool ngram_index::deserialize(detail::legacy_deserializer& source) {
+  if (!value_index::deserialize(source))
+    return false;
+  auto* strings = dynamic_cast<string_index*>(strings_.get());
+  VAST_ASSERT(strings);
+  return source(*strings, max_length_, postings_, truncated_);
+}
+
+bool ngram_index::append_impl(data_view x, id pos) {
+  auto str = caf::get_if<view<std::string>>(&x);
+  if (!str)
+    return false;
+  if (!strings_->append(x, pos))
+    return false;
+  auto length = str->size();
+  // Strings beyond the maximum length remain candidates for every substring
+  // lookup, because we only index the n-grams of their prefix.
+  if (length > max_length_) {
+    truncated_.append_bits(false, pos - truncated_.size());
+    truncated_.append_bit(true);
+    length = max_length_;
+  }
+  for (auto ngram : ngrams(str->substr(0, length))) {
+    auto& posting = postings_[ngram];
+    posting.append_bits(false, pos - posting.size());
+    posting.append_bit(true);
+  }
+  return true;
+}
+
+caf::expected<ids>
+ngram_index::lookup_impl(relational_operator op, data_view x) const {
+  auto f = detail::overload{
+    [&](auto) -> caf::expected<ids> {
+      return strings_->lookup(op, x);
+    },
+    [&](view<std::string> str) -> caf::expected<ids> {
+      if (op == relational_operator::ni && str.size() >= ngram_size)
+        return candidates({std::string{str}});
+      return strings_->lookup(op, x);
+    },
+    [&](view<pattern> pat) -> caf::expected<ids> {
+      switch (op) {
+        default:
+          return caf::make_error(ec::unsupported_operator, op);
+        case relational_operator::match:
+        case relational_operator::equal:
+        case relational_operator::in:
+          return candidates(required_literals(pat.string()));
+        case relational_operator::not_match:
+        case relational_operator::not_equal:
+        case relational_operator::not_in:
+          // We cannot rule out any string without evaluating the pattern.
+          return ids{offset(), true};
+      }
+    },
+    [&](view<list> xs) {
+      return detail::container_lookup(*this, op, xs);
+    },
+  };
+  return caf::visit(f, x);
+}
+
+size_t ngram_index::memusage_impl() const {
+  auto result = strings_->memusage() + truncated_.memusage()
+                + postings_.size() * sizeof(ngram_type);
+  for (const auto& [_, posting] : postings_)
+    result += posting.memusage();
+  return result;
+}
+
+flatbuffers::Offset<fbs::ValueIndex> ngram_index::pack_impl(
+  flatbuffers::FlatBufferBuilder& builder,
+  flatbuffers::Offset<fbs::value_index::detail::ValueIndexBase> base_offset) {
+  const auto string_index_offset = pack(builder, strings_);
+  // Sort the n-grams so that packing the same index twice yields the same
+  // bytes.
+  auto keys = std::vector<ngram_type>{};
+  keys.reserve(postings_.size());
+  for (const auto& [ngram, _] : postings_)
+    keys.push_back(ngram);
+  std::sort(keys.begin(), keys.end());
+  auto posting_offsets
+    = std::vector<flatbuffers::Offset<fbs::bitmap::EWAHBitmap>>{};
+  posting_offsets.reserve(keys.size());
+  for (auto ngram : keys)
+    posting_offsets.emplace_back(pack(builder, postings_.at(ngram)));
+  const auto truncated_offset = pack(builder, truncated_);
+  const auto ngram_index_offset = fbs::value_index::CreateNGramIndexDirect(
+    builder, base_offset, string_index_offset, max_length_, &keys,
+    &posting_offsets, truncated_offset);
+  return fbs::CreateValueIndex(builder, fbs::value_index::ValueIndex::ngram,
+                               ngram_index_offset.Union());
+}
+
+caf::error ngram_index::unpack_impl(const fbs::ValueIndex& from) {
+  const auto* from_ngram = from.value_index_as_ngram();
+  VAST_ASSERT(from_ngram);
+  if (auto err = unpack(*from_ngram->string_index(), strings_))
+    return err;
+  max_length_ = from_ngram->max_length();
+  const auto* keys = from_ngram->ngrams();
+  const auto* postings = from_ngram->postings();
+  if (keys->size() != postings->size())
+    return caf::make_error(ec::format_error,
+                           fmt::format("n-gram index has {} n-grams but {} "
+                                       "postings",
+                                       keys->size(), postings->size()));
+  postings_.clear();
+  postings_.reserve(keys->size());
+  for (size_t i = 0; i < keys->size(); ++i)
+    if (auto err = unpack(*postings->Get(i), postings_[keys->Get(i)]))
+      return err;
+  return unpack(*from_ngram->truncated(), truncated_);
+}
+
+ids ngram_index::candidates(const std::vector<std::string>& literals) const {
+  auto result = ewah_bitmap{};
+  auto empty = true;
+  for (const auto& literal : literals) {
+    for (auto ngram : ngrams(literal)) {
+      auto posting = postings_.find(ngram);
+      if (posting == postings_.end())
+        return truncated_;
+      if (empty) {
+        result = posting->second;
+        empty = false;
+      } else {
+        result &= posting->second;
+      }
+      if (all<0>(result))
+        return truncated_;
+    }
+  }
+  // Without a single n-gram to look for, every string is a candidate.
+  if (empty)
+    return ids{offset(), true};
+  return result | truncated_;
+}
+
+} // namespace vast
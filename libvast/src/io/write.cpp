@@ -8,10 +8,13 @@
 
 #include "vast/io/write.hpp"
 
+#include "vast/detail/posix.hpp"
 #include "vast/error.hpp"
 #include "vast/file.hpp"
+#include "vast/logger.hpp"
 
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <span>
 
@@ -25,4 +28,26 @@ write(const std::filesystem::path& filename, std::span<const std::byte> xs) {
   return f.write(xs.data(), xs.size());
 }
 
+caf::error write(const std::filesystem::path& filename, uint64_t offset,
+                 std::span<const std::byte> xs) {
+  // Multiple writers may write to different positions of the same file
+  // concurrently, so we must tolerate the parent directory appearing while
+  // we try to create it.
+  std::error_code err{};
+  std::filesystem::create_directories(filename.parent_path(), err);
+  if (err)
+    return caf::make_error(ec::filesystem_error,
+                           fmt::format("failed to create parent directory "
+                                       "{}: {}",
+                                       filename.parent_path(), err.message()));
+  file f{filename};
+  if (!f.open(file::write_only))
+    return caf::make_error(ec::filesystem_error, "failed open file");
+  // A freshly opened file starts at position zero, so seeking relative to
+  // the current position moves to the absolute offset.
+  if (auto error = detail::seek(f.handle(), offset))
+    return error;
+  return f.write(xs.data(), xs.size());
+}
+
 } // namespace vast::io
@@ -314,6 +314,22 @@ void msgpack_table_slice<FlatBuffer>::append_column_to_index(
   }
 }
 
+template <class FlatBuffer>
+detail::generator<data_view>
+msgpack_table_slice<FlatBuffer>::values(table_slice::size_type column) const {
+  const auto& offset_table = *slice_.offset_table();
+  auto view = as_bytes(*slice_.data());
+  const auto& layout_rt = caf::get<record_type>(this->layout());
+  auto layout_offset = layout_rt.resolve_flat_index(column);
+  auto type = layout_rt.field(layout_offset).type;
+  for (size_t row = 0; row < rows(); ++row) {
+    auto row_offset = offset_table[row];
+    auto xs = msgpack::overlay{view.subspan(row_offset)};
+    xs.next(column);
+    co_yield decode(xs, type);
+  }
+}
+
 template <class FlatBuffer>
 data_view
 msgpack_table_slice<FlatBuffer>::at(table_slice::size_type row,
@@ -112,15 +112,10 @@ void partition_synopsis::add(const table_slice& slice,
     = get_type_fprate(fp_rates, vast::type{address_type{}});
   for (size_t col = 0; col < slice.columns(); ++col, ++leaf_it) {
     auto&& leaf = *leaf_it;
+    // Synopses process entire columns at once, which avoids resolving the
+    // column type and dispatching virtually for every single value.
     auto add_column = [&](const synopsis_ptr& syn) {
-      for (size_t row = 0; row < slice.rows(); ++row) {
-        auto view = slice.at(row, col, leaf.field.type);
-        // TODO: It would probably make sense to allow `nil` in the
-        // synopsis API, so we can treat queries like `x == nil` just
-        // like normal queries.
-        if (!caf::holds_alternative<caf::none_t>(view))
-          syn->add(std::move(view));
-      }
+      syn->add_column(slice, col);
     };
     // Make a field synopsis if it was configured.
     if (auto key = qualified_record_field{layout, leaf.index};
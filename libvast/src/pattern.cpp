@@ -10,12 +10,121 @@
 
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/data.hpp"
+#include "vast/detail/assert.hpp"
 #include "vast/pattern.hpp"
 
+#include <algorithm>
+#include <cctype>
+#include <optional>
 #include <regex>
+#include <utility>
 
 namespace vast {
 
+namespace {
+
+/// Advances *i* past the end of a character class that starts at *i*.
+void skip_class(std::string_view rx, size_t& i) {
+  VAST_ASSERT(rx[i] == '[');
+  ++i;
+  // A closing bracket right at the beginning of a class is a literal.
+  if (i < rx.size() && rx[i] == '^')
+    ++i;
+  if (i < rx.size() && rx[i] == ']')
+    ++i;
+  for (; i < rx.size() && rx[i] != ']'; ++i)
+    if (rx[i] == '\\')
+      ++i;
+}
+
+/// Advances *i* past the end of a group that starts at *i*.
+void skip_group(std::string_view rx, size_t& i) {
+  VAST_ASSERT(rx[i] == '(');
+  auto depth = size_t{0};
+  for (; i < rx.size(); ++i) {
+    switch (rx[i]) {
+      case '\\':
+        ++i;
+        break;
+      case '[':
+        skip_class(rx, i);
+        break;
+      case '(':
+        ++depth;
+        break;
+      case ')':
+        if (--depth == 0)
+          return;
+        break;
+    }
+  }
+}
+
+/// Retrieves the string that an expression consists of if it contains no
+/// special characters other than escaped punctuation.
+std::optional<std::string> as_literal(std::string_view rx) {
+  static constexpr auto special = std::string_view{"^$\\.*+?()[]{}|"};
+  auto result = std::string{};
+  result.reserve(rx.size());
+  for (size_t i = 0; i < rx.size(); ++i) {
+    if (special.find(rx[i]) == std::string_view::npos) {
+      result += rx[i];
+    } else if (rx[i] == '\\' && i + 1 < rx.size()
+               && !std::isalnum(static_cast<unsigned char>(rx[i + 1]))) {
+      result += rx[++i];
+    } else {
+      return std::nullopt;
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+/// The compiled form of a pattern. Expressions without special characters
+/// skip the regex engine entirely, and all others first check for the
+/// literals that every match contains, which is much cheaper than running the
+/// regex engine on strings that cannot match.
+struct pattern::compiled {
+  explicit compiled(const std::string& str) {
+    if (auto x = as_literal(str)) {
+      literal = std::move(*x);
+      return;
+    }
+    required = required_literals(str);
+    try {
+      regex.emplace(str);
+    } catch (const std::regex_error&) {
+      // The validator rejects invalid expressions in queries, so we only end
+      // up here for data. Such a pattern does not match anything.
+    }
+  }
+
+  [[nodiscard]] bool may_contain_match(std::string_view str) const {
+    return std::all_of(required.begin(), required.end(), [&](const auto& x) {
+      return str.find(x) != std::string_view::npos;
+    });
+  }
+
+  [[nodiscard]] bool match(std::string_view str) const {
+    if (literal)
+      return str == *literal;
+    return regex && may_contain_match(str)
+           && std::regex_match(str.begin(), str.end(), *regex);
+  }
+
+  [[nodiscard]] bool search(std::string_view str) const {
+    if (literal)
+      return str.find(*literal) != std::string_view::npos;
+    return regex && may_contain_match(str)
+           && std::regex_search(str.begin(), str.end(), *regex);
+  }
+
+  std::optional<std::string> literal;
+  std::vector<std::string> required;
+  std::optional<std::regex> regex;
+};
+
 pattern pattern::glob(std::string_view str) {
   std::string rx;
   std::regex_replace(std::back_inserter(rx), str.begin(), str.end(),
@@ -24,15 +133,25 @@ pattern pattern::glob(std::string_view str) {
   return pattern{std::regex_replace(rx, std::regex("\\?"), ".")};
 }
 
+pattern::pattern() : pattern{std::string{}} {
+  // nop
+}
+
 pattern::pattern(std::string str) : str_(std::move(str)) {
+  compile();
 }
 
 bool pattern::match(std::string_view str) const {
-  return std::regex_match(str.begin(), str.end(), std::regex{str_});
+  // A moved-from pattern behaves like an empty pattern.
+  if (!compiled_)
+    return str.empty();
+  return compiled_->match(str);
 }
 
 bool pattern::search(std::string_view str) const {
-  return std::regex_search(str.begin(), str.end(), std::regex{str_});
+  if (!compiled_)
+    return true;
+  return compiled_->search(str);
 }
 
 const std::string& pattern::string() const {
@@ -45,6 +164,7 @@ pattern& pattern::operator+=(const pattern& other) {
 
 pattern& pattern::operator+=(std::string_view other) {
   str_ += other;
+  compile();
   return *this;
 }
 
@@ -57,6 +177,7 @@ pattern& pattern::operator|=(std::string_view other) {
   str_ += ")|(";
   str_.append(other.begin(), other.end());
   str_ += ')';
+  compile();
   return *this;
 }
 
@@ -69,6 +190,7 @@ pattern& pattern::operator&=(std::string_view other) {
   str_ += ")(";
   str_.append(other.begin(), other.end());
   str_ += ')';
+  compile();
   return *this;
 }
 
@@ -133,4 +255,82 @@ bool convert(const pattern& p, data& d) {
   return true;
 }
 
+void pattern::compile() {
+  compiled_ = std::make_shared<const compiled>(str_);
+}
+
+std::vector<std::string> required_literals(std::string_view rx) {
+  auto result = std::vector<std::string>{};
+  auto current = std::string{};
+  auto flush = [&] {
+    if (!current.empty())
+      result.push_back(std::exchange(current, {}));
+  };
+  for (size_t i = 0; i < rx.size(); ++i) {
+    switch (rx[i]) {
+      case '|':
+        // Groups are skipped entirely, so this is a top-level alternation
+        // that makes every literal optional.
+        return {};
+      case '\\':
+        if (++i == rx.size())
+          return {};
+        if (std::isalnum(static_cast<unsigned char>(rx[i]))) {
+          // Character classes, assertions, back references, and escape
+          // sequences for code points all end a literal.
+          flush();
+          if (rx[i] == 'x')
+            i += 2;
+          else if (rx[i] == 'u')
+            i += 4;
+          else if (rx[i] == 'c')
+            i += 1;
+          else
+            while (i + 1 < rx.size()
+                   && std::isdigit(static_cast<unsigned char>(rx[i + 1])))
+              ++i;
+        } else {
+          current += rx[i];
+        }
+        break;
+      case '[':
+        flush();
+        skip_class(rx, i);
+        break;
+      case '(':
+        flush();
+        skip_group(rx, i);
+        break;
+      case '*':
+      case '?':
+        // The preceding character is optional.
+        if (!current.empty())
+          current.pop_back();
+        flush();
+        break;
+      case '{':
+        // Bounded repetitions may also make the preceding character
+        // optional.
+        if (!current.empty())
+          current.pop_back();
+        flush();
+        while (i < rx.size() && rx[i] != '}')
+          ++i;
+        break;
+      case '+':
+      case '.':
+      case '^':
+      case '$':
+      case ')':
+      case ']':
+        flush();
+        break;
+      default:
+        current += rx[i];
+    }
+  }
+  flush();
+  return result;
+}
+
 } // namespace vast
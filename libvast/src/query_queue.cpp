@@ -56,6 +56,7 @@ query_queue::insert(query_state&& query_state, std::vector<uuid>&& candidates) {
     return caf::make_error(ec::unspecified, "the candidate set size must match "
                                             "the query state");
   auto qid = query_state.query.id;
+  query_state.activated = std::chrono::steady_clock::now();
   auto [query_state_it, emplace_success]
     = queries_.emplace(qid, std::move(query_state));
   if (!emplace_success)
@@ -95,6 +96,7 @@ query_queue::activate(const uuid& qid, uint32_t num_partitions) {
   if (it == queries_.end())
     return caf::make_error(ec::unspecified, "cannot activate unknown query");
   it->second.requested_partitions += num_partitions;
+  it->second.activated = std::chrono::steady_clock::now();
   // Go over all currently inactive partitions and splice those relevant for
   // `qid` back into the active queue.
   auto new_inactive = std::vector<query_queue::entry>{};
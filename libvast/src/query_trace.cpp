@@ -0,0 +1,134 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2022 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vast/query_trace.hpp"
+
+#include "vast/concept/printable/to_string.hpp"
+#include "vast/concept/printable/vast/uuid.hpp"
+#include "vast/detail/stable_map.hpp"
+
+#include <algorithm>
+
+namespace vast {
+
+namespace {
+
+/// Returns the nested record at `key`, creating it if necessary.
+record& nested(record& xs, const std::string& key) {
+  auto& x = xs[key];
+  if (!caf::holds_alternative<record>(x))
+    x = record{};
+  return caf::get<record>(x);
+}
+
+/// Adds a value to an accumulated record. Sums up counts and durations, counts
+/// strings per value, and keeps the last value for everything else.
+void accumulate(record& acc, const std::string& key, const data& value) {
+  auto& x = acc[key];
+  if (const auto* y = caf::get_if<count>(&value)) {
+    if (auto* sum = caf::get_if<count>(&x))
+      *sum += *y;
+    else
+      x = *y;
+  } else if (const auto* y = caf::get_if<duration>(&value)) {
+    if (auto* sum = caf::get_if<duration>(&x))
+      *sum += *y;
+    else
+      x = *y;
+  } else if (const auto* y = caf::get_if<std::string>(&value)) {
+    if (!caf::holds_alternative<record>(x))
+      x = record{};
+    accumulate(caf::get<record>(x), *y, count{1});
+  } else {
+    x = value;
+  }
+}
+
+/// Adds the runtime and the values of a span to an accumulated record.
+void accumulate(record& acc, const query_span& span) {
+  accumulate(acc, "count", count{1});
+  accumulate(acc, "runtime", span.runtime);
+  for (const auto& [key, value] : span.values)
+    if (key != "predicate")
+      accumulate(acc, key, value);
+}
+
+/// Converts the accumulated spans per predicate into a list that is sorted
+/// by the total runtime, most expensive first.
+list by_runtime(record predicates) {
+  auto runtime = [](const data& x) {
+    const auto& xs = caf::get<record>(x);
+    auto it = xs.find("runtime");
+    return it != xs.end() ? caf::get<duration>(it->second) : duration{};
+  };
+  auto result = list{};
+  result.reserve(predicates.size());
+  for (auto& [predicate, xs] : predicates) {
+    auto entry = record{{"predicate", predicate}};
+    for (auto& [key, value] : caf::get<record>(xs))
+      entry[key] = std::move(value);
+    result.emplace_back(std::move(entry));
+  }
+  std::stable_sort(result.begin(), result.end(),
+                   [&](const data& lhs, const data& rhs) {
+                     return runtime(lhs) > runtime(rhs);
+                   });
+  return result;
+}
+
+} // namespace
+
+void query_trace::add(query_span span) {
+  spans_.push_back(std::move(span));
+}
+
+size_t query_trace::size() const {
+  return spans_.size();
+}
+
+record query_trace::summarize() const {
+  auto result = record{};
+  auto predicates = record{};
+  auto partitions = detail::stable_map<uuid, record>{};
+  for (const auto& span : spans_) {
+    auto is_global = span.partition == uuid::nil();
+    auto& target = is_global ? result : partitions[span.partition];
+    if (span.name == "predicate") {
+      auto it = span.values.find("predicate");
+      auto name = it != span.values.end()
+                    ? caf::get_if<std::string>(&it->second)
+                    : nullptr;
+      auto key = name ? *name : std::string{"<unknown>"};
+      accumulate(nested(predicates, key), span);
+      if (!is_global)
+        accumulate(nested(nested(target, "predicates"), key), span);
+      continue;
+    }
+    accumulate(nested(target, span.name), span);
+    if (!is_global)
+      accumulate(nested(result, span.name), span);
+  }
+  if (!predicates.empty())
+    result["predicates"] = by_runtime(std::move(predicates));
+  auto partition_list = list{};
+  partition_list.reserve(partitions.size());
+  for (auto& [id, xs] : partitions) {
+    auto entry = record{{"id", to_string(id)}};
+    for (auto& [key, value] : xs) {
+      if (key == "predicates")
+        entry[key] = by_runtime(std::move(caf::get<record>(value)));
+      else
+        entry[key] = std::move(value);
+    }
+    partition_list.emplace_back(std::move(entry));
+  }
+  result["partitions"] = std::move(partition_list);
+  return result;
+}
+
+} // namespace vast
@@ -0,0 +1,595 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vast/roaring_bitmap.hpp"
+
+#include "vast/detail/assert.hpp"
+#include "vast/error.hpp"
+#include "vast/fbs/bitmap.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace vast {
+
+namespace {
+
+using container = roaring_bitmap::container;
+using kind = container::kind;
+using block_type = roaring_bitmap::block_type;
+using word_type = roaring_bitmap::word_type;
+
+/// The number of bits per container.
+constexpr uint32_t container_bits = 1u << 16;
+
+/// The number of blocks of a bitset container.
+constexpr size_t bitset_blocks = container_bits / word_type::width;
+
+/// Arrays with more values need more space than a bitset.
+constexpr size_t max_array_size = 4096;
+
+/// Containers with more runs need more space than a bitset.
+constexpr size_t max_runs = 2048;
+
+/// A half-open interval of set bits within a container.
+using interval = std::pair<uint32_t, uint32_t>;
+
+void set_range(std::vector<block_type>& blocks, uint32_t first,
+               uint32_t last) {
+  while (first < last) {
+    auto offset = first % word_type::width;
+    auto n = std::min<uint32_t>(last - first, word_type::width - offset);
+    blocks[first / word_type::width]
+      |= n == word_type::width ? word_type::all : word_type::lsb_mask(n)
+                                                    << offset;
+    first += n;
+  }
+}
+
+/// Invokes a function for all maximal intervals of set bits in a container.
+template <class F>
+void each_interval(const container& c, F f) {
+  switch (c.type) {
+    case kind::array: {
+      for (size_t i = 0; i < c.values.size();) {
+        uint32_t first = c.values[i];
+        uint32_t last = first + 1;
+        while (++i < c.values.size() && c.values[i] == last)
+          ++last;
+        f(first, last);
+      }
+      break;
+    }
+    case kind::runs: {
+      for (size_t i = 0; i < c.values.size(); i += 2) {
+        uint32_t first = c.values[i];
+        f(first, first + c.values[i + 1] + 1);
+      }
+      break;
+    }
+    case kind::bitset: {
+      auto position = uint32_t{0};
+      while (position < container_bits) {
+        auto block = c.blocks[position / word_type::width]
+                     >> (position % word_type::width);
+        if (block == word_type::none) {
+          position += word_type::width - position % word_type::width;
+          continue;
+        }
+        position += word_type::count_trailing_zeros(block);
+        auto first = position;
+        while (position < container_bits) {
+          auto offset = position % word_type::width;
+          auto ones = word_type::count_trailing_ones(
+            c.blocks[position / word_type::width] >> offset);
+          // The shift fills in zeros, so we never count beyond the block.
+          position += std::min(ones, word_type::width - offset);
+          if (ones < word_type::width - offset)
+            break;
+        }
+        f(first, position);
+      }
+      break;
+    }
+  }
+}
+
+std::vector<interval> intervals(const container& c) {
+  auto result = std::vector<interval>{};
+  each_interval(c, [&](uint32_t first, uint32_t last) {
+    result.emplace_back(first, last);
+  });
+  return result;
+}
+
+std::vector<block_type> materialize(const container& c) {
+  if (c.type == kind::bitset)
+    return c.blocks;
+  auto result = std::vector<block_type>(bitset_blocks, word_type::none);
+  each_interval(c, [&](uint32_t first, uint32_t last) {
+    set_range(result, first, last);
+  });
+  return result;
+}
+
+void to_bitset(container& c) {
+  c.blocks = materialize(c);
+  c.values.clear();
+  c.values.shrink_to_fit();
+  c.type = kind::bitset;
+}
+
+/// Sets the bits in *[first, last)* of a container, switching to a bitset
+/// once an array or runs would need more space.
+/// @pre `first < last && last <= container_bits` and *first* lies beyond the
+/// last set bit.
+void append_range(container& c, uint32_t first, uint32_t last) {
+  VAST_ASSERT(first < last && last <= container_bits);
+  switch (c.type) {
+    case kind::array: {
+      if (c.values.size() + (last - first) > max_array_size) {
+        to_bitset(c);
+        set_range(c.blocks, first, last);
+        break;
+      }
+      for (auto i = first; i < last; ++i)
+        c.values.push_back(static_cast<uint16_t>(i));
+      break;
+    }
+    case kind::bitset: {
+      set_range(c.blocks, first, last);
+      break;
+    }
+    case kind::runs: {
+      auto n = c.values.size();
+      if (n > 0 && uint32_t{c.values[n - 2]} + c.values[n - 1] + 1 == first) {
+        c.values[n - 1] = static_cast<uint16_t>(c.values[n - 1] + last - first);
+      } else if (n / 2 == max_runs) {
+        to_bitset(c);
+        set_range(c.blocks, first, last);
+      } else {
+        c.values.push_back(static_cast<uint16_t>(first));
+        c.values.push_back(static_cast<uint16_t>(last - first - 1));
+      }
+      break;
+    }
+  }
+  c.cardinality += last - first;
+}
+
+void optimize(container& c) {
+  auto num_runs = size_t{0};
+  each_interval(c, [&](uint32_t, uint32_t) {
+    ++num_runs;
+  });
+  auto array_size = c.cardinality * sizeof(uint16_t);
+  auto runs_size = num_runs * 2 * sizeof(uint16_t);
+  auto bitset_size = bitset_blocks * sizeof(block_type);
+  auto type = runs_size <= std::min(array_size, bitset_size) ? kind::runs
+              : array_size <= bitset_size                    ? kind::array
+                                                             : kind::bitset;
+  if (type == c.type)
+    return;
+  auto result = container{.key = c.key, .type = type};
+  if (type == kind::bitset)
+    result.blocks.resize(bitset_blocks, word_type::none);
+  each_interval(c, [&](uint32_t first, uint32_t last) {
+    append_range(result, first, last);
+  });
+  VAST_ASSERT(result.type == type);
+  VAST_ASSERT(result.cardinality == c.cardinality);
+  c = std::move(result);
+}
+
+/// Computes the complement of a container for the first *limit* bits.
+container complement(const container& c, uint32_t limit) {
+  auto result = container{.key = c.key};
+  if (c.type == kind::bitset) {
+    result.type = kind::bitset;
+    result.blocks = c.blocks;
+    for (auto& block : result.blocks)
+      block = ~block;
+    auto i = limit / word_type::width;
+    if (auto partial = limit % word_type::width; partial > 0)
+      result.blocks[i++] &= word_type::lsb_mask(partial);
+    std::fill(result.blocks.begin() + i, result.blocks.end(), word_type::none);
+    result.cardinality = limit - c.cardinality;
+    return result;
+  }
+  auto position = uint32_t{0};
+  each_interval(c, [&](uint32_t first, uint32_t last) {
+    if (first > position)
+      append_range(result, position, first);
+    position = last;
+  });
+  if (position < limit)
+    append_range(result, position, limit);
+  return result;
+}
+
+template <class Operation>
+container eval(const container& lhs, const container& rhs, Operation op) {
+  VAST_ASSERT(lhs.key == rhs.key);
+  auto result = container{.key = lhs.key};
+  if (lhs.type == kind::bitset || rhs.type == kind::bitset) {
+    // At least one side is dense, so we operate on whole blocks.
+    result.type = kind::bitset;
+    result.blocks = materialize(lhs);
+    auto materialized = std::vector<block_type>{};
+    if (rhs.type != kind::bitset)
+      materialized = materialize(rhs);
+    const auto& blocks
+      = rhs.type == kind::bitset ? rhs.blocks : materialized;
+    for (size_t i = 0; i < bitset_blocks; ++i) {
+      result.blocks[i] = op(result.blocks[i], blocks[i]);
+      result.cardinality += word_type::popcount(result.blocks[i]);
+    }
+  } else {
+    // Both sides are sparse or clustered, so we sweep over the boundaries of
+    // their intervals.
+    auto xs = intervals(lhs);
+    auto ys = intervals(rhs);
+    auto x = xs.begin();
+    auto y = ys.begin();
+    auto position = uint32_t{0};
+    while (x != xs.end() || y != ys.end()) {
+      auto in_x = x != xs.end() && x->first <= position;
+      auto in_y = y != ys.end() && y->first <= position;
+      auto next_x = x == xs.end() ? container_bits
+                    : in_x        ? x->second
+                                  : x->first;
+      auto next_y = y == ys.end() ? container_bits
+                    : in_y        ? y->second
+                                  : y->first;
+      auto next = std::min(next_x, next_y);
+      if (op(in_x ? word_type::all : word_type::none,
+             in_y ? word_type::all : word_type::none)
+          != word_type::none)
+        append_range(result, position, next);
+      position = next;
+      if (x != xs.end() && x->second == position)
+        ++x;
+      if (y != ys.end() && y->second == position)
+        ++y;
+    }
+  }
+  optimize(result);
+  return result;
+}
+
+} // namespace
+
+roaring_bitmap::roaring_bitmap(size_type n, bool bit) {
+  append_bits(bit, n);
+}
+
+bool roaring_bitmap::empty() const {
+  return size_ == 0;
+}
+
+roaring_bitmap::size_type roaring_bitmap::size() const {
+  return size_;
+}
+
+size_t roaring_bitmap::memusage() const {
+  auto result = containers_.capacity() * sizeof(container);
+  for (const auto& c : containers_)
+    result += c.values.capacity() * sizeof(uint16_t)
+              + c.blocks.capacity() * sizeof(block_type);
+  return result;
+}
+
+const std::vector<roaring_bitmap::container>&
+roaring_bitmap::containers() const {
+  return containers_;
+}
+
+void roaring_bitmap::append_bit(bool bit) {
+  append_bits(bit, 1);
+}
+
+void roaring_bitmap::append_bits(bool bit, size_type n) {
+  VAST_ASSERT(max_size - size_ >= n);
+  if (bit && n > 0)
+    add_range(size_, size_ + n);
+  size_ += n;
+}
+
+void roaring_bitmap::append_block(block_type bits, size_type n) {
+  VAST_ASSERT(n <= word_type::width);
+  VAST_ASSERT(max_size - size_ >= n);
+  if (n < word_type::width)
+    bits &= word_type::lsb_mask(n);
+  while (bits != word_type::none) {
+    auto zeros = word_type::count_trailing_zeros(bits);
+    auto ones = word_type::count_trailing_ones(bits >> zeros);
+    add_range(size_ + zeros, size_ + zeros + ones);
+    bits = zeros + ones == word_type::width
+             ? word_type::none
+             : bits & ~word_type::lsb_mask(zeros + ones);
+  }
+  size_ += n;
+}
+
+void roaring_bitmap::flip() {
+  if (size_ == 0)
+    return;
+  auto result = std::vector<container>{};
+  auto i = containers_.begin();
+  auto last_key = (size_ - 1) >> 16;
+  for (auto key = uint64_t{0}; key <= last_key; ++key) {
+    auto limit = static_cast<uint32_t>(
+      std::min(size_type{container_bits}, size_ - (key << 16)));
+    auto c = container{.key = key};
+    if (i != containers_.end() && i->key == key)
+      c = complement(*i++, limit);
+    else
+      append_range(c, 0, limit);
+    if (c.cardinality > 0) {
+      vast::optimize(c);
+      result.push_back(std::move(c));
+    }
+  }
+  containers_ = std::move(result);
+}
+
+void roaring_bitmap::optimize() {
+  for (auto& c : containers_)
+    vast::optimize(c);
+}
+
+void roaring_bitmap::add_range(size_type first, size_type last) {
+  while (first < last) {
+    auto key = first >> 16;
+    auto base = key << 16;
+    auto end = std::min(last, base + container_bits);
+    if (containers_.empty() || containers_.back().key != key) {
+      // Appending never modifies a container again after moving on to the
+      // next chunk, so this is the time to pick its final representation.
+      if (!containers_.empty())
+        vast::optimize(containers_.back());
+      containers_.push_back(container{.key = key});
+    }
+    append_range(containers_.back(), static_cast<uint32_t>(first - base),
+                 static_cast<uint32_t>(end - base));
+    first = end;
+  }
+}
+
+template <bool FillLHS, bool FillRHS, class Operation>
+roaring_bitmap roaring_bitmap::eval(const roaring_bitmap& lhs,
+                                    const roaring_bitmap& rhs, Operation op) {
+  auto result = roaring_bitmap{};
+  result.size_ = std::max(lhs.size_, rhs.size_);
+  auto x = lhs.containers_.begin();
+  auto y = rhs.containers_.begin();
+  while (x != lhs.containers_.end() && y != rhs.containers_.end()) {
+    if (x->key < y->key) {
+      if constexpr (FillLHS)
+        result.containers_.push_back(*x);
+      ++x;
+    } else if (y->key < x->key) {
+      if constexpr (FillRHS)
+        result.containers_.push_back(*y);
+      ++y;
+    } else {
+      auto c = vast::eval(*x, *y, op);
+      if (c.cardinality > 0)
+        result.containers_.push_back(std::move(c));
+      ++x;
+      ++y;
+    }
+  }
+  if constexpr (FillLHS)
+    result.containers_.insert(result.containers_.end(), x,
+                              lhs.containers_.end());
+  if constexpr (FillRHS)
+    result.containers_.insert(result.containers_.end(), y,
+                              rhs.containers_.end());
+  return result;
+}
+
+roaring_bitmap
+binary_and(const roaring_bitmap& lhs, const roaring_bitmap& rhs) {
+  return roaring_bitmap::eval<false, false>(lhs, rhs, [](auto x, auto y) {
+    return x & y;
+  });
+}
+
+roaring_bitmap binary_or(const roaring_bitmap& lhs, const roaring_bitmap& rhs) {
+  return roaring_bitmap::eval<true, true>(lhs, rhs, [](auto x, auto y) {
+    return x | y;
+  });
+}
+
+roaring_bitmap
+binary_xor(const roaring_bitmap& lhs, const roaring_bitmap& rhs) {
+  return roaring_bitmap::eval<true, true>(lhs, rhs, [](auto x, auto y) {
+    return x ^ y;
+  });
+}
+
+roaring_bitmap
+binary_nand(const roaring_bitmap& lhs, const roaring_bitmap& rhs) {
+  return roaring_bitmap::eval<true, false>(lhs, rhs, [](auto x, auto y) {
+    return x & ~y;
+  });
+}
+
+bool operator==(const roaring_bitmap& x, const roaring_bitmap& y) {
+  if (x.size_ != y.size_ || x.containers_.size() != y.containers_.size())
+    return false;
+  for (size_t i = 0; i < x.containers_.size(); ++i) {
+    const auto& lhs = x.containers_[i];
+    const auto& rhs = y.containers_[i];
+    if (lhs.key != rhs.key || lhs.cardinality != rhs.cardinality)
+      return false;
+    // The same set of bits may have different representations, e.g., when
+    // only one side optimized its last container.
+    if (lhs.type == rhs.type) {
+      if (lhs.values != rhs.values || lhs.blocks != rhs.blocks)
+        return false;
+    } else if (intervals(lhs) != intervals(rhs)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto pack(flatbuffers::FlatBufferBuilder& builder, const roaring_bitmap& from)
+  -> flatbuffers::Offset<fbs::bitmap::RoaringBitmap> {
+  auto container_offsets
+    = std::vector<flatbuffers::Offset<fbs::bitmap::detail::RoaringContainer>>{};
+  container_offsets.reserve(from.containers_.size());
+  for (const auto& c : from.containers_) {
+    auto type = fbs::bitmap::detail::RoaringContainerType::runs;
+    switch (c.type) {
+      case kind::array:
+        type = fbs::bitmap::detail::RoaringContainerType::array;
+        break;
+      case kind::bitset:
+        type = fbs::bitmap::detail::RoaringContainerType::bitset;
+        break;
+      case kind::runs:
+        type = fbs::bitmap::detail::RoaringContainerType::runs;
+        break;
+    }
+    container_offsets.emplace_back(
+      fbs::bitmap::detail::CreateRoaringContainerDirect(
+        builder, c.key, type, c.cardinality, &c.values, &c.blocks));
+  }
+  return fbs::bitmap::CreateRoaringBitmapDirect(builder, &container_offsets,
+                                                from.size_);
+}
+
+auto unpack(const fbs::bitmap::RoaringBitmap& from, roaring_bitmap& to)
+  -> caf::error {
+  to.size_ = from.num_bits();
+  to.containers_.clear();
+  to.containers_.reserve(from.containers()->size());
+  for (const auto* from_container : *from.containers()) {
+    auto& c = to.containers_.emplace_back();
+    c.key = from_container->key();
+    c.cardinality = from_container->cardinality();
+    switch (from_container->type()) {
+      case fbs::bitmap::detail::RoaringContainerType::array:
+        c.type = kind::array;
+        break;
+      case fbs::bitmap::detail::RoaringContainerType::bitset:
+        c.type = kind::bitset;
+        break;
+      case fbs::bitmap::detail::RoaringContainerType::runs:
+        c.type = kind::runs;
+        break;
+      default:
+        return caf::make_error(ec::format_error, "invalid vast.fbs.bitmap."
+                                                 "RoaringContainerType");
+    }
+    if (const auto* values = from_container->values())
+      c.values.assign(values->begin(), values->end());
+    if (const auto* blocks = from_container->blocks())
+      c.blocks.assign(blocks->begin(), blocks->end());
+    if (c.type == kind::bitset && c.blocks.size() != bitset_blocks)
+      return caf::make_error(ec::format_error, "invalid number of blocks in "
+                                               "roaring bitset container");
+  }
+  return caf::none;
+}
+
+roaring_bitmap_range::roaring_bitmap_range(const roaring_bitmap& bm)
+  : bm_{&bm} {
+  scan();
+}
+
+void roaring_bitmap_range::next() {
+  scan();
+}
+
+bool roaring_bitmap_range::done() const {
+  return bits_.empty();
+}
+
+void roaring_bitmap_range::scan() {
+  if (position_ == bm_->size_) {
+    bits_ = {};
+    return;
+  }
+  const auto& containers = bm_->containers_;
+  auto key = position_ >> 16;
+  while (container_ < containers.size() && containers[container_].key < key) {
+    ++container_;
+    entered_ = false;
+  }
+  if (container_ == containers.size() || containers[container_].key > key) {
+    // Produce a run of zeros up to the next container.
+    auto end = container_ == containers.size()
+                 ? bm_->size_
+                 : std::min(bm_->size_, containers[container_].key << 16);
+    bits_ = {word_type::none, end - position_};
+    position_ = end;
+    return;
+  }
+  const auto& c = containers[container_];
+  auto base = c.key << 16;
+  auto offset = static_cast<uint32_t>(position_ - base);
+  auto limit = static_cast<uint32_t>(
+    std::min(roaring_bitmap::size_type{container_bits}, bm_->size_ - base));
+  if (c.type == kind::bitset) {
+    // We always enter bitset containers at the beginning of a block, because
+    // the preceding run of zeros ends at the container boundary.
+    VAST_ASSERT(offset % word_type::width == 0);
+    auto i = offset / word_type::width;
+    auto data = c.blocks[i];
+    auto n = std::min<word_type::size_type>(word_type::width, limit - offset);
+    if (n == word_type::width && word_type::all_or_none(data))
+      while (offset + n + word_type::width <= limit
+             && c.blocks[i + n / word_type::width] == data)
+        n += word_type::width;
+    bits_ = {data, n};
+    position_ += n;
+    return;
+  }
+  if (!entered_) {
+    entered_ = true;
+    value_ = 0;
+    next_interval();
+  }
+  while (has_interval_ && last_ <= offset)
+    next_interval();
+  if (has_interval_ && first_ <= offset) {
+    auto n = std::min(last_, limit) - offset;
+    bits_ = {word_type::all, n};
+    position_ += n;
+  } else {
+    auto end = has_interval_ ? std::min(first_, limit) : limit;
+    bits_ = {word_type::none, end - offset};
+    position_ += end - offset;
+  }
+}
+
+void roaring_bitmap_range::next_interval() {
+  const auto& c = bm_->containers_[container_];
+  has_interval_ = value_ < c.values.size();
+  if (!has_interval_)
+    return;
+  first_ = c.values[value_];
+  if (c.type == kind::runs) {
+    last_ = first_ + c.values[value_ + 1] + 1;
+    value_ += 2;
+    return;
+  }
+  last_ = first_ + 1;
+  while (++value_ < c.values.size() && c.values[value_] == last_)
+    ++last_;
+}
+
+roaring_bitmap_range bit_range(const roaring_bitmap& bm) {
+  return roaring_bitmap_range{bm};
+}
+
+} // namespace vast
@@ -26,14 +26,35 @@
 #include "vast/si_literals.hpp"
 #include "vast/table_slice.hpp"
 #include "vast/uuid.hpp"
+#include "vast/zone_map.hpp"
 
 #include <caf/binary_serializer.hpp>
 #include <flatbuffers/base.h> // FLATBUFFERS_MAX_BUFFER_SIZE
 
+#include <algorithm>
+
 namespace vast {
 
 using namespace binary_byte_literals;
 
+namespace {
+
+zone_map unpack_zone_map(const fbs::segment::detail::ZoneMap& x) {
+  auto result = zone_map{};
+  if (!x.time_ranges())
+    return result;
+  result.time_ranges.reserve(x.time_ranges()->size());
+  for (const auto* range : *x.time_ranges())
+    result.time_ranges.push_back({
+      .column = detail::narrow_cast<size_t>(range->column()),
+      .min = time{duration{range->min()}},
+      .max = time{duration{range->max()}},
+    });
+  return result;
+}
+
+} // namespace
+
 caf::expected<segment> segment::make(chunk_ptr&& chunk) {
   auto s = flatbuffer<fbs::Segment>::make(std::move(chunk));
   if (!s)
@@ -72,6 +93,11 @@ chunk_ptr segment::chunk() const {
 
 caf::expected<std::vector<table_slice>>
 segment::lookup(const vast::ids& xs) const {
+  return lookup(xs, expression{});
+}
+
+caf::expected<std::vector<table_slice>>
+segment::lookup(const vast::ids& xs, const expression& expr) const {
   std::vector<table_slice> result;
   auto segment = flatbuffer_->segment_as_v0();
   if (!segment)
@@ -81,13 +107,20 @@ segment::lookup(const vast::ids& xs) const {
     auto&& interval = std::get<0>(zip);
     return std::pair{interval->begin(), interval->end()};
   };
+  auto filter = zone_map_filter{expr};
   auto g = [&](const auto& zip) {
-    auto&& [interval, flat_slice] = zip;
+    auto&& [interval, flat_slice, flat_zones] = zip;
     // TODO: rework lifetime sharing API of table slice.
     auto slice = table_slice{*flat_slice, chunk(), table_slice::verify::yes};
     slice.offset(interval->begin());
     VAST_ASSERT(slice.offset() == interval->begin());
     VAST_ASSERT(slice.offset() + slice.rows() == interval->end());
+    if (flat_zones && !filter(slice, unpack_zone_map(*flat_zones))) {
+      VAST_DEBUG("{} skips slice [{}, {}) because of its zone map",
+                 detail::pretty_type_name(this), interval->begin(),
+                 interval->end());
+      return caf::none;
+    }
     VAST_DEBUG("{} returns slice from lookup: {}",
                detail::pretty_type_name(this), to_string(slice));
     result.push_back(std::move(slice));
@@ -102,7 +135,14 @@ segment::lookup(const vast::ids& xs) const {
   auto intervals = std::vector(segment->ids()->begin(), segment->ids()->end());
   auto flat_slices
     = std::vector(segment->slices()->begin(), segment->slices()->end());
-  auto zipped = detail::zip(intervals, flat_slices);
+  // Segments written before zone maps existed have no zone maps at all.
+  auto flat_zone_maps = std::vector<const fbs::segment::detail::ZoneMap*>(
+    flat_slices.size(), nullptr);
+  if (segment->zone_maps()
+      && segment->zone_maps()->size() == flat_zone_maps.size())
+    std::copy(segment->zone_maps()->begin(), segment->zone_maps()->end(),
+              flat_zone_maps.begin());
+  auto zipped = detail::zip(intervals, flat_slices, flat_zone_maps);
   if (auto error = select_with(xs, zipped.begin(), zipped.end(), f, g))
     return error;
   return result;
@@ -11,6 +11,7 @@
 #include "vast/detail/assert.hpp"
 #include "vast/detail/byte_swap.hpp"
 #include "vast/detail/narrow.hpp"
+#include "vast/detail/zip_iterator.hpp"
 #include "vast/error.hpp"
 #include "vast/fbs/segment.hpp"
 #include "vast/fbs/utils.hpp"
@@ -37,6 +38,7 @@ caf::error segment_builder::add(table_slice x) {
   auto slice = fbs::CreateFlatTableSlice(builder_, bytes);
   flat_slices_.push_back(slice);
   intervals_.emplace_back(x.offset(), x.offset() + x.rows());
+  zone_maps_.push_back(zone_map::make(x));
   num_events_ += x.rows();
   slices_.push_back(x);
   return caf::none;
@@ -46,11 +48,26 @@ segment segment_builder::finish() {
   auto table_slices_offset = builder_.CreateVector(flat_slices_);
   auto uuid_offset = pack(builder_, id_);
   auto ids_offset = builder_.CreateVectorOfStructs(intervals_);
+  auto zone_map_offsets
+    = std::vector<flatbuffers::Offset<fbs::segment::detail::ZoneMap>>{};
+  zone_map_offsets.reserve(zone_maps_.size());
+  for (const auto& zones : zone_maps_) {
+    auto time_ranges = std::vector<fbs::segment::detail::TimeRange>{};
+    time_ranges.reserve(zones.time_ranges.size());
+    for (const auto& range : zones.time_ranges)
+      time_ranges.emplace_back(range.column,
+                               range.min.time_since_epoch().count(),
+                               range.max.time_since_epoch().count());
+    zone_map_offsets.push_back(fbs::segment::detail::CreateZoneMap(
+      builder_, builder_.CreateVectorOfStructs(time_ranges)));
+  }
+  auto zone_maps_offset = builder_.CreateVector(zone_map_offsets);
   fbs::segment::v0Builder segment_v0_builder{builder_};
   segment_v0_builder.add_slices(table_slices_offset);
   segment_v0_builder.add_uuid(*uuid_offset);
   segment_v0_builder.add_ids(ids_offset);
   segment_v0_builder.add_events(num_events_);
+  segment_v0_builder.add_zone_maps(zone_maps_offset);
   auto segment_v0_offset = segment_v0_builder.Finish();
   fbs::SegmentBuilder segment_builder{builder_};
   segment_builder.add_segment_type(vast::fbs::segment::Segment::v0);
@@ -64,15 +81,25 @@ segment segment_builder::finish() {
 
 caf::expected<std::vector<table_slice>>
 segment_builder::lookup(const vast::ids& xs) const {
+  return lookup(xs, expression{});
+}
+
+caf::expected<std::vector<table_slice>>
+segment_builder::lookup(const vast::ids& xs, const expression& expr) const {
   std::vector<table_slice> result;
-  auto f = [](auto& slice) {
+  auto filter = zone_map_filter{expr};
+  auto f = [](const auto& zip) {
+    const auto& slice = std::get<0>(zip);
     return std::pair{slice.offset(), slice.offset() + slice.rows()};
   };
-  auto g = [&](auto& slice) {
-    result.push_back(slice);
+  auto g = [&](const auto& zip) {
+    const auto& [slice, zones] = zip;
+    if (filter(slice, zones))
+      result.push_back(slice);
     return caf::none;
   };
-  if (auto error = select_with(xs, slices_.begin(), slices_.end(), f, g))
+  auto zipped = detail::zip(slices_, zone_maps_);
+  if (auto error = select_with(xs, zipped.begin(), zipped.end(), f, g))
     return error;
   return result;
 }
@@ -108,6 +135,7 @@ void segment_builder::reset(const std::optional<uuid>& id) {
   builder_.Clear();
   flat_slices_.clear();
   intervals_.clear();
+  zone_maps_.clear();
   slices_.clear();
 }
 
@@ -40,6 +40,14 @@ const vast::type& synopsis::type() const {
   return type_;
 }
 
+void synopsis::add_column(const table_slice& slice, size_t column) {
+  for (auto&& x : slice.values(column))
+    // TODO: It would probably make sense to allow `nil` in the synopsis API,
+    // so we can treat queries like `x == nil` just like normal queries.
+    if (!caf::holds_alternative<caf::none_t>(x))
+      add(std::move(x));
+}
+
 synopsis_ptr synopsis::shrink() const {
   return nullptr;
 }
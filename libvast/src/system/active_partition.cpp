@@ -54,9 +54,11 @@
 #include <flatbuffers/base.h> // FLATBUFFERS_MAX_BUFFER_SIZE
 #include <flatbuffers/flatbuffers.h>
 
+#include <algorithm>
 #include <filesystem>
 #include <memory>
 #include <span>
+#include <vector>
 
 namespace vast::system {
 
@@ -124,6 +126,17 @@ pack(flatbuffers::FlatBufferBuilder& builder,
     auto qindex = qbuilder.Finish();
     indices.push_back(qindex);
   }
+  for (const auto& [name, section] : x.indexer_sections) {
+    auto fieldname = builder.CreateString(name);
+    fbs::value_index::detail::LegacyValueIndexBuilder vbuilder(builder);
+    vbuilder.add_section(&section);
+    auto vindex = vbuilder.Finish();
+    fbs::value_index::LegacyQualifiedValueIndexBuilder qbuilder(builder);
+    qbuilder.add_field_name(fieldname);
+    qbuilder.add_index(vindex);
+    auto qindex = qbuilder.Finish();
+    indices.push_back(qindex);
+  }
   auto indexes = builder.CreateVector(indices);
   // Serialize layout.
   auto legacy_combined_layout
@@ -175,6 +188,143 @@ pack(flatbuffers::FlatBufferBuilder& builder,
   return partition;
 }
 
+chunk_ptr make_partition_header(const chunk& flatbuffer,
+                                uint64_t flatbuffer_offset) {
+  VAST_ASSERT(flatbuffer_offset % partition_section_alignment == 0);
+  VAST_ASSERT(flatbuffer.size() >= partition_header_size);
+  const auto* data = reinterpret_cast<const uint8_t*>(flatbuffer.data());
+  auto root_offset = flatbuffers::ReadScalar<flatbuffers::uoffset_t>(data);
+  auto header = std::vector<std::byte>(partition_header_size);
+  flatbuffers::WriteScalar(
+    header.data(), static_cast<flatbuffers::uoffset_t>(flatbuffer_offset
+                                                       + root_offset));
+  // Copy the file identifier that follows the root offset.
+  std::copy(flatbuffer.begin() + sizeof(flatbuffers::uoffset_t),
+            flatbuffer.begin() + partition_header_size,
+            header.begin() + sizeof(flatbuffers::uoffset_t));
+  return chunk::make(std::move(header));
+}
+
+namespace {
+
+/// Rounds a position in a partition file up to the next section boundary.
+uint64_t align_section(uint64_t offset) {
+  constexpr auto mask = partition_section_alignment - 1;
+  return (offset + mask) & ~mask;
+}
+
+/// Writes the trailing flatbuffer and the header of a partition file after
+/// all sections were written, and then the partition synopsis.
+void finish_persisting(
+  active_partition_actor::stateful_pointer<active_partition_state> self) {
+  auto& mutable_synopsis = self->state.data.synopsis.unshared();
+  // Shrink synopses for addr fields to optimal size.
+  mutable_synopsis.shrink();
+  // TODO: It would probably make more sense if the partition
+  // synopsis keeps track of offset/events internally.
+  mutable_synopsis.offset = self->state.data.offset;
+  mutable_synopsis.events = self->state.data.events;
+  // Create the partition flatbuffer. It only refers to the sections that
+  // contain the serialized indexers, so it stays small.
+  flatbuffers::FlatBufferBuilder builder;
+  auto combined_layout = self->state.combined_layout();
+  if (!combined_layout) {
+    auto err = caf::make_error(ec::logic_error, "unable to create "
+                                                "combined layout");
+    VAST_ERROR("{} failed to serialize {} with error: {}", *self,
+               self->state.name, err);
+    self->state.persistence_promise.deliver(err);
+    return;
+  }
+  auto partition = pack(builder, self->state.data, *combined_layout);
+  if (!partition) {
+    VAST_ERROR("{} failed to serialize {} with error: {}", *self,
+               self->state.name, partition.error());
+    self->state.persistence_promise.deliver(partition.error());
+    return;
+  }
+  auto fbchunk = fbs::release(builder);
+  auto fbchunk_offset = self->state.next_section_offset;
+  // Readers treat the entire file as a single flatbuffer, so it must not
+  // exceed the maximum flatbuffer size.
+  // FlatBuffers <= 1.11 does not correctly use '::flatbuffers::soffset_t'
+  // over 'soffset_t' in FLATBUFFERS_MAX_BUFFER_SIZE.
+  using ::flatbuffers::soffset_t;
+  if (fbchunk_offset + fbchunk->size() >= FLATBUFFERS_MAX_BUFFER_SIZE) {
+    auto err = caf::make_error(
+      ec::logic_error, fmt::format("{} exceeds the maximum partition size of "
+                                   "{} bytes",
+                                   self->state.name,
+                                   FLATBUFFERS_MAX_BUFFER_SIZE));
+    VAST_ERROR("{} failed to persist: {}", *self, err);
+    self->state.persistence_promise.deliver(err);
+    return;
+  }
+  auto header = make_partition_header(*fbchunk, fbchunk_offset);
+  VAST_ASSERT(self->state.persist_path);
+  VAST_ASSERT(self->state.synopsis_path);
+  // Note that this is a performance optimization: We used to store
+  // the partition synopsis inside the `Partition` flatbuffer, and
+  // then on startup the index would mmap all partitions and read
+  // the relevant part of the flatbuffer. However, due to the way
+  // the flatbuffer file format is structured this still needs three
+  // random file accesses: At the beginning to read vtable offset
+  // and file identifier, at the end to read the actual vtable, and
+  // finally at the actual data. On systems with aggressive
+  // readahead (ie., btrfs defaults to 4MiB), this can increase the
+  // i/o at startup and thus the time to boot by more than 10x.
+  //
+  // Since the synopsis should be small compared to the actual data,
+  // we store a redundant copy in the partition itself so we can
+  // regenerate the synopses as needed. This also means we don't
+  // need to handle errors here, since VAST can still start
+  // correctly (if a bit slower) when the write fails.
+  flatbuffers::FlatBufferBuilder synopsis_builder;
+  if (auto ps = pack(synopsis_builder, *self->state.data.synopsis)) {
+    fbs::PartitionSynopsisBuilder ps_builder(synopsis_builder);
+    ps_builder.add_partition_synopsis_type(
+      fbs::partition_synopsis::PartitionSynopsis::legacy);
+    ps_builder.add_partition_synopsis(ps->Union());
+    auto ps_offset = ps_builder.Finish();
+    fbs::FinishPartitionSynopsisBuffer(synopsis_builder, ps_offset);
+    auto ps_chunk = fbs::release(synopsis_builder);
+    self
+      ->request(self->state.filesystem, caf::infinite, atom::write_v,
+                *self->state.synopsis_path, ps_chunk)
+      .then([=](atom::ok) {}, [=](caf::error) {});
+  }
+  VAST_DEBUG("{} persists partition with a total size of {} bytes", *self,
+             fbchunk_offset + fbchunk->size());
+  // The header goes last, so that a partition file with a valid header is
+  // always complete.
+  // TODO: Add a proper timeout.
+  self
+    ->request(self->state.filesystem, caf::infinite, atom::write_v,
+              *self->state.persist_path, fbchunk_offset, fbchunk)
+    .then(
+      [=](atom::ok) {
+        self
+          ->request(self->state.filesystem, caf::infinite, atom::write_v,
+                    *self->state.persist_path, uint64_t{0}, header)
+          .then(
+            [=](atom::ok) {
+              // Relinquish ownership and send the shrunken synopsis to
+              // the index.
+              self->state.persistence_promise.deliver(
+                self->state.data.synopsis);
+              self->state.data.synopsis.reset();
+            },
+            [=](caf::error e) {
+              self->state.persistence_promise.deliver(std::move(e));
+            });
+      },
+      [=](caf::error e) {
+        self->state.persistence_promise.deliver(std::move(e));
+      });
+}
+
+} // namespace
+
 active_partition_actor::behavior_type active_partition(
   active_partition_actor::stateful_pointer<active_partition_state> self,
   uuid id, accountant_actor accountant, filesystem_actor filesystem,
@@ -357,8 +507,26 @@ active_partition_actor::behavior_type active_partition(
       }
       VAST_DEBUG("{} sends 'snapshot' to {} indexers", *self,
                  self->state.indexers.size());
-      for (auto& kv : self->state.indexers) {
-        self->request(kv.second, caf::infinite, atom::snapshot_v)
+      // Every serialized indexer is written to its own section of the
+      // partition file as soon as it arrives, so we never need to hold all of
+      // them in memory at once. Note that the deserialization code relies on
+      // the order of indexers within the flatbuffer being preserved.
+      // TODO: Consider storing indexer chunks by the fully qualified
+      // field instead of just its fully qualified name in a future
+      // partition version. As-is, this breaks if multiple fields with
+      // the same fully qualified name but different types exist in
+      // the same partition.
+      self->state.written_sections = 0;
+      self->state.next_section_offset = partition_header_size;
+      self->state.data.indexer_sections.clear();
+      for (const auto& [qf, _] : self->state.indexers)
+        self->state.data.indexer_sections.emplace_back(
+          qf.name(), fbs::value_index::detail::FileSection{});
+      for (size_t position = 0; position < self->state.indexers.size();
+           ++position) {
+        self
+          ->request(self->state.indexer_at(position), caf::infinite,
+                    atom::snapshot_v)
           .then(
             [=](chunk_ptr chunk) {
               ++self->state.persisted_indexers;
@@ -375,121 +543,45 @@ active_partition_actor::behavior_type active_partition(
                   ec::unspecified, "failed to persist indexer", sender));
                 return;
               }
-              VAST_DEBUG("{} got chunk from {}", *self, sender);
-              self->state.chunks.emplace(sender, chunk);
-              if (self->state.persisted_indexers
-                  < self->state.indexers.size()) {
-                VAST_DEBUG("{} waits for more chunks after receiving {} out of "
-                           "{}",
-                           *self, self->state.persisted_indexers,
-                           self->state.indexers.size());
-                return;
-              }
-              auto& mutable_synopsis = self->state.data.synopsis.unshared();
-              // Shrink synopses for addr fields to optimal size.
-              mutable_synopsis.shrink();
-              // TODO: It would probably make more sense if the partition
-              // synopsis keeps track of offset/events internally.
-              mutable_synopsis.offset = self->state.data.offset;
-              mutable_synopsis.events = self->state.data.events;
-              for (auto& [qf, actor] : self->state.indexers) {
-                auto actor_id = actor.id();
-                auto chunk_it = self->state.chunks.find(actor_id);
-                if (chunk_it == self->state.chunks.end()) {
-                  auto error = caf::make_error(ec::logic_error,
-                                               "no chunk for for actor id "
-                                                 + to_string(actor_id));
-                  VAST_ERROR("{} failed to serialize: {}", self->state.name,
-                             render(error));
-                  self->state.persistence_promise.deliver(error);
-                  return;
-                }
-                // TODO: Consider storing indexer chunks by the fully qualified
-                // field instead of just its fully qualified name in a future
-                // partition version. As-is, this breaks if multiple fields with
-                // the same fully qualified name but different types exist in
-                // the same partition.
-                self->state.data.indexer_chunks.push_back(
-                  std::make_pair(qf.name(), chunk_it->second));
-              }
-              // Create the partition flatbuffer.
-              flatbuffers::FlatBufferBuilder builder;
-              auto combined_layout = self->state.combined_layout();
-              if (!combined_layout) {
-                auto err = caf::make_error(ec::logic_error, "unable to create "
-                                                            "combined layout");
-                VAST_ERROR("{} failed to serialize {} with error: {}", *self,
-                           self->state.name, err);
-                self->state.persistence_promise.deliver(err);
-                return;
-              }
-              auto partition
-                = pack(builder, self->state.data, *combined_layout);
-              if (!partition) {
-                VAST_ERROR("{} failed to serialize {} with error: {}", *self,
-                           self->state.name, partition.error());
-                self->state.persistence_promise.deliver(partition.error());
-                return;
-              }
-              VAST_ASSERT(self->state.persist_path);
-              VAST_ASSERT(self->state.synopsis_path);
-              // Note that this is a performance optimization: We used to store
-              // the partition synopsis inside the `Partition` flatbuffer, and
-              // then on startup the index would mmap all partitions and read
-              // the relevant part of the flatbuffer. However, due to the way
-              // the flatbuffer file format is structured this still needs three
-              // random file accesses: At the beginning to read vtable offset
-              // and file identifier, at the end to read the actual vtable, and
-              // finally at the actual data. On systems with aggressive
-              // readahead (ie., btrfs defaults to 4MiB), this can increase the
-              // i/o at startup and thus the time to boot by more than 10x.
-              //
-              // Since the synopsis should be small compared to the actual data,
-              // we store a redundant copy in the partition itself so we can
-              // regenerate the synopses as needed. This also means we don't
-              // need to handle errors here, since VAST can still start
-              // correctly (if a bit slower) when the write fails.
-              flatbuffers::FlatBufferBuilder synopsis_builder;
-              if (auto ps
-                  = pack(synopsis_builder, *self->state.data.synopsis)) {
-                fbs::PartitionSynopsisBuilder ps_builder(synopsis_builder);
-                ps_builder.add_partition_synopsis_type(
-                  fbs::partition_synopsis::PartitionSynopsis::legacy);
-                ps_builder.add_partition_synopsis(ps->Union());
-                auto ps_offset = ps_builder.Finish();
-                fbs::FinishPartitionSynopsisBuffer(synopsis_builder, ps_offset);
-                auto ps_chunk = fbs::release(synopsis_builder);
-                self
-                  ->request(self->state.filesystem, caf::infinite,
-                            atom::write_v, *self->state.synopsis_path, ps_chunk)
-                  .then([=](atom::ok) {}, [=](caf::error) {});
-              }
-              auto fbchunk = fbs::release(builder);
-              VAST_DEBUG("{} persists partition with a total size of "
-                         "{} bytes",
-                         *self, fbchunk->size());
-              // TODO: Add a proper timeout.
+              auto offset = self->state.next_section_offset;
+              self->state.next_section_offset
+                = align_section(offset + chunk->size());
+              self->state.data.indexer_sections[position].second
+                = fbs::value_index::detail::FileSection{offset, chunk->size()};
+              VAST_DEBUG("{} writes {} bytes from {} at offset {}", *self,
+                         chunk->size(), sender, offset);
               self
                 ->request(self->state.filesystem, caf::infinite, atom::write_v,
-                          *self->state.persist_path, fbchunk)
+                          *self->state.persist_path, offset, std::move(chunk))
                 .then(
                   [=](atom::ok) {
-                    // Relinquish ownership and send the shrunken synopsis to
-                    // the index.
-                    self->state.persistence_promise.deliver(
-                      self->state.data.synopsis);
-                    self->state.data.synopsis.reset();
+                    ++self->state.written_sections;
+                    if (!self->state.persistence_promise.pending())
+                      return;
+                    if (self->state.written_sections
+                        < self->state.indexers.size()) {
+                      VAST_DEBUG("{} waits for more sections after writing "
+                                 "{} out of {}",
+                                 *self, self->state.written_sections,
+                                 self->state.indexers.size());
+                      return;
+                    }
+                    finish_persisting(self);
                   },
-                  [=](caf::error e) {
-                    self->state.persistence_promise.deliver(std::move(e));
+                  [=](caf::error err) {
+                    VAST_ERROR("{} failed to write section at offset {}: {}",
+                               *self, offset, err);
+                    if (self->state.persistence_promise.pending())
+                      self->state.persistence_promise.deliver(std::move(err));
                   });
-              return;
             },
             [=](caf::error err) {
               VAST_ERROR("{} failed to persist indexer for {} with error: {}",
-                         *self, kv.first.name(), err);
+                         *self,
+                         self->state.data.indexer_sections[position].first,
+                         err);
               ++self->state.persisted_indexers;
-              if (!self->state.persistence_promise.pending())
+              if (self->state.persistence_promise.pending())
                 self->state.persistence_promise.deliver(std::move(err));
             });
       }
@@ -512,7 +604,8 @@ active_partition_actor::behavior_type active_partition(
         rp.deliver(uint64_t{0});
         return rp;
       }
-      auto eval = self->spawn(evaluator, query.expr, triples);
+      auto eval = self->spawn(evaluator, query.expr, triples, query.tracer,
+                              self->state.data.id);
       self->request(eval, caf::infinite, atom::run_v)
         .then(
           [self, rp, start, query = std::move(query)](const ids& hits) mutable {
@@ -526,6 +619,14 @@ active_partition_actor::behavior_type active_partition(
                        rank(hits),
                        metrics_metadata{{"query", std::move(id_str)},
                                         {"partition-type", "active"}});
+            if (query.tracer)
+              self->send(query.tracer,
+                         query_span{
+                           .partition = self->state.data.id,
+                           .name = "evaluation",
+                           .runtime = runtime,
+                           .values = {{"hits", count{rank(hits)}}},
+                         });
             // TODO: Use the first path if the expression can be evaluated
             // exactly.
             auto* count = caf::get_if<query::count>(&query.cmd);
@@ -553,6 +654,10 @@ active_partition_actor::behavior_type active_partition(
         }
       };
       auto rs = make_status_request_state<extra_state>(self);
+      // The partition synopsis grows alongside the indexers, so we account
+      // for it as well.
+      if (self->state.data.synopsis)
+        rs->memory_usage += self->state.data.synopsis->memusage();
       auto indexer_states = list{};
       // Reservation is necessary to make sure the entries don't get relocated
       // as the underlying vector grows - `ps` would refer to the wrong memory
@@ -17,6 +17,7 @@
 #include "vast/plugin.hpp"
 #include "vast/system/configuration.hpp"
 #include "vast/system/count_command.hpp"
+#include "vast/system/explain_command.hpp"
 #include "vast/system/explore_command.hpp"
 #include "vast/system/import_command.hpp"
 #include "vast/system/infer_command.hpp"
@@ -42,7 +43,16 @@ command::opts_builder add_index_opts(command::opts_builder ob) {
                                             "partitions")
     .add<size_t>("max-taste-partitions", "maximum number of immediately "
                                          "scheduled partitions")
-    .add<size_t>("max-queries,q", "maximum number of concurrent queries");
+    .add<size_t>("max-queries,q", "maximum number of concurrent queries")
+    .add<size_t>("ingest-workers", "number of actors that feed active "
+                                   "partitions in parallel")
+    .add<std::string>("active-partition-memory-budget",
+                      "maximum memory of all active partitions together")
+    .add<size_t>("min-partition-size", "number of events below which "
+                                       "partitions get merged")
+    .add<duration>("partition-merge-interval",
+                   "timespan between two attempts to merge small "
+                   "partitions (0s disables merging)");
 }
 
 command::opts_builder add_archive_opts(command::opts_builder ob) {
@@ -74,6 +84,15 @@ auto make_dump_command() {
   return dump;
 }
 
+auto make_explain_command() {
+  return std::make_unique<command>(
+    "explain", "profile the execution of a query", documentation::vast_explain,
+    opts("?vast.explain")
+      .add<size_t>("max-events,n", "maximum number of results")
+      .add<std::string>("read,r", "path for reading the query")
+      .add<bool>("yaml", "format output as YAML"));
+}
+
 auto make_explore_command() {
   return std::make_unique<command>(
     "explore", "explore context around query results",
@@ -176,6 +195,9 @@ auto make_pivot_command() {
       .add<size_t>("flush-interval,f", "flush to disk after this many packets "
                                        "(only with the PCAP plugin)")
       .add<bool>("disable-taxonomies", "don't substitute taxonomy identifiers")
+      .add<size_t>("max-values-per-query", "maximum number of edge values "
+                                           "in a single query for the target "
+                                           "type")
       .add<std::string>("format", "output format "
                                   "(default: JSON)"));
   return pivot;
@@ -348,6 +370,7 @@ auto make_command_factory() {
     {"dump", remote_command},
     {"dump concepts", remote_command},
     {"dump models", remote_command},
+    {"explain", explain_command},
     {"explore", explore_command},
     {"export ascii", make_writer_command("ascii")},
     {"export csv", make_writer_command("csv")},
@@ -356,6 +379,7 @@ auto make_command_factory() {
     {"export arrow", make_writer_command("arrow")},
     {"export zeek", make_writer_command("zeek")},
     {"infer", infer_command},
+    {"import arrow", import_command},
     {"import csv", import_command},
     {"import json", import_command},
     {"import suricata", import_command},
@@ -461,13 +485,18 @@ auto make_root_command(std::string_view path) {
                           "time to wait until component shutdown "
                           "finishes cleanly before inducing a hard kill")
         .add<std::string>("store-backend", "store plugin to use for imported "
-                                           "data");
+                                           "data")
+        .add<size_t>("filesystem-read-workers", "number of threads for "
+                                                "filesystem reads")
+        .add<size_t>("filesystem-write-workers", "number of threads for "
+                                                 "filesystem writes");
   ob = add_index_opts(std::move(ob));
   ob = add_archive_opts(std::move(ob));
   auto root
     = std::make_unique<command>(path, "", documentation::vast, std::move(ob));
   root->add_subcommand(make_count_command());
   root->add_subcommand(make_dump_command());
+  root->add_subcommand(make_explain_command());
   root->add_subcommand(make_export_command());
   root->add_subcommand(make_explore_command());
   root->add_subcommand(make_infer_command());
@@ -502,6 +531,11 @@ std::unique_ptr<command> make_import_command() {
       .add<std::string>("read-timeout", "timeout for waiting for incoming data")
       .add<std::string>("schema,S", "alternate schema as string")
       .add<std::string>("schema-file,s", "path to alternate schema")
+      .add<bool>("shared-memory", "hand off table slices to a node on the "
+                                  "same host via shared memory")
+      .add<std::string>("shared-memory-timeout", "timeout after which "
+                                                 "unclaimed shared memory "
+                                                 "is released")
       .add<std::string>("type,t", "filter event type based on prefix matching")
       .add<bool>("uds,d", "treat -r as listening UNIX domain socket"));
   import_->add_subcommand("zeek", "imports Zeek TSV logs from STDIN or file",
@@ -511,6 +545,10 @@ std::unique_ptr<command> make_import_command() {
                           "imports Zeek JSON logs from STDIN or file",
                           documentation::vast_import_zeek,
                           opts("?vast.import.zeek-json"));
+  import_->add_subcommand("arrow",
+                          "imports Arrow IPC streams from STDIN or file",
+                          documentation::vast_import_arrow,
+                          opts("?vast.import.arrow"));
   import_->add_subcommand("csv", "imports CSV logs from STDIN or file",
                           documentation::vast_import_csv,
                           opts("?vast.import.csv"));
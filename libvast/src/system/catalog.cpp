@@ -394,6 +394,122 @@ std::vector<uuid> catalog_state::lookup_impl(const expression& expr) const {
   return caf::visit(f, expr);
 }
 
+namespace {
+
+/// Describes which events of a partition match an expression.
+enum class coverage { none, some, all };
+
+/// Determines which events of a partition match an expression, using only
+/// the partition metadata. Predicates on anything but the layout name and the
+/// import time cannot be decided this way and cover *some* events.
+coverage cover(const expression& expr, const partition_synopsis& synopsis) {
+  auto f = detail::overload{
+    [&](const conjunction& x) {
+      auto result = coverage::all;
+      for (const auto& op : x) {
+        auto c = cover(op, synopsis);
+        if (c == coverage::none)
+          return coverage::none;
+        if (c == coverage::some)
+          result = coverage::some;
+      }
+      return result;
+    },
+    [&](const disjunction& x) {
+      auto result = coverage::none;
+      for (const auto& op : x) {
+        auto c = cover(op, synopsis);
+        if (c == coverage::all)
+          return coverage::all;
+        if (c == coverage::some)
+          result = coverage::some;
+      }
+      return result;
+    },
+    [&](const negation& x) {
+      switch (cover(x.expr(), synopsis)) {
+        case coverage::none:
+          return coverage::all;
+        case coverage::some:
+          return coverage::some;
+        case coverage::all:
+          return coverage::none;
+      }
+      __builtin_unreachable();
+    },
+    [&](const predicate& x) {
+      const auto* lhs = caf::get_if<meta_extractor>(&x.lhs);
+      const auto* rhs = caf::get_if<data>(&x.rhs);
+      if (!lhs || !rhs)
+        return coverage::some;
+      if (lhs->kind == meta_extractor::type) {
+        // Every event belongs to exactly one layout, so the predicate covers
+        // the partition if it holds for all of its layouts.
+        auto matching = size_t{0};
+        auto total = size_t{0};
+        auto layout_names = detail::stable_set<std::string_view>{};
+        for (const auto& [field, _] : synopsis.field_synopses_)
+          layout_names.insert(field.layout_name());
+        for (const auto& layout_name : layout_names) {
+          ++total;
+          if (evaluate(std::string{layout_name}, x.op, *rhs))
+            ++matching;
+        }
+        if (total == 0)
+          return coverage::some;
+        if (matching == 0)
+          return coverage::none;
+        return matching == total ? coverage::all : coverage::some;
+      }
+      if (lhs->kind == meta_extractor::import_time) {
+        const auto* t = caf::get_if<vast::time>(rhs);
+        if (!t || synopsis.min_import_time > synopsis.max_import_time)
+          return coverage::some;
+        const auto& min = synopsis.min_import_time;
+        const auto& max = synopsis.max_import_time;
+        if (x.op == relational_operator::not_equal) {
+          if (*t < min || *t > max)
+            return coverage::all;
+          return min == max ? coverage::none : coverage::some;
+        }
+        auto ts = time_synopsis{min, max};
+        if (auto any = ts.lookup(x.op, *t); any && !*any)
+          return coverage::none;
+        // All other relational operators on time select a contiguous range,
+        // so it suffices to check both bounds.
+        if (evaluate(data{min}, x.op, *rhs) && evaluate(data{max}, x.op, *rhs))
+          return coverage::all;
+      }
+      return coverage::some;
+    },
+    [&](caf::none_t) {
+      return coverage::some;
+    },
+  };
+  return caf::visit(f, expr);
+}
+
+} // namespace
+
+void catalog_state::count_from_metadata(const expression& expr,
+                                        catalog_result& result) const {
+  std::erase_if(result.partitions, [&](const uuid& partition) {
+    auto it = synopses.find(partition);
+    if (it == synopses.end() || !it->second)
+      return false;
+    switch (cover(expr, *it->second)) {
+      case coverage::none:
+        return true;
+      case coverage::some:
+        return false;
+      case coverage::all:
+        result.counts.emplace_back(partition, it->second->events);
+        return true;
+    }
+    __builtin_unreachable();
+  });
+}
+
 catalog_actor::behavior_type
 catalog(catalog_actor::stateful_pointer<catalog_state> self,
         accountant_actor accountant) {
@@ -490,8 +606,15 @@ catalog(catalog_actor::stateful_pointer<catalog_state> self,
                  result_candidates.size(),
                  metrics_metadata{{"query", std::move(id_str)}});
 
-      return catalog_result{catalog_result::probabilistic,
-                            std::move(result_candidates)};
+      auto result = catalog_result{catalog_result::probabilistic,
+                                   std::move(result_candidates)};
+      // Estimates for queries on the layout or import time do not need to
+      // look at the partitions themselves.
+      if (const auto* count = caf::get_if<query::count>(&query.cmd);
+          count && count->mode == query::count::estimate && has_expression
+          && !has_ids)
+        self->state.count_from_metadata(query.expr, result);
+      return result;
     },
     [=](atom::status, status_verbosity v) {
       record result;
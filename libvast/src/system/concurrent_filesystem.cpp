@@ -0,0 +1,234 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vast/system/concurrent_filesystem.hpp"
+
+#include "vast/chunk.hpp"
+#include "vast/data.hpp"
+#include "vast/detail/assert.hpp"
+#include "vast/error.hpp"
+#include "vast/logger.hpp"
+#include "vast/system/posix_filesystem.hpp"
+#include "vast/system/status.hpp"
+
+#include <caf/typed_response_promise.hpp>
+
+#include <chrono>
+#include <type_traits>
+
+namespace vast::system {
+
+namespace {
+
+using concurrent_filesystem_actor
+  = filesystem_actor::stateful_pointer<concurrent_filesystem_state>;
+
+/// Runs a single operation on a worker of the given lane, and updates the
+/// statistics once the worker responds.
+/// @param check Whether the worker checks that the file exists first.
+/// @param bytes The number of bytes that a successful operation affects,
+/// unless the result is a chunk.
+/// @param filename The path that the operation affects.
+template <class Result, class... Ts>
+caf::typed_response_promise<Result>
+dispatch(concurrent_filesystem_actor self,
+         concurrent_filesystem_state::lane& lane,
+         concurrent_filesystem_state::priority priority,
+         filesystem_statistics::ops& ops, bool check, uint64_t bytes,
+         const std::filesystem::path& filename, Ts... xs) {
+  auto rp = self->make_response_promise<Result>();
+  auto start = std::chrono::steady_clock::now();
+  auto job = [=, &lane, &ops](filesystem_actor worker) mutable {
+    self->request(worker, caf::infinite, xs...)
+      .then(
+        [=, &lane, &ops](Result& result) mutable {
+          ops.latency.add(std::chrono::steady_clock::now() - start);
+          ++ops.successful;
+          if constexpr (std::is_same_v<Result, chunk_ptr>)
+            ops.bytes += result ? result->size() : 0;
+          else
+            ops.bytes += bytes;
+          if (check)
+            ++self->state.stats.checks.successful;
+          self->state.release(lane, worker, filename);
+          rp.deliver(std::move(result));
+        },
+        [=, &lane, &ops](caf::error& err) mutable {
+          ops.latency.add(std::chrono::steady_clock::now() - start);
+          if (check && err == ec::no_such_file) {
+            ++self->state.stats.checks.failed;
+          } else {
+            if (check)
+              ++self->state.stats.checks.successful;
+            ++ops.failed;
+          }
+          self->state.release(lane, worker, filename);
+          rp.deliver(std::move(err));
+        });
+  };
+  self->state.schedule(lane, priority, filename, std::move(job));
+  return rp;
+}
+
+record lane_status(const concurrent_filesystem_state::lane& lane) {
+  auto result = record{};
+  result["workers"] = count{lane.idle.size() + lane.busy};
+  result["busy"] = count{lane.busy};
+  result["queued-urgent"] = count{lane.urgent.size()};
+  result["queued-normal"] = count{lane.normal.size()};
+  auto blocked = size_t{0};
+  for (const auto& [_, jobs] : lane.blocked)
+    blocked += jobs.size();
+  result["blocked"] = count{blocked};
+  return result;
+}
+
+} // namespace
+
+namespace {
+
+/// Runs a job on an idle worker of the lane, or queues it until a worker
+/// becomes idle.
+void run_or_enqueue(concurrent_filesystem_state::lane& l,
+                    concurrent_filesystem_state::priority p,
+                    concurrent_filesystem_state::job f) {
+  if (!l.idle.empty()) {
+    auto worker = std::move(l.idle.back());
+    l.idle.pop_back();
+    ++l.busy;
+    f(std::move(worker));
+    return;
+  }
+  if (p == concurrent_filesystem_state::priority::urgent)
+    l.urgent.push_back(std::move(f));
+  else
+    l.normal.push_back(std::move(f));
+}
+
+} // namespace
+
+void concurrent_filesystem_state::schedule(lane& l, priority p,
+                                           const std::filesystem::path& path,
+                                           job f) {
+  if (l.exclusive) {
+    auto [it, inserted] = l.blocked.try_emplace(path);
+    if (!inserted) {
+      it->second.emplace_back(p, std::move(f));
+      return;
+    }
+  }
+  run_or_enqueue(l, p, std::move(f));
+}
+
+void concurrent_filesystem_state::release(lane& l, filesystem_actor worker,
+                                          const std::filesystem::path& path) {
+  VAST_ASSERT(l.busy > 0);
+  --l.busy;
+  if (l.exclusive) {
+    auto it = l.blocked.find(path);
+    VAST_ASSERT(it != l.blocked.end());
+    if (it->second.empty()) {
+      l.blocked.erase(it);
+    } else {
+      // The path stays blocked until the next job on it finishes as well.
+      auto [p, f] = std::move(it->second.front());
+      it->second.pop_front();
+      if (p == priority::urgent)
+        l.urgent.push_back(std::move(f));
+      else
+        l.normal.push_back(std::move(f));
+    }
+  }
+  auto& queue = l.urgent.empty() ? l.normal : l.urgent;
+  if (queue.empty()) {
+    l.idle.push_back(std::move(worker));
+    return;
+  }
+  auto f = std::move(queue.front());
+  queue.pop_front();
+  ++l.busy;
+  f(std::move(worker));
+}
+
+filesystem_actor::behavior_type concurrent_filesystem(
+  filesystem_actor::stateful_pointer<concurrent_filesystem_state> self,
+  const std::filesystem::path& root, size_t read_workers,
+  size_t write_workers) {
+  VAST_ASSERT(read_workers > 0 && write_workers > 0);
+  self->state.root = root;
+  // The workers block on the filesystem, so each of them needs its own
+  // thread. They go down together with this actor.
+  auto spawn_workers = [&](concurrent_filesystem_state::lane& lane, size_t n) {
+    for (size_t i = 0; i < n; ++i)
+      lane.idle.push_back(
+        self->spawn<caf::detached + caf::linked>(posix_filesystem, root));
+  };
+  spawn_workers(self->state.read_lane, read_workers);
+  spawn_workers(self->state.write_lane, write_workers);
+  // Writes to the same path must not race, e.g., on the temporary file that
+  // atomic writes use, and must finish in order.
+  self->state.write_lane.exclusive = true;
+  VAST_VERBOSE("{} uses {} workers for reads and {} workers for writes", *self,
+               read_workers, write_workers);
+  using priority = concurrent_filesystem_state::priority;
+  return {
+    [self](atom::write, const std::filesystem::path& filename,
+           const chunk_ptr& chk) -> caf::result<atom::ok> {
+      if (chk == nullptr)
+        return caf::make_error(ec::logic_error, "tried to write a nullptr to "
+                                                "disk");
+      return dispatch<atom::ok>(self, self->state.write_lane, priority::urgent,
+                                self->state.stats.writes, false, chk->size(),
+                                filename, atom::write_v, filename, chk);
+    },
+    [self](atom::write, const std::filesystem::path& filename,
+           uint64_t offset, const chunk_ptr& chk) -> caf::result<atom::ok> {
+      if (chk == nullptr)
+        return caf::make_error(ec::logic_error, "tried to write a nullptr to "
+                                                "disk");
+      return dispatch<atom::ok>(self, self->state.write_lane, priority::urgent,
+                                self->state.stats.writes, false, chk->size(),
+                                filename, atom::write_v, filename, offset,
+                                chk);
+    },
+    [self](atom::read,
+           const std::filesystem::path& filename) -> caf::result<chunk_ptr> {
+      return dispatch<chunk_ptr>(self, self->state.read_lane, priority::normal,
+                                 self->state.stats.reads, true, 0, filename,
+                                 atom::read_v, filename);
+    },
+    [self](atom::mmap,
+           const std::filesystem::path& filename) -> caf::result<chunk_ptr> {
+      return dispatch<chunk_ptr>(self, self->state.read_lane, priority::urgent,
+                                 self->state.stats.mmaps, true, 0, filename,
+                                 atom::mmap_v, filename);
+    },
+    [self](atom::erase,
+           const std::filesystem::path& filename) -> caf::result<atom::done> {
+      // Only the workers know the size of erased files, so the erased bytes
+      // are not part of the statistics here.
+      return dispatch<atom::done>(self, self->state.write_lane,
+                                  priority::normal, self->state.stats.erases,
+                                  true, 0, filename, atom::erase_v, filename);
+    },
+    [self](atom::status, status_verbosity v) {
+      auto result = record{};
+      if (v >= status_verbosity::info)
+        result["type"] = "POSIX";
+      if (v >= status_verbosity::detailed) {
+        result["read-lane"] = lane_status(self->state.read_lane);
+        result["write-lane"] = lane_status(self->state.write_lane);
+      }
+      if (v >= status_verbosity::debug)
+        result["operations"] = to_record(self->state.stats, v);
+      return result;
+    },
+  };
+}
+
+} // namespace vast::system
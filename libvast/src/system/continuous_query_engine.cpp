@@ -0,0 +1,281 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vast/system/continuous_query_engine.hpp"
+
+#include "vast/fwd.hpp"
+
+#include "vast/bitmap_algorithms.hpp"
+#include "vast/concept/printable/to_string.hpp"
+#include "vast/concept/printable/vast/expression.hpp"
+#include "vast/defaults.hpp"
+#include "vast/detail/fill_status_map.hpp"
+#include "vast/detail/overload.hpp"
+#include "vast/detail/shutdown_stream_stage.hpp"
+#include "vast/expression_visitors.hpp"
+#include "vast/ids.hpp"
+#include "vast/logger.hpp"
+#include "vast/system/report.hpp"
+#include "vast/system/status.hpp"
+#include "vast/table_slice.hpp"
+
+#include <caf/attach_continuous_stream_stage.hpp>
+
+#include <algorithm>
+#include <map>
+
+namespace vast::system {
+
+namespace {
+
+/// The result of a predicate for the rows of a table slice that were checked
+/// so far.
+struct predicate_result {
+  /// The rows that the predicate was evaluated for.
+  ids checked = {};
+
+  /// The checked rows for which the predicate yields true.
+  ids hits = {};
+};
+
+/// Evaluates a tailored expression for the candidate rows of a table slice.
+/// Connectives narrow down the candidates for their operands, so predicates
+/// are only evaluated for rows that may still affect the result.
+/// @param expr The tailored expression.
+/// @param slice The table slice to evaluate *expr* on.
+/// @param candidates The IDs of the rows to consider.
+/// @param cache The predicate results, shared between all queries.
+/// @returns The subset of *candidates* for which *expr* yields true.
+ids evaluate_candidates(const expression& expr, const table_slice& slice,
+                        const ids& candidates,
+                        std::map<predicate, predicate_result>& cache) {
+  auto f = detail::overload{
+    [&](caf::none_t) {
+      return ids{};
+    },
+    [&](const conjunction& xs) {
+      auto result = candidates;
+      for (const auto& x : xs) {
+        if (all<0>(result))
+          break;
+        result = evaluate_candidates(x, slice, result, cache);
+      }
+      return result;
+    },
+    [&](const disjunction& xs) {
+      auto result = ids{};
+      auto remaining = candidates;
+      for (const auto& x : xs) {
+        if (all<0>(remaining))
+          break;
+        auto hits = evaluate_candidates(x, slice, remaining, cache);
+        remaining -= hits;
+        result |= hits;
+      }
+      return result;
+    },
+    [&](const negation& x) {
+      return candidates
+             - evaluate_candidates(x.expr(), slice, candidates, cache);
+    },
+    [&](const predicate& x) {
+      auto& entry = cache[x];
+      auto unchecked = candidates - entry.checked;
+      if (any(unchecked)) {
+        entry.hits |= evaluate(expression{x}, slice, unchecked);
+        entry.checked |= unchecked;
+      }
+      return entry.hits & candidates;
+    },
+  };
+  return caf::visit(f, expr);
+}
+
+} // namespace
+
+void continuous_query_engine_state::subscribe(
+  expression expr, continuous_query_subscriber_actor subscriber) {
+  VAST_DEBUG("{} adds continuous query {} for {}", *self, expr, subscriber);
+  self->monitor(subscriber);
+  auto slot = stage->add_outbound_path(
+    static_cast<stream_sink_actor<table_slice, atom::subscribe>>(subscriber),
+    std::make_tuple(atom::subscribe_v));
+  queries.push_back(continuous_query{
+    .expr = std::move(expr),
+    .subscriber = std::move(subscriber),
+    .slot = slot,
+  });
+}
+
+void continuous_query_engine_state::handle_slice(const table_slice& slice) {
+  if (queries.empty() || slice.rows() == 0)
+    return;
+  auto t = timer::start(measurement_);
+  const auto& layout = slice.layout();
+  const auto mask = make_ids(slice);
+  auto& paths = stage->out().states();
+  auto cache = std::map<predicate, predicate_result>{};
+  for (auto& query : queries) {
+    // Tailor the query to the layout of the slice once.
+    auto it = query.checkers.find(layout);
+    if (it == query.checkers.end()) {
+      auto tailored = tailor(query.expr, layout);
+      if (!tailored) {
+        // The query refers to fields that do not exist in this layout.
+        VAST_TRACE("{} skips {} for layout {}: {}", *self, query.expr, layout,
+                   tailored.error());
+        tailored = expression{};
+      }
+      it = query.checkers.emplace(layout, std::move(*tailored)).first;
+    }
+    predicates += caf::visit(predicatizer{}, it->second).size();
+    query.checked += slice.rows();
+    auto selection = evaluate_candidates(it->second, slice, mask, cache);
+    auto selection_size = rank(selection);
+    if (selection_size == 0)
+      continue;
+    query.events += selection_size;
+    query.total_events += selection_size;
+    // Bypass the central buffer of the stage and push directly into the
+    // buffer of the subscriber's outbound path. The stage only grants new
+    // credit upstream when the fullest path buffer drains.
+    auto path = paths.find(query.slot);
+    if (path == paths.end())
+      continue;
+    auto& buf = path->second.buf;
+    if (selection_size == slice.rows()) {
+      buf.push_back(slice);
+      continue;
+    }
+    for (auto& result : select(slice, selection))
+      buf.push_back(std::move(result));
+  }
+  evaluated_predicates += cache.size();
+  t.stop(slice.rows());
+}
+
+void continuous_query_engine_state::send_progress() {
+  for (auto& query : queries)
+    if (query.checked > 0)
+      self->send(query.subscriber, atom::update_v,
+                 std::exchange(query.checked, 0));
+}
+
+void continuous_query_engine_state::send_report() {
+  if (!accountant)
+    return;
+  auto r = report{};
+  r.data.push_back({"continuous-query-engine.subscribers",
+                    static_cast<uint64_t>(queries.size())});
+  auto events = uint64_t{0};
+  for (auto& query : queries)
+    events += std::exchange(query.events, 0);
+  r.data.push_back({"continuous-query-engine.events", events});
+  r.data.push_back({"continuous-query-engine.predicates",
+                    std::exchange(predicates, 0)});
+  r.data.push_back({"continuous-query-engine.evaluated-predicates",
+                    std::exchange(evaluated_predicates, 0)});
+  self->send(accountant, std::move(r));
+  if (measurement_.events > 0) {
+    auto pr = performance_report{
+      .data = {{{"continuous-query-engine", std::exchange(measurement_, {})}}},
+    };
+    self->send(accountant, std::move(pr));
+  }
+}
+
+record continuous_query_engine_state::status(status_verbosity v) const {
+  auto result = record{};
+  result["subscribers"] = count{queries.size()};
+  if (v >= status_verbosity::detailed) {
+    auto xs = list{};
+    xs.reserve(queries.size());
+    for (const auto& query : queries) {
+      auto x = record{};
+      x["expression"] = to_string(query.expr);
+      x["events"] = count{query.total_events};
+      xs.push_back(std::move(x));
+    }
+    result["queries"] = std::move(xs);
+  }
+  if (v >= status_verbosity::debug)
+    detail::fill_status_map(result, self);
+  return result;
+}
+
+continuous_query_engine_actor::behavior_type continuous_query_engine(
+  continuous_query_engine_actor::stateful_pointer<continuous_query_engine_state>
+    self) {
+  self->state.self = self;
+  self->state.stage = caf::attach_continuous_stream_stage(
+    self,
+    [](caf::unit_t&) {
+      // nop
+    },
+    [self](caf::unit_t&, caf::downstream<table_slice>&, table_slice slice) {
+      self->state.handle_slice(slice);
+    },
+    [](caf::unit_t&, const caf::error&) {
+      // nop
+    },
+    caf::policy::arg<caf::broadcast_downstream_manager<table_slice>>{});
+  self->set_exit_handler([self](const caf::exit_msg& msg) {
+    VAST_DEBUG("{} got EXIT from {}", *self, msg.source);
+    detail::shutdown_stream_stage(self->state.stage);
+    self->state.send_progress();
+    self->state.send_report();
+    self->quit(msg.reason);
+  });
+  self->set_down_handler([self](const caf::down_msg& msg) {
+    auto& queries = self->state.queries;
+    auto is_source = [&](const continuous_query& query) {
+      return query.subscriber.address() == msg.source;
+    };
+    auto it = std::remove_if(queries.begin(), queries.end(), is_source);
+    VAST_DEBUG("{} removes {} continuous queries of {}", *self,
+               std::distance(it, queries.end()), msg.source);
+    queries.erase(it, queries.end());
+  });
+  // The telemetry loop also keeps the subscribers informed about the number of
+  // events checked against their queries, so it runs with or without an
+  // ACCOUNTANT.
+  self->delayed_send(self, defaults::system::telemetry_rate,
+                     atom::telemetry_v);
+  return {
+    // Register the ACCOUNTANT actor.
+    [self](accountant_actor accountant) {
+      VAST_DEBUG("{} registers accountant {}", *self, accountant);
+      self->state.accountant = std::move(accountant);
+      self->send(self->state.accountant, atom::announce_v, self->name());
+    },
+    // Register a continuous query.
+    [self](atom::subscribe, expression& expr,
+           continuous_query_subscriber_actor& subscriber) {
+      self->state.subscribe(std::move(expr), std::move(subscriber));
+    },
+    // The internal telemetry loop of the CONTINUOUS QUERY ENGINE.
+    [self](atom::telemetry) {
+      self->state.send_progress();
+      self->state.send_report();
+      self->delayed_send(self, defaults::system::telemetry_rate,
+                         atom::telemetry_v);
+    },
+    // -- stream_sink_actor<table_slice> ---------------------------------------
+    [self](
+      caf::stream<table_slice> in) -> caf::inbound_stream_slot<table_slice> {
+      VAST_DEBUG("{} attaches to the importer stream", *self);
+      return self->state.stage->add_inbound_path(in);
+    },
+    // -- status_client_actor --------------------------------------------------
+    [self](atom::status, status_verbosity v) {
+      return self->state.status(v);
+    },
+  };
+}
+
+} // namespace vast::system
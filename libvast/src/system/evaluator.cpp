@@ -10,6 +10,10 @@
 
 #include "vast/fwd.hpp"
 
+#include "vast/bitmap_algorithms.hpp"
+#include "vast/concept/printable/to_string.hpp"
+#include "vast/concept/printable/vast/expression.hpp"
+#include "vast/detail/overload.hpp"
 #include "vast/expression_visitors.hpp"
 #include "vast/logger.hpp"
 #include "vast/table_slice.hpp"
@@ -18,72 +22,256 @@
 #include <caf/event_based_actor.hpp>
 #include <caf/stateful_actor.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <optional>
+
 namespace vast::system {
 
 namespace {
 
-/// Concatenates IDs according to given predicates. In paticular, resolves
-/// conjunctions, disjunctions, and negations.
-class ids_evaluator {
-public:
-  ids_evaluator(const evaluator_state::predicate_hits_map& xs) : hits_(xs) {
-    push();
-  }
-
-  ids operator()(caf::none_t) {
-    return {};
-  }
+/// Predicates in the same stage have a priority of at most this factor times
+/// the priority of the cheapest predicate in the stage.
+constexpr double stage_factor = 2.0;
 
-  template <class Connective>
-  ids operator()(const Connective& xs) {
-    VAST_ASSERT(xs.size() > 0);
-    push();
-    auto result = caf::visit(*this, xs[0]);
-    for (size_t index = 1; index < xs.size(); ++index) {
-      next();
-      if constexpr (std::is_same_v<Connective, conjunction>) {
-        result &= caf::visit(*this, xs[index]);
-      } else {
-        static_assert(std::is_same_v<Connective, disjunction>);
-        result |= caf::visit(*this, xs[index]);
+/// Computes the result of a subexpression if it is already known. This is
+/// the case if all of its predicates were evaluated, or if a conjunction has
+/// an operand without any hits.
+/// @param expr The subexpression.
+/// @param position The position of the subexpression in the whole expression.
+/// @param hits The hits of the evaluated predicates.
+std::optional<ids>
+known_result(const expression& expr, offset& position,
+             const evaluator_state::predicate_hits_map& hits) {
+  auto f = detail::overload{
+    [](caf::none_t) -> std::optional<ids> {
+      return ids{};
+    },
+    [&](const conjunction& xs) -> std::optional<ids> {
+      auto result = std::optional<ids>{};
+      auto complete = true;
+      position.emplace_back(0);
+      for (const auto& x : xs) {
+        auto operand = known_result(x, position, hits);
+        ++position.back();
+        if (!operand) {
+          complete = false;
+          continue;
+        }
+        if (all<0>(*operand)) {
+          position.pop_back();
+          return operand;
+        }
+        if (result)
+          *result &= *operand;
+        else
+          result = std::move(operand);
+      }
+      position.pop_back();
+      return complete ? result : std::nullopt;
+    },
+    [&](const disjunction& xs) -> std::optional<ids> {
+      auto result = ids{};
+      position.emplace_back(0);
+      for (const auto& x : xs) {
+        auto operand = known_result(x, position, hits);
+        ++position.back();
+        if (!operand) {
+          position.pop_back();
+          return std::nullopt;
+        }
+        result |= *operand;
       }
+      position.pop_back();
+      return result;
+    },
+    [&](const negation& n) -> std::optional<ids> {
+      position.emplace_back(0);
+      auto result = known_result(n.expr(), position, hits);
+      position.pop_back();
+      if (result)
+        result->flip();
+      return result;
+    },
+    [&](const predicate&) -> std::optional<ids> {
+      auto i = hits.find(position);
+      // Predicates without an INDEXER have no hits.
+      if (i == hits.end())
+        return ids{};
+      if (i->second.first > 0)
+        return std::nullopt;
+      return i->second.second;
+    },
+  };
+  return caf::visit(f, expr);
+}
+
+/// Collects the positions of all predicates in a subexpression whose result
+/// is already known, or recurses into the operands otherwise.
+void collect_unneeded(const expression& expr, offset& position,
+                      const evaluator_state::predicate_hits_map& hits,
+                      std::set<offset>& result) {
+  if (known_result(expr, position, hits)) {
+    for (auto i = hits.lower_bound(position); i != hits.end(); ++i) {
+      if (!std::equal(position.begin(), position.end(), i->first.begin(),
+                      i->first.begin()
+                        + std::min(position.size(), i->first.size())))
+        break;
+      if (i->second.first > 0)
+        result.insert(i->first);
     }
-    pop();
-    return result;
+    return;
   }
+  auto f = detail::overload{
+    [&](const auto& xs) {
+      if constexpr (std::is_same_v<std::decay_t<decltype(xs)>, conjunction>
+                    || std::is_same_v<std::decay_t<decltype(xs)>,
+                                      disjunction>) {
+        position.emplace_back(0);
+        for (const auto& x : xs) {
+          collect_unneeded(x, position, hits, result);
+          ++position.back();
+        }
+        position.pop_back();
+      }
+    },
+    [&](const negation& n) {
+      position.emplace_back(0);
+      collect_unneeded(n.expr(), position, hits, result);
+      position.pop_back();
+    },
+  };
+  caf::visit(f, expr);
+}
 
-  ids operator()(const negation& n) {
-    push();
-    auto result = caf::visit(*this, n.expr());
-    pop();
-    result.flip();
-    return result;
+/// Computes the positions at which the predicate at `target` can still affect
+/// the result of the expression. Outside of these positions, a conjunction
+/// that encloses the predicate has an operand without hits, so the result of
+/// the predicate does not matter there.
+/// @param expr The whole expression.
+/// @param target The position of the predicate.
+/// @param hits The hits of the evaluated predicates.
+/// @returns The relevant positions or `std::nullopt` if they are unknown.
+std::optional<ids>
+relevant_positions(const expression& expr, const offset& target,
+                   const evaluator_state::predicate_hits_map& hits) {
+  auto result = std::optional<ids>{};
+  auto position = offset{};
+  const auto* node = &expr;
+  for (auto index : target) {
+    if (const auto* xs = caf::get_if<conjunction>(node)) {
+      position.emplace_back(0);
+      for (const auto& x : *xs) {
+        if (position.back() != index) {
+          if (auto operand = known_result(x, position, hits)) {
+            if (result)
+              *result &= *operand;
+            else
+              result = std::move(operand);
+          }
+        }
+        ++position.back();
+      }
+      position.back() = index;
+      node = &(*xs)[index];
+    } else if (const auto* xs = caf::get_if<disjunction>(node)) {
+      position.emplace_back(index);
+      node = &(*xs)[index];
+    } else if (const auto* n = caf::get_if<negation>(node)) {
+      position.emplace_back(index);
+      node = &n->expr();
+    } else {
+      break;
+    }
   }
+  return result;
+}
 
-  ids operator()(const predicate&) {
-    auto i = hits_.find(position_);
-    return i != hits_.end() ? i->second.second : ids{};
+/// Checks whether a conjunction encloses the predicate at `target`. Only the
+/// other operands of an enclosing conjunction can make a predicate unneeded or
+/// narrow down the positions it needs to look at, so deferring a predicate
+/// without one to a later stage only costs an extra round trip.
+/// @param expr The whole expression.
+/// @param target The position of the predicate.
+bool has_enclosing_conjunction(const expression& expr, const offset& target) {
+  const auto* node = &expr;
+  for (auto index : target) {
+    if (caf::get_if<conjunction>(node))
+      return true;
+    if (const auto* xs = caf::get_if<disjunction>(node))
+      node = &(*xs)[index];
+    else if (const auto* n = caf::get_if<negation>(node))
+      node = &n->expr();
+    else
+      break;
   }
+  return false;
+}
 
-private:
-  void push() {
-    position_.emplace_back(0);
-  }
+} // namespace
 
-  void pop() {
-    position_.pop_back();
-  }
+double estimate_cost(const curried_predicate& pred) {
+  auto f = detail::overload{
+    [&](const std::string& x) {
+      switch (pred.op) {
+        case relational_operator::equal:
+        case relational_operator::not_equal:
+          return 4.0;
+        default:
+          // Substring searches need to look at every character position.
+          return 32.0 + static_cast<double>(x.size());
+      }
+    },
+    [](const pattern&) {
+      return 64.0;
+    },
+    [](const address&) {
+      return 2.0;
+    },
+    [](const subnet&) {
+      return 2.0;
+    },
+    [&](const list& xs) {
+      // Membership tests look up every element.
+      return std::accumulate(xs.begin(), xs.end(), 0.0,
+                             [&](double acc, const data& x) {
+                               return acc
+                                      + estimate_cost(curried_predicate{
+                                        relational_operator::equal, x});
+                             });
+    },
+    [&](const auto&) {
+      switch (pred.op) {
+        case relational_operator::equal:
+        case relational_operator::not_equal:
+          return 1.0;
+        default:
+          return 2.0;
+      }
+    },
+  };
+  return std::max(caf::visit(f, pred.rhs), 1.0);
+}
 
-  void next() {
-    VAST_ASSERT(!position_.empty());
-    ++position_.back();
+double estimate_selectivity(const curried_predicate& pred) {
+  if (is_negated(pred.op))
+    return 1.0
+           - estimate_selectivity(curried_predicate{negate(pred.op), pred.rhs});
+  switch (pred.op) {
+    case relational_operator::equal:
+      return 0.1;
+    case relational_operator::in:
+      if (const auto* xs = caf::get_if<list>(&pred.rhs))
+        return std::clamp(0.1 * static_cast<double>(xs->size()), 0.1, 0.9);
+      return 0.3;
+    case relational_operator::ni:
+    case relational_operator::match:
+      return 0.3;
+    default:
+      return 0.5;
   }
-
-  const evaluator_state::predicate_hits_map& hits_;
-  offset position_;
-};
-
-} // namespace
+}
 
 evaluator_state::evaluator_state(
   evaluator_actor::stateful_pointer<evaluator_state> self)
@@ -98,10 +286,8 @@ void evaluator_state::handle_result(const offset& position, const ids& result) {
   VAST_ASSERT(ptr != nullptr);
   auto& [missing, accumulated_hits] = *ptr;
   accumulated_hits |= result;
-  if (--missing == 0) {
+  if (--missing == 0)
     VAST_DEBUG("{} collected all results at position {}", *self, position);
-    evaluate();
-  }
   decrement_pending();
 }
 
@@ -112,28 +298,115 @@ void evaluator_state::handle_missing_result(
             *self, render(err), position);
   auto ptr = hits_for(position);
   VAST_ASSERT(ptr != nullptr);
-  if (--ptr->first == 0) {
+  if (--ptr->first == 0)
     VAST_DEBUG("{} collected all results at position {}", *self, position);
-    evaluate();
-  }
   decrement_pending();
 }
 
 void evaluator_state::evaluate() {
-  auto expr_hits = caf::visit(ids_evaluator{predicate_hits}, expr);
+  // All predicates that were not skipped have their results at this point,
+  // so the result of the expression is known.
+  auto position = offset{};
+  auto result = known_result(expr, position, predicate_hits);
+  VAST_ASSERT(result);
+  hits = result ? std::move(*result) : ids{};
   VAST_DEBUG("{} got predicate_hits: {} expr_hits: {}", *self, predicate_hits,
-             expr_hits);
-  hits |= expr_hits;
+             hits);
 }
 
 void evaluator_state::decrement_pending() {
+  if (--pending_responses > 0)
+    return;
+  if (run_next_stage())
+    return;
   // We're done evaluating if all INDEXER actors have reported their hits.
-  if (--pending_responses == 0) {
-    // Now we ask the store for the actual data.
-    // TODO: handle count estimate requests.
-    promise.deliver(hits);
-    self->quit();
+  evaluate();
+  // Now we ask the store for the actual data.
+  // TODO: handle count estimate requests.
+  promise.deliver(hits);
+  self->quit();
+}
+
+void evaluator_state::skip_unneeded_predicates() {
+  auto position = offset{};
+  auto unneeded = std::set<offset>{};
+  collect_unneeded(expr, position, predicate_hits, unneeded);
+  for (const auto& x : unneeded)
+    if (skipped.insert(x).second)
+      VAST_DEBUG("{} skips predicate at position {}", *self, x);
+}
+
+bool evaluator_state::run_next_stage() {
+  if (next < schedule.size())
+    skip_unneeded_predicates();
+  auto is_skipped = [&](size_t i) {
+    return skipped.contains(std::get<0>(eval[i]));
+  };
+  while (next < schedule.size() && is_skipped(schedule[next]))
+    ++next;
+  if (next == schedule.size())
+    return false;
+  // The schedule starts with the predicates that cannot be deferred, so the
+  // first stage contains all of them. The limit for the remaining predicates
+  // depends on the cheapest deferrable one.
+  auto limit = std::optional<double>{};
+  auto stage = std::vector<size_t>{};
+  for (; next < schedule.size(); ++next) {
+    const auto i = schedule[next];
+    if (is_skipped(i))
+      continue;
+    if (deferrable[i]) {
+      if (!limit)
+        limit = priorities[i] * stage_factor;
+      if (priorities[i] > *limit)
+        break;
+    }
+    stage.push_back(i);
+  }
+  VAST_DEBUG("{} evaluates {} predicates in stage {}", *self, stage.size(),
+             stages++);
+  pending_responses += stage.size();
+  for (auto i : stage) {
+    const auto& [pos, curried_pred, indexer] = eval[i];
+    auto selection = relevant_positions(expr, pos, predicate_hits);
+    auto candidates = selection ? std::optional{rank(*selection)}
+                                : std::optional<uint64_t>{};
+    auto on_result = [this, pos = pos, candidates,
+                      start = std::chrono::steady_clock::now()](
+                       const ids& hits) {
+      if (tracer) {
+        duration runtime = std::chrono::steady_clock::now() - start;
+        auto values = record{{"hits", count{rank(hits)}}};
+        if (const auto* pred = at(expr, pos))
+          values["predicate"] = to_string(*pred);
+        if (candidates)
+          values["candidates"] = count{*candidates};
+        self->send(tracer, query_span{
+                             .partition = partition,
+                             .name = "predicate",
+                             .runtime = runtime,
+                             .values = std::move(values),
+                           });
+      }
+      handle_result(pos, hits);
+    };
+    auto on_error = [this, pos = pos](const caf::error& err) {
+      handle_missing_result(pos, err);
+    };
+    // Let the INDEXER only look at the positions where the predicate can
+    // still affect the result, if the previous stages narrowed them down.
+    if (selection) {
+      VAST_DEBUG("{} restricts predicate at position {} to {} candidates",
+                 *self, pos, *candidates);
+      self
+        ->request(indexer, caf::infinite, curried_pred, std::move(*selection))
+        .then(on_result, on_error);
+    } else {
+      self->request(indexer, caf::infinite, curried_pred)
+        .then(on_result, on_error);
+    }
   }
+  return true;
 }
 
 evaluator_state::predicate_hits_map::mapped_type*
@@ -144,33 +417,45 @@ evaluator_state::hits_for(const offset& position) {
 
 evaluator_actor::behavior_type
 evaluator(evaluator_actor::stateful_pointer<evaluator_state> self,
-          expression expr, std::vector<evaluation_triple> eval) {
+          expression expr, std::vector<evaluation_triple> eval,
+          receiver_actor<query_span> tracer, uuid partition) {
   VAST_TRACE_SCOPE("{} {}", VAST_ARG(expr), caf::deep_to_string(eval));
   VAST_ASSERT(!eval.empty());
   self->state.expr = std::move(expr);
   self->state.eval = std::move(eval);
+  self->state.tracer = std::move(tracer);
+  self->state.partition = partition;
   return {
     [self](atom::run) {
-      self->state.promise = self->make_response_promise<ids>();
-      self->state.pending_responses += self->state.eval.size();
-      for (auto& triple : self->state.eval) {
-        // No strucutured bindings available due to subsequent lambda. :-/
-        // TODO: C++20
-        auto& pos = std::get<0>(triple);
-        auto& curried_pred = std::get<1>(triple);
-        auto& indexer = std::get<2>(triple);
-        ++self->state.predicate_hits[pos].first;
-        self->request(indexer, caf::infinite, curried_pred)
-          .then([=](const ids& hits) { self->state.handle_result(pos, hits); },
-                [=](const caf::error& err) {
-                  self->state.handle_missing_result(pos, err);
-                });
+      auto& st = self->state;
+      st.promise = self->make_response_promise<ids>();
+      // Plan the evaluation: predicates that are cheap to look up and likely
+      // to rule out many rows go first.
+      st.priorities.reserve(st.eval.size());
+      st.deferrable.reserve(st.eval.size());
+      for (const auto& [pos, curried_pred, _] : st.eval) {
+        ++st.predicate_hits[pos].first;
+        st.priorities.push_back(estimate_cost(curried_pred)
+                                / (1.0 - estimate_selectivity(curried_pred)));
+        st.deferrable.push_back(has_enclosing_conjunction(st.expr, pos));
       }
-      if (self->state.pending_responses == 0) {
+      st.schedule.resize(st.eval.size());
+      std::iota(st.schedule.begin(), st.schedule.end(), size_t{0});
+      std::stable_sort(st.schedule.begin(), st.schedule.end(),
+                       [&](size_t lhs, size_t rhs) {
+                         return st.priorities[lhs] < st.priorities[rhs];
+                       });
+      // Predicates without an enclosing conjunction go out in the first
+      // stage, since waiting for other predicates cannot help them.
+      std::stable_partition(st.schedule.begin(), st.schedule.end(),
+                            [&](size_t i) {
+                              return !st.deferrable[i];
+                            });
+      if (!st.run_next_stage()) {
         VAST_DEBUG("{} has nothing to evaluate for expression", *self);
-        self->state.promise.deliver(ids{});
+        st.promise.deliver(ids{});
       }
-      return self->state.promise;
+      return st.promise;
     },
   };
 }
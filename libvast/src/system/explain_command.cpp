@@ -0,0 +1,127 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2022 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vast/system/explain_command.hpp"
+
+#include "vast/fwd.hpp"
+
+#include "vast/data.hpp"
+#include "vast/defaults.hpp"
+#include "vast/error.hpp"
+#include "vast/logger.hpp"
+#include "vast/scope_linked.hpp"
+#include "vast/system/read_query.hpp"
+#include "vast/system/signal_monitor.hpp"
+#include "vast/system/spawn_or_connect_to_node.hpp"
+#include "vast/table_slice.hpp"
+
+#include <caf/actor.hpp>
+#include <caf/scoped_actor.hpp>
+#include <caf/settings.hpp>
+
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <thread>
+
+namespace vast::system {
+
+caf::message explain_command(const invocation& inv, caf::actor_system& sys) {
+  VAST_DEBUG("{}", inv);
+  const auto& options = inv.options;
+  // Read query from input file, STDIN or CLI arguments.
+  auto query = read_query(inv, "vast.explain.read", must_provide_query::yes);
+  if (!query)
+    return caf::make_message(std::move(query.error()));
+  // Get a convenient and blocking way to interact with actors.
+  caf::scoped_actor self{sys};
+  // Get VAST node.
+  auto node_opt
+    = system::spawn_or_connect_to_node(self, options, content(sys.config()));
+  if (auto err = std::get_if<caf::error>(&node_opt))
+    return caf::make_message(std::move(*err));
+  const auto& node = std::holds_alternative<node_actor>(node_opt)
+                       ? std::get<node_actor>(node_opt)
+                       : std::get<scope_linked<node_actor>>(node_opt).get();
+  VAST_ASSERT(node != nullptr);
+  // Start signal monitor.
+  std::thread sig_mon_thread;
+  auto guard = system::signal_monitor::run_guarded(
+    sig_mon_thread, sys, defaults::system::signal_monitoring_interval, self);
+  // Spawn an EXPORTER that traces the query at the node. The exporter sends
+  // the summary of the trace to its trace subscriber right before it
+  // terminates.
+  auto exporter_options = options;
+  caf::put(exporter_options, "vast.export.trace", true);
+  caf::put(exporter_options, "vast.export.max-events",
+           caf::get_or(options, "vast.explain.max-events",
+                       defaults::export_::max_events));
+  auto args = invocation{std::move(exporter_options), "spawn exporter",
+                         {*query}};
+  VAST_DEBUG("{} spawns exporter with parameters: {}",
+             detail::pretty_type_name(inv.full_name), query);
+  caf::actor exporter;
+  caf::error err;
+  self->request(node, caf::infinite, atom::spawn_v, std::move(args))
+    .receive(
+      [&](caf::actor actor) {
+        exporter = std::move(actor);
+        if (!exporter)
+          err = caf::make_error(ec::invalid_result, //
+                                "remote spawn returned nullptr");
+      },
+      [&](caf::error e) { //
+        err = std::move(e);
+      });
+  if (err)
+    return caf::make_message(std::move(err));
+  self->monitor(exporter);
+  self->send(exporter, atom::sink_v, caf::actor_cast<caf::actor>(self));
+  self->send(exporter, atom::trace_v, caf::actor_cast<caf::actor>(self));
+  self->send(exporter, atom::run_v);
+  auto running = true;
+  auto events = uint64_t{0};
+  auto trace = std::optional<record>{};
+  self->receive_while(running)(
+    [&](table_slice& slice) {
+      events += slice.rows();
+    },
+    [&](atom::trace, record& summary) {
+      trace = std::move(summary);
+    },
+    [&](atom::signal, int signal) {
+      VAST_DEBUG("{} got {}", detail::pretty_type_name(inv.full_name),
+                 ::strsignal(signal));
+      // Stopping the exporter gracefully makes it report the partial trace.
+      if (signal == SIGINT || signal == SIGTERM)
+        self->send_exit(exporter, caf::exit_reason::user_shutdown);
+    },
+    [&](const caf::down_msg& msg) {
+      if (msg.source != exporter)
+        return;
+      if (msg.reason && msg.reason != caf::exit_reason::user_shutdown)
+        err = msg.reason;
+      running = false;
+    });
+  if (err)
+    return caf::make_message(std::move(err));
+  if (!trace)
+    return caf::make_message(caf::make_error(
+      ec::lookup_error, "exporter terminated without reporting a trace"));
+  (*trace)["events"] = count{events};
+  auto output = caf::get_or(options, "vast.explain.yaml", false)
+                  ? to_yaml(data{std::move(*trace)})
+                  : to_json(data{std::move(*trace)});
+  if (!output)
+    return caf::make_message(std::move(output.error()));
+  std::cout << *output << std::endl;
+  return caf::none;
+}
+
+} // namespace vast::system
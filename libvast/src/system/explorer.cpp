@@ -30,12 +30,98 @@
 #include <caf/settings.hpp>
 
 #include <algorithm>
+#include <limits>
 #include <optional>
+#include <unordered_map>
+#include <vector>
 
 using namespace std::chrono_literals;
 
 namespace vast::system {
 
+namespace {
+
+/// A time window around one or more results of the initial query.
+struct time_box {
+  vast::time first;
+  vast::time last;
+  uint64_t results;
+};
+
+/// Merges overlapping time windows.
+std::vector<time_box> coalesce(std::vector<time_box> xs) {
+  auto by_start = [](const time_box& lhs, const time_box& rhs) {
+    return lhs.first < rhs.first;
+  };
+  std::sort(xs.begin(), xs.end(), by_start);
+  auto result = std::vector<time_box>{};
+  for (const auto& x : xs) {
+    if (!result.empty() && x.first <= result.back().last) {
+      result.back().last = std::max(result.back().last, x.last);
+      result.back().results += x.results;
+    } else {
+      result.push_back(x);
+    }
+  }
+  return result;
+}
+
+/// Builds the query for a time window.
+expression make_window_expression(const explorer_state& st, vast::time first,
+                                  vast::time last, const data& key) {
+  const auto timestamp_type = type{"timestamp", time_type{}};
+  auto result = conjunction{};
+  if (st.before)
+    result.emplace_back(predicate{type_extractor{timestamp_type},
+                                  relational_operator::greater_equal,
+                                  data{first}});
+  if (st.after)
+    result.emplace_back(predicate{type_extractor{timestamp_type},
+                                  relational_operator::less_equal,
+                                  data{last}});
+  if (st.by)
+    result.emplace_back(
+      predicate{field_extractor{*st.by}, relational_operator::equal, key});
+  VAST_ASSERT(!result.empty());
+  if (result.size() == 1)
+    return std::move(result[0]);
+  return result;
+}
+
+} // namespace
+
+std::vector<time_window_set::window>
+time_window_set::add(vast::time first, vast::time last) {
+  VAST_ASSERT(first <= last);
+  auto result = std::vector<window>{};
+  // Find the first interval that overlaps with [first, last].
+  auto it = windows_.upper_bound(first);
+  if (it != windows_.begin() && std::prev(it)->second >= first)
+    --it;
+  // Collect the gaps between the overlapping intervals, and replace them with
+  // their union.
+  auto covered = std::optional<vast::time>{};
+  auto merged = window{first, last};
+  while (it != windows_.end() && it->first <= last) {
+    if (it->first > (covered ? *covered : first))
+      result.emplace_back(covered ? *covered : first, it->first);
+    covered = covered ? std::max(*covered, it->second) : it->second;
+    merged.first = std::min(merged.first, it->first);
+    merged.second = std::max(merged.second, it->second);
+    it = windows_.erase(it);
+  }
+  if (!covered)
+    result.emplace_back(first, last);
+  else if (*covered < last)
+    result.emplace_back(*covered, last);
+  windows_.emplace(merged);
+  return result;
+}
+
+size_t time_window_set::size() const noexcept {
+  return windows_.size();
+}
+
 explorer_state::explorer_state(caf::event_based_actor*) {
   // nop
 }
@@ -176,75 +262,84 @@ explorer(caf::stateful_actor<explorer_state>* self, node_actor node,
                  timestamp_leaf->field.name);
       auto column = table_slice_column{
         slice, layout_rt.flat_index(timestamp_leaf->index)};
+      // Collect the time windows around all results, grouped by the value of
+      // the `by` field.
+      auto windows = std::unordered_map<data, std::vector<time_box>>{};
       for (size_t i = 0; i < column.size(); ++i) {
         auto data_view = column[i];
         auto x = caf::get_if<vast::time>(&data_view);
         // Skip if no value
         if (!x)
           continue;
-        std::optional<vast::expression> before_expr;
-        const auto timestamp_type = type{"timestamp", time_type{}};
-        if (st.before)
-          before_expr = predicate{type_extractor{timestamp_type},
-                                  relational_operator::greater_equal,
-                                  data{*x - *st.before}};
-        std::optional<vast::expression> after_expr;
-        if (st.after)
-          after_expr
-            = predicate{type_extractor{timestamp_type},
-                        relational_operator::less_equal, data{*x + *st.after}};
-        std::optional<vast::expression> by_expr;
+        auto key = data{};
         if (st.by) {
           VAST_ASSERT(by_column); // Should have been checked above.
           auto ci = (*by_column)[i];
           if (caf::get_if<caf::none_t>(&ci))
             continue;
-          // TODO: Make `predicate` accept a data_view as well to save
-          // the call to `materialize()`.
-          by_expr = predicate{field_extractor{*st.by},
-                              relational_operator::equal, materialize(ci)};
+          key = materialize(ci);
         }
-        auto build_conjunction
-          = [](std::optional<expression>&& lhs,
-               std::optional<expression>&& rhs) -> std::optional<expression> {
-          if (lhs && rhs)
-            return conjunction{std::move(*lhs), std::move(*rhs)};
-          if (lhs)
-            return std::move(lhs);
-          if (rhs)
-            return std::move(rhs);
-          return std::nullopt;
-        };
-        auto temporal_expr
-          = build_conjunction(std::move(before_expr), std::move(after_expr));
-        auto spatial_expr = std::move(by_expr);
-        auto expr = build_conjunction(std::move(temporal_expr),
-                                      std::move(spatial_expr));
-        // We should have checked during argument parsing that `expr` has at
-        // least one constraint.
-        VAST_ASSERT(expr);
-        auto query = to_string(*expr);
-        VAST_TRACE("{} spawns new exporter with query {}", *self, query);
-        auto exporter_invocation = invocation{{}, "spawn exporter", {query}};
-        caf::put(exporter_invocation.options, "vast.export.preserve-ids", true);
-        caf::put(exporter_invocation.options, "vast.export.max-events",
-                 st.limits.per_result);
-        ++self->state.running_exporters;
-        self
-          ->request(st.node, caf::infinite, atom::spawn_v, exporter_invocation)
-          .then(
-            [=](caf::actor handle) {
-              auto exporter = caf::actor_cast<exporter_actor>(handle);
-              VAST_DEBUG("{} registers exporter {}", *self, exporter);
-              self->monitor(exporter);
-              self->send(exporter, atom::sink_v, self);
-              self->send(exporter, atom::run_v);
-            },
-            [=](caf::error error) {
-              --self->state.running_exporters;
-              VAST_ERROR("{} failed to spawn exporter: {}", *self, error);
-            });
+        // Without 'before' and 'after' the time box is infinite.
+        auto first = st.before ? *x - *st.before : vast::time::min();
+        auto last = st.after ? *x + *st.after : vast::time::max();
+        windows[std::move(key)].push_back({first, last, 1});
+      }
+      // Merge the overlapping windows for each value, and query only the parts
+      // that we did not query before. Instead of spawning an exporter for each
+      // result, we issue a single query for all windows of the slice, which
+      // allows the catalog to select the candidate partitions for all windows
+      // at once based on its time synopses.
+      auto exprs = std::vector<expression>{};
+      auto num_results = uint64_t{0};
+      for (auto& [key, xs] : windows) {
+        st.num_windows += xs.size();
+        auto& queried = st.queried_windows[key];
+        for (const auto& merged : coalesce(std::move(xs))) {
+          auto gaps = queried.add(merged.first, merged.last);
+          if (gaps.empty())
+            continue;
+          num_results += merged.results;
+          for (const auto& [first, last] : gaps)
+            exprs.push_back(make_window_expression(st, first, last, key));
+        }
+      }
+      if (exprs.empty()) {
+        VAST_DEBUG("{} already queried all time windows", *self);
+        return;
       }
+      // We should have checked during argument parsing that every expression
+      // has at least one constraint.
+      auto expr = exprs.size() == 1 ? std::move(exprs[0])
+                                    : expression{disjunction{std::move(exprs)}};
+      auto query = to_string(expr);
+      VAST_TRACE("{} spawns new exporter with query {}", *self, query);
+      auto exporter_invocation = invocation{{}, "spawn exporter", {query}};
+      caf::put(exporter_invocation.options, "vast.export.preserve-ids", true);
+      // The limit for each result applies to the combined windows in sum.
+      auto max_events = st.limits.per_result;
+      if (max_events <= std::numeric_limits<uint64_t>::max() / num_results)
+        max_events *= num_results;
+      else
+        max_events = std::numeric_limits<uint64_t>::max();
+      caf::put(exporter_invocation.options, "vast.export.max-events",
+               max_events);
+      ++self->state.running_exporters;
+      ++self->state.num_queries;
+      VAST_DEBUG("{} coalesced {} time windows into {} queries", *self,
+                 st.num_windows, st.num_queries);
+      self->request(st.node, caf::infinite, atom::spawn_v, exporter_invocation)
+        .then(
+          [=](caf::actor handle) {
+            auto exporter = caf::actor_cast<exporter_actor>(handle);
+            VAST_DEBUG("{} registers exporter {}", *self, exporter);
+            self->monitor(exporter);
+            self->send(exporter, atom::sink_v, self);
+            self->send(exporter, atom::run_v);
+          },
+          [=](caf::error error) {
+            --self->state.running_exporters;
+            VAST_ERROR("{} failed to spawn exporter: {}", *self, error);
+          });
     },
     [=](atom::provision, exporter_actor exporter) {
       self->state.initial_exporter = exporter.address();
@@ -106,6 +106,25 @@ void report_statistics(exporter_actor::stateful_pointer<exporter_state> self) {
   }
 }
 
+void report_trace(exporter_actor::stateful_pointer<exporter_state> self) {
+  auto& st = self->state;
+  if (!st.trace || !st.trace_subscriber)
+    return;
+  VAST_DEBUG("{} reports a trace of {} spans", *self, st.trace->size());
+  auto result = record{
+    {"query", to_string(st.id)},
+    {"expression", to_string(st.query.expr)},
+    {"runtime", st.query_status.runtime},
+  };
+  for (auto& [key, value] : st.trace->summarize())
+    result[key] = std::move(value);
+  result["exporter"] = record{
+    {"rows-checked", count{st.query_status.processed}},
+    {"rows-shipped", count{st.query_status.shipped}},
+  };
+  self->anon_send(st.trace_subscriber, atom::trace_v, std::move(result));
+}
+
 void shutdown(exporter_actor::stateful_pointer<exporter_state> self,
               caf::error err) {
   VAST_DEBUG("{} initiates shutdown with error {}", *self, render(err));
@@ -203,6 +222,11 @@ exporter(exporter_actor::stateful_pointer<exporter_state> self, expression expr,
   self->state.query.priority = has_low_priority_option(self->state.options)
                                  ? query::priority::low
                                  : query::priority::normal;
+  if (has_trace_option(self->state.options)) {
+    self->state.trace.emplace();
+    self->state.query.tracer
+      = caf::actor_cast<receiver_actor<query_span>>(self);
+  }
   self->state.transformer = transformation_engine{std::move(transforms)};
   if (auto err = self->state.transformer.validate(
         transformation_engine::allow_aggregate_transforms::no)) {
@@ -215,8 +239,10 @@ exporter(exporter_actor::stateful_pointer<exporter_state> self, expression expr,
   self->set_exit_handler([=](const caf::exit_msg& msg) {
     VAST_DEBUG("{} received exit from {} with reason: {}", *self, msg.source,
                msg.reason);
-    if (msg.reason != caf::exit_reason::kill)
+    if (msg.reason != caf::exit_reason::kill) {
       report_statistics(self);
+      report_trace(self);
+    }
     self->quit(msg.reason);
   });
   self->set_down_handler([=](const caf::down_msg& msg) {
@@ -308,6 +334,10 @@ exporter(exporter_actor::stateful_pointer<exporter_state> self, expression expr,
                  statistics_subscriber);
       self->state.statistics_subscriber = statistics_subscriber;
     },
+    [self](atom::trace, const caf::actor& trace_subscriber) {
+      VAST_DEBUG("{} registers trace subscriber {}", *self, trace_subscriber);
+      self->state.trace_subscriber = trace_subscriber;
+    },
     [self](
       caf::stream<table_slice> in) -> caf::inbound_stream_slot<table_slice> {
       return self
@@ -325,6 +355,33 @@ exporter(exporter_actor::stateful_pointer<exporter_state> self, expression expr,
           })
         .inbound_slot();
     },
+    // -- continuous_query_subscriber_actor ------------------------------------
+    [self](atom::update, uint64_t checked) {
+      self->state.query_status.processed += checked;
+    },
+    [self](caf::stream<table_slice> in,
+           atom::subscribe) -> caf::inbound_stream_slot<table_slice> {
+      // The CONTINUOUS QUERY ENGINE already selected the matching events and
+      // reports the number of checked events separately.
+      return self
+        ->make_sink(
+          in,
+          [](caf::unit_t&) {
+            // nop
+          },
+          [=](caf::unit_t&, table_slice slice) {
+            VAST_ASSERT(slice.encoding() != table_slice_encoding::none);
+            VAST_DEBUG("{} got batch of {} events", *self, slice.rows());
+            self->state.query_status.cached += slice.rows();
+            self->state.results.push_back(std::move(slice));
+            ship_results(self);
+          },
+          [=](caf::unit_t&, const caf::error& err) {
+            if (err)
+              VAST_ERROR("{} got error during streaming: {}", *self, err);
+          })
+        .inbound_slot();
+    },
     // -- status_client_actor --------------------------------------------------
     [self](atom::status, status_verbosity v) {
       auto result = record{};
@@ -337,6 +394,8 @@ exporter(exporter_actor::stateful_pointer<exporter_state> self, expression expr,
           for (const auto& t : self->state.transformer.transforms())
             transform_names.emplace_back(t.name());
           exp["transforms"] = std::move(transform_names);
+          if (self->state.trace)
+            exp["trace"] = self->state.trace->summarize();
           if (v >= status_verbosity::debug)
             detail::fill_status_map(exp, self);
         }
@@ -356,6 +415,13 @@ exporter(exporter_actor::stateful_pointer<exporter_state> self, expression expr,
       // Ship slices to connected SINKs.
       ship_results(self);
     },
+    // -- receiver_actor<query_span> -------------------------------------------
+    [self](query_span span) {
+      VAST_DEBUG("{} got {} span for partition {}", *self, span.name,
+                 span.partition);
+      if (self->state.trace)
+        self->state.trace->add(std::move(span));
+    },
     [self](atom::done) -> caf::result<void> {
       using namespace std::string_literals;
       // Figure out if we're done by bumping the counter for `received`
@@ -0,0 +1,73 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vast/system/filesystem_statistics.hpp"
+
+#include "vast/data.hpp"
+#include "vast/detail/assert.hpp"
+#include "vast/detail/bit.hpp"
+#include "vast/system/status.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace vast::system {
+
+void filesystem_statistics::latency_histogram::add(duration latency) {
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(latency);
+  auto bucket = us.count() <= 0 ? size_t{0}
+                                : static_cast<size_t>(detail::bit_width(
+                                  static_cast<uint64_t>(us.count())));
+  ++buckets[std::min(bucket, num_buckets - 1)];
+}
+
+duration filesystem_statistics::latency_histogram::quantile(double q) const {
+  VAST_ASSERT(0.0 <= q && q <= 1.0);
+  auto total = std::accumulate(buckets.begin(), buckets.end(), uint64_t{0});
+  if (total == 0)
+    return duration::zero();
+  auto rank = static_cast<uint64_t>(q * static_cast<double>(total));
+  auto seen = uint64_t{0};
+  for (size_t i = 0; i < num_buckets; ++i) {
+    seen += buckets[i];
+    if (seen > rank || seen == total)
+      return std::chrono::microseconds{uint64_t{1} << i};
+  }
+  return std::chrono::microseconds{uint64_t{1} << (num_buckets - 1)};
+}
+
+record to_record(const filesystem_statistics& stats, status_verbosity v) {
+  auto result = record{};
+  auto add = [&](const char* name, const filesystem_statistics::ops& ops) {
+    auto dict = record{};
+    dict["successful"] = count{ops.successful};
+    dict["failed"] = count{ops.failed};
+    dict["bytes"] = count{ops.bytes};
+    auto latency = record{};
+    latency["p50"] = ops.latency.quantile(0.5);
+    latency["p90"] = ops.latency.quantile(0.9);
+    latency["p99"] = ops.latency.quantile(0.99);
+    if (v >= status_verbosity::debug) {
+      auto buckets = list{};
+      buckets.reserve(ops.latency.buckets.size());
+      for (auto bucket : ops.latency.buckets)
+        buckets.emplace_back(count{bucket});
+      latency["histogram"] = std::move(buckets);
+    }
+    dict["latency"] = std::move(latency);
+    result[name] = std::move(dict);
+  };
+  add("checks", stats.checks);
+  add("writes", stats.writes);
+  add("reads", stats.reads);
+  add("mmaps", stats.mmaps);
+  add("erases", stats.erases);
+  return result;
+}
+
+} // namespace vast::system
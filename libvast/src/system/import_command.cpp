@@ -8,8 +8,11 @@
 
 #include "vast/system/import_command.hpp"
 
+#include "vast/chunk.hpp"
 #include "vast/command.hpp"
+#include "vast/concept/parseable/vast/endpoint.hpp"
 #include "vast/defaults.hpp"
+#include "vast/endpoint.hpp"
 #include "vast/error.hpp"
 #include "vast/format/reader.hpp"
 #include "vast/logger.hpp"
@@ -27,10 +30,51 @@
 
 #include <csignal>
 #include <string>
+#include <string_view>
 #include <utility>
 
 namespace vast::system {
 
+namespace {
+
+/// Checks whether the configured node endpoint refers to this host.
+bool is_local_endpoint(const caf::settings& options) {
+  auto node_endpoint = endpoint{};
+  auto endpoint_str
+    = get_or(options, "vast.endpoint", defaults::system::endpoint);
+  if (!parsers::endpoint(endpoint_str, node_endpoint))
+    return false;
+  const auto& host = node_endpoint.host;
+  return host.empty() || host == "localhost" || host == "::1"
+         || host.starts_with("127.");
+}
+
+/// Checks whether the importer can adopt chunks in shared memory from this
+/// process. This fails, e.g., if the node runs as a different user or in a
+/// different IPC namespace.
+caf::error
+probe_shared_memory(caf::scoped_actor& self, const importer_actor& importer) {
+  constexpr auto probe_data = std::string_view{"vast"};
+  auto probe = chunk::make_shared_memory(
+    as_bytes(probe_data), defaults::import::shared_memory_probe_timeout);
+  if (!probe)
+    return std::move(probe.error());
+  auto result = caf::error{};
+  // We only send the name of the probe, as the importer refuses to adopt
+  // chunks in shared memory before it accepted the probe.
+  self
+    ->request(importer, defaults::import::shared_memory_probe_timeout,
+              atom::ping_v, (*probe)->shared_memory_name(),
+              uint64_t{(*probe)->size()})
+    .receive([](atom::ok) {},
+             [&](caf::error& err) {
+               result = std::move(err);
+             });
+  return result;
+}
+
+} // namespace
+
 caf::message import_command(const invocation& inv, caf::actor_system& sys) {
   VAST_TRACE_SCOPE("{}", inv);
   auto self = caf::scoped_actor{sys};
@@ -64,9 +108,29 @@ caf::message import_command(const invocation& inv, caf::actor_system& sys) {
   auto guard = system::signal_monitor::run_guarded(
     sig_mon_thread, sys, defaults::system::signal_monitoring_interval, self);
   const auto format = std::string{inv.name()};
+  // Sharing memory only works with a separate node process on the same host.
+  auto source_inv = inv;
+  if (caf::get_or(inv.options, "vast.import.shared-memory", false)) {
+    if (!std::holds_alternative<node_actor>(node_opt)) {
+      VAST_VERBOSE("{} does not share memory with a node in the same process",
+                   inv.full_name);
+      caf::put(source_inv.options, "vast.import.shared-memory", false);
+    } else if (!is_local_endpoint(inv.options)) {
+      VAST_WARN("{} ignores vast.import.shared-memory because the node runs "
+                "on a different host",
+                inv.full_name);
+      caf::put(source_inv.options, "vast.import.shared-memory", false);
+    } else if (auto err = probe_shared_memory(self, importer)) {
+      VAST_WARN("{} falls back to serializing table slices because the node "
+                "cannot adopt shared memory: {}",
+                inv.full_name, err);
+      caf::put(source_inv.options, "vast.import.shared-memory", false);
+    }
+  }
   // Start the source.
-  auto src_result = make_source(sys, format, inv, accountant, type_registry,
-                                importer, std::move(*transforms));
+  auto src_result = make_source(sys, format, source_inv, accountant,
+                                type_registry, importer,
+                                std::move(*transforms));
   if (!src_result)
     return caf::make_message(std::move(src_result.error()));
   auto src = std::move(*src_result);
@@ -11,17 +11,20 @@
 #include "vast/fwd.hpp"
 
 #include "vast/atoms.hpp"
+#include "vast/chunk.hpp"
 #include "vast/concept/printable/numeric/integral.hpp"
 #include "vast/concept/printable/std/chrono.hpp"
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/error.hpp"
 #include "vast/defaults.hpp"
 #include "vast/detail/fill_status_map.hpp"
+#include "vast/detail/narrow.hpp"
 #include "vast/detail/shutdown_stream_stage.hpp"
 #include "vast/error.hpp"
 #include "vast/logger.hpp"
 #include "vast/plugin.hpp"
 #include "vast/si_literals.hpp"
+#include "vast/system/continuous_query_engine.hpp"
 #include "vast/system/report.hpp"
 #include "vast/system/status.hpp"
 #include "vast/table_slice.hpp"
@@ -218,6 +221,9 @@ importer_state::status(status_verbosity v) const {
   // Retrieve an additional subsection from the transformer.
   const auto timeout = defaults::system::initial_request_timeout / 5 * 4;
   collect_status(rs, timeout, v, transformer, rs->content, "transformer");
+  if (continuous_queries)
+    collect_status(rs, timeout, v, continuous_queries, rs->content,
+                   "continuous-queries");
   return rs->promise;
 }
 
@@ -268,6 +274,8 @@ importer(importer_actor::stateful_pointer<importer_state> self,
   namespace defs = defaults::system;
   self->set_exit_handler([=](const caf::exit_msg& msg) {
     self->state.send_report();
+    if (self->state.continuous_queries)
+      self->send_exit(self->state.continuous_queries, msg.reason);
     if (self->state.stage) {
       self->state.stage->out().push(detail::framed<table_slice>::make_eof());
       detail::shutdown_stream_stage(self->state.stage);
@@ -313,14 +321,38 @@ importer(importer_actor::stateful_pointer<importer_state> self,
             });
   if (index) {
     self->state.index = std::move(index);
-    self
-      ->request(self->state.transformer, caf::infinite,
-                static_cast<stream_sink_actor<table_slice>>(self->state.index))
-      .then([](const caf::outbound_stream_slot<table_slice>&) {},
-            [self](caf::error& error) {
-              VAST_ERROR("failed to connect index to the importer: {}", error);
-              self->quit(std::move(error));
-            });
+    // We stream directly into the workers of the index so that table slices
+    // don't clog the mailbox of the index, which must stay responsive for
+    // queries. An index without workers handles the stream itself.
+    self->request(self->state.index, caf::infinite, atom::get_v, atom::worker_v)
+      .then(
+        [self](std::vector<ingest_worker_actor>& workers) {
+          auto on_error = [self](caf::error& error) {
+            VAST_ERROR("failed to connect index to the importer: {}", error);
+            self->quit(std::move(error));
+          };
+          if (workers.empty()) {
+            self
+              ->request(self->state.transformer, caf::infinite,
+                        static_cast<stream_sink_actor<table_slice>>(
+                          self->state.index))
+              .then([](const caf::outbound_stream_slot<table_slice>&) {},
+                    on_error);
+            return;
+          }
+          // Every worker only receives the table slices of the layouts it
+          // owns.
+          for (size_t id = 0; id < workers.size(); ++id)
+            self
+              ->request(self->state.transformer, caf::infinite,
+                        std::move(workers[id]), id, workers.size())
+              .then([](const caf::outbound_stream_slot<table_slice>&) {},
+                    on_error);
+        },
+        [self](caf::error& error) {
+          VAST_ERROR("failed to retrieve the workers of the index: {}", error);
+          self->quit(std::move(error));
+        });
   }
   return {
     // Register the ACCOUNTANT actor.
@@ -328,12 +360,39 @@ importer(importer_actor::stateful_pointer<importer_state> self,
       VAST_DEBUG("{} registers accountant {}", *self, accountant);
       self->state.accountant = std::move(accountant);
       self->send(self->state.accountant, atom::announce_v, self->name());
+      if (self->state.continuous_queries)
+        self->send(self->state.continuous_queries, self->state.accountant);
     },
     // Add a new sink.
     [self](stream_sink_actor<table_slice> sink) {
       VAST_DEBUG("{} adds a new sink: {}", *self, sink);
       return self->delegate(self->state.transformer, sink);
     },
+    // Register a continuous query.
+    [self](atom::subscribe, expression& expr,
+           continuous_query_subscriber_actor& subscriber) {
+      VAST_DEBUG("{} adds continuous query {} for {}", *self, expr,
+                 subscriber);
+      // All continuous queries share a single engine that evaluates them
+      // together, so that we stream every table slice only once.
+      if (!self->state.continuous_queries) {
+        self->state.continuous_queries = self->spawn(continuous_query_engine);
+        if (self->state.accountant)
+          self->send(self->state.continuous_queries, self->state.accountant);
+        self
+          ->request(self->state.transformer, caf::infinite,
+                    static_cast<stream_sink_actor<table_slice>>(
+                      self->state.continuous_queries))
+          .then([](const caf::outbound_stream_slot<table_slice>&) {},
+                [self](caf::error& error) {
+                  VAST_ERROR("{} failed to connect the continuous query "
+                             "engine: {}",
+                             *self, error);
+                });
+      }
+      self->send(self->state.continuous_queries, atom::subscribe_v,
+                 std::move(expr), std::move(subscriber));
+    },
     // Register a FLUSH LISTENER actor.
     [self](atom::subscribe, atom::flush, flush_listener_actor listener) {
       VAST_DEBUG("{} adds new subscriber {}", *self, listener);
@@ -341,6 +400,21 @@ importer(importer_actor::stateful_pointer<importer_state> self,
       self->send(self->state.index, atom::subscribe_v, atom::flush_v,
                  std::move(listener));
     },
+    // Confirm that the IMPORTER can adopt a chunk in shared memory. Adopting
+    // the probe allows for handing off further chunks from the same process.
+    [self](atom::ping, const std::string& name,
+           uint64_t size) -> caf::result<atom::ok> {
+      auto probe = chunk::accept_shared_memory(
+        name, detail::narrow_cast<chunk::size_type>(size));
+      if (!probe)
+        return caf::make_error(ec::system_error,
+                               fmt::format("{} failed to adopt shared memory "
+                                           "probe: {}",
+                                           *self, probe.error()));
+      VAST_DEBUG("{} accepts chunks in shared memory from the creator of {}",
+                 *self, name);
+      return atom::ok_v;
+    },
     // Reserve a part of the id space.
     [self](atom::reserve, uint64_t n) {
       VAST_ASSERT(n <= static_cast<size_t>(self->state.available_ids()),
@@ -23,7 +23,6 @@
 #include "vast/detail/assert.hpp"
 #include "vast/detail/fill_status_map.hpp"
 #include "vast/detail/narrow.hpp"
-#include "vast/detail/notifying_stream_manager.hpp"
 #include "vast/detail/shutdown_stream_stage.hpp"
 #include "vast/detail/tracepoint.hpp"
 #include "vast/error.hpp"
@@ -38,14 +37,17 @@
 #include "vast/partition_synopsis.hpp"
 #include "vast/system/active_partition.hpp"
 #include "vast/system/catalog.hpp"
+#include "vast/system/ingest_worker.hpp"
 #include "vast/system/partition_transformer.hpp"
 #include "vast/system/passive_partition.hpp"
 #include "vast/system/report.hpp"
 #include "vast/system/shutdown.hpp"
 #include "vast/system/status.hpp"
 #include "vast/table_slice.hpp"
+#include "vast/transform.hpp"
 #include "vast/uuid.hpp"
 
+#include <caf/attach_continuous_stream_stage.hpp>
 #include <caf/error.hpp>
 #include <caf/make_copy_on_write.hpp>
 #include <caf/response_promise.hpp>
@@ -66,14 +68,18 @@
 //
 // # Import
 //
-// The index is implemented as a stream stage that hooks into the table slice
-// stream coming from the importer, and forwards them to the current active
-// partition
+// The index spawns a fixed number of ingest workers, which are stream stages
+// that hook into the table slice stream coming from the importer, and forward
+// them to the current active partition of their layout. Every worker owns a
+// disjoint subset of all layouts, so the table slices never pass through the
+// mailbox of the index itself, which stays free for control and query
+// traffic. The workers register new active partitions with the index, and hand
+// them over for persisting when they are full.
 //
-//              table slice              table slice                      table slice column
-//   importer ----------------> index ---------------> active partition ------------------------> indexer
-//                                                                      ------------------------> indexer
-//                                                                                ...
+//              table slice                      table slice                      table slice column
+//   importer ----------------> ingest worker ---------------> active partition ------------------------> indexer
+//            ----------------> ingest worker                                   ------------------------> indexer
+//                   ...                                                                  ...
 //
 // # Lookup
 //
@@ -397,12 +403,11 @@ void index_state::flush_to_disk() {
 void index_state::add_flush_listener(flush_listener_actor listener) {
   VAST_DEBUG("{} adds a new 'flush' subscriber: {}", *self, listener);
   flush_listeners.emplace_back(std::move(listener));
-  // We may need to call `notify_listeners_if_clean` if the subscription
-  // happens after the data has already completely passed the index, but
-  // we must not to call it before any data at all has arrived it would
-  // create a false positive.
+  // We must not forward the listeners before any data at all has arrived, as
+  // that would create a false positive. Instead, we forward them as soon as
+  // the first active partition gets registered.
   if (!active_partitions.empty())
-    detail::notify_listeners_if_clean(*this, *stage);
+    notify_flush_listeners();
 }
 
 // The whole purpose of the `-b` flag is to somehow block until all imported
@@ -414,94 +419,44 @@ void index_state::add_flush_listener(flush_listener_actor listener) {
 // TODO(ch19583): Rip out the whole 'notifying_stream_manager' and replace it
 // with some kind of ping/pong protocol.
 void index_state::notify_flush_listeners() {
-  VAST_DEBUG("{} sends 'flush' messages to {} listeners", *self,
+  VAST_DEBUG("{} forwards {} 'flush' subscribers to its workers", *self,
              flush_listeners.size());
-  for (auto& listener : flush_listeners) {
-    bool downstream = false;
-    for (const auto& [_, active_partition] : active_partitions) {
-      if (active_partition.actor) {
-        self->send(active_partition.actor, atom::subscribe_v, atom::flush_v,
-                   listener);
-        downstream = true;
-      }
-    }
-    if (!downstream)
-      self->send(listener, atom::flush_v);
+  for (const auto& worker : ingest_workers) {
+    // Workers without an active partition never received any data, so they
+    // would hold on to the listeners until they do.
+    auto feeds_active_partition = std::any_of(
+      active_partitions.begin(), active_partitions.end(),
+      [&](const auto& active_partition) {
+        return active_partition.second.worker == worker;
+      });
+    if (!feeds_active_partition)
+      continue;
+    for (const auto& listener : flush_listeners)
+      self->send(worker, atom::subscribe_v, atom::flush_v, listener);
   }
   flush_listeners.clear();
 }
 
 // -- partition handling -----------------------------------------------------
 
-bool i_partition_selector::operator()(const type& filter,
-                                      const table_slice& slice) const {
-  return filter == slice.layout();
-}
-
-void index_state::create_active_partition(const type& layout) {
-  auto id = uuid::random();
-  auto& active_partition = active_partitions[layout];
-  // If we're using the global store, the importer already sends the table
-  // slices. (In the long run, this should probably be streamlined so that all
-  // data moves through the index. However, that requires some refactoring of
-  // the archive itself so it can handle multiple input streams.)
-  std::string store_name = {};
-  chunk_ptr store_header = chunk::make_empty();
-  if (partition_local_stores) {
-    store_name = store_plugin->name();
-    auto builder_and_header
-      = store_plugin->make_store_builder(accountant, filesystem, id);
-    if (!builder_and_header) {
-      VAST_ERROR("could not create new active partition: {}",
-                 render(builder_and_header.error()));
-      self->quit(builder_and_header.error());
-      return;
-    }
-    auto& [builder, header] = *builder_and_header;
-    store_header = header;
-    active_partition.store = builder;
-    active_partition.store_slot
-      = stage->add_outbound_path(active_partition.store);
-    stage->out().set_filter(active_partition.store_slot, layout);
-  } else {
-    store_name = "legacy_archive";
-    active_partition.store = global_store;
+void index_state::decomission_active_partition(const uuid& id) {
+  auto active_partition = active_partitions.find(id);
+  if (active_partition == active_partitions.end()) {
+    VAST_WARN("{} cannot persist unknown active partition {}", *self, id);
+    return;
   }
-  active_partition.spawn_time = std::chrono::steady_clock::now();
-  active_partition.actor
-    = self->spawn(::vast::system::active_partition, id, accountant, filesystem,
-                  index_opts, synopsis_opts,
-                  static_cast<store_actor>(active_partition.store), store_name,
-                  store_header);
-  active_partition.stream_slot
-    = stage->add_outbound_path(active_partition.actor);
-  stage->out().set_filter(active_partition.stream_slot, layout);
-  active_partition.capacity = partition_capacity;
-  active_partition.id = id;
-  VAST_DEBUG("{} created new partition {}", *self, id);
-}
-
-void index_state::decomission_active_partition(const type& layout) {
-  auto active_partition = active_partitions.find(layout);
-  VAST_ASSERT(active_partition != active_partitions.end());
-  auto id = active_partition->second.id;
-  auto actor = std::exchange(active_partition->second.actor, {});
+  auto actor = std::move(active_partition->second.actor);
+  active_partitions.erase(active_partition);
   unpersisted[id] = actor;
-  // Send buffered batches and remove active partition from the stream.
-  stage->out().fan_out_flush();
-  stage->out().close(active_partition->second.stream_slot);
-  if (partition_local_stores)
-    stage->out().close(active_partition->second.store_slot);
-  stage->out().force_emit_batches();
-  // Persist active partition asynchronously.
+  // Persist active partition asynchronously. The partition waits until its
+  // input stream from the worker is closed.
   auto part_dir = partition_path(id);
   auto synopsis_dir = partition_synopsis_path(id);
-  VAST_DEBUG("{} persists active partition {} to {}", *self, layout, part_dir);
+  VAST_DEBUG("{} persists active partition {} to {}", *self, id, part_dir);
   self->request(actor, caf::infinite, atom::persist_v, part_dir, synopsis_dir)
     .then(
       [=, this](partition_synopsis_ptr& ps) {
-        VAST_DEBUG("{} successfully persisted partition {} {}", *self, layout,
-                   id);
+        VAST_DEBUG("{} successfully persisted partition {}", *self, id);
         // The catalog expects to own the partition synopsis it receives,
         // so we make a copy for the listeners.
         catalog_bytes += ps->memusage();
@@ -510,9 +465,8 @@ void index_state::decomission_active_partition(const type& layout) {
         self->request(catalog, caf::infinite, atom::merge_v, id, ps)
           .then(
             [=, this](atom::ok) {
-              VAST_DEBUG("{} received ok for request to persist partition {} "
-                         "{}",
-                         *self, layout, id);
+              VAST_DEBUG("{} received ok for request to persist partition {}",
+                         *self, id);
               for (auto& listener : partition_creation_listeners)
                 self->send(listener, atom::update_v,
                            partition_synopsis_pair{id, ps});
@@ -521,14 +475,13 @@ void index_state::decomission_active_partition(const type& layout) {
             },
             [=, this](const caf::error& err) {
               VAST_DEBUG("{} received error for request to persist partition "
-                         "{} "
                          "{}: {}",
-                         *self, layout, id, err);
+                         *self, id, err);
             });
       },
       [=, this](caf::error& err) {
-        VAST_ERROR("{} failed to persist partition {} {} with error: {}", *self,
-                   layout, id, err);
+        VAST_ERROR("{} failed to persist partition {} with error: {}", *self,
+                   id, err);
         self->quit(std::move(err));
       });
 }
@@ -538,6 +491,91 @@ void index_state::add_partition_creation_listener(
   partition_creation_listeners.push_back(listener);
 }
 
+void index_state::merge_small_partitions() {
+  // Merging requires partition-local stores and reserves new ids from the
+  // importer for the merged partition.
+  if (merging_partitions || !store_plugin || !importer)
+    return;
+  merging_partitions = true;
+  self->request(catalog, caf::infinite, atom::get_v)
+    .then(
+      [this](std::vector<partition_synopsis_pair>& synopses) {
+        // Group the small partitions by layout. Partitions with multiple
+        // layouts, e.g., from transforms, are never considered.
+        auto candidates
+          = std::unordered_map<std::string_view,
+                               std::vector<std::pair<size_t, uuid>>>{};
+        for (const auto& [id, synopsis] : synopses) {
+          if (!synopsis || synopsis->events >= min_partition_size
+              || !persisted_partitions.contains(id)
+              || synopsis->field_synopses_.empty())
+            continue;
+          auto layout_name
+            = synopsis->field_synopses_.begin()->first.layout_name();
+          auto single_layout = std::all_of(
+            synopsis->field_synopses_.begin(), synopsis->field_synopses_.end(),
+            [&](const auto& field_synopsis) {
+              return field_synopsis.first.layout_name() == layout_name;
+            });
+          if (single_layout)
+            candidates[layout_name].emplace_back(synopsis->events, id);
+        }
+        // Combine the smallest partitions first, as long as the result fits
+        // into a single partition.
+        auto batches = std::vector<std::vector<uuid>>{};
+        for (auto& [layout_name, partitions] : candidates) {
+          std::sort(partitions.begin(), partitions.end());
+          auto batch = std::vector<uuid>{};
+          auto events = size_t{0};
+          for (const auto& [partition_events, id] : partitions) {
+            if (events + partition_events > partition_capacity) {
+              if (batch.size() > 1)
+                batches.push_back(std::exchange(batch, {}));
+              batch.clear();
+              events = 0;
+            }
+            batch.push_back(id);
+            events += partition_events;
+          }
+          if (batch.size() > 1)
+            batches.push_back(std::move(batch));
+        }
+        merge_partitions(std::move(batches));
+      },
+      [this](const caf::error& err) {
+        VAST_WARN("{} failed to retrieve partition synopses for merging: {}",
+                  *self, err);
+        merging_partitions = false;
+      });
+}
+
+void index_state::merge_partitions(std::vector<std::vector<uuid>> batches) {
+  if (batches.empty()) {
+    merging_partitions = false;
+    return;
+  }
+  auto batch = std::move(batches.back());
+  batches.pop_back();
+  VAST_VERBOSE("{} merges {} small partitions", *self, batch.size());
+  // A transform without steps passes all events through unchanged.
+  auto identity = std::make_shared<vast::transform>("partition-merge",
+                                                    std::vector<std::string>{});
+  self
+    ->request(static_cast<index_actor>(self), caf::infinite, atom::apply_v,
+              std::move(identity), std::move(batch),
+              keep_original_partition::no)
+    .then(
+      [this, batches = std::move(batches)](partition_info& info) mutable {
+        VAST_DEBUG("{} merged small partitions into {} with {} events", *self,
+                   info.uuid, info.events);
+        merge_partitions(std::move(batches));
+      },
+      [this](const caf::error& err) {
+        VAST_WARN("{} failed to merge small partitions: {}", *self, err);
+        merging_partitions = false;
+      });
+}
+
 // -- query handling ---------------------------------------------------------
 
 void index_state::schedule_lookups() {
@@ -559,23 +597,25 @@ void index_state::schedule_lookups() {
                next->queries);
     // 2. Acquire the actor for the selected partition, potentially materializing
     //    it from its persisted state.
+    auto source = std::string{};
     auto acquire = [&](const uuid& partition_id) -> partition_actor {
       // We need to first check whether the ID is the active partition or one
       // of our unpersisted ones. Only then can we dispatch to our LRU cache.
       partition_actor part;
-      for (const auto& [_, active_partition] : active_partitions) {
-        if (active_partition.actor != nullptr
-            && active_partition.id == partition_id) {
-          part = active_partition.actor;
-          break;
-        }
+      if (auto it = active_partitions.find(partition_id);
+          it != active_partitions.end()) {
+        part = it->second.actor;
+        source = "active";
       }
       if (!part) {
-        if (auto it = unpersisted.find(partition_id); it != unpersisted.end())
+        if (auto it = unpersisted.find(partition_id); it != unpersisted.end()) {
           part = it->second;
-        else if (auto it = persisted_partitions.find(partition_id);
-                 it != persisted_partitions.end())
+          source = "unpersisted";
+        } else if (auto it = persisted_partitions.find(partition_id);
+                   it != persisted_partitions.end()) {
+          source = inmem_partitions.contains(partition_id) ? "cache" : "disk";
           part = inmem_partitions.get_or_load(partition_id);
+        }
       }
       if (!part)
         VAST_ERROR("{} could not load partition {} that was part of a "
@@ -615,11 +655,24 @@ void index_state::schedule_lookups() {
           schedule_lookups();
         }
       };
+      auto start = std::chrono::steady_clock::now();
+      auto queue_wait = duration{start - it->second.activated};
       self->request(partition_actor, caf::infinite, it->second.query)
         .then(
-          [this, handle_completion, qid, pid = next->partition](uint64_t n) {
+          [this, handle_completion, qid, pid = next->partition, start,
+           queue_wait, source, tracer = it->second.query.tracer](uint64_t n) {
             VAST_TRACE("{} received {} results for query {} from partition {}",
                        *self, n, qid, pid);
+            if (tracer)
+              self->send(tracer,
+                         query_span{
+                           .partition = pid,
+                           .name = "lookup",
+                           .runtime = std::chrono::steady_clock::now() - start,
+                           .values = {{"source", source},
+                                      {"queue-wait", queue_wait},
+                                      {"events", count{n}}},
+                         });
             handle_completion();
           },
           [this, handle_completion, qid,
@@ -678,6 +731,7 @@ void index_state::send_report() {
       {"scheduler.partition.remaining-capacity",
        max_concurrent_partition_lookups - running_partition_lookups},
       {"scheduler.partition.current-lookups", running_partition_lookups},
+      {"index.mailbox-size", self->mailbox().size()},
     }};
   self->send(accountant, std::move(msg));
   auto r = performance_report{.data = {{{"scheduler", scheduler_measurement}}}};
@@ -733,6 +787,7 @@ index_state::status(status_verbosity v) const {
     }
     rs->content["pending"] = std::move(pending_status);
     rs->content["num-active-partitions"] = count{active_partitions.size()};
+    rs->content["num-ingest-workers"] = count{ingest_workers.size()};
     rs->content["num-cached-partitions"] = count{inmem_partitions.size()};
     rs->content["num-unpersisted-partitions"] = count{unpersisted.size()};
     const auto timeout = defaults::system::initial_request_timeout / 5 * 4;
@@ -771,10 +826,8 @@ index_state::status(status_verbosity v) const {
     auto& active
       = caf::get<list>(partitions.emplace("active", list{}).first->second);
     active.reserve(active_partitions.size());
-    for (const auto& [_, active_partition] : active_partitions) {
-      if (active_partition.actor != nullptr)
-        partition_status(active_partition.id, active_partition.actor, active);
-    }
+    for (const auto& [id, active_partition] : active_partitions)
+      partition_status(id, active_partition.actor, active);
     auto& cached
       = caf::get<list>(partitions.emplace("cached", list{}).first->second);
     cached.reserve(inmem_partitions.size());
@@ -786,6 +839,21 @@ index_state::status(status_verbosity v) const {
     for (const auto& [id, actor] : this->unpersisted)
       partition_status(id, actor, unpersisted);
     rs->content["partitions"] = std::move(partitions);
+    rs->content["ingest-workers"] = list{};
+    for (const auto& worker : ingest_workers)
+      collect_status(
+        rs, timeout, v, worker,
+        [&content = rs->content](record& ingest_worker_status) {
+          caf::get<list>(content["ingest-workers"]).emplace_back(
+            std::move(ingest_worker_status));
+        },
+        [=, this, &content = rs->content](const caf::error& err) {
+          VAST_WARN("{} failed to retrieve status from {} : {}", *self, worker,
+                    render(err));
+          auto xs = record{};
+          xs["error"] = render(err);
+          caf::get<list>(content["ingest-workers"]).emplace_back(std::move(xs));
+        });
     // General state such as open streams.
   }
   rs->content["statistics"] = std::move(stats_object);
@@ -802,14 +870,20 @@ index(index_actor::stateful_pointer<index_state> self,
       std::string store_backend, size_t partition_capacity,
       duration active_partition_timeout, size_t max_inmem_partitions,
       size_t taste_partitions, size_t max_concurrent_partition_lookups,
+      size_t num_workers, size_t memory_budget, size_t min_partition_size,
+      duration partition_merge_interval,
       const std::filesystem::path& catalog_dir, index_config index_config) {
-  VAST_TRACE_SCOPE("index {} {} {} {} {} {} {} {} {} {}", VAST_ARG(self->id()),
-                   VAST_ARG(filesystem), VAST_ARG(dir),
+  VAST_TRACE_SCOPE("index {} {} {} {} {} {} {} {} {} {} {} {} {} {}",
+                   VAST_ARG(self->id()), VAST_ARG(filesystem), VAST_ARG(dir),
                    VAST_ARG(partition_capacity),
                    VAST_ARG(active_partition_timeout),
                    VAST_ARG(max_inmem_partitions), VAST_ARG(taste_partitions),
                    VAST_ARG(max_concurrent_partition_lookups),
-                   VAST_ARG(catalog_dir), VAST_ARG(index_config));
+                   VAST_ARG(num_workers), VAST_ARG(memory_budget),
+                   VAST_ARG(min_partition_size),
+                   VAST_ARG(partition_merge_interval), VAST_ARG(catalog_dir),
+                   VAST_ARG(index_config));
+  VAST_ASSERT(num_workers > 0);
   VAST_VERBOSE("{} initializes index in {} with a maximum partition "
                "size of {} events and {} resident partitions",
                *self, dir, partition_capacity, max_inmem_partitions);
@@ -849,6 +923,8 @@ index(index_actor::stateful_pointer<index_state> self,
   self->state.synopsisdir = catalog_dir;
   self->state.partition_capacity = partition_capacity;
   self->state.active_partition_timeout = active_partition_timeout;
+  self->state.min_partition_size = min_partition_size;
+  self->state.partition_merge_interval = partition_merge_interval;
   self->state.taste_partitions = taste_partitions;
   self->state.inmem_partitions.factory().filesystem() = self->state.filesystem;
   self->state.inmem_partitions.resize(max_inmem_partitions);
@@ -860,44 +936,33 @@ index(index_actor::stateful_pointer<index_state> self,
     self->quit(err);
     return index_actor::behavior_type::make_empty_behavior();
   }
-  // Setup stream manager.
-  self->state.stage = detail::attach_notifying_stream_stage(
+  // Spawn the workers that feed the active partitions. Each worker only
+  // receives the table slices of the layouts it owns. The workers split the
+  // memory budget evenly.
+  self->state.ingest_workers.reserve(num_workers);
+  for (size_t id = 0; id < num_workers; ++id) {
+    auto worker = self->spawn(
+      ingest_worker, static_cast<index_actor>(self), id, num_workers,
+      self->state.accountant, self->state.filesystem, self->state.global_store,
+      self->state.store_plugin, partition_capacity, min_partition_size,
+      memory_budget / num_workers, active_partition_timeout,
+      self->state.index_opts, self->state.synopsis_opts);
+    self->monitor(worker);
+    self->state.ingest_workers.push_back(std::move(worker));
+  }
+  VAST_VERBOSE("{} feeds active partitions from {} ingest workers", *self,
+               num_workers);
+  // Setup stream manager. This only relays table slices to the workers for
+  // sources that stream into the index directly; the importer connects to
+  // the workers instead.
+  self->state.stage = caf::attach_continuous_stream_stage(
     self,
-    /* continuous = */ true,
     [](caf::unit_t&) {
       // nop
     },
-    [self](caf::unit_t&, caf::downstream<table_slice>& out, table_slice x) {
+    [](caf::unit_t&, caf::downstream<table_slice>& out, table_slice x) {
       VAST_ASSERT(x.encoding() != table_slice_encoding::none);
-      auto&& layout = x.layout();
-      // TODO: Consider switching layouts to a robin map to take advantage of
-      // transparent key lookup with string views, avoding the copy of the name
-      // here.
-      self->state.stats.layouts[std::string{layout.name()}].count += x.rows();
-      auto& active = self->state.active_partitions[layout];
-      if (!active.actor) {
-        self->state.create_active_partition(layout);
-      } else if (x.rows() > active.capacity) {
-        VAST_DEBUG("{} exceeds active capacity by {} rows", *self,
-                   x.rows() - active.capacity);
-        VAST_VERBOSE("{} flushes active partition {} with {}/{} events", *self,
-                     layout, self->state.partition_capacity - active.capacity,
-                     self->state.partition_capacity);
-        self->state.decomission_active_partition(layout);
-        self->state.flush_to_disk();
-        self->state.create_active_partition(layout);
-      }
-      out.push(x);
-      if (active.capacity == self->state.partition_capacity
-          && x.rows() > active.capacity) {
-        VAST_WARN("{} got table slice with {} rows that exceeds the "
-                  "default partition capacity of {} rows",
-                  *self, x.rows(), self->state.partition_capacity);
-        active.capacity = 0;
-      } else {
-        VAST_ASSERT(active.capacity >= x.rows());
-        active.capacity -= x.rows();
-      }
+      out.push(std::move(x));
     },
     [self](caf::unit_t&, const caf::error& err) {
       // During "normal" shutdown, the node will send an exit message to
@@ -918,17 +983,29 @@ index(index_actor::stateful_pointer<index_state> self,
       }
     },
     caf::policy::arg<caf::broadcast_downstream_manager<
-      table_slice, vast::type, i_partition_selector>>{});
+      table_slice, ingest_worker_filter, ingest_worker_selector>>{});
+  for (size_t id = 0; id < num_workers; ++id) {
+    auto slot
+      = self->state.stage->add_outbound_path(self->state.ingest_workers[id]);
+    self->state.stage->out().set_filter(slot,
+                                        ingest_worker_filter{id, num_workers});
+  }
   self->set_exit_handler([self](const caf::exit_msg& msg) {
     VAST_DEBUG("{} received EXIT from {} with reason: {}", *self, msg.source,
                msg.reason);
     // Flush buffered batches and end stream.
     detail::shutdown_stream_stage(self->state.stage);
-    // Bring down active partition.
-    for (auto& [layout, partinfo] : self->state.active_partitions) {
-      if (partinfo.actor)
-        self->state.decomission_active_partition(layout);
-    }
+    // The workers close the streams to their active partitions before they
+    // exit, which in turn allows the active partitions to persist.
+    for (const auto& worker : self->state.ingest_workers)
+      self->send_exit(worker, msg.reason);
+    // Bring down active partitions.
+    auto active_partition_ids = std::vector<uuid>{};
+    active_partition_ids.reserve(self->state.active_partitions.size());
+    for (const auto& [id, _] : self->state.active_partitions)
+      active_partition_ids.push_back(id);
+    for (const auto& id : active_partition_ids)
+      self->state.decomission_active_partition(id);
     // Collect partitions for termination.
     // TODO: We must actor_cast to caf::actor here because 'shutdown' operates
     // on 'std::vector<caf::actor>' only. That should probably be generalized
@@ -951,6 +1028,19 @@ index(index_actor::stateful_pointer<index_state> self,
   });
   // Set up a down handler for monitored exporter actors.
   self->set_down_handler([=](const caf::down_msg& msg) {
+    // A worker going down while we're still running means that ingestion for
+    // its layouts stopped, so we bring down the whole index.
+    const auto& workers = self->state.ingest_workers;
+    if (std::any_of(workers.begin(), workers.end(), [&](const auto& worker) {
+          return worker.address() == msg.source;
+        })) {
+      if (self->state.stage->running()) {
+        VAST_WARN("{} shuts down after losing an ingest worker: {}", *self,
+                  render(msg.reason));
+        self->send_exit(self, msg.reason);
+      }
+      return;
+    }
     auto it = self->state.monitored_queries.find(msg.source);
     if (it == self->state.monitored_queries.end()) {
       VAST_WARN("{} received DOWN from unexpected sender", *self);
@@ -976,10 +1066,13 @@ index(index_actor::stateful_pointer<index_state> self,
   // Start metrics loop.
   if (self->state.accountant)
     self->send(self->state.accountant, atom::announce_v, self->name());
-  if (self->state.accountant
-      || self->state.active_partition_timeout.count() > 0)
+  if (self->state.accountant)
     self->delayed_send(self, defaults::system::telemetry_rate,
                        atom::telemetry_v);
+  // Start the loop that merges small partitions.
+  if (self->state.partition_merge_interval.count() > 0)
+    self->delayed_send(self, self->state.partition_merge_interval,
+                       atom::internal_v, atom::merge_v);
   return {
     [self](atom::done, uuid partition_id) {
       VAST_DEBUG("{} queried partition {} successfully", *self, partition_id);
@@ -994,29 +1087,6 @@ index(index_actor::stateful_pointer<index_state> self,
                          atom::telemetry_v);
       if (self->state.accountant)
         self->state.send_report();
-      if (self->state.active_partition_timeout.count() > 0) {
-        auto decomissioned = std::vector<type>{};
-        for (const auto& [layout, active_partition] :
-             self->state.active_partitions) {
-          if (active_partition.spawn_time + self->state.active_partition_timeout
-              < std::chrono::steady_clock::now()) {
-            VAST_VERBOSE("{} flushes active partition {} with {}/{} events "
-                         "after {} timeout",
-                         *self, layout,
-                         self->state.partition_capacity
-                           - active_partition.capacity,
-                         self->state.partition_capacity,
-                         data{self->state.active_partition_timeout});
-            self->state.decomission_active_partition(layout);
-            decomissioned.push_back(layout);
-          }
-        }
-        if (!decomissioned.empty()) {
-          for (const auto& layout : decomissioned)
-            self->state.active_partitions.erase(layout);
-          self->state.flush_to_disk();
-        }
-      }
     },
     [self](atom::subscribe, atom::flush, flush_listener_actor listener) {
       VAST_DEBUG("{} adds flush listener", *self);
@@ -1076,9 +1146,10 @@ index(index_actor::stateful_pointer<index_state> self,
         return caf::skip;
       }
       auto rp = self->make_response_promise<query_cursor>();
+      auto start = std::chrono::steady_clock::now();
       std::vector<uuid> candidates;
-      for (const auto& [_, active_partition] : self->state.active_partitions)
-        candidates.push_back(active_partition.id);
+      for (const auto& [id, _] : self->state.active_partitions)
+        candidates.push_back(id);
       for (const auto& [id, _] : self->state.unpersisted)
         candidates.push_back(id);
       self
@@ -1088,11 +1159,38 @@ index(index_actor::stateful_pointer<index_state> self,
           auto& midx_candidates = midx_result.partitions;
           VAST_DEBUG("{} got initial candidates {} and from meta-index {}",
                      *self, candidates, midx_candidates);
+          // The catalog answers estimates for partitions that are fully
+          // covered by the query from their metadata. Partitions that are
+          // still in the process of being persisted may already be known to
+          // the catalog, but count towards the result through the lookup.
+          auto counted_events = uint64_t{0};
+          for (const auto& [id, events] : midx_result.counts)
+            if (std::find(candidates.begin(), candidates.end(), id)
+                == candidates.end())
+              counted_events += events;
+          // The client only accepts results after it received the cursor.
+          auto send_counted_events = [&] {
+            if (counted_events == 0)
+              return;
+            VAST_DEBUG("{} counted {} events in {} partitions from the "
+                       "catalog",
+                       *self, counted_events, midx_result.counts.size());
+            self->send(caf::get<query::count>(query.cmd).sink,
+                       counted_events);
+          };
           candidates.insert(candidates.end(), midx_candidates.begin(),
                             midx_candidates.end());
           std::sort(candidates.begin(), candidates.end());
           candidates.erase(std::unique(candidates.begin(), candidates.end()),
                            candidates.end());
+          if (query.tracer)
+            self->send(query.tracer,
+                       query_span{
+                         .name = "catalog",
+                         .runtime = std::chrono::steady_clock::now() - start,
+                         .values = {{"candidates", count{candidates.size()}},
+                                    {"counted-events", count{counted_events}}},
+                       });
           // Allows the client to query further results after initial taste.
           auto query_id = query.id;
           auto client = caf::actor_cast<receiver_actor<atom::done>>(sender);
@@ -1100,6 +1198,7 @@ index(index_actor::stateful_pointer<index_state> self,
             VAST_DEBUG("{} returns without result: no partitions qualify",
                        *self);
             rp.deliver(query_cursor{query_id, 0u, 0u});
+            send_counted_events();
             self->send(client, atom::done_v);
             return;
           }
@@ -1114,6 +1213,7 @@ index(index_actor::stateful_pointer<index_state> self,
                 std::move(candidates)))
             rp.deliver(err);
           rp.deliver(query_cursor{query_id, num_candidates, scheduled});
+          send_counted_events();
           self->state.schedule_lookups();
         });
       return rp;
@@ -1252,6 +1352,36 @@ index(index_actor::stateful_pointer<index_state> self,
     [self](atom::importer, idspace_distributor_actor idspace_distributor) {
       self->state.importer = std::move(idspace_distributor);
     },
+    [self](atom::get, atom::worker) -> std::vector<ingest_worker_actor> {
+      return self->state.ingest_workers;
+    },
+    [self](atom::add, const uuid& id, active_partition_actor& actor) {
+      auto worker
+        = caf::actor_cast<ingest_worker_actor>(self->current_sender());
+      VAST_DEBUG("{} registers active partition {} from {}", *self, id, worker);
+      self->state.active_partitions.emplace(
+        id, active_partition_handle{std::move(actor), std::move(worker)});
+      // The worker created the partition while we were shutting down, so we
+      // missed it when decommissioning all active partitions.
+      if (!self->state.stage->running())
+        self->state.decomission_active_partition(id);
+      else if (!self->state.flush_listeners.empty())
+        self->state.notify_flush_listeners();
+      return atom::ok_v;
+    },
+    [self](atom::persist, const uuid& id) {
+      self->state.decomission_active_partition(id);
+      self->state.flush_to_disk();
+    },
+    [self](atom::statistics, const index_statistics& stats) {
+      for (const auto& [name, layout_stats] : stats.layouts)
+        self->state.stats.layouts[name].count += layout_stats.count;
+    },
+    [self](atom::internal, atom::merge) {
+      self->delayed_send(self, self->state.partition_merge_interval,
+                         atom::internal_v, atom::merge_v);
+      self->state.merge_small_partitions();
+    },
     [self](atom::apply, transform_ptr transform,
            std::vector<vast::uuid> old_partition_ids,
            keep_original_partition keep) -> caf::result<partition_info> {
@@ -10,6 +10,7 @@
 
 #include "vast/fwd.hpp"
 
+#include "vast/bitmap_algorithms.hpp"
 #include "vast/chunk.hpp"
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/expression.hpp"
@@ -86,6 +87,14 @@ active_indexer(active_indexer_actor::stateful_pointer<indexer_state> self,
       auto rep = to_internal(idx.type(), make_view(pred.rhs));
       return idx.lookup(pred.op, rep);
     },
+    [self](const curried_predicate& pred, const ids& selection) {
+      VAST_DEBUG("{} got predicate {} for {} candidates", *self, pred,
+                 rank(selection));
+      VAST_ASSERT(self->state.idx);
+      auto& idx = *self->state.idx;
+      auto rep = to_internal(idx.type(), make_view(pred.rhs));
+      return idx.lookup(pred.op, rep, selection);
+    },
     [self](atom::snapshot) {
       // The partition is only allowed to send a single snapshot atom.
       VAST_ASSERT(!self->state.promise.pending());
@@ -133,6 +142,14 @@ passive_indexer(indexer_actor::stateful_pointer<indexer_state> self,
       auto rep = to_internal(idx.type(), make_view(pred.rhs));
       return idx.lookup(pred.op, rep);
     },
+    [self](const curried_predicate& pred, const ids& selection) {
+      VAST_DEBUG("{} got predicate {} for {} candidates", *self, pred,
+                 rank(selection));
+      VAST_ASSERT(self->state.idx);
+      auto& idx = *self->state.idx;
+      auto rep = to_internal(idx.type(), make_view(pred.rhs));
+      return idx.lookup(pred.op, rep, selection);
+    },
     [self](atom::shutdown) {
       self->quit(caf::exit_reason::user_shutdown);
     },
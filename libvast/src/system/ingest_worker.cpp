@@ -0,0 +1,482 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vast/system/ingest_worker.hpp"
+
+#include "vast/fwd.hpp"
+
+#include "vast/chunk.hpp"
+#include "vast/concept/printable/to_string.hpp"
+#include "vast/concept/printable/vast/uuid.hpp"
+#include "vast/data.hpp"
+#include "vast/defaults.hpp"
+#include "vast/detail/assert.hpp"
+#include "vast/detail/fill_status_map.hpp"
+#include "vast/detail/notifying_stream_manager.hpp"
+#include "vast/detail/shutdown_stream_stage.hpp"
+#include "vast/logger.hpp"
+#include "vast/plugin.hpp"
+#include "vast/system/active_partition.hpp"
+#include "vast/system/report.hpp"
+#include "vast/system/status.hpp"
+#include "vast/table_slice.hpp"
+
+#include <caf/downstream.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+namespace vast::system {
+
+bool i_partition_selector::operator()(const type& filter,
+                                      const table_slice& slice) const {
+  return filter == slice.layout();
+}
+
+size_t ingest_worker_for(const type& layout, size_t num_workers) {
+  VAST_ASSERT(num_workers > 0);
+  return std::hash<type>{}(layout) % num_workers;
+}
+
+bool ingest_worker_selector::operator()(const ingest_worker_filter& filter,
+                                        const table_slice& slice) const {
+  return filter.num_workers == 0
+         || ingest_worker_for(slice.layout(), filter.num_workers) == filter.id;
+}
+
+// -- flush handling -----------------------------------------------------------
+
+void ingest_worker_state::add_flush_listener(flush_listener_actor listener) {
+  VAST_DEBUG("{} adds a new 'flush' subscriber: {}", *self, listener);
+  flush_listeners.emplace_back(std::move(listener));
+  // We may need to call `notify_listeners_if_clean` if the subscription
+  // happens after the data has already completely passed the worker, but
+  // we must not to call it before any data at all has arrived it would
+  // create a false positive.
+  if (!active_partitions.empty())
+    detail::notify_listeners_if_clean(*this, *stage);
+}
+
+void ingest_worker_state::notify_flush_listeners() {
+  VAST_DEBUG("{} sends 'flush' messages to {} listeners", *self,
+             flush_listeners.size());
+  // Listeners commonly query the index statistics after the flush, so the
+  // INDEX must know about all events we've seen so far.
+  send_statistics();
+  for (auto& listener : flush_listeners) {
+    bool downstream = false;
+    for (const auto& [_, active_partition] : active_partitions) {
+      if (active_partition.actor) {
+        self->send(active_partition.actor, atom::subscribe_v, atom::flush_v,
+                   listener);
+        downstream = true;
+      }
+    }
+    if (!downstream)
+      self->send(listener, atom::flush_v);
+  }
+  flush_listeners.clear();
+}
+
+// -- partition handling -------------------------------------------------------
+
+bool ingest_worker_state::owns(const type& layout) const {
+  return ingest_worker_for(layout, num_workers) == id;
+}
+
+void ingest_worker_state::create_active_partition(const type& layout) {
+  auto id = uuid::random();
+  auto& active_partition = active_partitions[layout];
+  // If we're using the global store, the importer already sends the table
+  // slices. (In the long run, this should probably be streamlined so that all
+  // data moves through the index. However, that requires some refactoring of
+  // the archive itself so it can handle multiple input streams.)
+  std::string store_name = {};
+  chunk_ptr store_header = chunk::make_empty();
+  if (store_plugin) {
+    store_name = store_plugin->name();
+    auto builder_and_header
+      = store_plugin->make_store_builder(accountant, filesystem, id);
+    if (!builder_and_header) {
+      VAST_ERROR("could not create new active partition: {}",
+                 render(builder_and_header.error()));
+      self->quit(builder_and_header.error());
+      return;
+    }
+    auto& [builder, header] = *builder_and_header;
+    store_header = header;
+    active_partition.store = builder;
+    active_partition.store_slot
+      = stage->add_outbound_path(active_partition.store);
+    stage->out().set_filter(active_partition.store_slot, layout);
+  } else {
+    store_name = "legacy_archive";
+    active_partition.store = global_store;
+  }
+  active_partition.spawn_time = std::chrono::steady_clock::now();
+  active_partition.actor
+    = self->spawn(::vast::system::active_partition, id, accountant, filesystem,
+                  index_opts, synopsis_opts,
+                  static_cast<store_actor>(active_partition.store), store_name,
+                  store_header);
+  active_partition.stream_slot
+    = stage->add_outbound_path(active_partition.actor);
+  stage->out().set_filter(active_partition.stream_slot, layout);
+  active_partition.capacity = adaptive_capacity(layout);
+  active_partition.events = 0;
+  active_partition.memory_usage = 0;
+  active_partition.id = id;
+  // The INDEX must know about the active partition before we quit, or it
+  // would never persist it. We keep track of unconfirmed registrations so
+  // that our shutdown can wait for them.
+  ++pending_registrations;
+  self
+    ->request(index, caf::infinite, atom::add_v, id, active_partition.actor)
+    .then(
+      [this](atom::ok) {
+        --pending_registrations;
+      },
+      [this, id](const caf::error& err) {
+        --pending_registrations;
+        VAST_WARN("{} failed to register active partition {} with the INDEX: "
+                  "{}",
+                  *self, id, err);
+      });
+  VAST_DEBUG("{} created new partition {}", *self, id);
+}
+
+void ingest_worker_state::decomission_active_partition(const type& layout) {
+  auto active_partition = active_partitions.find(layout);
+  VAST_ASSERT(active_partition != active_partitions.end());
+  auto id = active_partition->second.id;
+  active_partition->second.actor = {};
+  // Send buffered batches and remove active partition from the stream.
+  stage->out().fan_out_flush();
+  stage->out().close(active_partition->second.stream_slot);
+  if (store_plugin)
+    stage->out().close(active_partition->second.store_slot);
+  stage->out().force_emit_batches();
+  // The INDEX persists the partition once its input stream is closed. We
+  // update the statistics first so that they are always at least as recent as
+  // the persisted index state.
+  VAST_DEBUG("{} hands over active partition {} {}", *self, layout, id);
+  send_statistics();
+  self->send(index, atom::persist_v, id);
+}
+
+size_t ingest_worker_state::adaptive_capacity(const type& layout) const {
+  if (memory_budget == 0)
+    return partition_capacity;
+  auto profile = profiles.find(layout);
+  if (profile == profiles.end() || profile->second.bytes_per_event <= 0.0)
+    return partition_capacity;
+  // Layouts that we did not see for a while still get a fair share, so we
+  // count every layout with at least one event per second.
+  auto total_rate = 0.0;
+  for (const auto& [_, other] : profiles)
+    total_rate += std::max(other.event_rate, 1.0);
+  auto share = std::max(profile->second.event_rate, 1.0) / total_rate;
+  auto capacity = static_cast<size_t>(static_cast<double>(memory_budget)
+                                      * share
+                                      / profile->second.bytes_per_event);
+  auto lower_bound
+    = std::min(std::max(min_partition_size, size_t{1}), partition_capacity);
+  return std::clamp(capacity, lower_bound, partition_capacity);
+}
+
+void ingest_worker_state::update_event_rates() {
+  auto now = std::chrono::steady_clock::now();
+  auto elapsed = std::chrono::duration<double>{now - last_rate_update}.count();
+  last_rate_update = now;
+  if (elapsed <= 0.0)
+    return;
+  // An exponentially weighted moving average smoothes out bursts.
+  constexpr auto alpha = 0.5;
+  for (auto& [_, profile] : profiles) {
+    auto rate = static_cast<double>(std::exchange(profile.pending_events, 0))
+                / elapsed;
+    profile.event_rate = alpha * rate + (1.0 - alpha) * profile.event_rate;
+  }
+}
+
+void ingest_worker_state::measure_memory_usage() {
+  for (const auto& [layout, active_partition] : active_partitions) {
+    if (!active_partition.actor)
+      continue;
+    self
+      ->request(active_partition.actor,
+                defaults::system::initial_request_timeout, atom::status_v,
+                status_verbosity::info)
+      .then(
+        [this, layout = layout, id = active_partition.id](record& response) {
+          // The partition may have been decommissioned in the meantime.
+          auto active_partition = active_partitions.find(layout);
+          if (active_partition == active_partitions.end()
+              || active_partition->second.id != id)
+            return;
+          auto it = response.find("memory-usage");
+          if (it == response.end())
+            return;
+          const auto* memory_usage = caf::get_if<count>(&it->second);
+          if (!memory_usage)
+            return;
+          active_partition->second.memory_usage = *memory_usage;
+          if (active_partition->second.events > 0)
+            profiles[layout].bytes_per_event
+              = static_cast<double>(*memory_usage)
+                / static_cast<double>(active_partition->second.events);
+          enforce_memory_budget();
+        },
+        [this, id = active_partition.id](const caf::error& err) {
+          VAST_DEBUG("{} failed to measure the memory usage of active "
+                     "partition {}: {}",
+                     *self, id, err);
+        });
+  }
+}
+
+void ingest_worker_state::enforce_memory_budget() {
+  if (memory_budget == 0)
+    return;
+  auto total = size_t{0};
+  for (const auto& [_, active_partition] : active_partitions)
+    if (active_partition.actor)
+      total += active_partition.memory_usage;
+  while (total > memory_budget) {
+    auto largest = std::max_element(
+      active_partitions.begin(), active_partitions.end(),
+      [](const auto& lhs, const auto& rhs) {
+        return lhs.second.memory_usage < rhs.second.memory_usage;
+      });
+    if (largest == active_partitions.end() || !largest->second.actor
+        || largest->second.memory_usage == 0)
+      break;
+    VAST_VERBOSE("{} flushes active partition {} with {} events and {} bytes "
+                 "to stay within its memory budget of {} bytes",
+                 *self, largest->first, largest->second.events,
+                 largest->second.memory_usage, memory_budget);
+    total -= largest->second.memory_usage;
+    decomission_active_partition(largest->first);
+    active_partitions.erase(largest);
+  }
+}
+
+// -- introspection ------------------------------------------------------------
+
+void ingest_worker_state::send_statistics() {
+  if (stats.layouts.empty())
+    return;
+  self->send(index, atom::statistics_v, std::exchange(stats, {}));
+}
+
+void ingest_worker_state::send_report() {
+  auto memory_usage = size_t{0};
+  for (const auto& [_, active_partition] : active_partitions)
+    if (active_partition.actor)
+      memory_usage += active_partition.memory_usage;
+  auto msg = report{
+    .data = {
+      {"ingest-worker.events", std::exchange(events, 0)},
+      {"ingest-worker.active-partitions", active_partitions.size()},
+      {"ingest-worker.mailbox-size", self->mailbox().size()},
+      {"ingest-worker.memory-usage", memory_usage},
+    },
+    .metadata = {
+      {"worker", fmt::to_string(id)},
+    },
+  };
+  self->send(accountant, std::move(msg));
+}
+
+record ingest_worker_state::status(status_verbosity v) const {
+  auto result = record{};
+  if (v >= status_verbosity::detailed) {
+    result["id"] = count{id};
+    auto partitions = list{};
+    for (const auto& [layout, active_partition] : active_partitions) {
+      if (!active_partition.actor)
+        continue;
+      auto partition = record{};
+      partition["id"] = to_string(active_partition.id);
+      partition["layout"] = std::string{layout.name()};
+      partition["events"] = count{active_partition.events};
+      partition["remaining-capacity"] = count{active_partition.capacity};
+      partition["memory-usage"] = count{active_partition.memory_usage};
+      if (auto profile = profiles.find(layout); profile != profiles.end())
+        partition["event-rate"] = real{profile->second.event_rate};
+      partitions.push_back(std::move(partition));
+    }
+    result["active-partitions"] = std::move(partitions);
+  }
+  if (v >= status_verbosity::debug)
+    detail::fill_status_map(result, self);
+  return result;
+}
+
+ingest_worker_actor::behavior_type
+ingest_worker(ingest_worker_actor::stateful_pointer<ingest_worker_state> self,
+              index_actor index, size_t id, size_t num_workers,
+              accountant_actor accountant, filesystem_actor filesystem,
+              archive_actor global_store,
+              const vast::store_plugin* store_plugin,
+              size_t partition_capacity, size_t min_partition_size,
+              size_t memory_budget, duration active_partition_timeout,
+              caf::settings index_opts, index_config synopsis_opts) {
+  VAST_ASSERT(id < num_workers);
+  self->state.self = self;
+  self->state.index = std::move(index);
+  self->state.id = id;
+  self->state.num_workers = num_workers;
+  self->state.accountant = std::move(accountant);
+  self->state.filesystem = std::move(filesystem);
+  self->state.global_store = std::move(global_store);
+  self->state.store_plugin = store_plugin;
+  self->state.partition_capacity = partition_capacity;
+  self->state.min_partition_size = min_partition_size;
+  self->state.memory_budget = memory_budget;
+  self->state.last_rate_update = std::chrono::steady_clock::now();
+  self->state.active_partition_timeout = active_partition_timeout;
+  self->state.index_opts = std::move(index_opts);
+  self->state.synopsis_opts = std::move(synopsis_opts);
+  // Setup stream manager.
+  self->state.stage = detail::attach_notifying_stream_stage(
+    self,
+    /* continuous = */ true,
+    [](caf::unit_t&) {
+      // nop
+    },
+    [self](caf::unit_t&, caf::downstream<table_slice>& out, table_slice x) {
+      VAST_ASSERT(x.encoding() != table_slice_encoding::none);
+      auto&& layout = x.layout();
+      // The stages that feed the workers only route the layouts we own to us.
+      VAST_ASSERT(self->state.owns(layout));
+      // TODO: Consider switching layouts to a robin map to take advantage of
+      // transparent key lookup with string views, avoding the copy of the name
+      // here.
+      self->state.stats.layouts[std::string{layout.name()}].count += x.rows();
+      self->state.events += x.rows();
+      self->state.profiles[layout].pending_events += x.rows();
+      auto& active = self->state.active_partitions[layout];
+      if (!active.actor) {
+        self->state.create_active_partition(layout);
+      } else if (x.rows() > active.capacity) {
+        VAST_DEBUG("{} exceeds active capacity by {} rows", *self,
+                   x.rows() - active.capacity);
+        VAST_VERBOSE("{} flushes active partition {} with {}/{} events", *self,
+                     layout, active.events, active.events + active.capacity);
+        self->state.decomission_active_partition(layout);
+        self->state.create_active_partition(layout);
+      }
+      out.push(x);
+      if (active.events == 0 && x.rows() > active.capacity) {
+        if (x.rows() > self->state.partition_capacity)
+          VAST_WARN("{} got table slice with {} rows that exceeds the "
+                    "default partition capacity of {} rows",
+                    *self, x.rows(), self->state.partition_capacity);
+        active.capacity = 0;
+      } else {
+        VAST_ASSERT(active.capacity >= x.rows());
+        active.capacity -= x.rows();
+      }
+      active.events += x.rows();
+    },
+    [self](caf::unit_t&, const caf::error& err) {
+      // We get an 'unreachable' error when the stream becomes unreachable
+      // during actor destruction; in this case we can't use `self->state`
+      // anymore since it will already be destroyed.
+      VAST_DEBUG("ingest worker finalized streaming with error {}",
+                 render(err));
+      if (err && err != caf::exit_reason::unreachable) {
+        if (err != caf::exit_reason::user_shutdown)
+          VAST_ERROR("{} got a stream error: {}", *self, render(err));
+        else
+          VAST_DEBUG("{} got a user shutdown error: {}", *self, render(err));
+        // The INDEX monitors its workers and shuts down as well.
+        self->send_exit(self, err);
+      }
+    },
+    caf::policy::arg<caf::broadcast_downstream_manager<
+      table_slice, vast::type, i_partition_selector>>{});
+  self->set_exit_handler([self](const caf::exit_msg& msg) {
+    VAST_DEBUG("{} received EXIT from {} with reason: {}", *self, msg.source,
+               msg.reason);
+    if (!self->state.stage->running())
+      return;
+    // Flush buffered batches and end stream. The INDEX takes care of
+    // persisting the active partitions, which in turn wait for their input
+    // streams to close.
+    detail::shutdown_stream_stage(self->state.stage);
+    self->state.send_statistics();
+    self->send(self, atom::internal_v, atom::shutdown_v);
+  });
+  self->delayed_send(self, defaults::system::telemetry_rate,
+                     atom::telemetry_v);
+  if (self->state.accountant)
+    self->send(self->state.accountant, atom::announce_v, self->name());
+  return {
+    [self](
+      caf::stream<table_slice> in) -> caf::inbound_stream_slot<table_slice> {
+      VAST_DEBUG("{} got a new stream source", *self);
+      return self->state.stage->add_inbound_path(in);
+    },
+    [self](atom::subscribe, atom::flush, flush_listener_actor listener) {
+      VAST_DEBUG("{} adds flush listener", *self);
+      self->state.add_flush_listener(std::move(listener));
+    },
+    [self](atom::telemetry) {
+      self->delayed_send(self, defaults::system::telemetry_rate,
+                         atom::telemetry_v);
+      self->state.send_statistics();
+      self->state.update_event_rates();
+      self->state.measure_memory_usage();
+      if (self->state.accountant)
+        self->state.send_report();
+      if (self->state.active_partition_timeout.count() > 0) {
+        auto decomissioned = std::vector<type>{};
+        for (const auto& [layout, active_partition] :
+             self->state.active_partitions) {
+          if (active_partition.actor
+              && active_partition.spawn_time
+                     + self->state.active_partition_timeout
+                   < std::chrono::steady_clock::now()) {
+            VAST_VERBOSE("{} flushes active partition {} with {}/{} events "
+                         "after {} timeout",
+                         *self, layout, active_partition.events,
+                         active_partition.events + active_partition.capacity,
+                         data{self->state.active_partition_timeout});
+            self->state.decomission_active_partition(layout);
+            decomissioned.push_back(layout);
+          }
+        }
+        for (const auto& layout : decomissioned)
+          self->state.active_partitions.erase(layout);
+      }
+    },
+    [self](atom::internal, atom::shutdown) {
+      // Closing outbound paths stay around until all their batches were
+      // acknowledged, and the INDEX must confirm all active partitions, so we
+      // wait with quitting until then.
+      if (!self->state.stage->out().clean()
+          || self->state.pending_registrations > 0) {
+        using namespace std::chrono_literals;
+        self->delayed_send(self, 50ms, atom::internal_v, atom::shutdown_v);
+        return;
+      }
+      VAST_DEBUG("{} shuts down after flushing all buffered table slices",
+                 *self);
+      self->quit(caf::exit_reason::user_shutdown);
+    },
+    // -- status_client_actor --------------------------------------------------
+    [self](atom::status, status_verbosity v) { //
+      return self->state.status(v);
+    },
+  };
+}
+
+} // namespace vast::system
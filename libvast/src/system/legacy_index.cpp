@@ -1288,6 +1288,27 @@ legacy_index(index_actor::stateful_pointer<legacy_index_state> self,
     [self](atom::importer, idspace_distributor_actor idspace_distributor) {
       self->state.importer = std::move(idspace_distributor);
     },
+    // The legacy index does not use workers and handles the table slice stream
+    // itself, so the importer streams into it directly.
+    [](atom::get, atom::worker) -> std::vector<ingest_worker_actor> {
+      return {};
+    },
+    [self](atom::add, const uuid& id,
+           const active_partition_actor&) -> caf::result<atom::ok> {
+      return caf::make_error(ec::logic_error,
+                             fmt::format("{} ignores unexpected active "
+                                         "partition {}",
+                                         *self, id));
+    },
+    [self](atom::persist, const uuid& id) {
+      VAST_WARN("{} ignores unexpected active partition {}", *self, id);
+    },
+    [](atom::statistics, const index_statistics&) {
+      // nop
+    },
+    [](atom::internal, atom::merge) {
+      // nop
+    },
     [self](atom::apply, transform_ptr transform,
            std::vector<vast::uuid> old_partition_ids,
            keep_original_partition keep) -> caf::result<partition_info> {
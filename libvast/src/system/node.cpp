@@ -36,9 +36,9 @@
 #include "vast/plugin.hpp"
 #include "vast/system/accountant.hpp"
 #include "vast/system/accountant_config.hpp"
+#include "vast/system/concurrent_filesystem.hpp"
 #include "vast/system/configuration.hpp"
 #include "vast/system/node.hpp"
-#include "vast/system/posix_filesystem.hpp"
 #include "vast/system/shutdown.hpp"
 #include "vast/system/spawn_archive.hpp"
 #include "vast/system/spawn_arguments.hpp"
@@ -66,6 +66,7 @@
 #include <caf/io/middleman.hpp>
 #include <caf/settings.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <csignal>
 #include <fstream>
@@ -609,7 +610,17 @@ node(node_actor::stateful_pointer<node_state> self, std::string name,
   node_state::component_factory = make_component_factory();
   node_state::command_factory = make_command_factory();
   // Initialize the file system with the node directory as root.
-  auto fs = self->spawn<caf::detached>(posix_filesystem, self->state.dir);
+  const auto& opts = content(self->system().config());
+  auto read_workers
+    = std::max(caf::get_or(opts, "vast.filesystem-read-workers",
+                           defaults::system::filesystem_read_workers),
+               size_t{1});
+  auto write_workers
+    = std::max(caf::get_or(opts, "vast.filesystem-write-workers",
+                           defaults::system::filesystem_write_workers),
+               size_t{1});
+  auto fs = self->spawn(concurrent_filesystem, self->state.dir, read_workers,
+                        write_workers);
   auto err
     = register_component(self, caf::actor_cast<caf::actor>(fs), "filesystem");
   VAST_ASSERT(err == caf::none); // Registration cannot fail; empty registry.
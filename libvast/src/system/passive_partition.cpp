@@ -18,6 +18,7 @@
 #include "vast/concept/printable/vast/table_slice.hpp"
 #include "vast/concept/printable/vast/uuid.hpp"
 #include "vast/detail/assert.hpp"
+#include "vast/detail/legacy_deserialize.hpp"
 #include "vast/detail/notifying_stream_manager.hpp"
 #include "vast/detail/partition_common.hpp"
 #include "vast/detail/settings.hpp"
@@ -66,12 +67,16 @@ indexer_actor passive_partition_state::indexer_at(size_t position) const {
   if (!indexer) {
     auto qualified_index = flatbuffer->indexes()->Get(position);
     auto index = qualified_index->index();
-    auto data = index->data();
+    auto data = value_index_bytes(as_bytes(partition_chunk), *index);
+    if (!data) {
+      VAST_ERROR("{} failed to locate indexer at {} with error: {}", *self,
+                 position, render(data.error()));
+      return {};
+    }
     value_index_ptr state_ptr;
-    if (auto error = fbs::deserialize_bytes(data, state_ptr)) {
-      VAST_ERROR("{} failed to deserialize indexer at {} with error: "
-                 "{}",
-                 *self, position, render(error));
+    detail::legacy_deserializer sink(*data);
+    if (!sink(state_ptr)) {
+      VAST_ERROR("{} failed to deserialize indexer at {}", *self, position);
       return {};
     }
     indexer = self->spawn(passive_indexer, id, std::move(state_ptr));
@@ -89,6 +94,24 @@ passive_partition_state::type_ids() const {
   return type_ids_;
 }
 
+caf::expected<std::span<const std::byte>>
+value_index_bytes(std::span<const std::byte> partition,
+                  const fbs::value_index::detail::LegacyValueIndex& index) {
+  if (const auto* data = index.data())
+    return as_bytes(*data);
+  const auto* section = index.section();
+  if (!section)
+    return caf::make_error(ec::format_error, "missing data in index");
+  if (section->offset() > partition.size()
+      || section->size() > partition.size() - section->offset())
+    return caf::make_error(ec::format_error,
+                           fmt::format("section of {} bytes at offset {} "
+                                       "exceeds partition of {} bytes",
+                                       section->size(), section->offset(),
+                                       partition.size()));
+  return partition.subspan(section->offset(), section->size());
+}
+
 caf::error unpack(const fbs::partition::LegacyPartition& partition,
                   passive_partition_state& state) {
   // Check that all fields exist.
@@ -125,7 +148,7 @@ caf::error unpack(const fbs::partition::LegacyPartition& partition,
     if (!index)
       return caf::make_error(ec::format_error, //
                              "missing index name in qualified index");
-    if (!index->data())
+    if (!index->data() && !index->section())
       return caf::make_error(ec::format_error, "missing data in index");
   }
   if (auto error = unpack(*partition.uuid(), state.id))
@@ -225,6 +248,7 @@ partition_actor::behavior_type passive_partition(
   // We send a "read" to the fs actor and upon receiving the result deserialize
   // the flatbuffer and switch to the "normal" partition behavior for responding
   // to queries.
+  auto load_start = std::chrono::steady_clock::now();
   self->request(self->state.filesystem, caf::infinite, atom::mmap_v, path)
     .then(
       [=](chunk_ptr chunk) {
@@ -303,9 +327,19 @@ partition_actor::behavior_type passive_partition(
         // Delegate all deferred evaluations now that we have the partition chunk.
         VAST_DEBUG("{} delegates {} deferred evaluations", *self,
                    self->state.deferred_evaluations.size());
-        for (auto&& [expr, rp] :
-             std::exchange(self->state.deferred_evaluations, {}))
-          rp.delegate(static_cast<partition_actor>(self), std::move(expr));
+        duration load_runtime = std::chrono::steady_clock::now() - load_start;
+        for (auto&& [query, rp] :
+             std::exchange(self->state.deferred_evaluations, {})) {
+          if (query.tracer)
+            self->send(query.tracer,
+                       query_span{
+                         .partition = self->state.id,
+                         .name = "load",
+                         .runtime = load_runtime,
+                         .values = {{"bytes", count{chunk->size()}}},
+                       });
+          rp.delegate(static_cast<partition_actor>(self), std::move(query));
+        }
       },
       [=](caf::error err) {
         VAST_ERROR("{} failed to load partition: {}", *self, render(err));
@@ -350,7 +384,8 @@ partition_actor::behavior_type passive_partition(
       auto triples = detail::evaluate(self->state, query.expr);
       if (triples.empty())
         return uint64_t{0};
-      auto eval = self->spawn(evaluator, query.expr, triples);
+      auto eval = self->spawn(evaluator, query.expr, triples, query.tracer,
+                              self->state.id);
       self->request(eval, caf::infinite, atom::run_v)
         .then(
           [self, rp, start, query = std::move(query)](const ids& hits) mutable {
@@ -364,6 +399,14 @@ partition_actor::behavior_type passive_partition(
                        rank(hits),
                        metrics_metadata{{"query", std::move(id_str)},
                                         {"partition-type", "passive"}});
+            if (query.tracer)
+              self->send(query.tracer,
+                         query_span{
+                           .partition = self->state.id,
+                           .name = "evaluation",
+                           .runtime = runtime,
+                           .values = {{"hits", count{rank(hits)}}},
+                         });
             // TODO: Use the first path if the expression can be evaluated
             // exactly.
             auto* count = caf::get_if<query::count>(&query.cmd);
@@ -421,13 +464,13 @@ partition_actor::behavior_type passive_partition(
       result["size"] = self->state.partition_chunk->size();
       size_t mem_indexers = 0;
       for (size_t i = 0; i < self->state.indexers.size(); ++i) {
-        if (self->state.indexers[i])
-          mem_indexers += sizeof(indexer_state)
-                          + self->state.flatbuffer->indexes()
-                              ->Get(i)
-                              ->index()
-                              ->data()
-                              ->size();
+        if (!self->state.indexers[i])
+          continue;
+        mem_indexers += sizeof(indexer_state);
+        const auto* index = self->state.flatbuffer->indexes()->Get(i)->index();
+        if (auto data = value_index_bytes(
+              as_bytes(self->state.partition_chunk), *index))
+          mem_indexers += data->size();
       }
       result["memory-usage-indexers"] = mem_indexers;
       auto x = self->state.partition_chunk->incore();
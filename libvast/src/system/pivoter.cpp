@@ -10,12 +10,13 @@
 
 #include "vast/fwd.hpp"
 
-#include "vast/command.hpp"
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/expression.hpp"
-#include "vast/detail/string.hpp"
 #include "vast/expression.hpp"
+#include "vast/hash/hash.hpp"
 #include "vast/logger.hpp"
+#include "vast/query.hpp"
+#include "vast/system/query_cursor.hpp"
 #include "vast/system/query_status.hpp"
 #include "vast/table_slice.hpp"
 #include "vast/table_slice_column.hpp"
@@ -24,6 +25,9 @@
 #include <caf/event_based_actor.hpp>
 #include <caf/settings.hpp>
 
+#include <algorithm>
+#include <iterator>
+
 namespace vast::system {
 
 namespace {
@@ -70,32 +74,75 @@ common_field(const pivoter_state& st, const type& t) {
   return {};
 }
 
+/// Issues the next query for the target type, unless one is already running.
+void run_next_query(caf::stateful_actor<pivoter_state>* self) {
+  auto& st = self->state;
+  if (st.running || !st.sink)
+    return;
+  auto it = std::find_if(st.pending.begin(), st.pending.end(),
+                         [](const auto& x) {
+                           return !x.second.empty();
+                         });
+  if (it == st.pending.end()) {
+    if (st.initial_query_completed) {
+      VAST_DEBUG("{} completed {} queries for {}", *self, st.num_queries,
+                 st.target);
+      self->quit();
+    }
+    return;
+  }
+  auto& [field, values] = *it;
+  auto xs = list{};
+  if (values.size() <= st.max_values_per_query) {
+    xs = std::exchange(values, {});
+  } else {
+    auto first = values.end() - st.max_values_per_query;
+    xs.assign(std::make_move_iterator(first),
+              std::make_move_iterator(values.end()));
+    values.erase(first, values.end());
+  }
+  VAST_DEBUG("{} queries for {} {}", *self, xs.size(), field);
+  auto expr = conjunction{predicate{meta_extractor{meta_extractor::type},
+                                    relational_operator::equal,
+                                    data{st.target}},
+                          predicate{field_extractor{field},
+                                    relational_operator::in, data{xs}}};
+  auto query
+    = query::make_extract(st.sink, query::extract::drop_ids, std::move(expr));
+  st.running.emplace();
+  ++st.num_queries;
+  self->request(st.index, caf::infinite, atom::evaluate_v, std::move(query))
+    .then(
+      [=](const query_cursor& cursor) {
+        VAST_DEBUG("{} got lookup handle {}, scheduled {}/{} partitions",
+                   *self, cursor.id, cursor.scheduled_partitions,
+                   cursor.candidate_partitions);
+        auto& running = *self->state.running;
+        running.id = cursor.id;
+        running.expected = cursor.candidate_partitions;
+        running.scheduled = cursor.scheduled_partitions;
+      },
+      [=](const caf::error& error) {
+        VAST_ERROR("{} failed to query the index: {}", *self, error);
+        self->quit(error);
+      });
+}
+
 } // namespace
 
 pivoter_state::pivoter_state(caf::event_based_actor*) {
   // nop
 }
 
-caf::behavior pivoter(caf::stateful_actor<pivoter_state>* self, node_actor node,
-                      std::string target, expression expr) {
+caf::behavior pivoter(caf::stateful_actor<pivoter_state>* self,
+                      index_actor index, std::string target, expression expr,
+                      size_t max_values_per_query) {
   auto& st = self->state;
   st.self = self;
-  st.node = node;
+  st.index = std::move(index);
   st.expr = std::move(expr);
   st.target = std::move(target);
-  auto quit_if_done = [=]() {
-    auto& st = self->state;
-    if (st.initial_query_completed && st.running_exporters == 0)
-      self->quit();
-  };
-  self->set_down_handler([=]([[maybe_unused]] const caf::down_msg& msg) {
-    // Only the spawned EXPORTERs are expected to send down messages.
-    auto& st = self->state;
-    st.running_exporters--;
-    VAST_DEBUG("{} received DOWN from {} outstanding requests: {}", *self,
-               msg.source, st.running_exporters);
-    quit_if_done();
-  });
+  st.max_values_per_query = std::max(max_values_per_query, size_t{1});
   return {
     [=](vast::table_slice slice) {
       auto& st = self->state;
@@ -114,62 +161,62 @@ caf::behavior pivoter(caf::stateful_actor<pivoter_state>* self, node_actor node,
         break;
       }
       VAST_ASSERT(column);
-      auto xs = list{};
+      auto it = std::find_if(st.pending.begin(), st.pending.end(),
+                             [&](const auto& x) {
+                               return x.first == pivot_field->name;
+                             });
+      if (it == st.pending.end())
+        it = st.pending.emplace(st.pending.end(),
+                                std::string{pivot_field->name}, list{});
+      auto& values = it->second;
+      const auto num_pending = values.size();
       for (size_t i = 0; i < column->size(); ++i) {
-        auto data = materialize((*column)[i]);
-        auto x = caf::get_if<std::string>(&data);
+        auto x = (*column)[i];
         // Skip if no value
-        if (!x)
+        if (caf::holds_alternative<caf::none_t>(x))
           continue;
-        // Skip if ID was already requested
-        if (st.requested_ids.count(*x) > 0)
+        // Skip if ID was already requested; we only keep a digest of each
+        // value to keep the memory footprint low.
+        if (!st.requested_ids.insert(vast::hash(x)).second)
           continue;
-        xs.push_back(*x);
-        st.requested_ids.insert(*x);
+        values.push_back(materialize(x));
       }
-      if (xs.empty()) {
+      if (values.size() == num_pending) {
         VAST_DEBUG("{} already queried for all {}", *self, pivot_field->name);
         return;
       }
-      auto expr
-        = conjunction{predicate{meta_extractor{meta_extractor::type},
-                                relational_operator::equal, data{st.target}},
-                      predicate{field_extractor{std::string{pivot_field->name}},
-                                relational_operator::in, data{xs}}};
-      // TODO(ch9411): Drop the conversion to a string when node actors can
-      //               be spawned without going through an invocation.
-      auto query = to_string(expr);
-      VAST_DEBUG("{} queries for {} {}", *self, xs.size(), pivot_field->name);
-      VAST_TRACE_SCOPE("{} spawns new exporter with query {}", *self, query);
-      auto exporter_options = caf::settings{};
-      caf::put(exporter_options, "vast.export.disable-taxonomies", true);
-      auto exporter_invocation
-        = invocation{std::move(exporter_options), "spawn exporter", {query}};
-      ++self->state.running_exporters;
-      self->request(st.node, caf::infinite, atom::spawn_v, exporter_invocation)
-        .then(
-          [=](caf::actor handle) {
-            auto exporter = caf::actor_cast<exporter_actor>(handle);
-            VAST_DEBUG("{} registers exporter {}", *self, exporter);
-            self->monitor(exporter);
-            self->send(exporter, atom::sink_v, self->state.sink);
-            self->send(exporter, atom::run_v);
-          },
-          [=](caf::error error) {
-            --self->state.running_exporters;
-            VAST_ERROR("{} failed to spawn exporter: {}", *self, render(error));
-          });
-      ;
+      run_next_query(self);
+    },
+    [=](atom::done) {
+      auto& st = self->state;
+      if (!st.running) {
+        VAST_WARN("{} received an unexpected done signal", *self);
+        return;
+      }
+      auto& running = *st.running;
+      running.received += running.scheduled;
+      if (running.received < running.expected) {
+        // There is no need to page through the results, so we let the INDEX
+        // evaluate all remaining partitions at once.
+        running.scheduled = running.expected - running.received;
+        VAST_DEBUG("{} asks index to process {} more partitions", *self,
+                   running.scheduled);
+        self->send(st.index, running.id, running.scheduled);
+        return;
+      }
+      st.running.reset();
+      run_next_query(self);
     },
     [=](std::string name, query_status) {
       VAST_DEBUG("{} received final status from {}", *self, name);
       self->state.initial_query_completed = true;
-      quit_if_done();
+      run_next_query(self);
     },
     [=](atom::sink, const caf::actor& sink) {
       VAST_DEBUG("{} registers sink {}", *self, sink);
       auto& st = self->state;
       st.sink = sink;
+      run_next_query(self);
     },
   };
 }
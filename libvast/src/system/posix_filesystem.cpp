@@ -11,6 +11,7 @@
 #include "vast/chunk.hpp"
 #include "vast/io/read.hpp"
 #include "vast/io/save.hpp"
+#include "vast/io/write.hpp"
 #include "vast/system/status.hpp"
 
 #include <caf/config_value.hpp>
@@ -18,10 +19,35 @@
 #include <caf/result.hpp>
 #include <caf/settings.hpp>
 
+#include <chrono>
 #include <filesystem>
 
 namespace vast::system {
 
+namespace {
+
+/// Records the latency of a filesystem operation when going out of scope.
+class latency_timer {
+public:
+  explicit latency_timer(filesystem_statistics::ops& ops)
+    : ops_{ops}, start_{std::chrono::steady_clock::now()} {
+    // nop
+  }
+
+  ~latency_timer() {
+    ops_.latency.add(std::chrono::steady_clock::now() - start_);
+  }
+
+  latency_timer(const latency_timer&) = delete;
+  latency_timer& operator=(const latency_timer&) = delete;
+
+private:
+  filesystem_statistics::ops& ops_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace
+
 filesystem_actor::behavior_type
 posix_filesystem(filesystem_actor::stateful_pointer<posix_filesystem_state> self,
                  const std::filesystem::path& root) {
@@ -34,6 +60,7 @@ posix_filesystem(filesystem_actor::stateful_pointer<posix_filesystem_state> self
                                                 "disk");
       const auto path
         = filename.is_absolute() ? filename : self->state.root / filename;
+      auto t = latency_timer{self->state.stats.writes};
       if (auto err = io::save(path, as_bytes(chk))) {
         ++self->state.stats.writes.failed;
         return err;
@@ -43,6 +70,23 @@ posix_filesystem(filesystem_actor::stateful_pointer<posix_filesystem_state> self
         return atom::ok_v;
       }
     },
+    [self](atom::write, const std::filesystem::path& filename,
+           uint64_t offset, const chunk_ptr& chk) -> caf::result<atom::ok> {
+      if (chk == nullptr)
+        return caf::make_error(ec::logic_error, "tried to write a nullptr to "
+                                                "disk");
+      const auto path
+        = filename.is_absolute() ? filename : self->state.root / filename;
+      auto t = latency_timer{self->state.stats.writes};
+      if (auto err = io::write(path, offset, as_bytes(chk))) {
+        ++self->state.stats.writes.failed;
+        return err;
+      } else {
+        ++self->state.stats.writes.successful;
+        self->state.stats.writes.bytes += chk->size();
+        return atom::ok_v;
+      }
+    },
     [self](atom::read,
            const std::filesystem::path& filename) -> caf::result<chunk_ptr> {
       const auto path
@@ -54,6 +98,7 @@ posix_filesystem(filesystem_actor::stateful_pointer<posix_filesystem_state> self
         ++self->state.stats.checks.failed;
         return caf::make_error(ec::no_such_file, err.message());
       }
+      auto t = latency_timer{self->state.stats.reads};
       if (auto bytes = io::read(path)) {
         ++self->state.stats.reads.successful;
         self->state.stats.reads.bytes += bytes->size();
@@ -74,6 +119,7 @@ posix_filesystem(filesystem_actor::stateful_pointer<posix_filesystem_state> self
         ++self->state.stats.checks.failed;
         return caf::make_error(ec::no_such_file, err.message());
       }
+      auto t = latency_timer{self->state.stats.mmaps};
       if (auto chk = chunk::mmap(path)) {
         ++self->state.stats.mmaps.successful;
         self->state.stats.mmaps.bytes += chk->get()->size();
@@ -96,6 +142,7 @@ posix_filesystem(filesystem_actor::stateful_pointer<posix_filesystem_state> self
                                            path, err.message()));
       }
       ++self->state.stats.checks.successful;
+      auto t = latency_timer{self->state.stats.erases};
       std::filesystem::remove_all(path, err);
       if (err) {
         ++self->state.stats.erases.failed;
@@ -111,22 +158,8 @@ posix_filesystem(filesystem_actor::stateful_pointer<posix_filesystem_state> self
       auto result = record{};
       if (v >= status_verbosity::info)
         result["type"] = "POSIX";
-      if (v >= status_verbosity::debug) {
-        auto ops = record{};
-        auto add_stats = [&](auto& name, auto& stats) {
-          auto dict = record{};
-          dict["successful"] = count{stats.successful};
-          dict["failed"] = count{stats.failed};
-          dict["bytes"] = count{stats.bytes};
-          ops[name] = std::move(dict);
-        };
-        add_stats("checks", self->state.stats.checks);
-        add_stats("writes", self->state.stats.writes);
-        add_stats("reads", self->state.stats.reads);
-        add_stats("mmaps", self->state.stats.mmaps);
-        add_stats("erases", self->state.stats.erases);
-        result["operations"] = std::move(ops);
-      }
+      if (v >= status_verbosity::debug)
+        result["operations"] = to_record(self->state.stats, v);
       return result;
     },
   };
@@ -121,13 +121,30 @@ void source_state::send_report() {
 
 void source_state::filter_and_push(
   table_slice slice, const std::function<void(table_slice)>& push_to_out) {
+  // Hand off table slices to a node on the same host via shared memory rather
+  // than serializing them, if requested. Input transformations that replace
+  // table slices fall back to regular serialization for their results.
+  auto push = [&](table_slice out) {
+    if (reader->shared_memory_) {
+      if (auto shared_out = copy_to_shared_memory(
+            out, reader->shared_memory_timeout_)) {
+        push_to_out(std::move(*shared_out));
+        return;
+      } else {
+        VAST_WARN("{} falls back to serializing table slices: {}",
+                  reader->name(), shared_out.error());
+        reader->shared_memory_ = false;
+      }
+    }
+    push_to_out(std::move(out));
+  };
   const auto unfiltered_rows = slice.rows();
   if (filter) {
     if (auto filtered_slice = vast::filter(std::move(slice), *filter)) {
       VAST_DEBUG("{} forwards {}/{} produced {} events after filtering",
                  reader->name(), filtered_slice->rows(), unfiltered_rows,
                  slice.layout());
-      push_to_out(std::move(*filtered_slice));
+      push(std::move(*filtered_slice));
     } else {
       VAST_DEBUG("{} forwards 0/{} produced {} events after filtering",
                  reader->name(), unfiltered_rows, slice.layout());
@@ -135,7 +152,7 @@ void source_state::filter_and_push(
   } else {
     VAST_DEBUG("{} forwards {} produced {} events", reader->name(),
                unfiltered_rows, slice.layout());
-    push_to_out(std::move(slice));
+    push(std::move(slice));
   }
 }
 
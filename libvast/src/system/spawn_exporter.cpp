@@ -55,6 +55,9 @@ spawn_exporter(node_actor::stateful_pointer<node_state> self,
   // Mark the query as low priority if explicitly requested.
   if (get_or(args.inv.options, "vast.export.low-priority", false))
     query_opts = query_opts + low_priority;
+  // Collect the execution profile of the query if requested.
+  if (get_or(args.inv.options, "vast.export.trace", false))
+    query_opts = query_opts + trace;
   auto handle
     = self->spawn(exporter, *expr, query_opts, std::move(*transforms));
   VAST_VERBOSE("{} spawned an exporter for {}", *self, to_string(*expr));
@@ -64,17 +67,8 @@ spawn_exporter(node_actor::stateful_pointer<node_state> self,
   if (accountant)
     self->send(handle, accountant);
   if (importer && has_continuous_option(query_opts))
-    self
-      ->request(importer, caf::infinite,
-                static_cast<stream_sink_actor<table_slice>>(handle))
-      .then(
-        [=](caf::outbound_stream_slot<table_slice>) {
-          // nop
-        },
-        [=, importer = importer](caf::error err) {
-          VAST_ERROR("{} failed to connect to importer {}: {}", *self, importer,
-                     err);
-        });
+    self->send(importer, atom::subscribe_v, *expr,
+               static_cast<continuous_query_subscriber_actor>(handle));
   if (index) {
     VAST_DEBUG("{} connects index to new exporter", *self);
     self->send(handle, index);
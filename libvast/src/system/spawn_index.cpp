@@ -12,6 +12,7 @@
 #include "vast/concept/parseable/to.hpp"
 #include "vast/concept/parseable/vast/time.hpp"
 #include "vast/defaults.hpp"
+#include "vast/detail/settings.hpp"
 #include "vast/error.hpp"
 #include "vast/logger.hpp"
 #include "vast/system/catalog.hpp"
@@ -73,6 +74,11 @@ spawn_index(node_actor::stateful_pointer<node_state> self,
     VAST_VERBOSE("{} spawned the index", *self);
     return caf::actor_cast<caf::actor>(handle);
   }
+  auto memory_budget = detail::get_bytesize(
+    args.inv.options, "vast.active-partition-memory-budget",
+    sd::active_partition_memory_budget);
+  if (!memory_budget)
+    return memory_budget.error();
   auto handle = self->spawn(
     index, accountant, filesystem, archive, catalog, type_registry, indexdir,
     // TODO: Pass these options as a vast::data object instead.
@@ -82,6 +88,9 @@ spawn_index(node_actor::stateful_pointer<node_state> self,
     opt("vast.max-resident-partitions", sd::max_in_mem_partitions),
     opt("vast.max-taste-partitions", sd::taste_partitions),
     opt("vast.max-queries", sd::num_query_supervisors),
+    opt("vast.ingest-workers", sd::num_ingest_workers), *memory_budget,
+    opt("vast.min-partition-size", sd::min_partition_size),
+    opt("vast.partition-merge-interval", sd::partition_merge_interval),
     std::filesystem::path{opt("vast.catalog-dir", indexdir.string())},
     std::move(index_config));
   VAST_VERBOSE("{} spawned the index", *self);
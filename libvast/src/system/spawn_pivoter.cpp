@@ -10,12 +10,15 @@
 
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/expression.hpp"
+#include "vast/defaults.hpp"
+#include "vast/error.hpp"
 #include "vast/logger.hpp"
 #include "vast/system/node.hpp"
 #include "vast/system/pivoter.hpp"
 #include "vast/system/spawn_arguments.hpp"
 
 #include <caf/event_based_actor.hpp>
+#include <caf/settings.hpp>
 #include <caf/typed_event_based_actor.hpp>
 
 namespace vast::system {
@@ -39,7 +42,14 @@ spawn_pivoter(node_actor::stateful_pointer<node_state> self,
       return expr_.error();
     expr = *expr_;
   }
-  auto handle = self->spawn(pivoter, self, target_name, expr);
+  auto [index] = self->state.registry.find<index_actor>();
+  if (!index)
+    return caf::make_error(ec::missing_component, "index");
+  auto max_values_per_query
+    = caf::get_or(args.inv.options, "vast.pivot.max-values-per-query",
+                  defaults::pivot::max_values_per_query);
+  auto handle = self->spawn(pivoter, index, target_name, expr,
+                            max_values_per_query);
   VAST_VERBOSE("{} spawned a pivoter for {}", *self, to_string(expr));
   return handle;
 }
@@ -44,8 +44,11 @@ spawn_source(node_actor::stateful_pointer<node_state> self,
   if (!type_registry)
     return caf::make_error(ec::missing_component, "type-registry");
   const auto format = std::string{args.inv.name()};
+  // Sources inside the node have nothing to gain from sharing memory.
+  auto inv = args.inv;
+  caf::put(inv.options, "vast.import.shared-memory", false);
   auto src_result
-    = make_source(self->system(), format, args.inv,
+    = make_source(self->system(), format, inv,
                   caf::actor_cast<accountant_actor>(accountant),
                   caf::actor_cast<type_registry_actor>(type_registry),
                   caf::actor_cast<importer_actor>(importer),
@@ -70,7 +70,9 @@ transformer_stream_stage_ptr attach_transform_stage(
     },
     [=](caf::unit_t&, const caf::error&) {
       // nop
-    });
+    },
+    caf::policy::arg<caf::broadcast_downstream_manager<
+      table_slice, ingest_worker_filter, ingest_worker_selector>>{});
 }
 
 transformer_actor::behavior_type
@@ -116,6 +118,21 @@ transformer(transformer_actor::stateful_pointer<transformer_state> self,
       self->state.stage->add_outbound_path(sink,
                                            std::make_tuple(std::move(name)));
     },
+    [self](const ingest_worker_actor& worker, size_t id, size_t num_workers)
+      -> caf::outbound_stream_slot<table_slice> {
+      if (worker->getf(caf::abstract_actor::is_shutting_down_flag)) {
+        VAST_DEBUG("{} ignores ingest worker {} because the actor is already "
+                   "shutting down",
+                   self->state.transformer_name, worker);
+        return {};
+      }
+      VAST_DEBUG("{} adds ingest worker {} ({}/{})",
+                 self->state.transformer_name, worker, id, num_workers);
+      auto slot = self->state.stage->add_outbound_path(worker);
+      self->state.stage->out().set_filter(
+        slot, ingest_worker_filter{id, num_workers});
+      return slot;
+    },
     [self](caf::stream<detail::framed<table_slice>> in)
       -> caf::inbound_stream_slot<detail::framed<table_slice>> {
       // There's a race condition (mostly when using `vast -N`) that prevents
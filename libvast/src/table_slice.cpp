@@ -29,6 +29,8 @@
 
 #include <cstddef>
 #include <span>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace vast {
 
@@ -358,6 +360,20 @@ void table_slice::append_column_to_index(table_slice::size_type column,
   return visit(f, as_flatbuffer(chunk_));
 }
 
+detail::generator<data_view>
+table_slice::values(table_slice::size_type column) const {
+  VAST_ASSERT(column < columns());
+  auto f = detail::overload{
+    []() noexcept -> detail::generator<data_view> {
+      die("cannot access data of invalid table slice");
+    },
+    [&](const auto& encoded) noexcept {
+      return state(encoded, state_)->values(column);
+    },
+  };
+  return visit(f, as_flatbuffer(chunk_));
+}
+
 data_view table_slice::at(table_slice::size_type row,
                           table_slice::size_type column) const {
   VAST_ASSERT(row < rows());
@@ -589,11 +605,89 @@ uint64_t rows(const std::vector<table_slice>& slices) {
   return result;
 }
 
+caf::expected<table_slice>
+copy_to_shared_memory(const table_slice& slice,
+                      std::chrono::steady_clock::duration cleanup_timeout) {
+  VAST_ASSERT(slice.encoding() != table_slice_encoding::none);
+  auto chunk = chunk::make_shared_memory(as_bytes(slice), cleanup_timeout);
+  if (!chunk)
+    return std::move(chunk.error());
+  auto result = table_slice{std::move(*chunk), table_slice::verify::no};
+  result.offset(slice.offset());
+  return result;
+}
+
 namespace {
 
+/// Hash sets over the elements of the lists on the RHS of membership
+/// predicates, such that checking a row against a list takes constant time
+/// instead of a scan of the list.
+class membership_sets {
+public:
+  explicit membership_sets(const expression& expr) {
+    add(expr);
+  }
+
+  /// Retrieves the set for a list on the RHS of a predicate, if any.
+  [[nodiscard]] const std::unordered_set<data_view>*
+  find(const list& xs) const {
+    auto it = sets_.find(&xs);
+    return it != sets_.end() ? &it->second : nullptr;
+  }
+
+private:
+  /// Scanning short lists is faster than hashing.
+  static constexpr size_t min_size = 8;
+
+  void add(const expression& expr) {
+    auto f = detail::overload{
+      [](caf::none_t) {},
+      [&](const conjunction& xs) {
+        for (const auto& x : xs)
+          add(x);
+      },
+      [&](const disjunction& xs) {
+        for (const auto& x : xs)
+          add(x);
+      },
+      [&](const negation& x) {
+        add(x.expr());
+      },
+      [&](const predicate& x) {
+        add(x);
+      },
+    };
+    caf::visit(f, expr);
+  }
+
+  void add(const predicate& p) {
+    if (p.op != relational_operator::in && p.op != relational_operator::not_in)
+      return;
+    if (!caf::holds_alternative<data_extractor>(p.lhs))
+      return;
+    const auto* xs = caf::get_if<list>(&caf::get<data>(p.rhs));
+    if (!xs || xs->size() < min_size)
+      return;
+    // An address is also in a list if one of its subnets contains it.
+    auto is_subnet = [](const data& x) {
+      return caf::holds_alternative<subnet>(x);
+    };
+    if (std::any_of(xs->begin(), xs->end(), is_subnet))
+      return;
+    auto set = std::unordered_set<data_view>{};
+    set.reserve(xs->size());
+    for (const auto& x : *xs)
+      set.insert(make_view(x));
+    sets_.emplace(xs, std::move(set));
+  }
+
+  std::unordered_map<const list*, std::unordered_set<data_view>> sets_;
+};
+
 struct row_evaluator {
-  row_evaluator(const table_slice& slice, size_t row)
-    : slice_{slice}, row_{row} {
+  row_evaluator(const table_slice& slice, size_t row,
+                const membership_sets* sets = nullptr)
+    : slice_{slice}, row_{row}, sets_{sets} {
     // nop
   }
 
@@ -681,12 +775,23 @@ struct row_evaluator {
 
   bool operator()(const data_extractor& e, const data& d) {
     auto lhs = to_canonical(e.type, slice_.at(row_, e.column, e.type));
+    if (sets_ != nullptr
+        && (op_ == relational_operator::in
+            || op_ == relational_operator::not_in)) {
+      if (const auto* xs = caf::get_if<list>(&d)) {
+        if (const auto* set = sets_->find(*xs)) {
+          auto found = set->count(lhs) > 0;
+          return op_ == relational_operator::in ? found : !found;
+        }
+      }
+    }
     auto rhs = make_data_view(d);
     return evaluate_view(lhs, op_, rhs);
   }
 
   const table_slice& slice_;
   size_t row_;
+  const membership_sets* sets_;
   relational_operator op_ = {};
 };
 
@@ -696,13 +801,37 @@ ids evaluate(const expression& expr, const table_slice& slice) {
   // TODO: switch to a column-based evaluation strategy where it makes sense.
   ids result;
   result.append(false, slice.offset());
+  const auto sets = membership_sets{expr};
   for (size_t row = 0; row != slice.rows(); ++row) {
-    auto x = caf::visit(row_evaluator{slice, row}, expr);
+    auto x = caf::visit(row_evaluator{slice, row, &sets}, expr);
     result.append_bit(x);
   }
   return result;
 }
 
+ids evaluate(const expression& expr, const table_slice& slice,
+             const ids& hints) {
+  const auto offset = slice.offset();
+  ids result;
+  const auto sets = membership_sets{expr};
+  for (auto rng = select(hints); rng; rng.next()) {
+    if (rng.get() < offset) {
+      rng.next_from(offset);
+      if (!rng)
+        break;
+    }
+    const auto row = rng.get() - offset;
+    if (row >= slice.rows())
+      break;
+    if (caf::visit(row_evaluator{slice, row, &sets}, expr)) {
+      result.append_bits(false, rng.get() - result.size());
+      result.append_bit(true);
+    }
+  }
+  result.append_bits(false, offset + slice.rows() - result.size());
+  return result;
+}
+
 std::optional<table_slice>
 filter(const table_slice& slice, expression expr, const ids& hints) {
   VAST_ASSERT(slice.encoding() != table_slice_encoding::none);
@@ -729,6 +858,7 @@ filter(const table_slice& slice, expression expr, const ids& hints) {
       return {};
     expr = std::move(*tailored_expr);
   }
+  const auto sets = membership_sets{expr};
   // Get the desired encoding, and the already serialized layout.
   auto f = detail::overload{
     []() noexcept -> table_slice_encoding {
@@ -751,7 +881,7 @@ filter(const table_slice& slice, expression expr, const ids& hints) {
     // Check if the expression was unable to be tailored to the type.
     if (expr == expression{})
       return false;
-    return caf::visit(row_evaluator{slice, row}, expr);
+    return caf::visit(row_evaluator{slice, row, &sets}, expr);
   };
   const auto& layout = caf::get<record_type>(slice.layout());
   const auto column_types = [&]() noexcept {
@@ -809,6 +939,7 @@ uint64_t count_matching(const table_slice& slice, const expression& expr,
     if (rank(slice_ids) == selection_rank)
       return slice.rows();
   }
+  const auto sets = membership_sets{expr};
   auto check = [&](row_evaluator eval) -> uint64_t {
     if (expr == expression{})
       return 1u;
@@ -819,7 +950,7 @@ uint64_t count_matching(const table_slice& slice, const expression& expr,
     VAST_ASSERT(id >= offset);
     auto row = id - offset;
     VAST_ASSERT(row < slice.rows());
-    cnt += check(row_evaluator{slice, row});
+    cnt += check(row_evaluator{slice, row, &sets});
   }
   return cnt;
 }
@@ -53,6 +53,11 @@ bool transform::applies_to(std::string_view event_name) const {
 caf::error transform::add(table_slice&& x) {
   VAST_DEBUG("transform {} adds a slice", name_);
   auto batch = to_record_batch(x);
+  if (!batch)
+    return caf::make_error(ec::format_error,
+                           fmt::format("transform {} failed to convert table "
+                                       "slice to record batch",
+                                       name_));
   return add_batch(x.layout(), batch);
 }
 
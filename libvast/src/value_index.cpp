@@ -8,6 +8,7 @@
 
 #include "vast/value_index.hpp"
 
+#include "vast/bitmap_algorithms.hpp"
 #include "vast/chunk.hpp"
 #include "vast/data.hpp"
 #include "vast/detail/legacy_deserialize.hpp"
@@ -86,6 +87,34 @@ value_index::lookup(relational_operator op, data_view x) const {
   return std::move(*result);
 }
 
+caf::expected<ids> value_index::lookup(relational_operator op, data_view x,
+                                       const ids& selection) const {
+  // Nothing to do if there are no positions to consider.
+  if (all<0>(selection))
+    return ids{offset(), false};
+  if (caf::holds_alternative<caf::none_t>(x)) {
+    auto result = lookup(op, x);
+    if (result)
+      *result &= selection;
+    return result;
+  }
+  // Only positions with a value need to be looked up; the nils are handled
+  // below.
+  auto candidates = selection & mask_;
+  auto result = caf::expected<ids>{ids{}};
+  if (!all<0>(candidates))
+    result = lookup_selection_impl(op, x, candidates);
+  if (!result)
+    return result;
+  *result &= candidates;
+  // See above for the treatment of nils.
+  if (op == relational_operator::not_equal)
+    *result |= none_ & selection;
+  if (result->size() < offset())
+    result->append_bits(false, offset() - result->size());
+  return std::move(*result);
+}
+
 size_t value_index::memusage() const {
   return mask_.memusage() + none_.memusage() + memusage_impl();
 }
@@ -173,10 +202,20 @@ caf::error unpack(const fbs::ValueIndex& from, value_index_ptr& to) {
       return do_unpack(*from.value_index_as_subnet()->base());
     case fbs::value_index::ValueIndex::string:
       return do_unpack(*from.value_index_as_string()->base());
+    case fbs::value_index::ValueIndex::ngram:
+      return do_unpack(*from.value_index_as_ngram()->base());
+    case fbs::value_index::ValueIndex::address_prefix:
+      return do_unpack(*from.value_index_as_address_prefix()->base());
   }
   return caf::make_error(ec::format_error, "unexpected value index type");
 }
 
+caf::expected<ids>
+value_index::lookup_selection_impl(relational_operator op, data_view x,
+                                   const ids&) const {
+  return lookup_impl(op, x);
+}
+
 const ewah_bitmap& value_index::mask() const {
   return mask_;
 }
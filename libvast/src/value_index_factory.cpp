@@ -14,10 +14,12 @@
 #include "vast/detail/bit.hpp"
 #include "vast/detail/type_traits.hpp"
 #include "vast/index/address_index.hpp"
+#include "vast/index/address_prefix_index.hpp"
 #include "vast/index/arithmetic_index.hpp"
 #include "vast/index/enumeration_index.hpp"
 #include "vast/index/hash_index.hpp"
 #include "vast/index/list_index.hpp"
+#include "vast/index/ngram_index.hpp"
 #include "vast/index/string_index.hpp"
 #include "vast/index/subnet_index.hpp"
 #include "vast/logger.hpp"
@@ -56,7 +58,33 @@ value_index_ptr make(type x, caf::settings opts) {
       return nullptr;
     }
   }
+  // The bitmap type is either an option or a type attribute, with the latter
+  // taking precedence.
+  if (auto bitmap_attribute = x.attribute("bitmap"))
+    opts["bitmap"] = std::string{*bitmap_attribute};
+  if (auto i = opts.find("bitmap"); i != opts.end()) {
+    auto str = caf::get_if<caf::config_value::string>(&i->second);
+    if (!str || (*str != "ewah" && *str != "roaring")) {
+      VAST_ERROR("{} invalid bitmap type (ewah or roaring needed)", __func__);
+      return nullptr;
+    }
+  }
   if (auto index = x.attribute("index")) {
+    if (*index == "ngram"sv) {
+      if (!caf::holds_alternative<string_type>(x)) {
+        VAST_ERROR("{} n-gram index requires a string type", __func__);
+        return nullptr;
+      }
+      return std::make_unique<ngram_index>(std::move(x), std::move(opts));
+    }
+    if (*index == "prefix"sv) {
+      if (!caf::holds_alternative<address_type>(x)) {
+        VAST_ERROR("{} prefix index requires an address type", __func__);
+        return nullptr;
+      }
+      return std::make_unique<address_prefix_index>(std::move(x),
+                                                    std::move(opts));
+    }
     if (*index == "hash"sv) {
       auto i = opts.find("cardinality");
       if (i == opts.end())
@@ -20,7 +20,8 @@ namespace vast {
 
 // -- pattern_view ------------------------------------------------------------
 
-pattern_view::pattern_view(const pattern& x) : pattern_{x.string()} {
+pattern_view::pattern_view(const pattern& x)
+  : pattern_{x.string()}, source_{&x} {
   // nop
 }
 
@@ -33,11 +34,15 @@ std::string_view pattern_view::string() const {
 }
 
 bool pattern_view::match(std::string_view x) const {
+  if (source_)
+    return source_->match(x);
   return std::regex_match(x.begin(), x.end(),
                           std::regex{pattern_.begin(), pattern_.end()});
 }
 
 bool pattern_view::search(std::string_view x) const {
+  if (source_)
+    return source_->search(x);
   return std::regex_search(x.begin(), x.end(),
                            std::regex{pattern_.begin(), pattern_.end()});
 }
@@ -297,6 +302,17 @@ struct contains_predicate {
     return rhs.find(lhs) != std::string::npos;
   }
 
+  bool operator()(const view<address>& lhs, const view<list>& rhs) const {
+    auto pred = [&](const auto& x) {
+      if (auto sn = caf::get_if<view<subnet>>(&x))
+        return sn->contains(lhs);
+      if (auto addr = caf::get_if<view<address>>(&x))
+        return *addr == lhs;
+      return false;
+    };
+    return std::any_of(rhs->begin(), rhs->end(), pred);
+  }
+
   bool
   operator()(const view<std::string>& lhs, const view<pattern>& rhs) const {
     return rhs.search(lhs);
@@ -0,0 +1,122 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vast/zone_map.hpp"
+
+#include "vast/detail/overload.hpp"
+#include "vast/expression.hpp"
+#include "vast/operator.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/type.hpp"
+#include "vast/view.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace vast {
+
+zone_map zone_map::make(const table_slice& slice) {
+  auto result = zone_map{};
+  const auto& layout = caf::get<record_type>(slice.layout());
+  size_t column = 0;
+  for (const auto& [field, _] : layout.leaves()) {
+    if (caf::holds_alternative<time_type>(field.type)) {
+      auto range = time_range{column, time::max(), time::min()};
+      for (auto&& value : slice.values(column)) {
+        if (const auto* x = caf::get_if<view<time>>(&value)) {
+          range.min = std::min(range.min, *x);
+          range.max = std::max(range.max, *x);
+        }
+      }
+      if (range.min <= range.max)
+        result.time_ranges.push_back(range);
+    }
+    ++column;
+  }
+  return result;
+}
+
+bool zone_map::may_match(const expression& expr) const {
+  auto f = detail::overload{
+    [&](const conjunction& x) {
+      return std::all_of(x.begin(), x.end(), [&](const expression& op) {
+        return may_match(op);
+      });
+    },
+    [&](const disjunction& x) {
+      return std::any_of(x.begin(), x.end(), [&](const expression& op) {
+        return may_match(op);
+      });
+    },
+    [](const negation&) {
+      // The bounds cannot rule out events for negated expressions, because
+      // a slice may contain values on both sides of a bound.
+      return true;
+    },
+    [&](const predicate& x) {
+      const auto* lhs = caf::get_if<data_extractor>(&x.lhs);
+      const auto* rhs = caf::get_if<data>(&x.rhs);
+      if (!lhs || !rhs)
+        return true;
+      const auto* t = caf::get_if<time>(rhs);
+      if (!t)
+        return true;
+      auto range = std::find_if(time_ranges.begin(), time_ranges.end(),
+                                [&](const time_range& range) {
+                                  return range.column == lhs->column;
+                                });
+      if (range == time_ranges.end())
+        return true;
+      switch (x.op) {
+        case relational_operator::equal:
+          return range->min <= *t && *t <= range->max;
+        case relational_operator::not_equal:
+          // Lookups for `!=` also yield the null values of a column, which
+          // the bounds know nothing about.
+          return true;
+        case relational_operator::less:
+          return range->min < *t;
+        case relational_operator::less_equal:
+          return range->min <= *t;
+        case relational_operator::greater:
+          return range->max > *t;
+        case relational_operator::greater_equal:
+          return range->max >= *t;
+        default:
+          return true;
+      }
+    },
+    [](caf::none_t) {
+      return true;
+    },
+  };
+  return caf::visit(f, expr);
+}
+
+zone_map_filter::zone_map_filter(expression expr) : expr_{std::move(expr)} {
+  // nop
+}
+
+bool zone_map_filter::operator()(const table_slice& slice,
+                                 const zone_map& zones) {
+  if (expr_ == expression{} || zones.time_ranges.empty())
+    return true;
+  auto it = tailored_.find(slice.layout());
+  if (it == tailored_.end()) {
+    // Expressions that cannot be tailored to the layout do not get skipped
+    // here, so that the caller sees the error when evaluating them.
+    auto tailored = tailor(expr_, slice.layout());
+    it = tailored_
+           .emplace(slice.layout(), tailored ? std::move(*tailored)
+                                             : expression{})
+           .first;
+  }
+  return it->second == expression{} || zones.may_match(it->second);
+}
+
+} // namespace vast
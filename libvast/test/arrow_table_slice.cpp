@@ -15,11 +15,14 @@
 #include "vast/concept/parseable/vast/subnet.hpp"
 #include "vast/config.hpp"
 #include "vast/detail/narrow.hpp"
+#include "vast/fbs/table_slice.hpp"
 #include "vast/io/read.hpp"
 #include "vast/test/fixtures/table_slices.hpp"
 #include "vast/test/test.hpp"
 #include "vast/type.hpp"
 
+#include <arrow/io/memory.h>
+#include <arrow/ipc/reader.h>
 #include <arrow/record_batch.h>
 #include <arrow/type_fwd.h>
 #include <caf/test/dsl.hpp>
@@ -74,6 +77,22 @@ auto make_single_column_slice(const VastType& t, const Ts&... xs) {
   return make_slice(layout, xs...);
 }
 
+/// Decodes the serialized record batch of an Arrow-encoded table slice without
+/// restoring its dictionary-encoded columns.
+std::shared_ptr<arrow::RecordBatch>
+serialized_record_batch(const table_slice& slice) {
+  const auto* flat_slice = fbs::GetTableSlice(as_bytes(slice).data());
+  const auto* ipc = flat_slice->table_slice_as_arrow_v2()->arrow_ipc();
+  auto input = arrow::io::BufferReader{
+    std::make_shared<arrow::Buffer>(ipc->data(), ipc->size())};
+  auto reader = arrow::ipc::RecordBatchStreamReader::Open(&input);
+  REQUIRE(reader.ok());
+  auto result = std::shared_ptr<arrow::RecordBatch>{};
+  REQUIRE((*reader)->ReadNext(&result).ok());
+  REQUIRE(result);
+  return result;
+}
+
 table_slice roundtrip(table_slice slice) {
   table_slice slice_copy;
   std::vector<char> buf;
@@ -334,6 +353,47 @@ TEST(single column - string) {
   record_batch_roundtrip(slice);
 }
 
+TEST(single column - dictionary-encoded string) {
+  auto values = std::vector<std::string>{};
+  for (size_t i = 0; i < 256; ++i)
+    values.push_back(i % 3 == 0 ? "established-connection" : "rejected");
+  auto make_string_slice = [&](type t) {
+    auto builder = arrow_table_slice_builder::make(
+      type{"rec", record_type{{"foo", t}, {"bar", count_type{}}}});
+    for (size_t i = 0; i < values.size(); ++i)
+      REQUIRE(builder->add(std::string_view{values[i]}, count{i}));
+    return builder->finish();
+  };
+  // Low-cardinality columns are dictionary-encoded adaptively, which only
+  // changes the serialized size of the slice.
+  auto encoded = make_string_slice(type{string_type{}});
+  auto plain
+    = make_string_slice(type{string_type{}, {{"dictionary", "false"}}});
+  CHECK_LESS(as_bytes(encoded).size(), as_bytes(plain).size());
+  CHECK_EQUAL(serialized_record_batch(encoded)->column(0)->type_id(),
+              arrow::Type::DICTIONARY);
+  CHECK_EQUAL(serialized_record_batch(plain)->column(0)->type_id(),
+              arrow::Type::STRING);
+  for (size_t row = 0; row < values.size(); ++row)
+    CHECK_VARIANT_EQUAL(encoded.at(row, 0, type{string_type{}}),
+                        std::string_view{values[row]});
+  CHECK_EQUAL(encoded, plain);
+  CHECK_ROUNDTRIP(encoded);
+  record_batch_roundtrip(encoded);
+  // The #dictionary attribute forces dictionary encoding.
+  auto t = type{string_type{}, {{"dictionary"}}};
+  auto slice = make_slice(record_type{{"foo", t}}, "a"sv, caf::none, "a"sv);
+  REQUIRE_EQUAL(slice.rows(), 3u);
+  CHECK_EQUAL(serialized_record_batch(slice)->column(0)->type_id(),
+              arrow::Type::DICTIONARY);
+  CHECK(to_record_batch(slice)->column(0)->type()->Equals(arrow::utf8()));
+  CHECK_VARIANT_EQUAL(slice.at(0, 0, t), "a"sv);
+  CHECK_VARIANT_EQUAL(slice.at(1, 0, t), std::nullopt);
+  CHECK_VARIANT_EQUAL(slice.at(2, 0, t), "a"sv);
+  CHECK_ROUNDTRIP(slice);
+  record_batch_roundtrip(slice);
+}
+
 TEST(single column - pattern) {
   auto t = pattern_type{};
   auto p1 = pattern("foo.ar");
@@ -17,6 +17,7 @@
 #include "vast/flatbuffer.hpp"
 #include "vast/ids.hpp"
 #include "vast/null_bitmap.hpp"
+#include "vast/roaring_bitmap.hpp"
 #include "vast/test/test.hpp"
 
 #include <caf/test/dsl.hpp>
@@ -488,6 +489,14 @@ TEST(wah_bitmap) {
 
 FIXTURE_SCOPE_END()
 
+FIXTURE_SCOPE(roaring_bitmap_tests, bitmap_test_harness<roaring_bitmap>)
+
+TEST(roaring_bitmap) {
+  execute();
+}
+
+FIXTURE_SCOPE_END()
+
 FIXTURE_SCOPE(bitmap_tests, bitmap_test_harness<bitmap>)
 
 TEST(bitmap) {
@@ -915,3 +924,133 @@ TEST(EWAH RLE print 2) {
   // CHECK_EQUAL(str, "1F1T421F2T");
   CHECK_EQUAL(str, "1F1T62F320F39F2T");
 }
+
+TEST(EWAH bitwise operations against generic algorithms) {
+  // The specialized algorithms must produce the same blocks as the generic
+  // ones, including clean runs, partial last blocks, and operands of
+  // different lengths.
+  auto make = [](size_t seed, size_t density) {
+    ewah_bitmap bm;
+    auto block = ewah_bitmap::block_type{0x9e3779b97f4a7c15} * seed;
+    for (auto i = size_t{0}; i < 3'000; ++i) {
+      block ^= block << 13;
+      block ^= block >> 7;
+      block ^= block << 17;
+      switch (block % 8) {
+        case 0:
+          bm.append_bits(block & 1, block % 500);
+          break;
+        case 1:
+          bm.append_block(block, block % 64 + 1);
+          break;
+        default: {
+          auto x = block;
+          for (auto j = density; j < 3; ++j)
+            x &= x >> 3;
+          bm.append_block(x);
+        }
+      }
+    }
+    return bm;
+  };
+  for (auto density = size_t{0}; density < 4; ++density) {
+    auto x = make(1, density);
+    auto y = make(2, 3 - density);
+    auto and_op = [](auto lhs, auto rhs) {
+      return lhs & rhs;
+    };
+    auto or_op = [](auto lhs, auto rhs) {
+      return lhs | rhs;
+    };
+    auto xor_op = [](auto lhs, auto rhs) {
+      return lhs ^ rhs;
+    };
+    auto nand_op = [](auto lhs, auto rhs) {
+      return lhs & ~rhs;
+    };
+    CHECK_EQUAL(x & y, (binary_eval<false, false>(x, y, and_op)));
+    CHECK_EQUAL(x | y, (binary_eval<true, true>(x, y, or_op)));
+    CHECK_EQUAL(x ^ y, (binary_eval<true, true>(x, y, xor_op)));
+    CHECK_EQUAL(x - y, (binary_eval<true, false>(x, y, nand_op)));
+    CHECK_EQUAL(y - x, (binary_eval<true, false>(y, x, nand_op)));
+  }
+}
+
+TEST(roaring containers) {
+  using kind = roaring_bitmap::container::kind;
+  roaring_bitmap bm;
+  // A sparse chunk.
+  for (auto i = 0; i < 100; ++i) {
+    bm.append_bit(true);
+    bm.append_bits(false, 99);
+  }
+  bm.append_bits(false, (1 << 16) - bm.size());
+  // A clustered chunk.
+  bm.append_bits(true, 30'000);
+  bm.append_bits(false, (2 << 16) - bm.size());
+  // A dense chunk.
+  for (auto i = 0; i < 1024; ++i)
+    bm.append_block(0x5555555555555555);
+  // An empty chunk.
+  bm.append_bits(false, 1 << 16);
+  bm.append_bit(true);
+  bm.optimize();
+  const auto& containers = bm.containers();
+  REQUIRE_EQUAL(containers.size(), 4u);
+  CHECK(containers[0].type == kind::array);
+  CHECK_EQUAL(containers[0].cardinality, 100u);
+  CHECK(containers[1].type == kind::runs);
+  CHECK_EQUAL(containers[1].cardinality, 30'000u);
+  CHECK(containers[2].type == kind::bitset);
+  CHECK_EQUAL(containers[2].cardinality, 1u << 15);
+  CHECK_EQUAL(containers[3].key, 4u);
+  CHECK_EQUAL(rank(bm), 100u + 30'000u + (1u << 15) + 1u);
+  CHECK_EQUAL(select(bm, 101), 1u << 16);
+  CHECK_EQUAL(select(bm, -1), bm.size() - 1);
+}
+
+TEST(roaring against ewah) {
+  // Compare the container-wise algorithms with the generic algorithms over
+  // chunks of all representations.
+  auto make = [](auto& bm, size_t seed) {
+    for (auto i = size_t{0}; i < 20; ++i) {
+      switch ((i + seed) % 4) {
+        case 0:
+          bm.append_bits(false, 70'000);
+          break;
+        case 1:
+          for (auto j = 0; j < 500; ++j)
+            bm.append_block(0x0000100000000001 << (j + seed) % 7);
+          break;
+        case 2:
+          bm.append_bits(true, 50'000 + seed * 1'000);
+          break;
+        case 3:
+          for (auto j = 0; j < 1'000; ++j)
+            bm.append_block(0xf0f0f0f0f0f0f0f0 >> (j + seed) % 5);
+          break;
+      }
+    }
+  };
+  roaring_bitmap rx, ry;
+  ewah_bitmap ex, ey;
+  make(rx, 1);
+  make(ex, 1);
+  make(ry, 2);
+  make(ey, 2);
+  REQUIRE_EQUAL(to_string(rx), to_string(ex));
+  REQUIRE_EQUAL(to_string(ry), to_string(ey));
+  CHECK_EQUAL(to_string(rx & ry), to_string(ex & ey));
+  CHECK_EQUAL(to_string(rx | ry), to_string(ex | ey));
+  CHECK_EQUAL(to_string(rx ^ ry), to_string(ex ^ ey));
+  CHECK_EQUAL(to_string(rx - ry), to_string(ex - ey));
+  CHECK_EQUAL(to_string(ry - rx), to_string(ey - ex));
+  CHECK_EQUAL(to_string(~rx), to_string(~ex));
+  CHECK_EQUAL(rank(rx & ry), rank(ex & ey));
+  MESSAGE("type-erased bitmaps");
+  auto x = bitmap{rx};
+  auto y = bitmap{ry};
+  CHECK(caf::holds_alternative<roaring_bitmap>((x & y).get_data()));
+  CHECK_EQUAL(to_string(x | y), to_string(ex | ey));
+  CHECK_EQUAL(to_string(x - bitmap{ey}), to_string(ex - ey));
+}
@@ -15,8 +15,13 @@
 #include "vast/test/fixtures/filesystem.hpp"
 #include "vast/test/test.hpp"
 
+#include <caf/binary_deserializer.hpp>
+
+#include <chrono>
 #include <cstddef>
 #include <span>
+#include <thread>
+#include <vector>
 
 using namespace vast;
 
@@ -82,6 +87,82 @@ TEST(serialization) {
   CHECK(std::equal(x->begin(), x->end(), y->begin(), y->end()));
 }
 
+namespace {
+
+void accept_shared_memory_probe() {
+  std::string str = "vast";
+  auto probe = unbox(
+    chunk::make_shared_memory(as_bytes(str), std::chrono::minutes{1}));
+  auto accepted
+    = unbox(chunk::accept_shared_memory(probe->shared_memory_name(), 4));
+  CHECK(std::equal(probe->begin(), probe->end(), accepted->begin(),
+                   accepted->end()));
+}
+
+caf::error deserialize(const std::vector<char>& buf, chunk_ptr& x) {
+  caf::binary_deserializer source{nullptr, buf};
+  return source(x);
+}
+
+} // namespace
+
+TEST(shared memory serialization) {
+  std::string str = "foobarbaz";
+  auto x = unbox(
+    chunk::make_shared_memory(as_bytes(str), std::chrono::minutes{1}));
+  CHECK(std::equal(x->begin(), x->end(),
+                   reinterpret_cast<const std::byte*>(str.data()),
+                   reinterpret_cast<const std::byte*>(str.data() + str.size())));
+  std::vector<char> buf;
+  CHECK_EQUAL(detail::serialize(buf, x), caf::none);
+  // Only the handle of the shared memory object goes over the wire.
+  CHECK_LESS(buf.size(), 64u);
+  MESSAGE("persisted state never refers to shared memory");
+  chunk_ptr y;
+  CHECK_EQUAL(detail::legacy_deserialize(buf, y), false);
+  MESSAGE("adopting requires negotiating shared memory first");
+  CHECK_NOT_EQUAL(deserialize(buf, y), caf::none);
+  accept_shared_memory_probe();
+  CHECK_EQUAL(deserialize(buf, y), caf::none);
+  REQUIRE_NOT_EQUAL(y, nullptr);
+  CHECK(std::equal(x->begin(), x->end(), y->begin(), y->end()));
+  MESSAGE("adopting the chunk unlinks the shared memory object");
+  chunk_ptr z;
+  CHECK_NOT_EQUAL(deserialize(buf, z), caf::none);
+}
+
+TEST(shared memory cleanup timeout) {
+  accept_shared_memory_probe();
+  std::string str = "foobarbaz";
+  auto x = unbox(
+    chunk::make_shared_memory(as_bytes(str), std::chrono::milliseconds{10}));
+  std::vector<char> buf;
+  CHECK_EQUAL(detail::serialize(buf, x), caf::none);
+  x = nullptr;
+  MESSAGE("the sender unlinks the shared memory object after the timeout");
+  std::this_thread::sleep_for(std::chrono::milliseconds{200});
+  chunk_ptr y;
+  CHECK_NOT_EQUAL(deserialize(buf, y), caf::none);
+}
+
+TEST(serialization round trip) {
+  std::string str = "foobarbaz";
+  auto x = chunk::make(std::move(str));
+  std::vector<char> buf;
+  CHECK_EQUAL(detail::serialize(buf, x), caf::none);
+  chunk_ptr y;
+  CHECK_EQUAL(deserialize(buf, y), caf::none);
+  CHECK_EQUAL(as_bytes(x), as_bytes(y));
+  chunk_ptr z;
+  CHECK_EQUAL(detail::legacy_deserialize(buf, z), true);
+  CHECK_EQUAL(as_bytes(x), as_bytes(z));
+  MESSAGE("null chunks round-trip as well");
+  buf.clear();
+  CHECK_EQUAL(detail::serialize(buf, chunk_ptr{}), caf::none);
+  CHECK_EQUAL(deserialize(buf, y), caf::none);
+  CHECK_EQUAL(y, nullptr);
+}
+
 TEST(as_bytes) {
   std::string str = "foobarbaz";
   auto copy = str;
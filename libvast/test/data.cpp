@@ -194,6 +194,13 @@ TEST(evaluation) {
   CHECK(evaluate(lhs, relational_operator::in, rhs));
   rhs = *to<subnet>("10.0.42.0/17");
   CHECK(!evaluate(lhs, relational_operator::in, rhs));
+  lhs = *to<address>("10.0.0.1");
+  rhs = list{*to<address>("192.168.0.1"), *to<subnet>("10.0.0.0/8")};
+  CHECK(evaluate(lhs, relational_operator::in, rhs));
+  lhs = *to<address>("172.16.0.1");
+  CHECK(!evaluate(lhs, relational_operator::in, rhs));
+  lhs = *to<address>("192.168.0.1");
+  CHECK(evaluate(lhs, relational_operator::in, rhs));
   MESSAGE("mixed types");
   rhs = real{4.2};
   CHECK(!evaluate(lhs, relational_operator::equal, rhs));
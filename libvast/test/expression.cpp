@@ -11,6 +11,7 @@
 #include "vast/expression.hpp"
 
 #include "vast/concept/parseable/to.hpp"
+#include "vast/concept/parseable/vast/address.hpp"
 #include "vast/concept/parseable/vast/expression.hpp"
 #include "vast/concept/parseable/vast/schema.hpp"
 #include "vast/concept/parseable/vast/subnet.hpp"
@@ -179,6 +180,84 @@ TEST(normalization) {
   CHECK_EQUAL(normalize(*expr), *normalized);
 }
 
+TEST(membership batching) {
+  auto expr = to<expression>(":addr in 10.0.0.0/8 || :addr == 192.168.1.1 "
+                             "|| :addr in [172.16.0.0/12, ::1]");
+  auto normalized = to<expression>(
+    ":addr in [10.0.0.0/8, 192.168.1.1, 172.16.0.0/12, ::1]");
+  REQUIRE(expr);
+  REQUIRE(normalized);
+  CHECK_EQUAL(normalize(*expr), *normalized);
+  MESSAGE("flattening of expanded predicates");
+  expr = to<expression>("10.0.0.0/8 || 192.168.0.0/16");
+  normalized = to<expression>(":subnet in [10.0.0.0/8, 192.168.0.0/16] "
+                              "|| :addr in [10.0.0.0/8, 192.168.0.0/16]");
+  REQUIRE(expr);
+  REQUIRE(normalized);
+  CHECK_EQUAL(normalize(*expr), *normalized);
+  MESSAGE("equality with values of the type of a type extractor");
+  expr = to<expression>(":string == \"foo\" || :string == \"bar\" "
+                        "|| :string == 42");
+  normalized = to<expression>(":string in [\"foo\", \"bar\"] "
+                              "|| :string == 42");
+  REQUIRE(expr);
+  REQUIRE(normalized);
+  CHECK_EQUAL(normalize(*expr), *normalized);
+  MESSAGE("no batching of field extractors before type resolution");
+  expr = to<expression>("x == \"foo\" || x == \"bar\" "
+                        "|| x in [\"baz\", \"qux\"]");
+  REQUIRE(expr);
+  CHECK_EQUAL(normalize(*expr), *expr);
+  expr = to<expression>("x == /foo/ || x == /bar/ || x == nil || x == nil");
+  normalized = to<expression>("x == /foo/ || x == /bar/ || x == nil");
+  REQUIRE(expr);
+  REQUIRE(normalized);
+  CHECK_EQUAL(normalize(*expr), *normalized);
+  expr = to<expression>("x == 10.0.0.0/8 || x == 10.1.0.0/16");
+  REQUIRE(expr);
+  CHECK_EQUAL(normalize(*expr), *expr);
+  MESSAGE("no batching across extractors or conjunctions");
+  expr = to<expression>("src in 10.0.0.0/8 || src in 192.168.0.0/16");
+  REQUIRE(expr);
+  CHECK_EQUAL(normalize(*expr), *expr);
+  expr = to<expression>(":addr in 10.0.0.0/8 && :addr in 10.1.0.0/16");
+  REQUIRE(expr);
+  CHECK_EQUAL(normalize(*expr), *expr);
+  MESSAGE("batching after type resolution");
+  auto layout = type{"x", record_type{
+                            {"src", address_type{}},
+                            {"dst", address_type{}},
+                          }};
+  expr = to<expression>("src in 10.0.0.0/8 || src == 10.1.1.1 "
+                        "|| dst in 10.0.0.0/8");
+  REQUIRE(expr);
+  auto sn = data{unbox(to<subnet>("10.0.0.0/8"))};
+  auto src = data_extractor{type{address_type{}}, 0};
+  auto dst = data_extractor{type{address_type{}}, 1};
+  auto expected = expression{disjunction{
+    predicate{src, relational_operator::in,
+              data{list{sn, data{unbox(to<address>("10.1.1.1"))}}}},
+    predicate{dst, relational_operator::in, sn},
+  }};
+  CHECK_EQUAL(unbox(tailor(*expr, layout)), expected);
+  MESSAGE("batching only values that fit the type of a field");
+  layout = type{"y", record_type{
+                       {"a", record_type{{"x", string_type{}}}},
+                       {"b", record_type{{"x", count_type{}}}},
+                     }};
+  expr = to<expression>("x == \"foo\" || x == 42 || x == \"bar\" "
+                        "|| x == 43");
+  REQUIRE(expr);
+  auto ax = data_extractor{type{string_type{}}, 0};
+  auto bx = data_extractor{type{count_type{}}, 1};
+  expected = expression{disjunction{
+    predicate{ax, relational_operator::in,
+              data{list{data{"foo"}, data{"bar"}}}},
+    predicate{bx, relational_operator::in, data{list{data{42u}, data{43u}}}},
+  }};
+  CHECK_EQUAL(unbox(tailor(*expr, layout)), expected);
+}
+
 TEST(extractors) {
   auto port = type{"port", count_type{}};
   auto subport = type{"subport", port};
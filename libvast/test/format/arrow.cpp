@@ -28,6 +28,7 @@
 #include <arrow/ipc/reader.h>
 #include <caf/sum_type.hpp>
 
+#include <sstream>
 #include <utility>
 
 using namespace std::chrono;
@@ -84,4 +85,79 @@ TEST(arrow batch) {
   CHECK_EQUAL(slice_id, zeek_conn_log.size());
 }
 
+TEST(arrow roundtrip) {
+  std::shared_ptr<arrow::io::BufferOutputStream> stream;
+  {
+    auto res = arrow::io::BufferOutputStream::Create(
+      1024, arrow::default_memory_pool());
+    REQUIRE_OK(res);
+    stream = *res;
+  }
+  {
+    format::arrow::writer writer;
+    writer.out(stream);
+    // Two layouts result in two consecutive IPC streams.
+    for (auto& slice : zeek_conn_log)
+      REQUIRE_EQUAL(writer.write(slice), caf::none);
+    for (auto& slice : zeek_dns_log)
+      REQUIRE_EQUAL(writer.write(slice), caf::none);
+  }
+  auto buf = stream->Finish();
+  REQUIRE_OK(buf);
+  auto in = std::make_unique<std::istringstream>((*buf)->ToString());
+  format::arrow::reader reader{caf::settings{}, std::move(in)};
+  std::vector<table_slice> slices;
+  auto add_slice = [&](table_slice slice) {
+    slices.emplace_back(std::move(slice));
+  };
+  auto [err, produced] = reader.read(
+    std::numeric_limits<size_t>::max(), slice_size, add_slice);
+  CHECK_EQUAL(err, ec::end_of_input);
+  REQUIRE_EQUAL(slices.size(), zeek_conn_log.size() + zeek_dns_log.size());
+  auto expected = zeek_conn_log;
+  expected.insert(expected.end(), zeek_dns_log.begin(), zeek_dns_log.end());
+  for (size_t i = 0; i < slices.size(); ++i)
+    CHECK_EQUAL(slices[i], expected[i]);
+  CHECK_EQUAL(reader.module().size(), 2u);
+}
+
+TEST(arrow reader splits record batches) {
+  std::shared_ptr<arrow::io::BufferOutputStream> stream;
+  {
+    auto res = arrow::io::BufferOutputStream::Create(
+      1024, arrow::default_memory_pool());
+    REQUIRE_OK(res);
+    stream = *res;
+  }
+  {
+    format::arrow::writer writer;
+    writer.out(stream);
+    REQUIRE_EQUAL(writer.write(zeek_conn_log[0]), caf::none);
+  }
+  auto buf = stream->Finish();
+  REQUIRE_OK(buf);
+  auto in = std::make_unique<std::istringstream>((*buf)->ToString());
+  format::arrow::reader reader{caf::settings{}, std::move(in)};
+  std::vector<table_slice> slices;
+  auto add_slice = [&](table_slice slice) {
+    slices.emplace_back(std::move(slice));
+  };
+  auto [err, produced] = reader.read(5, 3, add_slice);
+  CHECK_EQUAL(err, caf::none);
+  CHECK_EQUAL(produced, 5u);
+  REQUIRE_EQUAL(slices.size(), 2u);
+  CHECK_EQUAL(slices[0].rows(), 3u);
+  CHECK_EQUAL(slices[1].rows(), 2u);
+  CHECK_EQUAL(materialize(slices[1].at(0, 0)),
+              materialize(zeek_conn_log[0].at(3, 0)));
+}
+
+TEST(arrow writer reports unwritable output) {
+  auto options = caf::settings{};
+  caf::put(options, "vast.export.write", "/nonexistent/directory/out.arrow");
+  auto writer = format::arrow::writer::make(options);
+  CHECK(!writer);
+  CHECK_EQUAL(writer.error(), ec::filesystem_error);
+}
+
 FIXTURE_SCOPE_END()
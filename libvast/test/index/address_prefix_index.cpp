@@ -0,0 +1,130 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#define SUITE value_index
+
+#include "vast/index/address_prefix_index.hpp"
+
+#include "vast/concept/parseable/to.hpp"
+#include "vast/concept/parseable/vast/address.hpp"
+#include "vast/concept/parseable/vast/subnet.hpp"
+#include "vast/concept/printable/to_string.hpp"
+#include "vast/concept/printable/vast/bitmap.hpp"
+#include "vast/detail/legacy_deserialize.hpp"
+#include "vast/detail/serialize.hpp"
+#include "vast/fbs/value_index.hpp"
+#include "vast/flatbuffer.hpp"
+#include "vast/subnet.hpp"
+#include "vast/test/test.hpp"
+#include "vast/value_index_factory.hpp"
+
+#include <caf/test/dsl.hpp>
+
+using namespace vast;
+using namespace std::string_literals;
+
+namespace {
+
+auto addr(std::string_view str) {
+  return unbox(to<address>(str));
+}
+
+auto sn(std::string_view str) {
+  return unbox(to<subnet>(str));
+}
+
+struct fixture {
+  fixture() {
+    factory<value_index>::initialize();
+    idx = factory<value_index>::make(
+      type{address_type{}, {{"index", "prefix"}}}, caf::settings{});
+    REQUIRE_NOT_EQUAL(idx, nullptr);
+    REQUIRE(dynamic_cast<address_prefix_index*>(idx.get()) != nullptr);
+    for (auto x : {"10.0.0.1", "10.1.2.3", "192.168.0.1", "192.168.1.7",
+                   "10.0.0.1", "::1", "172.16.5.4"})
+      REQUIRE(idx->append(make_data_view(addr(x))));
+    REQUIRE(idx->append(make_data_view(caf::none)));
+  }
+
+  auto lookup(relational_operator op, data_view x) {
+    return to_string(unbox(idx->lookup(op, x)));
+  }
+
+  value_index_ptr idx;
+};
+
+} // namespace
+
+FIXTURE_SCOPE(address_prefix_index_tests, fixture)
+
+TEST(address prefix index equality lookup) {
+  auto x = addr("10.0.0.1");
+  CHECK_EQUAL(lookup(relational_operator::equal, make_data_view(x)),
+              "10001000");
+  CHECK_EQUAL(lookup(relational_operator::not_equal, make_data_view(x)),
+              "01110111");
+  x = addr("10.0.0.2");
+  CHECK_EQUAL(lookup(relational_operator::equal, make_data_view(x)),
+              "00000000");
+  MESSAGE("invalid operators");
+  CHECK(!idx->lookup(relational_operator::match, make_data_view(x)));
+  CHECK(!idx->lookup(relational_operator::in, make_data_view(x)));
+}
+
+TEST(address prefix index subnet lookup) {
+  auto x = sn("10.0.0.0/8");
+  CHECK_EQUAL(lookup(relational_operator::in, make_data_view(x)), "11001000");
+  CHECK_EQUAL(lookup(relational_operator::not_in, make_data_view(x)),
+              "00110110");
+  x = sn("192.168.1.7/32");
+  CHECK_EQUAL(lookup(relational_operator::in, make_data_view(x)), "00010000");
+  x = sn("0.0.0.0/0");
+  CHECK_EQUAL(lookup(relational_operator::in, make_data_view(x)), "11111010");
+  x = sn("::/0");
+  CHECK_EQUAL(lookup(relational_operator::in, make_data_view(x)), "11111110");
+  CHECK(!idx->lookup(relational_operator::equal, make_data_view(x)));
+}
+
+TEST(address prefix index list lookup) {
+  auto xs = list{sn("10.0.0.0/16"), addr("192.168.1.7"), sn("172.16.0.0/12"),
+                 addr("2001:db8::1"), "foo"s};
+  CHECK_EQUAL(lookup(relational_operator::in, make_data_view(xs)), "10011010");
+  CHECK_EQUAL(lookup(relational_operator::not_in, make_data_view(xs)),
+              "01100100");
+  MESSAGE("overlapping subnets");
+  xs = list{sn("10.1.0.0/16"), sn("10.0.0.0/8"), addr("10.0.0.1")};
+  CHECK_EQUAL(lookup(relational_operator::in, make_data_view(xs)), "11001000");
+  xs = list{};
+  CHECK_EQUAL(lookup(relational_operator::in, make_data_view(xs)), "00000000");
+}
+
+TEST(address prefix index serialization) {
+  auto xs = list{sn("192.168.0.0/16"), addr("::1")};
+  auto builder = flatbuffers::FlatBufferBuilder{};
+  const auto idx_offset = pack(builder, idx);
+  builder.Finish(idx_offset);
+  auto maybe_fb = flatbuffer<fbs::ValueIndex>::make(builder.Release());
+  REQUIRE_NOERROR(maybe_fb);
+  auto fb = *maybe_fb;
+  REQUIRE(fb);
+  auto idx2 = value_index_ptr{};
+  REQUIRE_EQUAL(unpack(*fb, idx2), caf::none);
+  REQUIRE(dynamic_cast<address_prefix_index*>(idx2.get()) != nullptr);
+  CHECK_EQUAL(idx->type(), idx2->type());
+  auto result = idx2->lookup(relational_operator::in, make_data_view(xs));
+  CHECK_EQUAL(to_string(unbox(result)), "00110100");
+  MESSAGE("legacy serialization");
+  std::vector<char> buf;
+  CHECK_EQUAL(detail::serialize(buf, idx), caf::none);
+  auto idx3 = value_index_ptr{};
+  REQUIRE_EQUAL(detail::legacy_deserialize(buf, idx3), true);
+  result = idx3->lookup(relational_operator::in, make_data_view(xs));
+  CHECK_EQUAL(to_string(unbox(result)), "00110100");
+}
+
+FIXTURE_SCOPE_END()
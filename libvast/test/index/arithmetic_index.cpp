@@ -155,4 +155,31 @@ TEST(none values - arithmetic) {
   CHECK_EQUAL(to_string(unbox(bm)), "00100");
 }
 
+TEST(roaring bitmaps) {
+  auto ewah_idx
+    = factory<value_index>::make(type{count_type{}}, caf::settings{});
+  auto roaring_idx = factory<value_index>::make(
+    type{count_type{}, {{"bitmap", "roaring"}}}, caf::settings{});
+  REQUIRE_NOT_EQUAL(ewah_idx, nullptr);
+  REQUIRE_NOT_EQUAL(roaring_idx, nullptr);
+  for (auto i = count{0}; i < 100'000; ++i) {
+    auto x = make_data_view(i % 7 == 0 ? i : i % 13);
+    REQUIRE(ewah_idx->append(x));
+    REQUIRE(roaring_idx->append(x));
+  }
+  for (auto op : {relational_operator::less, relational_operator::equal,
+                  relational_operator::not_equal,
+                  relational_operator::greater_equal}) {
+    auto x = make_data_view(count{12});
+    auto expected = unbox(ewah_idx->lookup(op, x));
+    auto result = unbox(roaring_idx->lookup(op, x));
+    CHECK_EQUAL(result.size(), expected.size());
+    CHECK_EQUAL(rank(result ^ expected), 0u);
+  }
+  MESSAGE("invalid bitmap types");
+  auto invalid = factory<value_index>::make(
+    type{count_type{}, {{"bitmap", "bloom"}}}, caf::settings{});
+  CHECK_EQUAL(invalid, nullptr);
+}
+
 FIXTURE_SCOPE_END()
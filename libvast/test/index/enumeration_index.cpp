@@ -10,9 +10,13 @@
 
 #include "vast/index/enumeration_index.hpp"
 
+#include "vast/concept/parseable/to.hpp"
+#include "vast/concept/parseable/vast/expression.hpp"
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/bitmap.hpp"
+#include "vast/expression.hpp"
 #include "vast/test/test.hpp"
+#include "vast/view.hpp"
 
 #include <caf/test/dsl.hpp>
 
@@ -35,3 +39,27 @@ TEST(enumeration) {
   CHECK_NOERROR(bar);
   CHECK_EQUAL(to_string(*bar), "0010");
 }
+
+TEST(enumeration membership) {
+  auto e = enumeration_type{{{"foo"}, {"bar"}, {"baz"}}};
+  auto idx = enumeration_index(type{e});
+  REQUIRE(idx.append(enumeration{0}));
+  REQUIRE(idx.append(enumeration{0}));
+  REQUIRE(idx.append(enumeration{1}));
+  REQUIRE(idx.append(enumeration{2}));
+  // Look up the right-hand side the same way as the INDEXER does.
+  auto lookup = [&](std::string_view query) {
+    auto expr = normalize(unbox(to<expression>(query)));
+    const auto* pred = caf::get_if<predicate>(&expr);
+    REQUIRE(pred);
+    auto rep = to_internal(idx.type(), make_view(caf::get<data>(pred->rhs)));
+    auto result = idx.lookup(pred->op, rep);
+    REQUIRE_NOERROR(result);
+    return to_string(*result);
+  };
+  MESSAGE("membership in a list of names");
+  CHECK_EQUAL(lookup("x in [\"foo\", \"baz\"]"), "1101");
+  CHECK_EQUAL(lookup("x !in [\"foo\", \"baz\"]"), "0010");
+  MESSAGE("names that the enumeration does not know match nothing");
+  CHECK_EQUAL(lookup("x in [\"bar\", \"qux\"]"), "0010");
+}
@@ -16,6 +16,7 @@
 #include "vast/detail/serialize.hpp"
 #include "vast/fbs/value_index.hpp"
 #include "vast/flatbuffer.hpp"
+#include "vast/ids.hpp"
 #include "vast/operator.hpp"
 #include "vast/si_literals.hpp"
 #include "vast/test/test.hpp"
@@ -47,6 +48,63 @@ TEST(string) {
   CHECK_EQUAL(to_string(unbox(result)), "01101000101");
 }
 
+TEST(restricted lookup) {
+  hash_index<1> idx{type{string_type{}}};
+  REQUIRE(idx.append(make_data_view("foo")));
+  REQUIRE(idx.append(make_data_view("bar")));
+  REQUIRE(idx.append(make_data_view("baz")));
+  REQUIRE(idx.append(make_data_view("foo")));
+  REQUIRE(idx.append(make_data_view(caf::none)));
+  REQUIRE(idx.append(make_data_view("bar"), 8));
+  REQUIRE(idx.append(make_data_view("foo"), 9));
+  REQUIRE(idx.append(make_data_view(caf::none)));
+  MESSAGE("only the selected positions have hits");
+  auto selection = make_ids({{0, 1}, {9, 10}});
+  auto result
+    = idx.lookup(relational_operator::equal, make_data_view("foo"), selection);
+  CHECK_EQUAL(to_string(unbox(result)), "10000000010");
+  MESSAGE("selected nils are hits for !=");
+  selection = make_ids({{1, 2}, {3, 6}});
+  result = idx.lookup(relational_operator::not_equal, make_data_view("foo"),
+                      selection);
+  CHECK_EQUAL(to_string(unbox(result)), "01001000000");
+  MESSAGE("selecting everything is the same as no selection");
+  selection = make_ids({{0, 11}});
+  result = idx.lookup(relational_operator::in,
+                      make_data_view(list{"foo", "baz"}), selection);
+  CHECK_EQUAL(to_string(unbox(result)), "10110000010");
+  MESSAGE("an empty selection has no hits");
+  result = idx.lookup(relational_operator::equal, make_data_view("foo"), ids{});
+  CHECK_EQUAL(to_string(unbox(result)), "00000000000");
+}
+
+TEST(restricted lookup at non-zero offset) {
+  hash_index<1> idx{type{string_type{}}};
+  REQUIRE(idx.append(make_data_view("foo"), 5));
+  REQUIRE(idx.append(make_data_view("bar")));
+  REQUIRE(idx.append(make_data_view("baz")));
+  REQUIRE(idx.append(make_data_view("foo")));
+  REQUIRE(idx.append(make_data_view(caf::none)));
+  REQUIRE(idx.append(make_data_view("foo"), 12));
+  MESSAGE("unrestricted lookup");
+  auto result = idx.lookup(relational_operator::equal, make_data_view("foo"));
+  CHECK_EQUAL(to_string(unbox(result)), "0000010010001");
+  MESSAGE("candidates map to the digests of their IDs");
+  auto selection = make_ids({{5, 6}, {8, 13}});
+  result
+    = idx.lookup(relational_operator::equal, make_data_view("foo"), selection);
+  CHECK_EQUAL(to_string(unbox(result)), "0000010010001");
+  selection = make_ids({{6, 10}});
+  result = idx.lookup(relational_operator::not_equal, make_data_view("foo"),
+                      selection);
+  CHECK_EQUAL(to_string(unbox(result)), "0000001101000");
+  MESSAGE("the last value is found at its ID");
+  selection = make_ids({{12, 13}});
+  result = idx.lookup(relational_operator::equal, make_data_view("foo"),
+                      selection);
+  CHECK_EQUAL(to_string(unbox(result)), "0000000000001");
+}
+
 TEST(serialization) {
   hash_index<1> x{type{string_type{}}};
   REQUIRE(x.append(make_data_view("foo")));
@@ -0,0 +1,137 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#define SUITE value_index
+
+#include "vast/index/ngram_index.hpp"
+
+#include "vast/concept/printable/to_string.hpp"
+#include "vast/concept/printable/vast/bitmap.hpp"
+#include "vast/detail/legacy_deserialize.hpp"
+#include "vast/detail/serialize.hpp"
+#include "vast/fbs/value_index.hpp"
+#include "vast/flatbuffer.hpp"
+#include "vast/test/test.hpp"
+#include "vast/value_index_factory.hpp"
+
+#include <caf/test/dsl.hpp>
+
+using namespace vast;
+using namespace std::string_literals;
+
+namespace {
+
+struct fixture {
+  fixture() {
+    factory<value_index>::initialize();
+    idx = factory<value_index>::make(type{string_type{}, {{"index", "ngram"}}},
+                                     caf::settings{});
+    REQUIRE_NOT_EQUAL(idx, nullptr);
+    REQUIRE(dynamic_cast<ngram_index*>(idx.get()) != nullptr);
+    for (std::string_view x : {"www.evil.com", "evil.com", "example.org",
+                               "devil.co", "", "mail.evil.com.cn", "abcbca"})
+      REQUIRE(idx->append(make_data_view(x)));
+    REQUIRE(idx->append(make_data_view(caf::none)));
+  }
+
+  auto lookup(relational_operator op, data_view x) {
+    return to_string(unbox(idx->lookup(op, x)));
+  }
+
+  value_index_ptr idx;
+};
+
+} // namespace
+
+FIXTURE_SCOPE(ngram_index_tests, fixture)
+
+TEST(ngram index substring lookup) {
+  CHECK_EQUAL(lookup(relational_operator::ni, make_data_view("evil.com")),
+              "11000100");
+  CHECK_EQUAL(lookup(relational_operator::ni, make_data_view(".org")),
+              "00100000");
+  CHECK_EQUAL(lookup(relational_operator::ni, make_data_view("nope")),
+              "00000000");
+  MESSAGE("substrings shorter than an n-gram are exact");
+  CHECK_EQUAL(lookup(relational_operator::ni, make_data_view("co")),
+              "11010100");
+  CHECK_EQUAL(lookup(relational_operator::ni, make_data_view("")),
+              "11111110");
+  MESSAGE("results are candidates");
+  // "abcbca" contains all n-grams of "abca", but not "abca" itself.
+  CHECK_EQUAL(lookup(relational_operator::ni, make_data_view("abca")),
+              "00000010");
+  MESSAGE("negations are exact");
+  CHECK_EQUAL(lookup(relational_operator::not_ni, make_data_view("evil.com")),
+              "00111010");
+  CHECK_EQUAL(lookup(relational_operator::not_ni, make_data_view("abca")),
+              "11111110");
+}
+
+TEST(ngram index equality lookup) {
+  CHECK_EQUAL(lookup(relational_operator::equal, make_data_view("evil.com")),
+              "01000000");
+  CHECK_EQUAL(lookup(relational_operator::not_equal,
+                     make_data_view("evil.com")),
+              "10111111");
+  CHECK_EQUAL(lookup(relational_operator::equal, make_data_view("")),
+              "00001000");
+  auto xs = list{"evil.com", "example.org"};
+  CHECK_EQUAL(lookup(relational_operator::in, make_data_view(xs)), "01100000");
+}
+
+TEST(ngram index pattern lookup) {
+  auto evil = pattern{".*\\.evil\\.com.*"};
+  CHECK_EQUAL(lookup(relational_operator::match, make_data_view(evil)),
+              "10000100");
+  CHECK_EQUAL(lookup(relational_operator::equal, make_data_view(evil)),
+              "10000100");
+  auto alternation = pattern{"evil|example"};
+  CHECK_EQUAL(lookup(relational_operator::match, make_data_view(alternation)),
+              "11111110");
+  CHECK_EQUAL(lookup(relational_operator::not_match, make_data_view(evil)),
+              "11111110");
+}
+
+TEST(ngram index truncation) {
+  caf::settings opts;
+  opts["max-size"] = 8;
+  auto idx = ngram_index{type{string_type{}}, opts};
+  REQUIRE(idx.append(make_data_view("0123456789evil")));
+  REQUIRE(idx.append(make_data_view("evil")));
+  REQUIRE(idx.append(make_data_view("good")));
+  auto result = idx.lookup(relational_operator::ni, make_data_view("evil"));
+  CHECK_EQUAL(to_string(unbox(result)), "110");
+}
+
+TEST(ngram index serialization) {
+  auto builder = flatbuffers::FlatBufferBuilder{};
+  const auto idx_offset = pack(builder, idx);
+  builder.Finish(idx_offset);
+  auto maybe_fb = flatbuffer<fbs::ValueIndex>::make(builder.Release());
+  REQUIRE_NOERROR(maybe_fb);
+  auto fb = *maybe_fb;
+  REQUIRE(fb);
+  auto idx2 = value_index_ptr{};
+  REQUIRE_EQUAL(unpack(*fb, idx2), caf::none);
+  REQUIRE(dynamic_cast<ngram_index*>(idx2.get()) != nullptr);
+  CHECK_EQUAL(idx->type(), idx2->type());
+  auto result = idx2->lookup(relational_operator::ni, make_data_view("evil"));
+  CHECK_EQUAL(to_string(unbox(result)), "11010100");
+  result = idx2->lookup(relational_operator::equal, make_data_view("devil.co"));
+  CHECK_EQUAL(to_string(unbox(result)), "00010000");
+  MESSAGE("legacy serialization");
+  std::vector<char> buf;
+  CHECK_EQUAL(detail::serialize(buf, idx), caf::none);
+  auto idx3 = value_index_ptr{};
+  REQUIRE_EQUAL(detail::legacy_deserialize(buf, idx3), true);
+  result = idx3->lookup(relational_operator::ni, make_data_view("evil"));
+  CHECK_EQUAL(to_string(unbox(result)), "11010100");
+}
+
+FIXTURE_SCOPE_END()
@@ -17,6 +17,7 @@
 #include "vast/fbs/partition.hpp"
 #include "vast/fbs/utils.hpp"
 #include "vast/fbs/uuid.hpp"
+#include "vast/io/read.hpp"
 #include "vast/query.hpp"
 #include "vast/system/active_partition.hpp"
 #include "vast/system/actors.hpp"
@@ -277,6 +278,26 @@ TEST(full partition roundtrip) {
     [](const caf::error& err) {
       FAIL(err);
     });
+  MESSAGE("the value index is stored in a section of the partition file");
+  {
+    auto bytes = vast::io::read(directory / persist_path);
+    REQUIRE(bytes);
+    REQUIRE(vast::fbs::PartitionBufferHasIdentifier(bytes->data()));
+    auto persisted = vast::fbs::GetPartition(bytes->data());
+    REQUIRE_EQUAL(persisted->partition_type(),
+                  vast::fbs::partition::Partition::legacy);
+    auto indexes = persisted->partition_as_legacy()->indexes();
+    REQUIRE(indexes);
+    REQUIRE_EQUAL(indexes->size(), 1u);
+    auto index = indexes->Get(0)->index();
+    CHECK(!index->data());
+    REQUIRE(index->section());
+    CHECK_EQUAL(index->section()->offset(),
+                vast::system::partition_header_size);
+    auto section = vast::system::value_index_bytes(*bytes, *index);
+    REQUIRE(section);
+    CHECK_EQUAL(section->size(), index->section()->size());
+  }
   self->send_exit(partition, caf::exit_reason::user_shutdown);
   // Spawn a read-only partition from this chunk and try to query the data we
   // added. We make two queries, one "#type"-query and one "normal" query
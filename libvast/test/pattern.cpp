@@ -10,6 +10,8 @@
 
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/pattern.hpp"
+#include "vast/detail/legacy_deserialize.hpp"
+#include "vast/detail/serialize.hpp"
 #include "vast/pattern.hpp"
 
 #define SUITE pattern
@@ -39,6 +41,60 @@ TEST(functionality) {
   CHECK(p.search(str));
 }
 
+TEST(literals) {
+  auto p = pattern{"evil\\.com"};
+  CHECK(p.match("evil.com"));
+  CHECK(!p.match("evilxcom"));
+  CHECK(p.search("www.evil.com"));
+  CHECK(!p.search("www.evil.org"));
+  p = pattern{};
+  CHECK(p.match(""));
+  CHECK(!p.match("foo"));
+  CHECK(p.search("foo"));
+  MESSAGE("candidates with the required literals");
+  p = pattern{".*\\.evil\\.com"};
+  CHECK(p.match("www.evil.com"));
+  CHECK(!p.match("www.evil.com.cn"));
+  CHECK(p.search("www.evil.com.cn"));
+  CHECK(!p.search("www.devil.co"));
+  MESSAGE("invalid expressions match nothing");
+  p = pattern{"[a-"};
+  CHECK(!p.match("a"));
+  CHECK(!p.search("a"));
+}
+
+TEST(compiled form) {
+  auto p = pattern{"^foo"};
+  auto q = p;
+  CHECK(q.search("foobar"));
+  q += "bar$";
+  CHECK(p.search("foobarbaz"));
+  CHECK(!q.search("foobarbaz"));
+  CHECK(q.search("foobar"));
+  MESSAGE("deserialization compiles the expression");
+  std::vector<char> buf;
+  REQUIRE_EQUAL(detail::serialize(buf, q), caf::none);
+  auto r = pattern{};
+  REQUIRE(detail::legacy_deserialize(buf, r));
+  CHECK_EQUAL(r, q);
+  CHECK(r.match("foobar"));
+  CHECK(!r.match("foobarbaz"));
+}
+
+TEST(required literals) {
+  using strings = std::vector<std::string>;
+  CHECK_EQUAL(required_literals("foo"), strings{"foo"});
+  CHECK_EQUAL(required_literals(".*evil\\.com.*"), strings{"evil.com"});
+  CHECK_EQUAL(required_literals("^GET /index\\.php"),
+              strings{"GET /index.php"});
+  CHECK_EQUAL(required_literals("ab*cde"), (strings{"a", "cde"}));
+  CHECK_EQUAL(required_literals("abcd{2,3}efg"), (strings{"abc", "efg"}));
+  CHECK_EQUAL(required_literals("(foo|bar)baz"), strings{"baz"});
+  CHECK_EQUAL(required_literals("x[a-z]yzw"), (strings{"x", "yzw"}));
+  CHECK_EQUAL(required_literals("\\d+abc\\x41def"), (strings{"abc", "def"}));
+  CHECK(required_literals("foo|bar").empty());
+}
+
 TEST(comparison with string) {
   auto rx = pattern{"foo.*baz"};
   CHECK("foobarbaz"sv == rx);
@@ -0,0 +1,99 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2022 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#define SUITE query_trace
+
+#include "vast/query_trace.hpp"
+
+#include "vast/concept/printable/to_string.hpp"
+#include "vast/concept/printable/vast/uuid.hpp"
+#include "vast/test/test.hpp"
+
+using namespace vast;
+using namespace std::chrono_literals;
+
+TEST(summarize) {
+  auto p1 = uuid::random();
+  auto p2 = uuid::random();
+  auto trace = query_trace{};
+  trace.add({.name = "catalog",
+             .runtime = 1ms,
+             .values = {{"candidates", count{2}}}});
+  trace.add({.partition = p1,
+             .name = "lookup",
+             .runtime = 3ms,
+             .values = {{"source", "disk"}, {"events", count{10}}}});
+  trace.add({.partition = p2,
+             .name = "lookup",
+             .runtime = 2ms,
+             .values = {{"source", "cache"}, {"events", count{5}}}});
+  trace.add({.partition = p1,
+             .name = "predicate",
+             .runtime = 1ms,
+             .values = {{"predicate", "x == 1"}, {"hits", count{3}}}});
+  trace.add({.partition = p2,
+             .name = "predicate",
+             .runtime = 4ms,
+             .values = {{"predicate", "x == 1"}, {"hits", count{1}}}});
+  trace.add({.partition = p1,
+             .name = "predicate",
+             .runtime = 2ms,
+             .values = {{"predicate", "y > 2"},
+                        {"hits", count{2}},
+                        {"candidates", count{3}}}});
+  REQUIRE_EQUAL(trace.size(), 6u);
+  auto summary = trace.summarize();
+  // Spans that concern the query as a whole appear only at the top level.
+  auto catalog = record{
+    {"count", count{1}},
+    {"runtime", duration{1ms}},
+    {"candidates", count{2}},
+  };
+  CHECK_EQUAL(summary["catalog"], data{catalog});
+  // The spans of all partitions are summed up at the top level.
+  auto lookup = record{
+    {"count", count{2}},
+    {"runtime", duration{5ms}},
+    {"source", record{{"disk", count{1}}, {"cache", count{1}}}},
+    {"events", count{15}},
+  };
+  CHECK_EQUAL(summary["lookup"], data{lookup});
+  // The predicates are sorted by their total runtime.
+  auto predicates = list{
+    record{
+      {"predicate", "x == 1"},
+      {"count", count{2}},
+      {"runtime", duration{5ms}},
+      {"hits", count{4}},
+    },
+    record{
+      {"predicate", "y > 2"},
+      {"count", count{1}},
+      {"runtime", duration{2ms}},
+      {"hits", count{2}},
+      {"candidates", count{3}},
+    },
+  };
+  CHECK_EQUAL(summary["predicates"], data{predicates});
+  // Every partition has its own breakdown.
+  const auto& partitions = caf::get<list>(summary["partitions"]);
+  REQUIRE_EQUAL(partitions.size(), 2u);
+  const auto& first = caf::get<record>(partitions[0]);
+  CHECK_EQUAL(first.at("id"), data{to_string(p1)});
+  auto first_lookup = record{
+    {"count", count{1}},
+    {"runtime", duration{3ms}},
+    {"source", record{{"disk", count{1}}}},
+    {"events", count{10}},
+  };
+  CHECK_EQUAL(first.at("lookup"), data{first_lookup});
+  CHECK_EQUAL(caf::get<list>(first.at("predicates")).size(), 2u);
+  const auto& second = caf::get<record>(partitions[1]);
+  CHECK_EQUAL(second.at("id"), data{to_string(p2)});
+  CHECK(!second.contains("catalog"));
+}
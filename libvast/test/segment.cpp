@@ -10,6 +10,9 @@
 
 #include "vast/segment.hpp"
 
+#include "vast/concept/parseable/to.hpp"
+#include "vast/concept/parseable/vast/data.hpp"
+#include "vast/concept/parseable/vast/time.hpp"
 #include "vast/detail/legacy_deserialize.hpp"
 #include "vast/detail/serialize.hpp"
 #include "vast/ids.hpp"
@@ -17,6 +20,7 @@
 #include "vast/table_slice.hpp"
 #include "vast/test/fixtures/events.hpp"
 #include "vast/test/test.hpp"
+#include "vast/zone_map.hpp"
 
 #include <caf/test/dsl.hpp>
 
@@ -59,4 +63,51 @@ TEST(serialization) {
   CHECK_EQUAL(x.num_slices(), y->num_slices());
 }
 
+TEST(zone maps) {
+  segment_builder builder{1024};
+  for (auto& slice : zeek_conn_log)
+    REQUIRE(!builder.add(slice));
+  REQUIRE_EQUAL(zeek_conn_log.size(), 3u);
+  auto zones = zone_map::make(zeek_conn_log[0]);
+  REQUIRE_EQUAL(zones.time_ranges.size(), 1u);
+  auto ts = [&](relational_operator op, data x) {
+    return expression{predicate{field_extractor{"ts"}, op, std::move(x)}};
+  };
+  auto first = ts(relational_operator::less_equal, zones.time_ranges[0].max);
+  auto rest = ts(relational_operator::greater, zones.time_ranges[0].max);
+  auto never = ts(relational_operator::less, unbox(to<data>("2000-01-01")));
+  MESSAGE("lookup in the segment builder");
+  auto xs = builder.ids();
+  auto slices = unbox(builder.lookup(xs, first));
+  REQUIRE_EQUAL(slices.size(), 1u);
+  CHECK_EQUAL(slices[0], zeek_conn_log[0]);
+  CHECK_EQUAL(unbox(builder.lookup(xs, rest)).size(), 2u);
+  CHECK_EQUAL(unbox(builder.lookup(xs, never)).size(), 0u);
+  CHECK_EQUAL(unbox(builder.lookup(xs, negation{never})).size(), 3u);
+  CHECK_EQUAL(unbox(builder.lookup(xs, disjunction{first, rest})).size(), 3u);
+  CHECK_EQUAL(unbox(builder.lookup(xs, conjunction{first, rest})).size(), 0u);
+  MESSAGE("lookup in the finished segment");
+  auto x = builder.finish();
+  slices = unbox(x.lookup(xs, first));
+  REQUIRE_EQUAL(slices.size(), 1u);
+  CHECK_EQUAL(slices[0], zeek_conn_log[0]);
+  CHECK_EQUAL(unbox(x.lookup(xs, rest)).size(), 2u);
+  CHECK_EQUAL(unbox(x.lookup(xs, never)).size(), 0u);
+  CHECK_EQUAL(unbox(x.lookup(xs, expression{})).size(), 3u);
+}
+
+TEST(zone maps never rule out inequality) {
+  // A slice whose time column holds a single distinct value may still have
+  // null values in that column, which match `!=` as well.
+  auto t = unbox(to<vast::time>("2021-01-01"));
+  auto zones = zone_map{};
+  zones.time_ranges.push_back({0, t, t});
+  auto extractor = data_extractor{type{time_type{}}, 0};
+  CHECK(!zones.may_match(
+    expression{predicate{extractor, relational_operator::equal,
+                         data{t + std::chrono::seconds{1}}}}));
+  CHECK(zones.may_match(
+    expression{predicate{extractor, relational_operator::not_equal, data{t}}}));
+}
+
 FIXTURE_SCOPE_END()
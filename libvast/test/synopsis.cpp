@@ -12,6 +12,7 @@
 
 #include "vast/bool_synopsis.hpp"
 #include "vast/synopsis_factory.hpp"
+#include "vast/table_slice_builder_factory.hpp"
 #include "vast/test/fixtures/actor_system.hpp"
 #include "vast/test/synopsis.hpp"
 #include "vast/test/test.hpp"
@@ -75,6 +76,48 @@ TEST(min - max synopsis) {
   verify(heterogeneous_view, {N, N, T, F, N, N, N, N, N, N, N, N});
 }
 
+TEST(adding columns) {
+  using vast::time;
+  factory<synopsis>::initialize();
+  factory<table_slice_builder>::initialize();
+  auto layout = type{
+    "test",
+    record_type{
+      {"ts", time_type{}},
+      {"flag", bool_type{}},
+    },
+  };
+  for (auto encoding :
+       {table_slice_encoding::arrow, table_slice_encoding::msgpack}) {
+    MESSAGE(fmt::format("add columns of a {} table slice", encoding));
+    auto builder = factory<table_slice_builder>::make(encoding, layout);
+    REQUIRE(builder);
+    REQUIRE(builder->add(time{epoch + 7s}, true));
+    REQUIRE(builder->add(caf::none, caf::none));
+    REQUIRE(builder->add(time{epoch + 4s}, true));
+    auto slice = builder->finish();
+    REQUIRE_EQUAL(slice.rows(), 3u);
+    auto ts = factory<synopsis>::make(type{time_type{}}, caf::settings{});
+    REQUIRE_NOT_EQUAL(ts, nullptr);
+    ts->add_column(slice, 0);
+    auto expected = factory<synopsis>::make(type{time_type{}}, caf::settings{});
+    expected->add(time{epoch + 4s});
+    expected->add(time{epoch + 7s});
+    CHECK(*ts == *expected);
+    auto flag = factory<synopsis>::make(type{bool_type{}}, caf::settings{});
+    REQUIRE_NOT_EQUAL(flag, nullptr);
+    flag->add_column(slice, 1);
+    auto any_true = flag->lookup(relational_operator::equal,
+                                 make_data_view(true));
+    REQUIRE(any_true);
+    CHECK(*any_true);
+    auto any_false = flag->lookup(relational_operator::equal,
+                                  make_data_view(false));
+    REQUIRE(any_false);
+    CHECK(!*any_false);
+  }
+}
+
 namespace {
 
 struct fixture : public fixtures::deterministic_actor_system {
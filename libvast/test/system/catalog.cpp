@@ -323,6 +323,55 @@ TEST(attribute extractor - import time) {
   CHECK_EQUAL(lookup(newer_than_y2030), empty());
 }
 
+TEST(estimate counts from metadata) {
+  auto estimate = [&](std::string_view expr) {
+    auto result = catalog_result{};
+    auto q = query::make_count(system::receiver_actor<uint64_t>{},
+                               query::count::estimate,
+                               unbox(to<expression>(expr)));
+    auto rp = self->request(meta_idx, caf::infinite, atom::candidates_v, q);
+    run();
+    rp.receive(
+      [&](catalog_result& candidates) {
+        result = std::move(candidates);
+      },
+      [](const caf::error& e) {
+        FAIL(render(e));
+      });
+    return result;
+  };
+  using counts = std::vector<std::pair<uuid, uint64_t>>;
+  MESSAGE("partitions fully covered by the query are counted");
+  auto result = estimate("#type == \"foo\"");
+  CHECK_EQUAL(result.partitions, empty());
+  CHECK_EQUAL(result.counts, (counts{{ids[0], 25u}, {ids[2], 25u}}));
+  result = estimate("#type == \"foobar\" || #import_time < 2000-01-01");
+  CHECK_EQUAL(result.partitions, empty());
+  CHECK_EQUAL(result.counts.size(), ids.size());
+  MESSAGE("predicates on the data need a partition lookup");
+  auto foo = std::vector<uuid>{ids[0], ids[2]};
+  result = estimate("#type == \"foo\" && content == \"foo\"");
+  CHECK_EQUAL(result.partitions, foo);
+  CHECK(result.counts.empty());
+  MESSAGE("extractions always need a partition lookup");
+  CHECK_EQUAL(lookup("#type == \"foo\""), foo);
+  MESSAGE("partitions straddling a bound are left to the partitions");
+  auto straddling = make_partition_synopsis(generator{"foo", 100}(10));
+  straddling.min_import_time
+    = caf::get<vast::time>(unbox(to<data>("1975-01-01")));
+  straddling.max_import_time
+    = caf::get<vast::time>(unbox(to<data>("2015-01-01")));
+  auto straddling_id = uuid::random();
+  merge(meta_idx, straddling_id,
+        caf::make_copy_on_write<partition_synopsis>(std::move(straddling)));
+  result = estimate("#import_time < 2000-01-01");
+  CHECK_EQUAL(result.partitions, std::vector{straddling_id});
+  CHECK_EQUAL(result.counts, (counts{{ids[0], 25u}, {ids[2], 25u}}));
+  result = estimate("#type == \"foo\"");
+  CHECK_EQUAL(result.partitions, empty());
+  CHECK_EQUAL(result.counts.size(), 3u);
+}
+
 TEST(catalog with bool synopsis) {
   MESSAGE("generate slice data and add it to the catalog");
   // FIXME: do we have to replace the catalog from the fixture with a new
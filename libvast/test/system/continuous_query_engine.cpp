@@ -0,0 +1,141 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#define SUITE continuous_query_engine
+
+#include "vast/system/continuous_query_engine.hpp"
+
+#include "vast/bitmap_algorithms.hpp"
+#include "vast/concept/parseable/to.hpp"
+#include "vast/concept/parseable/vast/expression.hpp"
+#include "vast/detail/spawn_container_source.hpp"
+#include "vast/system/status.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/test/fixtures/actor_system_and_events.hpp"
+#include "vast/test/test.hpp"
+
+#include <caf/attach_stream_sink.hpp>
+
+using namespace vast;
+using namespace std::chrono_literals;
+
+namespace {
+
+/// The results that a subscriber received for its query.
+struct subscription {
+  std::vector<table_slice> slices = {};
+  uint64_t checked = {};
+};
+
+struct fixture : fixtures::deterministic_actor_system_and_events {
+  fixture()
+    : fixtures::deterministic_actor_system_and_events(
+      VAST_PP_STRINGIFY(SUITE)) {
+    engine = self->spawn(system::continuous_query_engine);
+  }
+
+  ~fixture() override {
+    self->send_exit(engine, caf::exit_reason::user_shutdown);
+    run();
+  }
+
+  /// Subscribes a dummy actor that collects the results.
+  auto subscribe(std::string_view query,
+                 std::shared_ptr<subscription> results) {
+    using subscriber_actor = system::continuous_query_subscriber_actor;
+    auto subscriber = sys.spawn(
+      [=](subscriber_actor::pointer sink) -> subscriber_actor::behavior_type {
+        return {
+          [=](atom::update, uint64_t checked) {
+            results->checked += checked;
+          },
+          [=](caf::stream<table_slice> in,
+              atom::subscribe) -> caf::inbound_stream_slot<table_slice> {
+            return caf::attach_stream_sink(
+                     sink, in,
+                     [](caf::unit_t&) {
+                       // nop
+                     },
+                     [=](caf::unit_t&, table_slice slice) {
+                       results->slices.push_back(std::move(slice));
+                     })
+              .inbound_slot();
+          },
+        };
+      });
+    self->send(engine, atom::subscribe_v, unbox(to<expression>(query)),
+               subscriber);
+    run();
+    return subscriber;
+  }
+
+  /// Computes the number of matching events by evaluating a query for each
+  /// table slice individually.
+  size_t expected(std::string_view query) {
+    auto expr = unbox(to<expression>(query));
+    auto result = size_t{0};
+    for (const auto& slice : zeek_conn_log)
+      if (auto tailored = tailor(expr, slice.layout()))
+        result += rank(evaluate(*tailored, slice));
+    return result;
+  }
+
+  system::continuous_query_engine_actor engine;
+};
+
+} // namespace
+
+FIXTURE_SCOPE(continuous_query_engine_tests, fixture)
+
+TEST(shared evaluation) {
+  auto queries = std::vector<std::string_view>{
+    R"__(service == "dns" && :addr == 192.168.1.1)__",
+    R"__(service == "dns")__",
+    R"__(! (service == "dns") || :addr == 192.168.1.1)__",
+    R"__(foo.bar == "baz")__",
+  };
+  auto results = std::vector<std::shared_ptr<subscription>>{};
+  for (auto query : queries) {
+    results.push_back(std::make_shared<subscription>());
+    subscribe(query, results.back());
+  }
+  vast::detail::spawn_container_source(sys, zeek_conn_log, engine);
+  run();
+  CHECK_EQUAL(rows(results[0]->slices), 5u);
+  for (size_t i = 0; i < queries.size(); ++i)
+    CHECK_EQUAL(rows(results[i]->slices), expected(queries[i]));
+  MESSAGE("subscribers learn how many events were checked");
+  self->send(engine, atom::telemetry_v);
+  run();
+  for (const auto& result : results)
+    CHECK_EQUAL(result->checked, rows(zeek_conn_log));
+  MESSAGE("subscribers that go down no longer receive results");
+  auto status = [&] {
+    auto result = record{};
+    self->send(engine, atom::status_v, system::status_verbosity::info);
+    run();
+    self->receive(
+      [&](record& x) {
+        result = std::move(x);
+      },
+      caf::after(0s) >>
+        [&] {
+          FAIL("CONTINUOUS QUERY ENGINE did not respond to status request");
+        });
+    return result;
+  };
+  CHECK_EQUAL(status()["subscribers"], count{4});
+  auto subscriber
+    = subscribe("service == \"http\"", std::make_shared<subscription>());
+  CHECK_EQUAL(status()["subscribers"], count{5});
+  self->send_exit(subscriber, caf::exit_reason::user_shutdown);
+  run();
+  CHECK_EQUAL(status()["subscribers"], count{4});
+}
+
+FIXTURE_SCOPE_END()
@@ -76,7 +76,8 @@ struct fixture : fixtures::deterministic_actor_system_and_events {
     index = self->spawn(system::index, system::accountant_actor{}, fs, archive,
                         catalog, type_registry, indexdir, "archive",
                         defaults::import::table_slice_size, duration{}, 100, 3,
-                        1, indexdir, vast::index_config{});
+                        1, 1, 0, 0, duration{}, indexdir,
+                        vast::index_config{});
     client = sys.spawn(mock_client);
     // Fill the INDEX with 400 rows from the Zeek conn log.
     detail::spawn_container_source(sys, take(zeek_conn_log_full, 4), index);
@@ -156,7 +157,7 @@ TEST(count IP point query with partition - local stores) {
     = self->spawn(system::index, system::accountant_actor{}, fs, archive,
                   catalog, type_registry, indexdir, "segment-store",
                   defaults::import::table_slice_size, duration{}, 100, 3, 1,
-                  indexdir, vast::index_config{});
+                  1, 0, 0, duration{}, indexdir, vast::index_config{});
   // Fill the INDEX with 400 rows from the Zeek conn log.
   detail::spawn_container_source(sys, take(zeek_conn_log_full, 4), index);
   MESSAGE("spawn the COUNTER for query ':addr == 192.168.1.104'");
@@ -186,7 +187,7 @@ TEST(count meta extractor import time 1) {
     = self->spawn(system::index, system::accountant_actor{}, fs, archive,
                   catalog, type_registry, indexdir, "segment-store",
                   defaults::import::table_slice_size, duration{}, 100, 3, 1,
-                  indexdir, vast::index_config{});
+                  1, 0, 0, duration{}, indexdir, vast::index_config{});
   // Fill the INDEX with 400 rows from the Zeek conn log.
   auto slices = take(zeek_conn_log_full, 4);
   for (auto& slice : slices) {
@@ -223,7 +224,7 @@ TEST(count meta extractor import time 2) {
     = self->spawn(system::index, system::accountant_actor{}, fs, archive,
                   catalog, type_registry, indexdir, "segment-store",
                   defaults::import::table_slice_size, duration{}, 100, 3, 1,
-                  indexdir, vast::index_config{});
+                  1, 0, 0, duration{}, indexdir, vast::index_config{});
   // Fill the INDEX with 400 rows from the Zeek conn log.
   auto slices = take(zeek_conn_log_full, 4);
   for (auto& slice : slices) {
@@ -15,9 +15,11 @@
 #include "vast/concept/parseable/to.hpp"
 #include "vast/concept/parseable/vast/expression.hpp"
 #include "vast/expression.hpp"
+#include "vast/query_trace.hpp"
 #include "vast/test/fixtures/actor_system_and_events.hpp"
 #include "vast/test/test.hpp"
 
+#include <algorithm>
 #include <vector>
 
 using namespace vast;
@@ -57,11 +59,19 @@ ids select(const counts& xs, curried_predicate pred) {
 }
 
 // Dummy actor representing an INDEXER for field `x`.
-vast::system::indexer_actor::behavior_type dummy_indexer(counts xs) {
+vast::system::indexer_actor::behavior_type
+dummy_indexer(counts xs, size_t* lookups, size_t* restricted_lookups) {
   return {
-    [xs = std::move(xs)](curried_predicate pred) {
+    [xs, lookups](curried_predicate pred) {
+      ++*lookups;
       return select(xs, pred);
     },
+    [xs, lookups, restricted_lookups](curried_predicate pred,
+                                      const ids& selection) {
+      ++*lookups;
+      ++*restricted_lookups;
+      return select(xs, pred) & selection;
+    },
     [](atom::shutdown) {
       FAIL("received shutdown request as dummy indexer");
     },
@@ -84,8 +94,25 @@ struct fixture : fixtures::deterministic_actor_system_and_events {
   /// Maps predicates to a list of actors.
   std::map<std::string, std::vector<system::indexer_actor>> indexers;
 
+  /// Counts the lookups of all INDEXER actors.
+  size_t lookups = 0;
+
+  /// Counts the lookups of all INDEXER actors that were restricted to the
+  /// hits of previous lookups.
+  size_t restricted_lookups = 0;
+
+  /// Receives the spans of the predicate lookups, if set.
+  system::receiver_actor<query_span> tracer = {};
+
+  /// Stores the spans that `tracer` received.
+  std::vector<query_span> spans;
+
+  /// The partition that the spans belong to.
+  uuid partition = uuid::random();
+
   void add_indexer(std::vector<system::indexer_actor>& container, counts data) {
-    container.emplace_back(sys.spawn(dummy_indexer, std::move(data)));
+    container.emplace_back(sys.spawn(dummy_indexer, std::move(data), &lookups,
+                                     &restricted_lookups));
   }
 
   type layout = type{
@@ -96,7 +123,7 @@ struct fixture : fixtures::deterministic_actor_system_and_events {
     },
   };
 
-  ids query(std::string_view expr_str) {
+  system::evaluator_actor spawn_evaluator(std::string_view expr_str) {
     auto expr = unbox(to<expression>(expr_str));
     std::vector<system::evaluation_triple> triples;
     auto resolved = resolve(expr, layout);
@@ -109,8 +136,14 @@ struct fixture : fixtures::deterministic_actor_system_and_events {
       for (auto& x : xs)
         triples.emplace_back(expr_position, curried(pred), x);
     }
-    auto eval = sys.spawn(system::evaluator, expr, std::move(triples));
+    auto eval = sys.spawn(system::evaluator, expr, std::move(triples),
+                          tracer, partition);
     run();
+    return eval;
+  }
+
+  ids query(std::string_view expr_str) {
+    auto eval = spawn_evaluator(expr_str);
     self->send(eval, atom::run_v);
     run();
     ids result;
@@ -177,4 +210,108 @@ TEST(disjunctions) {
   CHECK_QUERY("x == 75 || y == 77", ({3, 5}));
 }
 
+TEST(predicate ordering) {
+  MESSAGE("selective predicates go first");
+  auto eq = curried_predicate{relational_operator::equal, vast::count{42}};
+  auto ne = curried_predicate{relational_operator::not_equal, vast::count{42}};
+  CHECK_LESS(system::estimate_selectivity(eq),
+             system::estimate_selectivity(ne));
+  MESSAGE("substring searches are more expensive than equality");
+  auto str = curried_predicate{relational_operator::equal, "foo"};
+  auto sub = curried_predicate{relational_operator::ni, "foo"};
+  CHECK_LESS(system::estimate_cost(eq), system::estimate_cost(str));
+  CHECK_LESS(system::estimate_cost(str), system::estimate_cost(sub));
+}
+
+TEST(short circuiting) {
+  MESSAGE("an empty conjunction operand skips the remaining predicates");
+  CHECK_QUERY("x == 98 && y != 10", ({}));
+  CHECK_EQUAL(lookups, 2u);
+  lookups = 0;
+  CHECK_QUERY("y != 10 && (x == 98 || x == 99)", ({}));
+  CHECK_EQUAL(lookups, 4u);
+  lookups = 0;
+  MESSAGE("negations of skipped conjunctions remain correct");
+  CHECK_QUERY("! (x == 98 && y != 10) && x == 13", ({1}));
+  CHECK_EQUAL(lookups, 4u);
+  lookups = 0;
+  MESSAGE("disjunctions evaluate all operands");
+  CHECK_QUERY("x == 98 || y != 10", ({1, 3, 4, 8}));
+  CHECK_EQUAL(lookups, 4u);
+}
+
+TEST(restricted lookups) {
+  MESSAGE("later stages only look at the hits of earlier stages");
+  CHECK_QUERY("x == 42 && y != 10", ({1, 3, 4}));
+  CHECK_EQUAL(lookups, 4u);
+  CHECK_EQUAL(restricted_lookups, 2u);
+  lookups = 0;
+  restricted_lookups = 0;
+  MESSAGE("negations of restricted conjunctions remain correct");
+  CHECK_QUERY("! (x == 42 && y != 10)", ({0, 2, {5, 9}}));
+  CHECK_EQUAL(restricted_lookups, 2u);
+  restricted_lookups = 0;
+  MESSAGE("disjunctions do not restrict their operands");
+  CHECK_QUERY("x == 42 || y != 10", ({0, 1, 2, 3, 4, 8}));
+  CHECK_EQUAL(restricted_lookups, 0u);
+}
+
+TEST(single stage for disjunctions) {
+  MESSAGE("predicates without an enclosing conjunction go out at once");
+  auto eval = spawn_evaluator("x == 42 || y != 10");
+  self->send(eval, atom::run_v);
+  // Let only the EVALUATOR handle the request, which schedules one job per
+  // INDEXER that it sends a lookup to.
+  sched.run_once();
+  CHECK_EQUAL(sched.jobs.size(), 4u);
+  run();
+  auto result = ids{};
+  self->receive([&](const ids& hits) {
+    result = hits;
+  });
+  CHECK_EQUAL(pad_result(result), pad_result(make_ids({0, 1, 2, 3, 4, 8})));
+  CHECK_EQUAL(lookups, 4u);
+  MESSAGE("conjunctions still evaluate their operands in stages");
+  lookups = 0;
+  eval = spawn_evaluator("x == 42 && y != 10");
+  self->send(eval, atom::run_v);
+  sched.run_once();
+  CHECK_EQUAL(sched.jobs.size(), 2u);
+  run();
+  self->receive([&](const ids& hits) {
+    result = hits;
+  });
+  CHECK_EQUAL(pad_result(result), pad_result(make_ids({1, 3, 4})));
+  CHECK_EQUAL(lookups, 4u);
+}
+
+TEST(tracing) {
+  using tracer_actor = system::receiver_actor<query_span>;
+  tracer = sys.spawn([this]() -> tracer_actor::behavior_type {
+    return {
+      [this](query_span span) {
+        spans.push_back(std::move(span));
+      },
+    };
+  });
+  CHECK_QUERY("x == 42 && y != 10", ({1, 3, 4}));
+  MESSAGE("every lookup produces a span");
+  REQUIRE_EQUAL(spans.size(), lookups);
+  for (const auto& span : spans) {
+    CHECK_EQUAL(span.name, "predicate");
+    CHECK_EQUAL(span.partition, partition);
+  }
+  MESSAGE("spans of restricted lookups contain the number of candidates");
+  auto restricted
+    = std::count_if(spans.begin(), spans.end(), [](const auto& x) {
+        return x.values.contains("candidates");
+      });
+  CHECK_EQUAL(static_cast<size_t>(restricted), restricted_lookups);
+  auto y_lookups
+    = std::count_if(spans.begin(), spans.end(), [](const auto& x) {
+        return x.values.at("predicate") == data{"y != 10"};
+      });
+  CHECK_EQUAL(y_lookups, 2);
+}
+
 FIXTURE_SCOPE_END()
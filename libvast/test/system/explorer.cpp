@@ -8,6 +8,7 @@
 
 #define SUITE explorer
 
+#include "vast/system/explorer.hpp"
 #include "vast/system/spawn_explorer.hpp"
 #include "vast/test/test.hpp"
 #include "vast/time.hpp"
@@ -67,3 +68,30 @@ TEST(explorer config) {
     CHECK_EQUAL(vast::system::explorer_validate_args(settings), caf::none);
   }
 }
+
+TEST(time window coalescing) {
+  using window = vast::system::time_window_set::window;
+  using windows = std::vector<window>;
+  auto at = [](auto offset) {
+    return vast::time{} + offset;
+  };
+  auto xs = vast::system::time_window_set{};
+  MESSAGE("a new interval is uncovered");
+  CHECK_EQUAL(xs.add(at(10s), at(20s)), (windows{{at(10s), at(20s)}}));
+  CHECK_EQUAL(xs.add(at(30s), at(40s)), (windows{{at(30s), at(40s)}}));
+  CHECK_EQUAL(xs.size(), 2u);
+  MESSAGE("covered intervals yield nothing");
+  CHECK_EQUAL(xs.add(at(12s), at(18s)), windows{});
+  CHECK_EQUAL(xs.add(at(30s), at(30s)), windows{});
+  MESSAGE("overlapping intervals yield the gaps and merge");
+  CHECK_EQUAL(xs.add(at(15s), at(35s)), (windows{{at(20s), at(30s)}}));
+  CHECK_EQUAL(xs.size(), 1u);
+  CHECK_EQUAL(xs.add(at(5s), at(50s)),
+              (windows{{at(5s), at(10s)}, {at(40s), at(50s)}}));
+  CHECK_EQUAL(xs.size(), 1u);
+  MESSAGE("points are intervals too");
+  CHECK_EQUAL(xs.add(at(60s), at(60s)), (windows{{at(60s), at(60s)}}));
+  CHECK_EQUAL(xs.size(), 2u);
+  CHECK_EQUAL(xs.add(at(50s), at(60s)), (windows{{at(50s), at(60s)}}));
+  CHECK_EQUAL(xs.size(), 1u);
+}
@@ -12,6 +12,7 @@
 
 #include "vast/concept/parseable/to.hpp"
 #include "vast/concept/parseable/vast/expression.hpp"
+#include "vast/data.hpp"
 #include "vast/detail/spawn_container_source.hpp"
 #include "vast/query_options.hpp"
 #include "vast/system/archive.hpp"
@@ -24,6 +25,8 @@
 #include "vast/test/fixtures/table_slices.hpp"
 #include "vast/test/test.hpp"
 
+#include <optional>
+
 using namespace vast;
 
 using std::string;
@@ -67,7 +70,8 @@ struct fixture : fixture_base {
     index = self->spawn(system::index, system::accountant_actor{}, fs, archive,
                         catalog, type_registry, indexdir,
                         defaults::system::store_backend, 10000, duration{}, 5,
-                        5, 1, indexdir, vast::index_config{});
+                        5, 1, 1, 0, 0, duration{}, indexdir,
+                        vast::index_config{});
   }
 
   void spawn_importer() {
@@ -180,6 +184,37 @@ TEST(historical query with importer) {
   verify(fetch_results());
 }
 
+TEST(traced historical query) {
+  MESSAGE("spawn index and archive");
+  spawn_archive();
+  spawn_catalog();
+  spawn_index();
+  run();
+  MESSAGE("ingest conn.log into archive and index");
+  vast::detail::spawn_container_source(sys, zeek_conn_log, index, archive);
+  run();
+  MESSAGE("spawn exporter for traced historical query");
+  spawn_exporter(historical + trace);
+  send(exporter, atom::trace_v, self);
+  send(exporter, index);
+  send(exporter, atom::sink_v, self);
+  send(exporter, atom::run_v);
+  send(exporter, atom::extract_v);
+  run();
+  verify(fetch_results());
+  MESSAGE("the exporter reports the trace to its trace subscriber");
+  self->send_exit(exporter, caf::exit_reason::user_shutdown);
+  run();
+  auto summary = std::optional<record>{};
+  self->receive(
+    [&](atom::trace, record& x) {
+      summary = std::move(x);
+    },
+    error_handler(), caf::after(0ms) >> [] {});
+  REQUIRE(summary);
+  CHECK(summary->find("exporter") != summary->end());
+}
+
 TEST(continuous query with exporter only) {
   MESSAGE("prepare exporter for continuous query");
   spawn_exporter(continuous);
@@ -205,6 +240,20 @@ TEST(continuous query with importer) {
   verify(fetch_results());
 }
 
+TEST(continuous query with importer subscription) {
+  MESSAGE("prepare importer");
+  importer_setup();
+  MESSAGE("prepare exporter for continous query");
+  exporter_setup(continuous);
+  send(importer, atom::subscribe_v, expr,
+       static_cast<system::continuous_query_subscriber_actor>(exporter));
+  run();
+  MESSAGE("ingest conn.log via importer");
+  vast::detail::spawn_container_source(sys, zeek_conn_log, importer);
+  run();
+  verify(fetch_results());
+}
+
 TEST(continuous query with mismatching importer) {
   MESSAGE("prepare importer");
   importer_setup();
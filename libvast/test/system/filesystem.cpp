@@ -11,6 +11,7 @@
 #include "vast/chunk.hpp"
 #include "vast/io/read.hpp"
 #include "vast/io/write.hpp"
+#include "vast/system/concurrent_filesystem.hpp"
 #include "vast/system/posix_filesystem.hpp"
 #include "vast/system/status.hpp"
 #include "vast/test/fixtures/actor_system.hpp"
@@ -135,4 +136,111 @@ TEST(status) {
       });
 }
 
+TEST(concurrent filesystem) {
+  auto concurrent
+    = self->spawn<caf::detached>(concurrent_filesystem, directory, 2, 1);
+  auto files = std::vector<std::string>{"a", "b", "c", "d"};
+  MESSAGE("write files via actor");
+  for (const auto& file : files) {
+    auto copy = file;
+    self
+      ->request(concurrent, caf::infinite, atom::write_v,
+                std::filesystem::path{file}, chunk::make(std::move(copy)))
+      .receive(
+        [&](atom::ok) {
+          // all good
+        },
+        [&](const caf::error& err) { FAIL(err); });
+  }
+  MESSAGE("read and mmap files via actor");
+  for (const auto& file : files) {
+    auto bytes = std::span<const char>{file.data(), file.size()};
+    self
+      ->request(concurrent, caf::infinite, atom::read_v,
+                std::filesystem::path{file})
+      .receive(
+        [&](const chunk_ptr& chk) {
+          CHECK_EQUAL(as_bytes(chk), as_bytes(bytes));
+        },
+        [&](const caf::error& err) { FAIL(err); });
+    self
+      ->request(concurrent, caf::infinite, atom::mmap_v,
+                std::filesystem::path{file})
+      .receive(
+        [&](const chunk_ptr& chk) {
+          CHECK_EQUAL(as_bytes(chk), as_bytes(bytes));
+        },
+        [&](const caf::error& err) { FAIL(err); });
+  }
+  MESSAGE("check status");
+  self
+    ->request(concurrent, caf::infinite, atom::status_v,
+              status_verbosity::debug)
+    .receive(
+      [&](record& status) {
+        auto read_lane = caf::get<record>(status["read-lane"]);
+        CHECK_EQUAL(caf::get<count>(read_lane["workers"]), 2u);
+        CHECK_EQUAL(caf::get<count>(read_lane["busy"]), 0u);
+        auto write_lane = caf::get<record>(status["write-lane"]);
+        CHECK_EQUAL(caf::get<count>(write_lane["workers"]), 1u);
+        auto ops = caf::get<record>(status["operations"]);
+        auto writes = caf::get<record>(ops["writes"]);
+        CHECK_EQUAL(caf::get<count>(writes["successful"]), files.size());
+        CHECK_EQUAL(caf::get<count>(writes["bytes"]), files.size());
+        auto latency = caf::get<record>(writes["latency"]);
+        CHECK_GREATER(caf::get<duration>(latency["p99"]), duration::zero());
+        auto mmaps = caf::get<record>(ops["mmaps"]);
+        CHECK_EQUAL(caf::get<count>(mmaps["successful"]), files.size());
+      },
+      [&](const caf::error& err) {
+        FAIL(err);
+      });
+  self->send_exit(concurrent, caf::exit_reason::user_shutdown);
+}
+
+TEST(concurrent filesystem writes to the same path) {
+  auto concurrent
+    = self->spawn<caf::detached>(concurrent_filesystem, directory, 1, 4);
+  auto filename = std::filesystem::path{"index.bin"};
+  MESSAGE("issue back-to-back writes to the same path");
+  constexpr auto num_writes = 8;
+  auto last = std::string{};
+  for (auto i = 0; i < num_writes; ++i) {
+    // Earlier writes are larger, so that they take longer.
+    last = std::string(4096 * static_cast<size_t>(num_writes - i),
+                       static_cast<char>('a' + i));
+    self->send(concurrent, atom::write_v, filename, chunk::copy(last));
+  }
+  auto i = 0;
+  self->receive_for(i, num_writes)(
+    [&](atom::ok) {
+      // all good
+    },
+    [&](const caf::error& err) {
+      FAIL(err);
+    });
+  MESSAGE("the last write wins");
+  self->request(concurrent, caf::infinite, atom::read_v, filename)
+    .receive(
+      [&](const chunk_ptr& chk) {
+        CHECK_EQUAL(as_bytes(chk), as_bytes(last));
+      },
+      [&](const caf::error& err) {
+        FAIL(err);
+      });
+  self->send_exit(concurrent, caf::exit_reason::user_shutdown);
+}
+
+TEST(latency histogram) {
+  auto histogram = filesystem_statistics::latency_histogram{};
+  CHECK_EQUAL(histogram.quantile(0.5), duration::zero());
+  for (int i = 0; i < 90; ++i)
+    histogram.add(std::chrono::microseconds{3});
+  for (int i = 0; i < 10; ++i)
+    histogram.add(std::chrono::milliseconds{1});
+  CHECK_EQUAL(histogram.quantile(0.5), duration{std::chrono::microseconds{4}});
+  CHECK_EQUAL(histogram.quantile(0.99),
+              duration{std::chrono::microseconds{1024}});
+}
+
 FIXTURE_SCOPE_END()
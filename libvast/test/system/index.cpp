@@ -21,6 +21,7 @@
 #include "vast/ids.hpp"
 #include "vast/query_options.hpp"
 #include "vast/system/archive.hpp"
+#include "vast/system/importer.hpp"
 #include "vast/system/posix_filesystem.hpp"
 #include "vast/table_slice.hpp"
 #include "vast/table_slice_builder.hpp"
@@ -41,6 +42,7 @@ struct fixture : fixtures::deterministic_actor_system_and_events {
   static constexpr uint32_t in_mem_partitions = 8;
   static constexpr uint32_t taste_count = 4;
   static constexpr size_t num_query_supervisors = 1;
+  static constexpr size_t num_ingest_workers = 2;
   static constexpr size_t segments = 1;
   static constexpr size_t max_segment_size = 8192;
 
@@ -57,7 +59,8 @@ struct fixture : fixtures::deterministic_actor_system_and_events {
                         catalog, type_registry, index_dir,
                         defaults::system::store_backend, slice_size,
                         vast::duration{}, in_mem_partitions, taste_count,
-                        num_query_supervisors, index_dir, vast::index_config{});
+                        num_query_supervisors, num_ingest_workers, 0, 0,
+                        vast::duration{}, index_dir, vast::index_config{});
   }
 
   ~fixture() override {
@@ -172,6 +175,56 @@ TEST(one - shot integer query result) {
   CHECK_EQUAL(result, expected_result);
 }
 
+TEST(ingest workers) {
+  MESSAGE("retrieve the ingest workers");
+  auto rp = self->request(index, caf::infinite, atom::get_v, atom::worker_v);
+  run();
+  rp.receive(
+    [&](std::vector<system::ingest_worker_actor>& workers) {
+      CHECK_EQUAL(workers.size(), num_ingest_workers);
+    },
+    [&](const caf::error& err) {
+      FAIL(err);
+    });
+  MESSAGE("stream slices through the index to the owning worker");
+  auto slices = rebase(first_n(alternating_integers, taste_count));
+  auto src = detail::spawn_container_source(sys, slices, archive, index);
+  run();
+  auto [query_id, hits, scheduled] = query(":int == +1");
+  CHECK_EQUAL(hits, taste_count);
+  auto result = receive_result(query_id, hits, scheduled);
+  CHECK_EQUAL(result, rows(slices) / 2);
+}
+
+TEST(ingest workers behind the importer) {
+  MESSAGE("spawn an importer that streams into the ingest workers");
+  auto importer
+    = self->spawn(system::importer, directory / "importer", archive, index,
+                  type_registry, std::vector<vast::transform>{});
+  run();
+  MESSAGE("import slices of two layouts");
+  auto integers = first_n(alternating_integers, taste_count);
+  auto src1 = detail::spawn_container_source(sys, integers, importer);
+  run();
+  auto src2 = detail::spawn_container_source(sys, zeek_conn_log, importer);
+  run();
+  MESSAGE("query the events of both layouts");
+  {
+    auto [query_id, hits, scheduled] = query(":int == +1");
+    CHECK_EQUAL(hits, taste_count);
+    auto result = receive_result(query_id, hits, scheduled);
+    CHECK_EQUAL(result, rows(integers) / 2);
+  }
+  {
+    auto [query_id, hits, scheduled] = query("#type == \"zeek.conn\"");
+    auto result = receive_result(query_id, hits, scheduled);
+    CHECK_EQUAL(result, rows(zeek_conn_log));
+  }
+  MESSAGE("shut down the importer before the index");
+  anon_send_exit(importer, caf::exit_reason::user_shutdown);
+  run();
+}
+
 TEST(iterable integer query result) {
   auto partitions = taste_count * 3;
   MESSAGE("fill first " << partitions << " partitions");
@@ -0,0 +1,62 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#define SUITE ingest_worker
+
+#include "vast/system/ingest_worker.hpp"
+
+#include "vast/fwd.hpp"
+
+#include "vast/test/test.hpp"
+#include "vast/type.hpp"
+
+using namespace vast;
+
+namespace {
+
+struct fixture {
+  fixture() {
+    state.partition_capacity = 1'000'000;
+    state.min_partition_size = 1'000;
+  }
+
+  system::ingest_worker_state state;
+  type busy = type{"busy", record_type{{"x", count_type{}}}};
+  type quiet = type{"quiet", record_type{{"x", count_type{}}}};
+};
+
+} // namespace
+
+FIXTURE_SCOPE(ingest_worker_tests, fixture)
+
+TEST(adaptive capacity without memory budget) {
+  state.profiles[busy] = {.event_rate = 3'000, .bytes_per_event = 1'000};
+  CHECK_EQUAL(state.adaptive_capacity(busy), 1'000'000u);
+}
+
+TEST(adaptive capacity without measurements) {
+  state.memory_budget = 1'000'000'000;
+  CHECK_EQUAL(state.adaptive_capacity(busy), 1'000'000u);
+}
+
+TEST(adaptive capacity splits the memory budget by event rate) {
+  state.memory_budget = 1'000'000'000;
+  state.profiles[busy] = {.event_rate = 3'000, .bytes_per_event = 1'000};
+  state.profiles[quiet] = {.event_rate = 1'000, .bytes_per_event = 1'000};
+  CHECK_EQUAL(state.adaptive_capacity(busy), 750'000u);
+  CHECK_EQUAL(state.adaptive_capacity(quiet), 250'000u);
+  MESSAGE("the capacity never drops below the minimum partition size");
+  state.memory_budget = 1'000'000;
+  CHECK_EQUAL(state.adaptive_capacity(busy), 1'000u);
+  CHECK_EQUAL(state.adaptive_capacity(quiet), 1'000u);
+  MESSAGE("the capacity never exceeds the maximum partition size");
+  state.memory_budget = 1'000'000'000'000;
+  CHECK_EQUAL(state.adaptive_capacity(busy), 1'000'000u);
+}
+
+FIXTURE_SCOPE_END()
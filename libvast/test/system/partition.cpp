@@ -35,6 +35,11 @@ system::filesystem_actor::behavior_type mock_filesystem(
       VAST_ASSERT(chk != nullptr);
       return atom::ok_v;
     },
+    [](atom::write, const std::filesystem::path&, uint64_t,
+       const chunk_ptr& chk) -> caf::result<atom::ok> {
+      VAST_ASSERT(chk != nullptr);
+      return atom::ok_v;
+    },
     [](atom::read, const std::filesystem::path&) -> caf::result<chunk_ptr> {
       return nullptr;
     },
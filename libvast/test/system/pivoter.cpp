@@ -10,11 +10,15 @@
 
 #include "vast/system/pivoter.hpp"
 
-#include "vast/command.hpp"
 #include "vast/concept/parseable/to.hpp"
 #include "vast/concept/parseable/vast/expression.hpp"
+#include "vast/concept/printable/to_string.hpp"
+#include "vast/concept/printable/vast/expression.hpp"
 #include "vast/defaults.hpp"
 #include "vast/format/zeek.hpp"
+#include "vast/query.hpp"
+#include "vast/system/query_cursor.hpp"
+#include "vast/system/query_status.hpp"
 #include "vast/table_slice.hpp"
 #include "vast/test/fixtures/actor_system.hpp"
 #include "vast/test/test.hpp"
@@ -24,6 +28,8 @@
 #include <caf/stateful_actor.hpp>
 
 using namespace vast;
+using namespace std::chrono_literals;
+using namespace std::string_literals;
 
 namespace {
 
@@ -67,23 +73,30 @@ std::vector<table_slice> inhale(const char* data) {
   return slices;
 }
 
-struct mock_node_state {
-  std::vector<invocation> invocs;
-  static inline constexpr const char* name = "mock-node";
+struct mock_index_state {
+  std::vector<query> queries;
+  static inline constexpr const char* name = "mock-index";
 };
 
-caf::behavior mock_node(caf::stateful_actor<mock_node_state>* self) {
+caf::behavior mock_index(caf::stateful_actor<mock_index_state>* self) {
   return {
-    [=](atom::spawn, invocation invocation) {
-      self->state.invocs.push_back(std::move(invocation));
+    [=](atom::evaluate, query& query) {
+      self->state.queries.push_back(std::move(query));
+      // Pretend that no partitions qualify. Like the INDEX, we deliver the
+      // cursor before signaling completion.
+      auto client = caf::actor_cast<caf::actor>(self->current_sender());
+      auto rp = self->make_response_promise<system::query_cursor>();
+      rp.deliver(system::query_cursor{uuid::random(), 0u, 0u});
+      self->send(client, atom::done_v);
+      return rp;
     },
   };
 }
 
 struct fixture : fixtures::deterministic_actor_system {
   fixture() : fixtures::deterministic_actor_system(VAST_PP_STRINGIFY(SUITE)) {
-    MESSAGE("spawn mock node");
-    node = sys.spawn(mock_node);
+    MESSAGE("spawn mock index");
+    index = sys.spawn(mock_index);
     run();
   }
 
@@ -91,16 +104,25 @@ struct fixture : fixtures::deterministic_actor_system {
     self->send_exit(aut, caf::exit_reason::user_shutdown);
   }
 
-  void spawn_aut(expression expr, std::string target_type) {
-    aut = sys.spawn(system::pivoter, caf::actor_cast<system::node_actor>(node),
-                    std::move(target_type), std::move(expr));
+  void spawn_aut(expression expr, std::string target_type,
+                 size_t max_values_per_query
+                 = defaults::pivot::max_values_per_query) {
+    aut = sys.spawn(system::pivoter,
+                    caf::actor_cast<system::index_actor>(index),
+                    std::move(target_type), std::move(expr),
+                    max_values_per_query);
+    self->send(aut, atom::sink_v, caf::actor_cast<caf::actor>(self));
     run();
   }
 
+  std::vector<query>& queries() {
+    return deref<caf::stateful_actor<mock_index_state>>(index).state.queries;
+  }
+
   const std::vector<table_slice> slices
     = inhale<format::zeek::reader>(zeek_conn_m57_head);
 
-  caf::actor node;
+  caf::actor index;
   caf::actor aut;
 };
 
@@ -117,10 +139,9 @@ TEST(count IP point query without candidate check) {
   self->send(aut, slices[0]);
   // The pivoter maps the slice to an expression and passes it on.
   run();
-  auto& node_state = deref<caf::stateful_actor<mock_node_state>>(node).state;
-  REQUIRE_EQUAL(node_state.invocs.size(), 1u);
+  REQUIRE_EQUAL(queries().size(), 1u);
   CHECK_EQUAL(
-    node_state.invocs[0].arguments[0],
+    to_string(queries()[0].expr),
     "(#type == \"pcap.packet\" && community_id in "
     "[\"1:aWZfLIquYlCxKGuJ62fQGlgFzAI=\", "
     "\"1:fLbpXGtS1VgDhqUW+WYaP0v+NuA=\", \"1:BY/pbReW8Oa+xSY2fNZPZUB1Nnk=\", "
@@ -129,6 +150,38 @@ TEST(count IP point query without candidate check) {
     "\"1:oG55uQUH+XuHYHOFV0c+yOutW8E=\", \"1:FVMx3YawO69eZmiaMJJbrs6447E=\", "
     "\"1:79fDvfGNCWV1JBYjXCE5Ov1FuMM=\", \"1:aGi0Bt5ApW6HEEO7wfz+PwvniIU=\", "
     "\"1:JoBDvaK4Tt6BfWSKWPKaJTELr2M=\"])");
+  MESSAGE("values that were queried before are skipped");
+  self->send(aut, slices[0]);
+  run();
+  CHECK_EQUAL(queries().size(), 1u);
+}
+
+TEST(batched edge values) {
+  auto expr = unbox(to<expression>("proto == udp"));
+  spawn_aut(expr, "pcap.packet", 5);
+  self->send(aut, slices[0]);
+  run();
+  MESSAGE("the pivoter splits the 12 distinct values into 3 queries");
+  REQUIRE_EQUAL(queries().size(), 3u);
+  auto num_values = size_t{0};
+  for (const auto& query : queries()) {
+    const auto& conj = caf::get<conjunction>(query.expr);
+    const auto& pred = caf::get<predicate>(conj[1]);
+    num_values += caf::get<list>(caf::get<data>(pred.rhs)).size();
+  }
+  CHECK_EQUAL(num_values, 12u);
+  MESSAGE("the pivoter terminates after the initial query completed");
+  self->monitor(aut);
+  self->send(aut, "exporter"s, system::query_status{});
+  run();
+  self->receive(
+    [&](const caf::down_msg& msg) {
+      CHECK_EQUAL(msg.source, aut.address());
+    },
+    caf::after(0s) >>
+      [&] {
+        FAIL("PIVOTER did not terminate");
+      });
 }
 
 FIXTURE_SCOPE_END()
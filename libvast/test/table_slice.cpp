@@ -239,6 +239,19 @@ TEST(filter - expression overload) {
   check_eval("id.orig_h != 192.168.1.102", 5);
 }
 
+TEST(filter - large membership lists) {
+  auto sut = zeek_conn_log[0];
+  auto check_eval = [&](std::string_view expr, size_t x) {
+    auto exp = unbox(tailor(unbox(to<expression>(expr)), sut.layout()));
+    CHECK_EQUAL(filter(sut, exp)->rows(), x);
+    CHECK_EQUAL(count_matching(sut, exp, {}), x);
+  };
+  auto xs = "[10.0.0.1, 10.0.0.2, 10.0.0.3, 10.0.0.4, 10.0.0.5, 10.0.0.6, "
+            "10.0.0.7, 192.168.1.102]"s;
+  check_eval("id.orig_h in " + xs, 3);
+  check_eval("id.orig_h !in " + xs, 5);
+}
+
 TEST(filter - hints only) {
   auto sut = zeek_conn_log[0];
   // sut.offset(0);
@@ -276,6 +289,24 @@ TEST(evaluate) {
   check_eval("#field != \"orig_pkts\"", {});
 }
 
+TEST(evaluate with hints) {
+  auto sut = zeek_conn_log[0];
+  sut.offset(100);
+  auto check_eval = [&](std::string_view expr,
+                        std::initializer_list<id_range> hints_init,
+                        std::initializer_list<id_range> id_init) {
+    auto hints = make_ids(hints_init);
+    auto ids = make_ids(id_init, sut.offset() + sut.rows());
+    auto exp = unbox(to<expression>(expr));
+    CHECK_EQUAL(evaluate(exp, sut, hints), ids);
+  };
+  check_eval("#type == \"zeek.conn\"", {{102, 105}}, {{102, 105}});
+  check_eval("#type == \"zeek.conn\"", {{90, 103}, {106, 120}},
+             {{100, 103}, {106, 108}});
+  check_eval("#type != \"zeek.conn\"", {{100, 108}}, {});
+  check_eval("#type == \"zeek.conn\"", {}, {});
+}
+
 TEST(project column flat index) {
   auto sut = truncate(zeek_conn_log[0], 3);
   auto proj = project(sut, time_type{}, 0, string_type{}, 6);
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "vast/chunk.hpp"
 #include "vast/detail/assert.hpp"
 #include "vast/error.hpp"
 #include "vast/system/actors.hpp"
@@ -15,6 +16,9 @@
 #include <caf/typed_event_based_actor.hpp>
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <vector>
+
 // An in-memory implementation of the filesystem actor, to rule out
 // test flakiness due to a slow disk and to be able to write to any
 // path without permission issues.
@@ -28,6 +32,19 @@ inline vast::system::filesystem_actor::behavior_type memory_filesystem() {
       (*chunks)[path] = std::move(chunk);
       return vast::atom::ok_v;
     },
+    [chunks](vast::atom::write, const std::filesystem::path& path,
+             uint64_t offset, vast::chunk_ptr& chunk) {
+      VAST_ASSERT(chunk, "attempted to write a null chunk");
+      auto& file = (*chunks)[path];
+      auto bytes = std::vector<std::byte>{};
+      if (file)
+        bytes.assign(file->begin(), file->end());
+      if (bytes.size() < offset + chunk->size())
+        bytes.resize(offset + chunk->size());
+      std::copy(chunk->begin(), chunk->end(), bytes.begin() + offset);
+      file = vast::chunk::make(std::move(bytes));
+      return vast::atom::ok_v;
+    },
     [chunks](vast::atom::read, const std::filesystem::path& path)
       -> caf::result<vast::chunk_ptr> {
       auto chunk = chunks->find(path);
@@ -0,0 +1,86 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <vast/fwd.hpp>
+
+#include <vast/type.hpp>
+
+#include <arrow/io/interfaces.h>
+#include <arrow/ipc/writer.h>
+#include <caf/error.hpp>
+#include <caf/expected.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace vast::plugins::arrow_endpoint {
+
+/// A query that a client submits to the endpoint.
+struct request {
+  /// The maximum number of events to return, or 0 for all events.
+  uint64_t max_events = 0;
+
+  /// The query expression.
+  std::string query = {};
+};
+
+/// Reads a request from a connected socket. A request consists of two lines
+/// that each end with a newline character: the maximum number of events, and
+/// the query expression.
+/// @param fd The socket to read from.
+/// @param stop Cancels the request when set while waiting for input. The
+/// socket must have a receive timeout for this to take effect.
+/// @param timeout The time the client has to send the complete request. The
+/// socket must have a receive timeout for this to take effect.
+/// @returns The request, or an error if the client sent a malformed request,
+/// closed the connection, or did not finish the request in time.
+caf::expected<request>
+read_request(int fd, const std::atomic<bool>& stop,
+             std::chrono::steady_clock::duration timeout);
+
+/// Writes the status line that precedes every response: `ok` if the endpoint
+/// accepted the request and the results follow, or `error: <reason>` if the
+/// endpoint rejected the request and closes the connection.
+/// @param fd The socket to write to.
+/// @param status The reason for rejecting the request, or `caf::none`.
+/// @param stop Cancels the write when set while the client does not read. The
+/// socket must have a send timeout for this to take effect.
+caf::error write_status(int fd, const caf::error& status,
+                        const std::atomic<bool>& stop);
+
+/// Writes table slices to a connected socket as a sequence of Arrow IPC
+/// streams, starting a new stream whenever the layout changes. Arrow-encoded
+/// table slices are written as is, without converting them.
+class batch_writer {
+public:
+  /// Constructs a writer for a socket.
+  /// @param fd The socket to write to. The writer does not take ownership.
+  /// @param stop Cancels pending writes when set while the client does not
+  /// read. The socket must have a send timeout for this to take effect.
+  batch_writer(int fd, const std::atomic<bool>& stop);
+
+  ~batch_writer() noexcept;
+
+  /// Writes a table slice as record batch.
+  caf::error write(const table_slice& slice);
+
+  /// Ends the current stream.
+  caf::error close();
+
+private:
+  std::shared_ptr<::arrow::io::OutputStream> out_;
+  std::shared_ptr<::arrow::ipc::RecordBatchWriter> writer_ = {};
+  type layout_ = {};
+};
+
+} // namespace vast::plugins::arrow_endpoint
@@ -0,0 +1,211 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "arrow_endpoint/connection.hpp"
+
+#include <vast/error.hpp>
+#include <vast/table_slice.hpp>
+
+#include <arrow/ipc/writer.h>
+#include <arrow/record_batch.h>
+#include <arrow/status.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <sys/socket.h>
+
+namespace vast::plugins::arrow_endpoint {
+
+namespace {
+
+/// The maximum size of a request in bytes.
+constexpr size_t max_request_size = 64 * 1024;
+
+/// Writes a buffer to a connected socket in full.
+/// @param stop Cancels the write when set while the client does not read. The
+/// socket must have a send timeout for this to take effect.
+/// @returns 0 on success, or the value of `errno` on failure.
+int send_all(int fd, const char* data, size_t size,
+             const std::atomic<bool>& stop) {
+  while (size > 0) {
+    // Use MSG_NOSIGNAL so that a client that goes away results in an error
+    // instead of terminating the process with SIGPIPE.
+    auto n = ::send(fd, data, size, MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        if (stop)
+          return ECANCELED;
+        continue;
+      }
+      return errno;
+    }
+    data += n;
+    size -= n;
+  }
+  return 0;
+}
+
+/// An Arrow output stream that writes to a connected socket.
+class socket_output_stream final : public ::arrow::io::OutputStream {
+public:
+  socket_output_stream(int fd, const std::atomic<bool>& stop)
+    : fd_{fd}, stop_{stop} {
+    // nop
+  }
+
+  ::arrow::Status Close() override {
+    closed_ = true;
+    return ::arrow::Status::OK();
+  }
+
+  [[nodiscard]] bool closed() const override {
+    return closed_;
+  }
+
+  [[nodiscard]] ::arrow::Result<int64_t> Tell() const override {
+    return position_;
+  }
+
+  ::arrow::Status Write(const void* data, int64_t nbytes) override {
+    if (auto err
+        = send_all(fd_, static_cast<const char*>(data), nbytes, stop_))
+      return ::arrow::Status::IOError("failed to write to socket: ",
+                                      std::strerror(err));
+    position_ += nbytes;
+    return ::arrow::Status::OK();
+  }
+
+  using ::arrow::io::OutputStream::Write;
+
+private:
+  int fd_;
+  const std::atomic<bool>& stop_;
+  int64_t position_ = 0;
+  bool closed_ = false;
+};
+
+} // namespace
+
+caf::expected<request>
+read_request(int fd, const std::atomic<bool>& stop,
+             std::chrono::steady_clock::duration timeout) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  auto buffer = std::string{};
+  auto newlines = size_t{0};
+  char chunk[4096];
+  while (newlines < 2) {
+    if (stop)
+      return caf::make_error(ec::end_of_input, "endpoint is shutting down");
+    if (std::chrono::steady_clock::now() >= deadline)
+      return caf::make_error(ec::timeout,
+                             "client did not complete the request in time");
+    auto n = ::recv(fd, chunk, sizeof(chunk), 0);
+    if (n == 0)
+      return caf::make_error(ec::end_of_input, "client closed the connection");
+    if (n < 0) {
+      if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)
+        continue;
+      return caf::make_error(ec::system_error,
+                             fmt::format("failed to read request: {}",
+                                         std::strerror(errno)));
+    }
+    for (auto i = 0; i < n; ++i)
+      if (chunk[i] == '\n')
+        ++newlines;
+    buffer.append(chunk, n);
+    if (buffer.size() > max_request_size)
+      return caf::make_error(ec::parse_error,
+                             fmt::format("request exceeds {} bytes",
+                                         max_request_size));
+  }
+  auto first = buffer.find('\n');
+  auto second = buffer.find('\n', first + 1);
+  if (second + 1 != buffer.size())
+    return caf::make_error(ec::parse_error, "trailing data after request");
+  auto result = request{};
+  auto [ptr, err] = std::from_chars(buffer.data(), buffer.data() + first,
+                                    result.max_events);
+  if (err != std::errc{} || ptr != buffer.data() + first)
+    return caf::make_error(ec::parse_error,
+                           fmt::format("invalid maximum number of events: {}",
+                                       buffer.substr(0, first)));
+  result.query = buffer.substr(first + 1, second - first - 1);
+  if (result.query.empty())
+    return caf::make_error(ec::parse_error, "empty query");
+  return result;
+}
+
+caf::error write_status(int fd, const caf::error& status,
+                        const std::atomic<bool>& stop) {
+  auto line = std::string{"ok\n"};
+  if (status) {
+    // The status must fit on a single line.
+    auto reason = render(status);
+    std::replace(reason.begin(), reason.end(), '\n', ' ');
+    line = fmt::format("error: {}\n", reason);
+  }
+  if (auto err = send_all(fd, line.data(), line.size(), stop))
+    return caf::make_error(ec::system_error,
+                           fmt::format("failed to write status: {}",
+                                       std::strerror(err)));
+  return caf::none;
+}
+
+batch_writer::batch_writer(int fd, const std::atomic<bool>& stop)
+  : out_{std::make_shared<socket_output_stream>(fd, stop)} {
+  // nop
+}
+
+batch_writer::~batch_writer() noexcept {
+  if (writer_)
+    static_cast<void>(writer_->Close());
+}
+
+caf::error batch_writer::write(const table_slice& slice) {
+  auto batch = to_record_batch(slice);
+  if (!batch)
+    return caf::make_error(ec::format_error,
+                           "failed to convert table slice to record batch");
+  if (slice.layout() != layout_) {
+    if (auto err = close())
+      return err;
+    auto writer = ::arrow::ipc::MakeStreamWriter(out_.get(), batch->schema());
+    if (!writer.ok())
+      return caf::make_error(ec::format_error,
+                             fmt::format("failed to create Arrow stream "
+                                         "writer: {}",
+                                         writer.status().ToString()));
+    writer_ = std::move(*writer);
+    layout_ = slice.layout();
+  }
+  if (auto status = writer_->WriteRecordBatch(*batch); !status.ok())
+    return caf::make_error(ec::system_error,
+                           fmt::format("failed to write record batch: {}",
+                                       status.ToString()));
+  return caf::none;
+}
+
+caf::error batch_writer::close() {
+  if (!writer_)
+    return caf::none;
+  auto status = writer_->Close();
+  writer_ = nullptr;
+  layout_ = {};
+  if (!status.ok())
+    return caf::make_error(ec::system_error,
+                           fmt::format("failed to end Arrow stream: {}",
+                                       status.ToString()));
+  return caf::none;
+}
+
+} // namespace vast::plugins::arrow_endpoint
@@ -0,0 +1,327 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "arrow_endpoint/connection.hpp"
+
+#include <vast/atoms.hpp>
+#include <vast/command.hpp>
+#include <vast/data.hpp>
+#include <vast/detail/posix.hpp>
+#include <vast/error.hpp>
+#include <vast/logger.hpp>
+#include <vast/plugin.hpp>
+#include <vast/system/actors.hpp>
+#include <vast/system/node.hpp>
+#include <vast/system/node_control.hpp>
+#include <vast/system/status.hpp>
+#include <vast/table_slice.hpp>
+
+#include <caf/error.hpp>
+#include <caf/scoped_actor.hpp>
+#include <caf/settings.hpp>
+#include <caf/typed_event_based_actor.hpp>
+#include <fmt/format.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+namespace vast::plugins::arrow_endpoint {
+
+namespace {
+
+using namespace std::chrono_literals;
+
+/// The state that the listener and connection threads share with the actor.
+struct shared_state {
+  shared_state(uint64_t max_connections,
+               std::chrono::steady_clock::duration request_timeout)
+    : max_connections{max_connections}, request_timeout{request_timeout} {
+    // nop
+  }
+
+  /// The maximum number of connections that are served concurrently.
+  const uint64_t max_connections;
+
+  /// The time a client has to send its request.
+  const std::chrono::steady_clock::duration request_timeout;
+
+  /// Signals all threads to stop.
+  std::atomic<bool> stopping = false;
+
+  /// The total number of accepted connections.
+  std::atomic<uint64_t> connections = 0;
+
+  /// The total number of events sent to clients.
+  std::atomic<uint64_t> events = 0;
+
+  /// The number of running connection threads, guarded by `mtx`.
+  uint64_t active = 0;
+
+  std::mutex mtx;
+  std::condition_variable cv;
+};
+
+/// Answers a single client request.
+void serve(int fd, system::node_actor node,
+           const std::shared_ptr<shared_state>& shared) {
+  // Time out blocking reads and writes regularly to notice when the endpoint
+  // stops, even if the client stops reading or writing.
+  auto tv = ::timeval{.tv_sec = 1, .tv_usec = 0};
+  ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+  auto req = read_request(fd, shared->stopping, shared->request_timeout);
+  if (!req) {
+    VAST_WARN("arrow-endpoint rejects request: {}", req.error());
+    static_cast<void>(write_status(fd, req.error(), shared->stopping));
+    return;
+  }
+  VAST_VERBOSE("arrow-endpoint executes query: {}", req->query);
+  auto self = caf::scoped_actor{node->home_system()};
+  auto options = caf::settings{};
+  caf::put(options, "vast.export.max-events", req->max_events);
+  auto exporter = system::spawn_at_node(
+    self, node, invocation{std::move(options), "spawn exporter", {req->query}});
+  if (!exporter) {
+    VAST_WARN("arrow-endpoint failed to spawn exporter for query {}: {}",
+              req->query, exporter.error());
+    static_cast<void>(write_status(fd, exporter.error(), shared->stopping));
+    return;
+  }
+  if (auto err = write_status(fd, caf::none, shared->stopping)) {
+    VAST_DEBUG("arrow-endpoint aborts query: {}", err);
+    self->send_exit(*exporter, caf::exit_reason::user_shutdown);
+    return;
+  }
+  self->monitor(*exporter);
+  self->send(*exporter, atom::sink_v, caf::actor_cast<caf::actor>(self));
+  self->send(*exporter, atom::run_v);
+  auto writer = batch_writer{fd, shared->stopping};
+  auto running = true;
+  auto events = uint64_t{0};
+  self->receive_while(running)(
+    [&](table_slice& slice) {
+      if (shared->stopping) {
+        self->send_exit(*exporter, caf::exit_reason::user_shutdown);
+        running = false;
+        return;
+      }
+      if (auto err = writer.write(slice)) {
+        VAST_DEBUG("arrow-endpoint aborts query: {}", err);
+        self->send_exit(*exporter, caf::exit_reason::user_shutdown);
+        running = false;
+        return;
+      }
+      events += slice.rows();
+      shared->events += slice.rows();
+    },
+    [&](const caf::down_msg& msg) {
+      if (msg.source == *exporter)
+        running = false;
+    },
+    caf::after(1s) >>
+      [&] {
+        if (shared->stopping) {
+          self->send_exit(*exporter, caf::exit_reason::user_shutdown);
+          running = false;
+        }
+      });
+  if (auto err = writer.close())
+    VAST_DEBUG("arrow-endpoint failed to finish query: {}", err);
+  VAST_VERBOSE("arrow-endpoint sent {} events for query: {}", events,
+               req->query);
+}
+
+/// Accepts connections and starts a thread for each of them. Waits for a
+/// running connection to finish before accepting a new one when the maximum
+/// number of connections is reached, so further clients queue up in the
+/// backlog of the listening socket.
+void listen(int listen_fd, system::node_actor node,
+            std::shared_ptr<shared_state> shared) {
+  while (!shared->stopping) {
+    {
+      auto lock = std::unique_lock{shared->mtx};
+      shared->cv.wait(lock, [&] {
+        return shared->stopping || shared->active < shared->max_connections;
+      });
+    }
+    if (shared->stopping)
+      break;
+    auto fd = detail::uds_accept(listen_fd);
+    if (fd < 0) {
+      if (shared->stopping)
+        break;
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+      VAST_ERROR("arrow-endpoint failed to accept connection: {}",
+                 std::strerror(errno));
+      break;
+    }
+    ++shared->connections;
+    {
+      auto lock = std::unique_lock{shared->mtx};
+      ++shared->active;
+    }
+    std::thread{[fd, node, shared] {
+      serve(fd, node, shared);
+      ::close(fd);
+      auto lock = std::unique_lock{shared->mtx};
+      --shared->active;
+      shared->cv.notify_all();
+    }}.detach();
+  }
+}
+
+/// The state of the ARROW ENDPOINT actor.
+struct endpoint_state {
+  endpoint_state() = default;
+  endpoint_state(const endpoint_state&) = delete;
+  endpoint_state& operator=(const endpoint_state&) = delete;
+
+  ~endpoint_state() noexcept {
+    if (!shared)
+      return;
+    {
+      // Wake up the listener thread if it waits for a free connection slot.
+      auto lock = std::unique_lock{shared->mtx};
+      shared->stopping = true;
+      shared->cv.notify_all();
+    }
+    // Shutting down the socket wakes up the listener thread.
+    ::shutdown(listen_fd, SHUT_RDWR);
+    if (listener.joinable())
+      listener.join();
+    ::close(listen_fd);
+    auto lock = std::unique_lock{shared->mtx};
+    shared->cv.wait(lock, [this] {
+      return shared->active == 0;
+    });
+    std::error_code err{};
+    std::filesystem::remove(path, err);
+  }
+
+  /// The path of the listening socket.
+  std::filesystem::path path = {};
+
+  /// The listening socket.
+  int listen_fd = -1;
+
+  /// The thread that accepts connections.
+  std::thread listener = {};
+
+  /// The state shared with all threads.
+  std::shared_ptr<shared_state> shared = {};
+
+  /// Name of this actor in log events.
+  static inline const char* name = "arrow-endpoint";
+};
+
+system::component_plugin_actor::behavior_type endpoint(
+  system::component_plugin_actor::stateful_pointer<endpoint_state> self,
+  int listen_fd, std::filesystem::path path, system::node_actor node,
+  uint64_t max_connections, duration request_timeout) {
+  self->state.path = std::move(path);
+  self->state.listen_fd = listen_fd;
+  self->state.shared = std::make_shared<shared_state>(
+    max_connections,
+    std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      request_timeout));
+  self->state.listener
+    = std::thread{listen, listen_fd, std::move(node), self->state.shared};
+  VAST_INFO("{} accepts queries at {}", *self, self->state.path);
+  return {
+    [self](atom::status, system::status_verbosity) -> record {
+      auto& shared = *self->state.shared;
+      auto result = record{};
+      result["socket"] = self->state.path.string();
+      result["connections"] = count{shared.connections};
+      result["events"] = count{shared.events};
+      result["max-connections"] = count{shared.max_connections};
+      auto lock = std::unique_lock{shared.mtx};
+      result["active"] = count{shared.active};
+      return result;
+    },
+  };
+}
+
+} // namespace
+
+/// A component that answers queries with Arrow IPC streams.
+class plugin final : public virtual component_plugin {
+public:
+  caf::error initialize(data config) override {
+    auto* r = caf::get_if<record>(&config);
+    if (!r)
+      return caf::none;
+    if (auto* socket = caf::get_if<std::string>(&(*r)["socket"]))
+      socket_ = *socket;
+    if (auto it = r->find("max-connections"); it != r->end()) {
+      auto* max_connections = caf::get_if<count>(&it->second);
+      if (!max_connections || *max_connections == 0)
+        return caf::make_error(ec::invalid_configuration,
+                               fmt::format("{} expected a positive number for "
+                                           "max-connections, but got {}",
+                                           name(), it->second));
+      max_connections_ = *max_connections;
+    }
+    if (auto it = r->find("request-timeout"); it != r->end()) {
+      auto* request_timeout = caf::get_if<duration>(&it->second);
+      if (!request_timeout || *request_timeout <= duration::zero())
+        return caf::make_error(ec::invalid_configuration,
+                               fmt::format("{} expected a positive duration "
+                                           "for request-timeout, but got {}",
+                                           name(), it->second));
+      request_timeout_ = *request_timeout;
+    }
+    return caf::none;
+  }
+
+  [[nodiscard]] const char* name() const override {
+    return "arrow-endpoint";
+  }
+
+  system::component_plugin_actor make_component(
+    system::node_actor::stateful_pointer<system::node_state> node)
+    const override {
+    auto path = std::filesystem::path{socket_};
+    if (path.is_relative())
+      path = node->state.dir / path;
+    if (path.string().size() >= sizeof(::sockaddr_un::sun_path)) {
+      VAST_ERROR("{} cannot listen on {}: path exceeds {} characters", name(),
+                 path, sizeof(::sockaddr_un::sun_path) - 1);
+      return {};
+    }
+    auto listen_fd = detail::uds_listen(path.string());
+    if (listen_fd < 0) {
+      VAST_ERROR("{} failed to listen on {}: {}", name(), path,
+                 std::strerror(errno));
+      return {};
+    }
+    return node->spawn(endpoint, listen_fd, std::move(path),
+                       caf::actor_cast<system::node_actor>(node),
+                       max_connections_, request_timeout_);
+  }
+
+private:
+  std::string socket_ = "arrow.sock";
+  uint64_t max_connections_ = 16;
+  duration request_timeout_ = std::chrono::seconds{10};
+};
+
+} // namespace vast::plugins::arrow_endpoint
+
+VAST_REGISTER_PLUGIN(vast::plugins::arrow_endpoint::plugin)
@@ -0,0 +1,182 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#define SUITE arrow_endpoint
+
+#include "arrow_endpoint/connection.hpp"
+
+#include <vast/data.hpp>
+#include <vast/defaults.hpp>
+#include <vast/table_slice.hpp>
+#include <vast/table_slice_builder_factory.hpp>
+#include <vast/test/test.hpp>
+
+#include <arrow/buffer.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/record_batch.h>
+#include <caf/test/dsl.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string_view>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace vast;
+using namespace vast::plugins::arrow_endpoint;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct fixture {
+  fixture() {
+    REQUIRE_EQUAL(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  }
+
+  ~fixture() {
+    ::close(fds[0]);
+    ::close(fds[1]);
+  }
+
+  /// Sends bytes from the client side.
+  void send(std::string_view str) {
+    REQUIRE_EQUAL(::write(fds[0], str.data(), str.size()),
+                  static_cast<ssize_t>(str.size()));
+  }
+
+  /// Receives all bytes on the client side until the server side is shut down.
+  std::string receive_all() {
+    auto result = std::string{};
+    char chunk[4096];
+    while (true) {
+      auto n = ::read(fds[0], chunk, sizeof(chunk));
+      REQUIRE(n >= 0);
+      if (n == 0)
+        break;
+      result.append(chunk, n);
+    }
+    return result;
+  }
+
+  int fds[2] = {-1, -1};
+  std::atomic<bool> stop = false;
+  std::chrono::steady_clock::duration timeout = 10s;
+};
+
+table_slice make_slice(std::string_view name, int64_t first, int64_t last) {
+  factory<table_slice_builder>::initialize();
+  auto layout = type{
+    name,
+    record_type{
+      {"x", integer_type{}},
+    },
+  };
+  auto builder = factory<table_slice_builder>::make(
+    defaults::import::table_slice_type, layout);
+  REQUIRE(builder);
+  for (auto i = first; i < last; ++i)
+    REQUIRE(builder->add(integer{i}));
+  return builder->finish();
+}
+
+} // namespace
+
+FIXTURE_SCOPE(arrow_endpoint_tests, fixture)
+
+TEST(read request) {
+  send("42\n");
+  send("x > 1\n");
+  auto req = unbox(read_request(fds[1], stop, timeout));
+  CHECK_EQUAL(req.max_events, 42u);
+  CHECK_EQUAL(req.query, "x > 1");
+}
+
+TEST(read request - malformed) {
+  send("forty-two\nx > 1\n");
+  CHECK(!read_request(fds[1], stop, timeout));
+}
+
+TEST(read request - closed connection) {
+  send("0\n");
+  ::shutdown(fds[0], SHUT_WR);
+  CHECK(!read_request(fds[1], stop, timeout));
+}
+
+TEST(read request - timeout) {
+  auto tv = ::timeval{.tv_sec = 0, .tv_usec = 10'000};
+  REQUIRE_EQUAL(::setsockopt(fds[1], SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)),
+                0);
+  send("0\n");
+  auto req = read_request(fds[1], stop, 50ms);
+  REQUIRE(!req);
+  CHECK_EQUAL(req.error(), ec::timeout);
+}
+
+TEST(write status) {
+  CHECK_EQUAL(write_status(fds[1], caf::none, stop), caf::none);
+  auto err = caf::make_error(ec::parse_error, "invalid query");
+  CHECK_EQUAL(write_status(fds[1], err, stop), caf::none);
+  ::shutdown(fds[1], SHUT_WR);
+  auto status = receive_all();
+  CHECK(status.starts_with("ok\nerror: "));
+  CHECK(status.find("invalid query") != std::string::npos);
+  CHECK_EQUAL(std::count(status.begin(), status.end(), '\n'), 2);
+  CHECK(status.ends_with("\n"));
+}
+
+TEST(batch writer) {
+  auto slices = std::vector<table_slice>{
+    make_slice("foo", 0, 10),
+    make_slice("foo", 10, 20),
+    make_slice("bar", 20, 25),
+    make_slice("foo", 25, 30),
+  };
+  // Write from a separate thread to avoid filling up the socket buffer.
+  auto writer_thread = std::thread{[&] {
+    auto writer = batch_writer{fds[1], stop};
+    for (const auto& slice : slices)
+      CHECK_EQUAL(writer.write(slice), caf::none);
+    CHECK_EQUAL(writer.close(), caf::none);
+    ::shutdown(fds[1], SHUT_WR);
+  }};
+  auto bytes = receive_all();
+  writer_thread.join();
+  MESSAGE("a new stream starts whenever the layout changes");
+  auto buffer = std::make_shared<::arrow::Buffer>(bytes);
+  auto input = std::make_shared<::arrow::io::BufferReader>(buffer);
+  auto streams = std::vector<std::vector<int64_t>>{};
+  while (input->Tell().ValueOrDie() < buffer->size()) {
+    auto reader = ::arrow::ipc::RecordBatchStreamReader::Open(input);
+    REQUIRE(reader.ok());
+    auto& rows = streams.emplace_back();
+    std::shared_ptr<::arrow::RecordBatch> batch;
+    while ((*reader)->ReadNext(&batch).ok() && batch)
+      rows.push_back(batch->num_rows());
+  }
+  CHECK_EQUAL(streams,
+              (std::vector<std::vector<int64_t>>{{10, 10}, {5}, {5}}));
+}
+
+TEST(batch writer - stalled client) {
+  auto tv = ::timeval{.tv_sec = 0, .tv_usec = 10'000};
+  REQUIRE_EQUAL(::setsockopt(fds[1], SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv)),
+                0);
+  stop = true;
+  auto slice = make_slice("foo", 0, 1000);
+  auto writer = batch_writer{fds[1], stop};
+  MESSAGE("writing gives up once the socket buffer is full");
+  auto err = caf::error{};
+  for (auto i = 0; i < 10'000 && !err; ++i)
+    err = writer.write(slice);
+  CHECK_NOT_EQUAL(err, caf::none);
+}
+
+FIXTURE_SCOPE_END()
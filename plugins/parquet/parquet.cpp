@@ -0,0 +1,432 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2022 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <vast/arrow_table_slice.hpp>
+#include <vast/data.hpp>
+#include <vast/defaults.hpp>
+#include <vast/detail/narrow.hpp>
+#include <vast/error.hpp>
+#include <vast/format/arrow.hpp>
+#include <vast/format/reader.hpp>
+#include <vast/format/writer.hpp>
+#include <vast/logger.hpp>
+#include <vast/module.hpp>
+#include <vast/plugin.hpp>
+#include <vast/table_slice.hpp>
+#include <vast/type.hpp>
+
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <arrow/io/memory.h>
+#include <arrow/io/stdio.h>
+#include <arrow/util/compression.h>
+#include <caf/settings.hpp>
+#include <parquet/arrow/reader.h>
+#include <parquet/arrow/writer.h>
+#include <parquet/properties.h>
+
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <unordered_map>
+
+namespace vast::defaults::export_ {
+
+/// Contains settings for the parquet subcommand.
+struct parquet {
+  /// The compression codec for column chunks.
+  static constexpr std::string_view compression = "zstd";
+
+  /// Number of events to buffer per layout before writing a row group.
+  static constexpr size_t row_group_size = 65'536;
+};
+
+} // namespace vast::defaults::export_
+
+namespace vast::plugins::parquet {
+
+/// Writes table slices as Parquet files, one per layout.
+class writer final : public format::writer {
+public:
+  using defaults = vast::defaults::export_::parquet;
+
+  /// Constructs a Parquet writer.
+  /// @param options The configuration options for the writer.
+  explicit writer(const caf::settings& options) {
+    output_ = std::string{
+      get_or(options, "vast.export.write", vast::defaults::export_::write)};
+    row_group_size_ = get_or(options, "vast.export.parquet.row-group-size",
+                             defaults::row_group_size);
+    auto compression
+      = std::string{get_or(options, "vast.export.parquet.compression",
+                           defaults::compression)};
+    auto codec = ::arrow::util::Codec::GetCompressionType(compression);
+    if (!codec.ok()) {
+      init_error_ = caf::make_error(
+        ec::invalid_configuration,
+        fmt::format("{} got unsupported compression {}: {}", name(),
+                    compression, codec.status().ToString()));
+      return;
+    }
+    auto builder = ::parquet::WriterProperties::Builder{};
+    // Parquet 2.6 is the first format version with nanosecond timestamps.
+    builder.version(::parquet::ParquetVersion::PARQUET_2_6);
+    builder.compression(*codec);
+    if (auto level = caf::get_if<int64_t>(
+          &options, "vast.export.parquet.compression-level"))
+      builder.compression_level(detail::narrow_cast<int>(*level));
+    if (get_or(options, "vast.export.parquet.disable-dictionary", false))
+      builder.disable_dictionary();
+    else
+      builder.enable_dictionary();
+    properties_ = builder.build();
+    // Embedding the Arrow schema preserves VAST's type metadata and extension
+    // types across a roundtrip.
+    arrow_properties_
+      = ::parquet::ArrowWriterProperties::Builder{}.store_schema()->build();
+  }
+
+  ~writer() override {
+    if (auto err = close())
+      VAST_ERROR("{} failed to finish writing: {}", name(), err);
+  }
+
+  using format::writer::write;
+
+  caf::error write(const table_slice& slice) override {
+    if (init_error_)
+      return init_error_;
+    auto& state = states_[slice.layout()];
+    if (state.writer == nullptr)
+      if (auto err = open(slice.layout(), state))
+        return err;
+    // For Arrow-encoded table slices this is zero-copy.
+    auto batch = to_record_batch(slice);
+    if (!batch)
+      return caf::make_error(ec::format_error,
+                             fmt::format("{} failed to convert table slice "
+                                         "to record batch",
+                                         name()));
+    state.batches.push_back(std::move(batch));
+    state.rows += slice.rows();
+    if (state.rows >= row_group_size_)
+      return write_row_group(state);
+    return caf::none;
+  }
+
+  [[nodiscard]] const char* name() const override {
+    return "parquet-writer";
+  }
+
+private:
+  /// The per-layout output state.
+  struct layout_state {
+    std::shared_ptr<::arrow::io::OutputStream> sink;
+    std::unique_ptr<::parquet::arrow::FileWriter> writer;
+    std::vector<std::shared_ptr<::arrow::RecordBatch>> batches;
+    size_t rows = 0;
+  };
+
+  caf::error open(const type& layout, layout_state& state) {
+    if (output_ == "-") {
+      // The state for this layout already exists at this point.
+      if (states_.size() > 1)
+        return caf::make_error(
+          ec::format_error,
+          fmt::format("{} cannot write more than one layout to STDOUT; use "
+                      "--write=<directory> to write one file per layout",
+                      name()));
+      state.sink = std::make_shared<::arrow::io::StdoutStream>();
+    } else {
+      auto dir = std::filesystem::path{output_};
+      auto err = std::error_code{};
+      std::filesystem::create_directories(dir, err);
+      if (err)
+        return caf::make_error(ec::filesystem_error,
+                               fmt::format("{} failed to create directory {}: "
+                                           "{}",
+                                           name(), dir.string(),
+                                           err.message()));
+      // Different layouts may share a name, e.g., after a schema change.
+      auto filename = std::string{layout.name()};
+      if (auto n = file_names_[filename]++; n > 0)
+        filename = fmt::format("{}.{}", filename, n);
+      auto path = dir / fmt::format("{}.parquet", filename);
+      auto file = ::arrow::io::FileOutputStream::Open(path.string());
+      if (!file.ok())
+        return caf::make_error(ec::filesystem_error,
+                               fmt::format("{} failed to open {}: {}", name(),
+                                           path.string(),
+                                           file.status().ToString()));
+      state.sink = std::move(*file);
+    }
+    auto schema = layout.to_arrow_schema();
+    if (auto status = ::parquet::arrow::FileWriter::Open(
+          *schema, ::arrow::default_memory_pool(), state.sink, properties_,
+          arrow_properties_, &state.writer);
+        !status.ok())
+      return caf::make_error(ec::format_error,
+                             fmt::format("{} failed to create Parquet writer "
+                                         "for layout {}: {}",
+                                         name(), layout.name(),
+                                         status.ToString()));
+    return caf::none;
+  }
+
+  caf::error write_row_group(layout_state& state) {
+    VAST_ASSERT(!state.batches.empty());
+    auto table = ::arrow::Table::FromRecordBatches(
+      state.batches.front()->schema(), state.batches);
+    if (!table.ok())
+      return caf::make_error(ec::format_error,
+                             fmt::format("{} failed to combine record "
+                                         "batches: {}",
+                                         name(), table.status().ToString()));
+    if (auto status = state.writer->WriteTable(
+          **table, detail::narrow_cast<int64_t>(row_group_size_));
+        !status.ok())
+      return caf::make_error(ec::format_error,
+                             fmt::format("{} failed to write row group: {}",
+                                         name(), status.ToString()));
+    state.batches.clear();
+    state.rows = 0;
+    return caf::none;
+  }
+
+  caf::error close() {
+    auto result = caf::error{};
+    for (auto& [layout, state] : states_) {
+      if (state.writer == nullptr)
+        continue;
+      if (state.rows > 0)
+        if (auto err = write_row_group(state); err && !result)
+          result = std::move(err);
+      if (auto status = state.writer->Close(); !status.ok() && !result)
+        result = caf::make_error(ec::format_error, status.ToString());
+      if (auto status = state.sink->Close(); !status.ok() && !result)
+        result = caf::make_error(ec::filesystem_error, status.ToString());
+      state.writer = nullptr;
+    }
+    return result;
+  }
+
+  caf::error init_error_ = {};
+  std::string output_ = {};
+  size_t row_group_size_ = defaults::row_group_size;
+  std::shared_ptr<::parquet::WriterProperties> properties_ = {};
+  std::shared_ptr<::parquet::ArrowWriterProperties> arrow_properties_ = {};
+  std::unordered_map<type, layout_state> states_ = {};
+  std::unordered_map<std::string, size_t> file_names_ = {};
+};
+
+/// Reads Parquet files written by the Parquet writer.
+class reader final : public format::reader {
+public:
+  /// Constructs a Parquet reader.
+  /// @param options The configuration options for the reader.
+  explicit reader(const caf::settings& options) : format::reader(options) {
+    input_path_
+      = std::string{get_or(options, "vast.import.read", defaults::import::read)};
+  }
+
+  ~reader() override = default;
+
+  void reset(std::unique_ptr<std::istream> in) override {
+    VAST_ASSERT(in != nullptr);
+    input_ = std::move(in);
+    batch_reader_ = nullptr;
+    current_batch_ = nullptr;
+    current_offset_ = 0;
+  }
+
+  caf::error module(vast::module x) override {
+    // The layouts are part of the Parquet files, so there's nothing to
+    // replace here.
+    module_ = std::move(x);
+    return caf::none;
+  }
+
+  [[nodiscard]] vast::module module() const override {
+    return module_;
+  }
+
+  [[nodiscard]] const char* name() const override {
+    return "parquet-reader";
+  }
+
+protected:
+  caf::error
+  read_impl(size_t max_events, size_t max_slice_size, consumer& f) override {
+    if (batch_reader_ == nullptr)
+      if (auto err = open(max_slice_size))
+        return err;
+    size_t produced = 0;
+    while (produced < max_events) {
+      if (current_batch_ == nullptr
+          || current_offset_ == current_batch_->num_rows()) {
+        current_offset_ = 0;
+        if (auto status = batch_reader_->ReadNext(&current_batch_);
+            !status.ok())
+          return caf::make_error(ec::format_error,
+                                 fmt::format("{} failed to read record "
+                                             "batch: {}",
+                                             name(), status.ToString()));
+        if (current_batch_ == nullptr)
+          return caf::make_error(ec::end_of_input, "input exhausted");
+      }
+      auto consumed = format::arrow::slice_record_batch(
+        current_batch_, current_offset_, max_events - produced,
+        max_slice_size, f);
+      current_offset_ += detail::narrow_cast<int64_t>(consumed);
+      produced += consumed;
+    }
+    return caf::none;
+  }
+
+private:
+  caf::error open(size_t max_slice_size) {
+    auto file = std::shared_ptr<::arrow::io::RandomAccessFile>{};
+    if (input_ != nullptr || input_path_ == "-") {
+      // Parquet requires random access, so we must buffer streamed input.
+      auto& in = input_ != nullptr ? *input_ : std::cin;
+      auto buffer = std::string{std::istreambuf_iterator<char>{in},
+                                std::istreambuf_iterator<char>{}};
+      file = std::make_shared<::arrow::io::BufferReader>(
+        ::arrow::Buffer::FromString(std::move(buffer)));
+    } else {
+      auto readable_file = ::arrow::io::ReadableFile::Open(input_path_);
+      if (!readable_file.ok())
+        return caf::make_error(ec::filesystem_error,
+                               fmt::format("{} failed to open {}: {}", name(),
+                                           input_path_,
+                                           readable_file.status().ToString()));
+      file = std::move(*readable_file);
+    }
+    if (auto status = ::parquet::arrow::OpenFile(
+          file, ::arrow::default_memory_pool(), &file_reader_);
+        !status.ok())
+      return caf::make_error(ec::format_error,
+                             fmt::format("{} failed to open Parquet file: {}",
+                                         name(), status.ToString()));
+    file_reader_->set_batch_size(detail::narrow_cast<int64_t>(max_slice_size));
+    auto row_groups = std::vector<int>(file_reader_->num_row_groups());
+    std::iota(row_groups.begin(), row_groups.end(), 0);
+    if (auto status
+        = file_reader_->GetRecordBatchReader(row_groups, &batch_reader_);
+        !status.ok())
+      return caf::make_error(ec::format_error,
+                             fmt::format("{} failed to read Parquet file: {}",
+                                         name(), status.ToString()));
+    auto layout = format::arrow::layout_from_schema(*batch_reader_->schema());
+    if (!layout) {
+      batch_reader_ = nullptr;
+      return layout.error();
+    }
+    if (!module_.find(layout->name()))
+      module_.add(std::move(*layout));
+    return caf::none;
+  }
+
+  std::string input_path_ = {};
+  std::unique_ptr<std::istream> input_ = {};
+  std::unique_ptr<::parquet::arrow::FileReader> file_reader_ = {};
+  std::unique_ptr<::arrow::RecordBatchReader> batch_reader_ = {};
+  std::shared_ptr<::arrow::RecordBatch> current_batch_ = {};
+  int64_t current_offset_ = 0;
+  vast::module module_ = {};
+};
+
+class plugin final : public virtual reader_plugin,
+                     public virtual writer_plugin {
+public:
+  caf::error initialize(data) override {
+    return caf::none;
+  }
+
+  [[nodiscard]] const char* name() const override {
+    return "parquet";
+  }
+
+  [[nodiscard]] const char* reader_format() const override {
+    return "parquet";
+  }
+
+  [[nodiscard]] const char* reader_help() const override {
+    return "imports Parquet files from STDIN or file";
+  }
+
+  [[nodiscard]] const char* reader_documentation() const override {
+    return R"__(The `import parquet` command reads [Apache Parquet](https://parquet.apache.org)
+files written by `vast export parquet`. The record batches in the file become
+table slices directly, without converting the data row by row.
+
+Parquet readers need random access to the file, so the command buffers the
+entire input in memory when reading from STDIN.
+
+```bash
+vast import --read=zeek.conn.parquet parquet
+```
+)__";
+  }
+
+  [[nodiscard]] caf::config_option_set
+  reader_options(command::opts_builder&& opts) const override {
+    return std::move(opts).finish();
+  }
+
+  [[nodiscard]] std::unique_ptr<format::reader>
+  make_reader(const caf::settings& options) const override {
+    return std::make_unique<reader>(options);
+  }
+
+  [[nodiscard]] const char* writer_format() const override {
+    return "parquet";
+  }
+
+  [[nodiscard]] const char* writer_help() const override {
+    return "exports query results as Parquet files";
+  }
+
+  [[nodiscard]] const char* writer_documentation() const override {
+    return R"__(The `export parquet` command writes query results as [Apache
+Parquet](https://parquet.apache.org) files. The record batches of Arrow-encoded
+table slices go to the Parquet writer as is.
+
+A Parquet file has exactly one schema. When writing to STDOUT, the result must
+therefore consist of a single layout. With `--write=<directory>`, the command
+writes one file per layout named after the layout, e.g., `zeek.conn.parquet`.
+
+Columns are dictionary-encoded and compressed with Zstandard by default.
+
+```bash
+vast export --write=/tmp/zeek parquet '#type ~ /zeek.*/'
+```
+)__";
+  }
+
+  [[nodiscard]] caf::config_option_set
+  writer_options(command::opts_builder&& opts) const override {
+    return std::move(opts)
+      .add<std::string>("compression", "compression codec for column chunks "
+                                       "(default: zstd)")
+      .add<int64_t>("compression-level", "codec-specific compression level")
+      .add<size_t>("row-group-size", "number of events per row group")
+      .add<bool>("disable-dictionary", "disable dictionary encoding")
+      .finish();
+  }
+
+  [[nodiscard]] std::unique_ptr<format::writer>
+  make_writer(const caf::settings& options) const override {
+    return std::make_unique<writer>(options);
+  }
+};
+
+} // namespace vast::plugins::parquet
+
+VAST_REGISTER_PLUGIN(vast::plugins::parquet::plugin)
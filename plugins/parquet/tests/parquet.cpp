@@ -0,0 +1,117 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2022 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#define SUITE parquet
+
+#include <vast/format/reader.hpp>
+#include <vast/format/reader_factory.hpp>
+#include <vast/format/writer.hpp>
+#include <vast/format/writer_factory.hpp>
+#include <vast/table_slice.hpp>
+#include <vast/test/fixtures/events.hpp>
+#include <vast/test/fixtures/filesystem.hpp>
+#include <vast/test/test.hpp>
+
+#include <caf/settings.hpp>
+
+#include <filesystem>
+
+namespace vast::plugins::parquet {
+
+namespace {
+
+struct fixture : fixtures::events, fixtures::filesystem {
+  fixture() : fixtures::filesystem(VAST_PP_STRINGIFY(SUITE)) {
+    factory<format::reader>::initialize();
+    factory<format::writer>::initialize();
+  }
+
+  std::vector<table_slice> read(const std::filesystem::path& file) {
+    caf::settings settings;
+    caf::put(settings, "vast.import.read", file.string());
+    auto reader = format::reader::make("parquet", settings);
+    REQUIRE(reader);
+    std::vector<table_slice> result;
+    auto add_slice = [&](table_slice slice) {
+      result.emplace_back(std::move(slice));
+    };
+    auto [err, produced] = (*reader)->read(std::numeric_limits<size_t>::max(),
+                                           slice_size, add_slice);
+    CHECK_EQUAL(err, ec::end_of_input);
+    return result;
+  }
+};
+
+} // namespace
+
+FIXTURE_SCOPE(parquet_tests, fixture)
+
+TEST(parquet roundtrip) {
+  caf::settings settings;
+  caf::put(settings, "vast.export.write", directory.string());
+  // Force multiple row groups.
+  caf::put(settings, "vast.export.parquet.row-group-size", size_t{20});
+  {
+    auto writer = format::writer::make("parquet", settings);
+    REQUIRE(writer);
+    for (const auto& slice : zeek_conn_log)
+      REQUIRE_EQUAL((*writer)->write(slice), caf::none);
+    for (const auto& slice : zeek_dns_log)
+      REQUIRE_EQUAL((*writer)->write(slice), caf::none);
+  }
+  auto check = [&](const std::vector<table_slice>& expected,
+                   const std::filesystem::path& file) {
+    REQUIRE(std::filesystem::exists(file));
+    auto slices = read(file);
+    auto rows = size_t{0};
+    for (const auto& slice : expected)
+      rows += slice.rows();
+    auto read_rows = size_t{0};
+    for (const auto& slice : slices) {
+      CHECK_EQUAL(slice.layout(), expected[0].layout());
+      read_rows += slice.rows();
+    }
+    REQUIRE_EQUAL(read_rows, rows);
+    // Slices read back consist of the same rows in the same order, but may be
+    // cut differently due to row groups.
+    auto row = size_t{0};
+    for (const auto& slice : slices) {
+      for (size_t i = 0; i < slice.rows(); ++i, ++row) {
+        const auto& original = expected[row / slice_size];
+        for (size_t column = 0; column < slice.columns(); ++column)
+          CHECK_EQUAL(materialize(slice.at(i, column)),
+                      materialize(original.at(row % slice_size, column)));
+      }
+    }
+  };
+  check(zeek_conn_log, directory / "zeek.conn.parquet");
+  check(zeek_dns_log, directory / "zeek.dns.parquet");
+}
+
+TEST(parquet to stdout rejects multiple layouts) {
+  caf::settings settings;
+  caf::put(settings, "vast.export.write", "-");
+  caf::put(settings, "vast.export.parquet.compression", "uncompressed");
+  auto writer = format::writer::make("parquet", settings);
+  REQUIRE(writer);
+  CHECK_EQUAL((*writer)->write(zeek_conn_log[0]), caf::none);
+  CHECK_NOT_EQUAL((*writer)->write(zeek_dns_log[0]), caf::none);
+}
+
+TEST(parquet rejects unknown compression) {
+  caf::settings settings;
+  caf::put(settings, "vast.export.write", directory.string());
+  caf::put(settings, "vast.export.parquet.compression", "foo");
+  auto writer = format::writer::make("parquet", settings);
+  REQUIRE(writer);
+  CHECK_NOT_EQUAL((*writer)->write(zeek_conn_log[0]), caf::none);
+}
+
+FIXTURE_SCOPE_END()
+
+} // namespace vast::plugins::parquet
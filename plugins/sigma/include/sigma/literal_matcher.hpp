@@ -0,0 +1,116 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <vast/detail/assert.hpp>
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string_view>
+#include <vector>
+
+namespace vast::plugins::sigma {
+
+/// An Aho-Corasick automaton that finds the occurrences of many literals in a
+/// single pass over a string. The cost of a search depends on the length of
+/// the string and the number of occurrences, but not on the number of
+/// literals.
+class literal_matcher {
+public:
+  /// Constructs an empty matcher.
+  literal_matcher();
+
+  /// Adds a literal to the automaton.
+  /// @param literal The string to look for.
+  /// @returns The identifier of *literal*. Adding the same literal twice
+  /// yields the same identifier.
+  /// @pre The matcher must not be compiled yet.
+  size_t add(std::string_view literal);
+
+  /// Computes the failure transitions. Must be called after adding the last
+  /// literal and before the first search.
+  void compile();
+
+  /// @returns The number of distinct literals.
+  [[nodiscard]] size_t size() const;
+
+  /// Searches all literals in a string.
+  /// @param str The string to search.
+  /// @param f The function to invoke with the identifier of each literal that
+  /// occurs in *str*. Literals that occur more than once are reported once
+  /// per occurrence.
+  /// @pre The matcher must be compiled.
+  template <class F>
+  void find(std::string_view str, F&& f) const {
+    VAST_ASSERT(compiled_);
+    // The empty literal occurs in every string.
+    if (nodes_[0].output != none)
+      f(size_t{nodes_[0].output});
+    auto state = uint32_t{0};
+    for (auto c : str) {
+      state = next(state, static_cast<uint8_t>(c));
+      auto match = state != 0 && nodes_[state].output != none
+                     ? state
+                     : nodes_[state].report;
+      while (match != none) {
+        f(size_t{nodes_[match].output});
+        match = nodes_[match].report;
+      }
+    }
+  }
+
+private:
+  static constexpr auto none = ~uint32_t{0};
+
+  struct node {
+    /// The state to continue with if no transition matches.
+    uint32_t fail = 0;
+
+    /// The literal that ends in this state, if any.
+    uint32_t output = none;
+
+    /// The closest state on the failure path that ends a literal, if any.
+    uint32_t report = none;
+
+    /// The range of the transitions of this state in `labels_` and
+    /// `targets_`.
+    uint32_t first = 0;
+    uint32_t last = 0;
+  };
+
+  /// Computes the state after reading a byte.
+  [[nodiscard]] uint32_t next(uint32_t state, uint8_t c) const {
+    while (state != 0) {
+      const auto& n = nodes_[state];
+      for (auto i = n.first; i != n.last; ++i)
+        if (labels_[i] == c)
+          return targets_[i];
+      state = n.fail;
+    }
+    return root_[c];
+  }
+
+  std::vector<node> nodes_;
+
+  /// The transitions of the trie while adding literals.
+  std::vector<std::map<uint8_t, uint32_t>> trie_;
+
+  /// The transitions of all states except for the root, grouped by state.
+  std::vector<uint8_t> labels_;
+  std::vector<uint32_t> targets_;
+
+  /// The transitions of the root, which every failure path ends in.
+  std::array<uint32_t, 256> root_ = {};
+
+  size_t size_ = 0;
+  bool compiled_ = false;
+};
+
+} // namespace vast::plugins::sigma
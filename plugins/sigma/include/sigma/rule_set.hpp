@@ -0,0 +1,67 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <vast/fwd.hpp>
+
+#include <vast/expression.hpp>
+#include <vast/type.hpp>
+
+#include <caf/error.hpp>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vast::plugins::sigma {
+
+/// A collection of Sigma rules that are evaluated together. Instead of
+/// checking one rule after another, the rule set merges the string conditions
+/// of all rules into one automaton per field, so that every value of a batch
+/// is scanned once, no matter how many rules refer to it.
+class rule_set {
+public:
+  /// The rules compiled for a specific layout.
+  struct program;
+
+  /// Adds a rule to the set.
+  /// @param name The name to report for matches of the rule.
+  /// @param expr The rule as VAST expression.
+  void add(std::string name, expression expr);
+
+  /// Parses a rule and adds it to the set under its title.
+  /// @param yaml The rule contents.
+  /// @returns An error if *yaml* is not a valid Sigma rule.
+  caf::error add(const data& yaml);
+
+  /// @returns The number of rules in the set.
+  [[nodiscard]] size_t size() const;
+
+  /// @returns The name of a rule.
+  /// @param rule The index of the rule in the order of insertion.
+  [[nodiscard]] const std::string& name(size_t rule) const;
+
+  /// Evaluates all rules against a table slice.
+  /// @param slice The table slice to evaluate.
+  /// @returns For every row of *slice*, the ascending indices of the rules
+  /// that match the row.
+  std::vector<std::vector<size_t>> match(const table_slice& slice);
+
+private:
+  /// Retrieves the compiled rules for a layout, compiling them on first use.
+  const program& compile(const type& layout);
+
+  std::vector<std::pair<std::string, expression>> rules_;
+
+  /// The compiled rules for each layout seen so far.
+  std::vector<std::pair<type, std::shared_ptr<const program>>> programs_;
+};
+
+} // namespace vast::plugins::sigma
@@ -0,0 +1,91 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "sigma/literal_matcher.hpp"
+
+#include <vast/detail/narrow.hpp>
+
+#include <queue>
+
+namespace vast::plugins::sigma {
+
+literal_matcher::literal_matcher() : nodes_(1), trie_(1) {
+  // nop
+}
+
+size_t literal_matcher::add(std::string_view literal) {
+  VAST_ASSERT(!compiled_);
+  auto state = uint32_t{0};
+  for (auto c : literal) {
+    auto [it, inserted] = trie_[state].try_emplace(
+      static_cast<uint8_t>(c), detail::narrow_cast<uint32_t>(nodes_.size()));
+    if (inserted) {
+      nodes_.emplace_back();
+      trie_.emplace_back();
+    }
+    state = it->second;
+  }
+  if (nodes_[state].output == none)
+    nodes_[state].output = detail::narrow_cast<uint32_t>(size_++);
+  return nodes_[state].output;
+}
+
+void literal_matcher::compile() {
+  VAST_ASSERT(!compiled_);
+  for (const auto& [c, child] : trie_[0])
+    root_[c] = child;
+  // Visit the states in breadth-first order, such that the failure state of
+  // a parent is complete before we follow it for its children.
+  auto queue = std::queue<uint32_t>{};
+  for (const auto& [_, child] : trie_[0])
+    queue.push(child);
+  while (!queue.empty()) {
+    auto state = queue.front();
+    queue.pop();
+    for (const auto& [c, child] : trie_[state]) {
+      auto fail = nodes_[state].fail;
+      auto target = uint32_t{0};
+      while (true) {
+        if (auto it = trie_[fail].find(c); it != trie_[fail].end()) {
+          target = it->second;
+          break;
+        }
+        if (fail == 0)
+          break;
+        fail = nodes_[fail].fail;
+      }
+      auto& n = nodes_[child];
+      n.fail = target;
+      // The empty literal ends in the root, which we report separately.
+      n.report = target != 0 && nodes_[target].output != none
+                   ? target
+                   : nodes_[target].report;
+      queue.push(child);
+    }
+  }
+  // Flatten the transitions into contiguous arrays, which are cheaper to scan
+  // than the tree-based maps.
+  for (uint32_t state = 1; state < nodes_.size(); ++state) {
+    auto& n = nodes_[state];
+    n.first = detail::narrow_cast<uint32_t>(labels_.size());
+    for (const auto& [c, child] : trie_[state]) {
+      labels_.push_back(c);
+      targets_.push_back(child);
+    }
+    n.last = detail::narrow_cast<uint32_t>(labels_.size());
+  }
+  trie_.clear();
+  trie_.shrink_to_fit();
+  compiled_ = true;
+}
+
+size_t literal_matcher::size() const {
+  return size_;
+}
+
+} // namespace vast::plugins::sigma
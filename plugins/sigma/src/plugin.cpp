@@ -7,18 +7,158 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include "sigma/parse.hpp"
+#include "sigma/rule_set.hpp"
 
+#include <vast/arrow_table_slice.hpp>
+#include <vast/arrow_table_slice_builder.hpp>
+#include <vast/bitmap_algorithms.hpp>
 #include <vast/data.hpp>
+#include <vast/detail/load_contents.hpp>
 #include <vast/error.hpp>
+#include <vast/ids.hpp>
+#include <vast/logger.hpp>
 #include <vast/plugin.hpp>
+#include <vast/table_slice.hpp>
+#include <vast/transform_step.hpp>
 
+#include <arrow/record_batch.h>
 #include <caf/error.hpp>
 #include <caf/expected.hpp>
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <filesystem>
+#include <utility>
+
 namespace vast::plugins::sigma {
 
-class plugin final : public virtual query_language_plugin {
+namespace {
+
+/// Adds all rules in a file or directory to a rule set.
+caf::error load(rule_set& rules, const std::filesystem::path& path) {
+  auto files = std::vector<std::filesystem::path>{};
+  auto error = std::error_code{};
+  if (std::filesystem::is_directory(path, error)) {
+    for (const auto& entry :
+         std::filesystem::recursive_directory_iterator{path, error}) {
+      const auto& extension = entry.path().extension();
+      if (entry.is_regular_file()
+          && (extension == ".yml" || extension == ".yaml"))
+        files.push_back(entry.path());
+    }
+    // Sort the files to report the rules in a stable order.
+    std::sort(files.begin(), files.end());
+  } else {
+    files.push_back(path);
+  }
+  if (error)
+    return caf::make_error(ec::filesystem_error,
+                           fmt::format("failed to list Sigma rules in {}: {}",
+                                       path.string(), error.message()));
+  for (const auto& file : files) {
+    auto contents = detail::load_contents(file);
+    if (!contents)
+      return contents.error();
+    auto yaml = from_yaml(*contents);
+    if (!yaml)
+      return caf::make_error(ec::invalid_configuration,
+                             fmt::format("not a Sigma rule: {}: {}",
+                                         file.string(), yaml.error()));
+    if (auto err = rules.add(*yaml))
+      return caf::make_error(ec::invalid_configuration,
+                             fmt::format("failed to parse Sigma rule {}: {}",
+                                         file.string(), err));
+  }
+  return caf::none;
+}
+
+/// Evaluates a set of Sigma rules against every batch, keeps the events that
+/// match at least one rule, and adds a field with the titles of the matching
+/// rules.
+class sigma_step : public transform_step {
+public:
+  sigma_step(rule_set rules, std::string field)
+    : rules_{std::move(rules)}, field_{std::move(field)} {
+    // nop
+  }
+
+  [[nodiscard]] caf::error
+  add(type layout, std::shared_ptr<arrow::RecordBatch> batch) override {
+    VAST_TRACE("sigma step adds batch");
+    const auto matches = rules_.match(table_slice{batch});
+    auto selection = ids{};
+    const auto names_type = list_type{string_type{}};
+    auto names_builder
+      = names_type.make_arrow_builder(arrow::default_memory_pool());
+    for (const auto& rules : matches) {
+      auto names = list{};
+      names.reserve(rules.size());
+      for (auto rule : rules)
+        names.emplace_back(rules_.name(rule));
+      selection.append_bit(!rules.empty());
+      const auto append_status
+        = append_builder(names_type, *names_builder, make_view(names));
+      VAST_ASSERT(append_status.ok(), append_status.ToString().c_str());
+    }
+    const auto num_matches = rank(selection);
+    if (num_matches == 0)
+      return caf::none;
+    // Append the field with the rule titles after the last column.
+    auto transform_fn = [&](struct record_type::field field,
+                            std::shared_ptr<arrow::Array> array) noexcept
+      -> std::vector<
+        std::pair<struct record_type::field, std::shared_ptr<arrow::Array>>> {
+      return {
+        {
+          std::move(field),
+          std::move(array),
+        },
+        {
+          {
+            field_,
+            names_type,
+          },
+          names_builder->Finish().ValueOrDie(),
+        },
+      };
+    };
+    const auto& layout_rt = caf::get<record_type>(layout);
+    auto [adjusted_layout, adjusted_batch] = transform_columns(
+      layout, batch,
+      {{offset{layout_rt.num_fields() - 1}, std::move(transform_fn)}});
+    VAST_ASSERT(adjusted_layout);
+    VAST_ASSERT(adjusted_batch);
+    if (num_matches == matches.size()) {
+      transformed_.emplace_back(std::move(adjusted_layout),
+                                std::move(adjusted_batch));
+      return caf::none;
+    }
+    auto filtered = filter(table_slice{adjusted_batch}, selection);
+    VAST_ASSERT(filtered);
+    transformed_.emplace_back(filtered->layout(), to_record_batch(*filtered));
+    return caf::none;
+  }
+
+  [[nodiscard]] caf::expected<std::vector<transform_batch>> finish() override {
+    VAST_DEBUG("sigma step finished transformation");
+    return std::exchange(transformed_, {});
+  }
+
+private:
+  /// The rules to evaluate.
+  rule_set rules_;
+
+  /// The name of the field with the titles of the matching rules.
+  std::string field_;
+
+  /// The slices being transformed.
+  std::vector<transform_batch> transformed_ = {};
+};
+
+} // namespace
+
+class plugin final : public virtual query_language_plugin,
+                     public virtual transform_plugin {
   caf::error initialize(data) override {
     return caf::none;
   }
@@ -35,6 +175,44 @@ class plugin final : public virtual query_language_plugin {
       return caf::make_error(ec::invalid_query,
                              fmt::format("not a Sigma rule: {}", yaml.error()));
   }
+
+  [[nodiscard]] caf::expected<std::unique_ptr<transform_step>>
+  make_transform_step(const record& options) const override {
+    auto paths = std::vector<std::string>{};
+    if (auto i = options.find("rules"); i != options.end()) {
+      if (const auto* path = caf::get_if<std::string>(&i->second)) {
+        paths.push_back(*path);
+      } else if (const auto* xs = caf::get_if<list>(&i->second)) {
+        for (const auto& x : *xs) {
+          const auto* path = caf::get_if<std::string>(&x);
+          if (!path)
+            return caf::make_error(ec::invalid_configuration,
+                                   "key 'rules' must contain paths in "
+                                   "configuration for sigma step");
+          paths.push_back(*path);
+        }
+      }
+    }
+    if (paths.empty())
+      return caf::make_error(ec::invalid_configuration,
+                             "key 'rules' is missing in configuration for "
+                             "sigma step");
+    auto field = std::string{"sigma"};
+    if (auto i = options.find("field"); i != options.end()) {
+      const auto* str = caf::get_if<std::string>(&i->second);
+      if (!str)
+        return caf::make_error(ec::invalid_configuration,
+                               "key 'field' must be a string in configuration "
+                               "for sigma step");
+      field = *str;
+    }
+    auto rules = rule_set{};
+    for (const auto& path : paths)
+      if (auto err = load(rules, path))
+        return err;
+    VAST_VERBOSE("sigma step loaded {} rules", rules.size());
+    return std::make_unique<sigma_step>(std::move(rules), std::move(field));
+  }
 };
 
 } // namespace vast::plugins::sigma
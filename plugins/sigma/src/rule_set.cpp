@@ -0,0 +1,364 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "sigma/rule_set.hpp"
+
+#include "sigma/literal_matcher.hpp"
+#include "sigma/parse.hpp"
+
+#include <vast/bitmap_algorithms.hpp>
+#include <vast/data.hpp>
+#include <vast/detail/assert.hpp>
+#include <vast/detail/overload.hpp>
+#include <vast/error.hpp>
+#include <vast/ids.hpp>
+#include <vast/pattern.hpp>
+#include <vast/table_slice.hpp>
+#include <vast/view.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+namespace vast::plugins::sigma {
+
+namespace {
+
+constexpr auto none = std::numeric_limits<size_t>::max();
+
+/// A rule in which every predicate refers to the slot that holds its outcome
+/// for the current row.
+struct condition {
+  enum class kind { never, slot, negation, conjunction, disjunction };
+
+  enum kind kind = kind::never;
+  size_t slot = none;
+  std::vector<condition> operands = {};
+};
+
+/// Evaluates a condition for a row.
+/// @param x The condition to evaluate.
+/// @param hits The row for which each slot last held.
+/// @param row The current row.
+bool eval(const condition& x, const std::vector<size_t>& hits, size_t row) {
+  auto f = [&](const condition& operand) {
+    return eval(operand, hits, row);
+  };
+  switch (x.kind) {
+    case condition::kind::never:
+      return false;
+    case condition::kind::slot:
+      return hits[x.slot] == row;
+    case condition::kind::negation:
+      return !f(x.operands[0]);
+    case condition::kind::conjunction:
+      return std::all_of(x.operands.begin(), x.operands.end(), f);
+    case condition::kind::disjunction:
+      return std::any_of(x.operands.begin(), x.operands.end(), f);
+  }
+  VAST_ASSERT(!"missing case");
+  return false;
+}
+
+/// The string predicates of all rules that refer to the same column.
+struct column_matcher {
+  size_t column;
+  vast::type type;
+
+  /// The literals of substring predicates and the literals that patterns
+  /// require, in one automaton.
+  literal_matcher literals = {};
+
+  /// The slot of the substring predicate for each literal, if any.
+  std::vector<size_t> literal_slots = {};
+
+  /// The slots of the equality and membership predicates for each value.
+  std::unordered_map<std::string, std::vector<size_t>> values = {};
+
+  /// The slot of each distinct equality predicate.
+  std::unordered_map<std::string, size_t> equality_slots = {};
+
+  struct pattern_check {
+    vast::pattern pattern;
+    std::vector<size_t> literals;
+    size_t slot;
+  };
+
+  /// The patterns along with the literals that must occur for a match.
+  std::vector<pattern_check> patterns = {};
+
+  /// The slot of each distinct pattern.
+  std::unordered_map<std::string, size_t> pattern_slots = {};
+};
+
+} // namespace
+
+struct rule_set::program {
+  std::vector<column_matcher> columns = {};
+
+  /// Predicates that the matchers do not cover, which we evaluate for the
+  /// whole table slice at once.
+  std::vector<std::pair<expression, size_t>> fallbacks = {};
+
+  /// The compiled rules in the order of insertion.
+  std::vector<condition> rules = {};
+
+  size_t slots = 0;
+};
+
+namespace {
+
+/// Turns tailored expressions into conditions, registering their string
+/// predicates with the matcher of the respective column.
+class program_builder {
+public:
+  explicit program_builder(rule_set::program& program) : program_{program} {
+    // nop
+  }
+
+  condition make(const expression& expr) {
+    auto f = detail::overload{
+      [&](caf::none_t) {
+        return condition{};
+      },
+      [&](const conjunction& xs) {
+        return make(condition::kind::conjunction, xs);
+      },
+      [&](const disjunction& xs) {
+        return make(condition::kind::disjunction, xs);
+      },
+      [&](const negation& x) {
+        return negate(make(x.expr()));
+      },
+      [&](const predicate& x) {
+        return make(x);
+      },
+    };
+    return caf::visit(f, expr);
+  }
+
+  void finish() {
+    for (auto& column : program_.columns) {
+      column.literals.compile();
+      column.literal_slots.resize(column.literals.size(), none);
+    }
+  }
+
+private:
+  static condition negate(condition x) {
+    auto result = condition{condition::kind::negation};
+    result.operands.push_back(std::move(x));
+    return result;
+  }
+
+  condition make(enum condition::kind kind, const std::vector<expression>& xs) {
+    auto result = condition{kind};
+    result.operands.reserve(xs.size());
+    for (const auto& x : xs)
+      result.operands.push_back(make(x));
+    return result;
+  }
+
+  condition make(const predicate& pred) {
+    auto result = condition{condition::kind::slot};
+    const auto* lhs = caf::get_if<data_extractor>(&pred.lhs);
+    const auto* rhs = caf::get_if<data>(&pred.rhs);
+    // The negated operators are the negations of the operators we cover.
+    const auto op = is_negated(pred.op) ? vast::negate(pred.op) : pred.op;
+    if (lhs && rhs && caf::holds_alternative<string_type>(lhs->type))
+      result.slot = add(column(*lhs), op, *rhs);
+    if (result.slot == none) {
+      result.slot = program_.slots++;
+      program_.fallbacks.emplace_back(pred, result.slot);
+      return result;
+    }
+    return is_negated(pred.op) ? negate(std::move(result)) : result;
+  }
+
+  column_matcher& column(const data_extractor& x) {
+    auto [it, inserted] = columns_.try_emplace(x.column, columns_.size());
+    if (inserted)
+      program_.columns.push_back(column_matcher{x.column, x.type});
+    return program_.columns[it->second];
+  }
+
+  /// Registers a predicate on a string column.
+  /// @returns The slot of the predicate, or `none` if it is not covered.
+  size_t add(column_matcher& column, relational_operator op, const data& rhs) {
+    auto f = detail::overload{
+      [&](const auto&) {
+        return none;
+      },
+      [&](const std::string& str) {
+        if (op == relational_operator::ni) {
+          auto id = column.literals.add(str);
+          if (id >= column.literal_slots.size())
+            column.literal_slots.resize(id + 1, none);
+          if (column.literal_slots[id] == none)
+            column.literal_slots[id] = program_.slots++;
+          return column.literal_slots[id];
+        }
+        if (op == relational_operator::equal) {
+          auto [it, inserted]
+            = column.equality_slots.try_emplace(str, program_.slots);
+          if (inserted) {
+            column.values[str].push_back(it->second);
+            ++program_.slots;
+          }
+          return it->second;
+        }
+        return none;
+      },
+      [&](const list& xs) {
+        if (op != relational_operator::in)
+          return none;
+        auto is_string = [](const data& x) {
+          return caf::holds_alternative<std::string>(x);
+        };
+        if (!std::all_of(xs.begin(), xs.end(), is_string))
+          return none;
+        auto slot = program_.slots++;
+        for (const auto& x : xs) {
+          auto& slots = column.values[caf::get<std::string>(x)];
+          if (slots.empty() || slots.back() != slot)
+            slots.push_back(slot);
+        }
+        return slot;
+      },
+      [&](const pattern& pat) {
+        if (op != relational_operator::match)
+          return none;
+        auto [it, inserted]
+          = column.pattern_slots.try_emplace(pat.string(), program_.slots);
+        if (inserted) {
+          auto check = column_matcher::pattern_check{pat, {}, it->second};
+          for (const auto& literal : required_literals(pat.string()))
+            check.literals.push_back(column.literals.add(literal));
+          column.patterns.push_back(std::move(check));
+          ++program_.slots;
+        }
+        return it->second;
+      },
+    };
+    return caf::visit(f, rhs);
+  }
+
+  rule_set::program& program_;
+
+  /// Maps columns to their index in the list of matchers.
+  std::unordered_map<size_t, size_t> columns_ = {};
+};
+
+} // namespace
+
+void rule_set::add(std::string name, expression expr) {
+  rules_.emplace_back(std::move(name), std::move(expr));
+  programs_.clear();
+}
+
+caf::error rule_set::add(const data& yaml) {
+  auto expr = parse_rule(yaml);
+  if (!expr)
+    return expr.error();
+  const auto& xs = caf::get<record>(yaml);
+  const std::string* title = nullptr;
+  if (auto i = xs.find("title"); i != xs.end())
+    title = caf::get_if<std::string>(&i->second);
+  if (!title)
+    return caf::make_error(ec::invalid_query, "no title attribute");
+  add(*title, std::move(*expr));
+  return caf::none;
+}
+
+size_t rule_set::size() const {
+  return rules_.size();
+}
+
+const std::string& rule_set::name(size_t rule) const {
+  VAST_ASSERT(rule < rules_.size());
+  return rules_[rule].first;
+}
+
+const rule_set::program& rule_set::compile(const type& layout) {
+  for (const auto& [cached_layout, program] : programs_)
+    if (cached_layout == layout)
+      return *program;
+  auto result = std::make_shared<program>();
+  auto builder = program_builder{*result};
+  result->rules.reserve(rules_.size());
+  for (const auto& [_, expr] : rules_) {
+    // Rules that refer to fields the layout does not have never match.
+    if (auto tailored = tailor(expr, layout))
+      result->rules.push_back(builder.make(*tailored));
+    else
+      result->rules.emplace_back();
+  }
+  builder.finish();
+  programs_.emplace_back(layout, result);
+  return *result;
+}
+
+std::vector<std::vector<size_t>> rule_set::match(const table_slice& slice) {
+  auto result = std::vector<std::vector<size_t>>(slice.rows());
+  if (rules_.empty() || slice.rows() == 0)
+    return result;
+  const auto& program = compile(slice.layout());
+  // First, we collect the slots that hold for each row, scanning each column
+  // once for the predicates of all rules.
+  auto row_slots = std::vector<std::vector<size_t>>(slice.rows());
+  for (const auto& column : program.columns) {
+    auto seen = std::vector<size_t>(column.literals.size(), none);
+    auto row = size_t{0};
+    for (auto&& x : slice.values(column.column)) {
+      auto current = row++;
+      const auto* str = caf::get_if<view<std::string>>(&x);
+      if (!str)
+        continue;
+      auto& slots = row_slots[current];
+      column.literals.find(*str, [&](size_t id) {
+        if (seen[id] == current)
+          return;
+        seen[id] = current;
+        if (column.literal_slots[id] != none)
+          slots.push_back(column.literal_slots[id]);
+      });
+      if (!column.values.empty())
+        if (auto it = column.values.find(std::string{*str});
+            it != column.values.end())
+          slots.insert(slots.end(), it->second.begin(), it->second.end());
+      for (const auto& check : column.patterns) {
+        auto has_literal = [&](size_t id) {
+          return seen[id] == current;
+        };
+        if (std::all_of(check.literals.begin(), check.literals.end(),
+                        has_literal)
+            && check.pattern.match(*str))
+          slots.push_back(check.slot);
+      }
+    }
+  }
+  // The remaining predicates use the regular evaluation. We rebase the table
+  // slice so that the resulting IDs correspond to rows.
+  auto rebased = slice;
+  rebased.offset(0);
+  for (const auto& [expr, slot] : program.fallbacks)
+    for (auto id : select(evaluate(expr, rebased)))
+      row_slots[id].push_back(slot);
+  // Finally, we evaluate the rules for each row based on the slots alone.
+  auto hits = std::vector<size_t>(program.slots, none);
+  for (size_t row = 0; row < slice.rows(); ++row) {
+    for (auto slot : row_slots[row])
+      hits[slot] = row;
+    for (size_t rule = 0; rule < program.rules.size(); ++rule)
+      if (eval(program.rules[rule], hits, row))
+        result[row].push_back(rule);
+  }
+  return result;
+}
+
+} // namespace vast::plugins::sigma
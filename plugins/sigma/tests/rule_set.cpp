@@ -0,0 +1,156 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#define SUITE sigma
+
+#include "sigma/literal_matcher.hpp"
+#include "sigma/rule_set.hpp"
+
+#include <vast/bitmap_algorithms.hpp>
+#include <vast/concept/parseable/to.hpp>
+#include <vast/concept/parseable/vast/expression.hpp>
+#include <vast/data.hpp>
+#include <vast/defaults.hpp>
+#include <vast/expression.hpp>
+#include <vast/table_slice.hpp>
+#include <vast/table_slice_builder_factory.hpp>
+#include <vast/test/test.hpp>
+
+#include <caf/test/dsl.hpp>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <string_view>
+
+using namespace std::string_literals;
+using namespace vast;
+using namespace vast::plugins::sigma;
+
+namespace {
+
+table_slice make_slice() {
+  factory<table_slice_builder>::initialize();
+  auto layout = type{
+    "test",
+    record_type{
+      {"image", string_type{}},
+      {"cmd", string_type{}},
+      {"pid", count_type{}},
+    },
+  };
+  auto builder = factory<table_slice_builder>::make(
+    defaults::import::table_slice_type, layout);
+  REQUIRE(builder);
+  using namespace std::string_view_literals;
+  REQUIRE(builder->add("C:\\Windows\\cmd.exe"sv, "whoami /all"sv, count{1}));
+  REQUIRE(builder->add("powershell.exe"sv, "Invoke-Mimikatz"sv, count{2}));
+  REQUIRE(builder->add("notepad.exe"sv, ""sv, count{3}));
+  REQUIRE(builder->add(caf::none, "whoami"sv, count{4}));
+  auto result = builder->finish();
+  result.offset(0);
+  return result;
+}
+
+} // namespace
+
+TEST(literal matcher) {
+  auto matcher = literal_matcher{};
+  CHECK_EQUAL(matcher.add("he"), 0u);
+  CHECK_EQUAL(matcher.add("she"), 1u);
+  CHECK_EQUAL(matcher.add("his"), 2u);
+  CHECK_EQUAL(matcher.add("hers"), 3u);
+  CHECK_EQUAL(matcher.add("she"), 1u);
+  CHECK_EQUAL(matcher.size(), 4u);
+  matcher.compile();
+  auto find = [&](std::string_view str) {
+    auto result = std::vector<size_t>{};
+    matcher.find(str, [&](size_t id) {
+      result.push_back(id);
+    });
+    std::sort(result.begin(), result.end());
+    return result;
+  };
+  CHECK_EQUAL(find("ushers"), (std::vector<size_t>{0, 1, 3}));
+  CHECK_EQUAL(find("hishe"), (std::vector<size_t>{0, 1, 2}));
+  CHECK_EQUAL(find("hehe"), (std::vector<size_t>{0, 0}));
+  CHECK_EQUAL(find("xyz"), (std::vector<size_t>{}));
+  MESSAGE("the empty literal occurs everywhere");
+  auto empty = literal_matcher{};
+  CHECK_EQUAL(empty.add(""), 0u);
+  CHECK_EQUAL(empty.add("a"), 1u);
+  empty.compile();
+  auto hits = size_t{0};
+  empty.find("", [&](size_t id) {
+    CHECK_EQUAL(id, 0u);
+    ++hits;
+  });
+  CHECK_EQUAL(hits, 1u);
+}
+
+TEST(rule set) {
+  auto slice = make_slice();
+  auto rules = rule_set{};
+  auto exprs = std::vector<std::string>{
+    R"__(image ni "cmd.exe" || image == "powershell.exe")__",
+    R"__(cmd ni "whoami" && pid > 1)__",
+    R"__(cmd ~ /.*Mimikatz.*/)__",
+    R"__(! (image ni "notepad"))__",
+    R"__(foo == "bar")__",
+    R"__(image in ["notepad.exe", "calc.exe"])__",
+    R"__(image !ni "exe" || cmd ni "all")__",
+  };
+  for (size_t i = 0; i < exprs.size(); ++i)
+    rules.add(fmt::format("rule {}", i), unbox(to<expression>(exprs[i])));
+  REQUIRE_EQUAL(rules.size(), exprs.size());
+  CHECK_EQUAL(rules.name(2), "rule 2");
+  auto matches = rules.match(slice);
+  REQUIRE_EQUAL(matches.size(), slice.rows());
+  CHECK_EQUAL(matches[0], (std::vector<size_t>{0, 3, 6}));
+  CHECK_EQUAL(matches[1], (std::vector<size_t>{0, 2, 3}));
+  CHECK_EQUAL(matches[2], (std::vector<size_t>{5}));
+  CHECK_EQUAL(matches[3], (std::vector<size_t>{1, 3, 6}));
+  MESSAGE("results agree with the evaluation of individual rules");
+  for (size_t rule = 0; rule < exprs.size(); ++rule) {
+    auto expected = std::vector<bool>(slice.rows());
+    if (auto expr = tailor(unbox(to<expression>(exprs[rule])), slice.layout()))
+      for (auto id : select(evaluate(*expr, slice)))
+        expected[id] = true;
+    for (size_t row = 0; row < slice.rows(); ++row) {
+      auto found = std::find(matches[row].begin(), matches[row].end(), rule)
+                   != matches[row].end();
+      CHECK_EQUAL(found, expected[row]);
+    }
+  }
+  MESSAGE("adding a rule invalidates the compiled rules");
+  rules.add("late", unbox(to<expression>(R"__(cmd == "")__")));
+  matches = rules.match(slice);
+  CHECK_EQUAL(matches[2], (std::vector<size_t>{5, 7}));
+}
+
+TEST(rule set - sigma rules) {
+  auto rules = rule_set{};
+  auto yaml = unbox(from_yaml(R"__(
+title: Whoami Execution
+detection:
+  selection:
+    cmd|contains: whoami
+  condition: selection
+)__"));
+  CHECK_EQUAL(rules.add(yaml), caf::none);
+  yaml = unbox(from_yaml(R"__(
+detection:
+  selection:
+    cmd|contains: whoami
+  condition: selection
+)__"));
+  CHECK_NOT_EQUAL(rules.add(yaml), caf::none);
+  REQUIRE_EQUAL(rules.size(), 1u);
+  CHECK_EQUAL(rules.name(0), "Whoami Execution");
+  auto matches = rules.match(make_slice());
+  CHECK_EQUAL(matches, (std::vector<std::vector<size_t>>{{0}, {}, {}, {0}}));
+}
@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+
+"""
+Compares the throughput of the Arrow endpoint with `vast export json`.
+
+Start a node with the `arrow-endpoint` plugin and ingest some data as described
+in the README.md, then run this script with the path of the endpoint socket:
+
+    python example/arrow_throughput.py vast.db/arrow.sock '#type == "zeek.conn"'
+"""
+
+import argparse
+import json
+import subprocess
+import time
+
+from pyvast import ArrowEndpoint
+
+
+def via_arrow(path, query):
+    rows = 0
+    for batch in ArrowEndpoint(path).export(query):
+        rows += batch.num_rows
+    return rows
+
+
+def via_json(binary, query):
+    proc = subprocess.run(
+        [binary, "export", "json", query], capture_output=True, check=True
+    )
+    return sum(1 for line in proc.stdout.splitlines() if json.loads(line))
+
+
+def measure(name, f, *args):
+    start = time.perf_counter()
+    rows = f(*args)
+    elapsed = time.perf_counter() - start
+    rate = rows / elapsed if elapsed > 0 else float("inf")
+    print(f"{name:>6}: {rows} events in {elapsed:.3f}s ({rate:,.0f} events/s)")
+    return elapsed
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    parser.add_argument("socket", help="the socket of the Arrow endpoint")
+    parser.add_argument("query", help="the query expression")
+    parser.add_argument("--binary", default="vast", help="the VAST binary")
+    args = parser.parse_args()
+    arrow = measure("arrow", via_arrow, args.socket, args.query)
+    json_ = measure("json", via_json, args.binary, args.query)
+    print(f"speedup: {json_ / arrow:.1f}x")
@@ -1 +1,7 @@
 from .vast import VAST
+
+try:
+    from .arrow import ArrowEndpoint, ArrowEndpointError
+except ImportError:
+    # The Arrow endpoint client requires pyarrow, which is optional.
+    pass
@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+
+"""python vast arrow module
+
+Queries the Arrow endpoint of a VAST node, which the `arrow-endpoint` plugin
+provides, and yields the results as `pyarrow.RecordBatch` objects without
+going through the `vast` binary and an intermediate text format.
+
+Example:
+
+    Connect to the socket of the Arrow endpoint:
+    > from pyvast import ArrowEndpoint
+    > endpoint = ArrowEndpoint("/var/lib/vast/arrow.sock")
+    Extract some data:
+    > for batch in endpoint.export(":addr == 192.168.1.104", max_events=10):
+    >     print(batch.num_rows)
+
+"""
+
+import socket
+
+import pyarrow
+import pyarrow.ipc
+
+
+class ArrowEndpointError(Exception):
+    """The Arrow endpoint rejected a request"""
+
+
+class ArrowEndpoint:
+    """A handle to the Arrow endpoint of a VAST node"""
+
+    def __init__(self, path):
+        self.path = str(path)
+
+    def export(self, expression, max_events=0):
+        """Runs a query and yields the results as pyarrow.RecordBatch objects.
+
+        The node starts a new Arrow IPC stream whenever the layout of the
+        results changes, so consecutive batches may have different schemas.
+        Raises ArrowEndpointError if the node rejects the query.
+        """
+        if "\n" in expression:
+            raise ValueError("the query expression must not contain newlines")
+        with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as sock:
+            sock.connect(self.path)
+            sock.sendall(f"{int(max_events)}\n{expression}\n".encode())
+            with sock.makefile("rb") as stream:
+                status = stream.readline().decode().rstrip("\n")
+                if status != "ok":
+                    prefix = "error: "
+                    if status.startswith(prefix):
+                        raise ArrowEndpointError(status[len(prefix) :])
+                    raise ArrowEndpointError(
+                        f"unexpected response from the node: {status!r}"
+                    )
+                while stream.peek(1):
+                    reader = pyarrow.ipc.open_stream(stream)
+                    for batch in reader:
+                        yield batch
+
+    def export_table(self, expression, max_events=0):
+        """Runs a query and returns the results as one pyarrow.Table per
+        layout, keyed by the name of the layout."""
+        batches = {}
+        for batch in self.export(expression, max_events):
+            metadata = batch.schema.metadata or {}
+            name = metadata.get(b"VAST:name:0", b"").decode()
+            batches.setdefault(name, []).append(batch)
+        return {
+            name: pyarrow.Table.from_batches(xs) for name, xs in batches.items()
+        }
@@ -0,0 +1,51 @@
+import json
+import os
+import subprocess
+import unittest
+
+try:
+    import pyarrow
+    from pyvast import ArrowEndpoint, ArrowEndpointError
+except ImportError:
+    pyarrow = None
+
+# The socket of the Arrow endpoint of a running node, which must contain the
+# Zeek conn.log from the integration test data.
+SOCKET = os.environ.get("VAST_ARROW_SOCKET", "vast.db/arrow.sock")
+BINARY = os.environ.get("VAST_BINARY", "/opt/tenzir/bin/vast")
+QUERY = '#type == "zeek.conn"'
+
+
+@unittest.skipIf(pyarrow is None, "requires pyarrow")
+@unittest.skipUnless(os.path.exists(SOCKET), "requires a running node")
+class TestArrowEndpoint(unittest.TestCase):
+    def setUp(self):
+        self.endpoint = ArrowEndpoint(SOCKET)
+
+    def test_export_yields_record_batches(self):
+        batches = list(self.endpoint.export(QUERY, max_events=10))
+        self.assertTrue(batches)
+        for batch in batches:
+            self.assertIsInstance(batch, pyarrow.RecordBatch)
+        self.assertEqual(sum(batch.num_rows for batch in batches), 10)
+
+    def test_export_table(self):
+        tables = self.endpoint.export_table(QUERY, max_events=10)
+        self.assertEqual(list(tables.keys()), ["zeek.conn"])
+        self.assertEqual(tables["zeek.conn"].num_rows, 10)
+
+    def test_results_match_json_export(self):
+        rows = sum(batch.num_rows for batch in self.endpoint.export(QUERY))
+        proc = subprocess.run(
+            [BINARY, "export", "json", QUERY], capture_output=True, check=True
+        )
+        lines = [json.loads(x) for x in proc.stdout.splitlines() if x]
+        self.assertEqual(rows, len(lines))
+
+    def test_invalid_query_raises(self):
+        with self.assertRaises(ArrowEndpointError):
+            list(self.endpoint.export("foo =="))
+
+    def test_newlines_are_rejected(self):
+        with self.assertRaises(ValueError):
+            list(self.endpoint.export("x == 1\ny == 2"))
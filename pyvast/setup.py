@@ -24,6 +24,7 @@ setup(
     description="Python CLI wrapper for VAST - Visibility Across Space and Time",
     include_package_data=True,
     install_requires=[],
+    extras_require={"arrow": ["pyarrow"]},
     keywords=[
         "vast",
         "pyvast",
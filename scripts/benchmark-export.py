@@ -0,0 +1,89 @@
+#! /usr/bin/env python3
+
+# Measures the export throughput of VAST for different output formats.
+#
+# Example usage:
+# ./scripts/benchmark-export.py -e localhost:42000 '#type == "zeek.conn"'
+# ./scripts/benchmark-export.py -f json -f arrow -f parquet -r 3 'x'
+#
+# For every format, the script runs `vast export <format> <query>`, counts the
+# bytes written, and reports the throughput in MB/s. Formats that write files
+# instead of STDOUT (parquet) export into a temporary directory.
+
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+
+def export(vast, endpoint, fmt, query):
+    cmd = [vast]
+    if endpoint:
+        cmd.append(f"--endpoint={endpoint}")
+    cmd.append("export")
+    tmpdir = None
+    if fmt == "parquet":
+        tmpdir = tempfile.mkdtemp(prefix="vast-benchmark-export-")
+        cmd.append(f"--write={tmpdir}")
+    cmd += [fmt, query]
+    start = time.perf_counter()
+    if tmpdir is None:
+        size = 0
+        with subprocess.Popen(cmd, stdout=subprocess.PIPE) as proc:
+            while chunk := proc.stdout.read(1 << 20):
+                size += len(chunk)
+        returncode = proc.returncode
+    else:
+        returncode = subprocess.run(cmd).returncode
+        elapsed = time.perf_counter() - start
+        size = sum(
+            os.path.getsize(os.path.join(tmpdir, f)) for f in os.listdir(tmpdir)
+        )
+        shutil.rmtree(tmpdir)
+        if returncode != 0:
+            sys.exit(f"'{' '.join(cmd)}' failed with exit code {returncode}")
+        return size, elapsed
+    elapsed = time.perf_counter() - start
+    if returncode != 0:
+        sys.exit(f"'{' '.join(cmd)}' failed with exit code {returncode}")
+    return size, elapsed
+
+
+def main():
+    parser = argparse.ArgumentParser(description="benchmark VAST exports")
+    parser.add_argument("query", help="the query expression to export")
+    parser.add_argument("-b", "--vast", default="vast", help="the VAST binary")
+    parser.add_argument("-e", "--endpoint", help="the VAST node endpoint")
+    parser.add_argument(
+        "-f",
+        "--format",
+        action="append",
+        dest="formats",
+        help="the export formats (default: json, arrow, parquet)",
+    )
+    parser.add_argument(
+        "-r", "--runs", type=int, default=1, help="runs per format"
+    )
+    args = parser.parse_args()
+    formats = args.formats or ["json", "arrow", "parquet"]
+    baseline = None
+    print(f"{'format':>10} {'run':>4} {'MB':>12} {'seconds':>10} {'MB/s':>10}")
+    for fmt in formats:
+        for run in range(args.runs):
+            size, elapsed = export(args.vast, args.endpoint, fmt, args.query)
+            mb = size / 1e6
+            throughput = mb / elapsed if elapsed > 0 else float("inf")
+            line = f"{fmt:>10} {run:>4} {mb:>12.2f} {elapsed:>10.3f}"
+            line += f" {throughput:>10.2f}"
+            if fmt == "json" and baseline is None:
+                baseline = elapsed
+            elif baseline is not None and elapsed > 0:
+                line += f"  ({baseline / elapsed:.1f}x faster than json)"
+            print(line)
+
+
+if __name__ == "__main__":
+    main()
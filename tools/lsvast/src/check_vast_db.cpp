@@ -0,0 +1,482 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <vast/as_bytes.hpp>
+#include <vast/chunk.hpp>
+#include <vast/concept/printable/to_string.hpp>
+#include <vast/concept/printable/vast/error.hpp>
+#include <vast/concept/printable/vast/uuid.hpp>
+#include <vast/detail/legacy_deserialize.hpp>
+#include <vast/fbs/index.hpp>
+#include <vast/fbs/partition.hpp>
+#include <vast/fbs/partition_synopsis.hpp>
+#include <vast/fbs/segment.hpp>
+#include <vast/fbs/utils.hpp>
+#include <vast/ids.hpp>
+#include <vast/system/index.hpp>
+#include <vast/system/passive_partition.hpp>
+#include <vast/table_slice.hpp>
+#include <vast/uuid.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <set>
+#include <thread>
+
+#include "lsvast.hpp"
+#include "util.hpp"
+
+namespace lsvast {
+
+namespace {
+
+// A value index that takes up more than this fraction of the bytes that the
+// store uses for its layout is reported as a compression opportunity.
+constexpr double index_heavy_ratio = 0.25;
+
+struct layout_stats {
+  uint64_t events = 0;
+  size_t store_bytes = 0;
+  size_t index_bytes = 0;
+};
+
+struct column_stats {
+  std::string layout = {};
+  size_t bytes = 0;
+};
+
+// The result of checking a single file. Every file is checked by exactly one
+// worker thread, and the results are merged afterwards.
+struct file_report {
+  std::filesystem::path path = {};
+  std::vector<std::string> problems = {};
+  uint64_t events = 0;
+  size_t bytes = 0;
+  std::map<std::string, layout_stats> layouts = {};
+  std::map<std::string, column_stats> columns = {};
+  // The store file that the partition refers to, relative to the database
+  // directory.
+  std::optional<std::filesystem::path> store = {};
+  bool rebuilt_synopsis = false;
+};
+
+template <class T>
+const T* verify_flatbuffer(const vast::chunk& chunk) {
+  auto verifier = vast::fbs::make_verifier(vast::as_bytes(chunk));
+  if (!verifier.template VerifyBuffer<T>())
+    return nullptr;
+  return flatbuffers::GetRoot<T>(chunk.data());
+}
+
+// Checks the table slices of a segment and attributes their sizes to layouts.
+void check_segment_v0(const vast::fbs::segment::v0& segment,
+                      file_report& report) {
+  if (!segment.slices()) {
+    report.problems.emplace_back("segment has no table slices");
+    return;
+  }
+  auto events = uint64_t{0};
+  for (const auto* flat_slice : *segment.slices()) {
+    if (!flat_slice->data()) {
+      report.problems.emplace_back("segment contains an empty table slice");
+      continue;
+    }
+    // The chunk does not own its data; the segment outlives the slice.
+    auto chunk = vast::chunk::make(flat_slice->data()->data(),
+                                   flat_slice->data()->size(), {});
+    auto slice
+      = vast::table_slice(std::move(chunk), vast::table_slice::verify::yes);
+    if (slice.encoding() == vast::table_slice_encoding::none) {
+      report.problems.emplace_back("segment contains a corrupt table slice");
+      continue;
+    }
+    auto& layout = report.layouts[std::string{slice.layout().name()}];
+    layout.store_bytes += flat_slice->data()->size();
+    events += slice.rows();
+  }
+  if (events != segment.events())
+    report.problems.push_back(fmt::format("segment claims {} events but its "
+                                          "table slices contain {}",
+                                          segment.events(), events));
+}
+
+void check_segment_file(const std::filesystem::path& path,
+                        file_report& report) {
+  auto chunk = vast::chunk::mmap(path);
+  if (!chunk) {
+    report.problems.push_back(
+      fmt::format("failed to map {}: {}", path.string(),
+                  to_string(chunk.error())));
+    return;
+  }
+  report.bytes += (*chunk)->size();
+  const auto* segment = verify_flatbuffer<vast::fbs::Segment>(**chunk);
+  if (!segment || !vast::fbs::SegmentBufferHasIdentifier((*chunk)->data())) {
+    report.problems.push_back(
+      fmt::format("{} is not a valid segment", path.string()));
+    return;
+  }
+  if (segment->segment_type() != vast::fbs::segment::Segment::v0) {
+    report.problems.push_back(
+      fmt::format("{} has an unknown segment version", path.string()));
+    return;
+  }
+  report.events += segment->segment_as_v0()->events();
+  check_segment_v0(*segment->segment_as_v0(), report);
+}
+
+void check_partition_legacy(
+  const std::filesystem::path& db_dir,
+  const vast::fbs::partition::LegacyPartition& partition,
+  std::span<const std::byte> file, file_report& report) {
+  auto id = vast::uuid{};
+  if (!partition.uuid() || unpack(*partition.uuid(), id))
+    report.problems.emplace_back("partition has no valid uuid");
+  else if (to_string(id) != report.path.filename().string())
+    report.problems.push_back(
+      fmt::format("partition uuid {} does not match its file name",
+                  to_string(id)));
+  report.events = partition.events();
+  // Check that the type ids add up to the number of events.
+  auto events = uint64_t{0};
+  if (const auto* type_ids = partition.type_ids()) {
+    for (const auto* entry : *type_ids) {
+      if (!entry->name() || !entry->ids()) {
+        report.problems.emplace_back("partition has incomplete type ids");
+        continue;
+      }
+      auto ids = vast::ids{};
+      vast::detail::legacy_deserializer source(
+        vast::as_bytes(entry->ids()->data(), entry->ids()->size()));
+      if (!source(ids)) {
+        report.problems.push_back(fmt::format(
+          "failed to deserialize ids of layout {}", entry->name()->str()));
+        continue;
+      }
+      report.layouts[entry->name()->str()].events += rank(ids);
+      events += rank(ids);
+    }
+  }
+  if (events != partition.events())
+    report.problems.push_back(fmt::format("partition claims {} events but its "
+                                          "type ids contain {}",
+                                          partition.events(), events));
+  // Check that every value index lies within the partition file.
+  if (const auto* indexes = partition.indexes()) {
+    for (const auto* qualified_index : *indexes) {
+      if (!qualified_index->field_name() || !qualified_index->index()) {
+        report.problems.emplace_back("partition has an incomplete value index");
+        continue;
+      }
+      auto name = qualified_index->field_name()->str();
+      auto bytes
+        = vast::system::value_index_bytes(file, *qualified_index->index());
+      if (!bytes) {
+        report.problems.push_back(fmt::format("value index of {} is corrupt: "
+                                              "{}",
+                                              name, to_string(bytes.error())));
+        continue;
+      }
+      // Attribute the index to the layout with the longest matching prefix.
+      auto layout = std::string{};
+      for (const auto& [layout_name, _] : report.layouts)
+        if (name.size() > layout_name.size() && name.starts_with(layout_name)
+            && name[layout_name.size()] == '.'
+            && layout_name.size() > layout.size())
+          layout = layout_name;
+      auto& column = report.columns[name];
+      column.layout = layout;
+      column.bytes += bytes->size();
+      if (!layout.empty())
+        report.layouts[layout].index_bytes += bytes->size();
+    }
+  } else {
+    report.problems.emplace_back("partition has no value indexes");
+  }
+  // Check the store that holds the events of the partition.
+  const auto* store = partition.store();
+  if (!store || !store->id() || store->id()->str() == "legacy_archive")
+    return;
+  if (!store->data()) {
+    report.problems.emplace_back("partition store header has no data");
+    return;
+  }
+  auto store_path = std::filesystem::path{std::string_view{
+    reinterpret_cast<const char*>(store->data()->data()),
+    store->data()->size()}};
+  report.store = store_path;
+  if (store_path.is_relative())
+    store_path = db_dir / store_path;
+  std::error_code err{};
+  if (!std::filesystem::exists(store_path, err)) {
+    report.problems.push_back(fmt::format("store {} is missing",
+                                          store_path.string()));
+    return;
+  }
+  auto store_report = file_report{};
+  check_segment_file(store_path, store_report);
+  for (auto& problem : store_report.problems)
+    report.problems.push_back(std::move(problem));
+  for (const auto& [name, stats] : store_report.layouts)
+    report.layouts[name].store_bytes += stats.store_bytes;
+  report.bytes += store_report.bytes;
+  if (store_report.events != partition.events())
+    report.problems.push_back(fmt::format("partition claims {} events but its "
+                                          "store contains {}",
+                                          partition.events(),
+                                          store_report.events));
+}
+
+void check_partition_file(const std::filesystem::path& db_dir,
+                          const std::filesystem::path& path,
+                          const options& options, file_report& report) {
+  auto chunk = vast::chunk::mmap(path);
+  if (!chunk) {
+    report.problems.push_back(
+      fmt::format("failed to map {}: {}", path.string(),
+                  to_string(chunk.error())));
+    return;
+  }
+  report.bytes += (*chunk)->size();
+  const auto* partition = verify_flatbuffer<vast::fbs::Partition>(**chunk);
+  if (!partition
+      || !vast::fbs::PartitionBufferHasIdentifier((*chunk)->data())) {
+    report.problems.emplace_back("not a valid partition");
+    return;
+  }
+  if (partition->partition_type()
+      != vast::fbs::partition::Partition::legacy) {
+    report.problems.emplace_back("unknown partition version");
+    return;
+  }
+  check_partition_legacy(db_dir, *partition->partition_as_legacy(),
+                         vast::as_bytes(**chunk), report);
+  // Check the partition synopsis next to the partition.
+  auto synopsis_path = path;
+  synopsis_path += ".mdx";
+  std::error_code err{};
+  auto synopsis_ok = false;
+  if (std::filesystem::exists(synopsis_path, err)) {
+    auto synopsis = vast::chunk::mmap(synopsis_path);
+    synopsis_ok
+      = synopsis
+        && verify_flatbuffer<vast::fbs::PartitionSynopsis>(**synopsis)
+        && vast::fbs::PartitionSynopsisBufferHasIdentifier((*synopsis)->data());
+    if (!synopsis_ok)
+      report.problems.emplace_back("partition synopsis is corrupt");
+  } else {
+    report.problems.emplace_back("partition synopsis is missing");
+  }
+  if (!synopsis_ok && options.check.rebuild_synopses) {
+    if (auto error
+        = vast::system::extract_partition_synopsis(path, synopsis_path)) {
+      report.problems.push_back(fmt::format("failed to rebuild partition "
+                                            "synopsis: {}",
+                                            to_string(error)));
+    } else {
+      report.problems.back() += " (rebuilt)";
+      report.rebuilt_synopsis = true;
+    }
+  }
+}
+
+// Runs `f(i)` for every `i` in `[0, n)` on up to `jobs` threads.
+template <class F>
+void parallel_for(size_t n, size_t jobs, F f) {
+  auto next = std::atomic<size_t>{0};
+  auto worker = [&] {
+    for (auto i = next++; i < n; i = next++)
+      f(i);
+  };
+  auto threads = std::vector<std::thread>{};
+  for (size_t i = 1; i < std::min(jobs, n); ++i)
+    threads.emplace_back(worker);
+  worker();
+  for (auto& thread : threads)
+    thread.join();
+}
+
+// Lists the regular files in a directory, or nothing if it does not exist.
+std::vector<std::filesystem::path>
+list_files(const std::filesystem::path& dir,
+           std::vector<std::string>& problems) {
+  auto result = std::vector<std::filesystem::path>{};
+  std::error_code err{};
+  if (!std::filesystem::exists(dir, err))
+    return result;
+  for (const auto& entry : std::filesystem::directory_iterator{dir, err})
+    if (entry.is_regular_file())
+      result.push_back(entry.path());
+  if (err)
+    problems.push_back(fmt::format("failed to list {}: {}", dir.string(),
+                                   err.message()));
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+} // namespace
+
+int check_vast_db(const std::filesystem::path& db_dir, const options& options) {
+  const auto& format = options.format;
+  auto problems = std::vector<std::string>{};
+  // Collect the partitions that the index knows about.
+  auto index_dir = db_dir / "index";
+  auto listed = std::set<std::string>{};
+  auto index = read_flatbuffer_file<vast::fbs::Index>(index_dir / "index.bin");
+  if (!index || index->index_type() != vast::fbs::index::Index::v0) {
+    problems.emplace_back("index.bin is missing or corrupt");
+  } else if (const auto* uuids = index->index_as_v0()->partitions()) {
+    for (const auto* uuid : *uuids) {
+      auto id = vast::uuid{};
+      if (unpack(*uuid, id))
+        problems.emplace_back("index.bin contains an invalid uuid");
+      else
+        listed.insert(to_string(id));
+    }
+  }
+  // Classify the files in the database directory.
+  auto partitions = std::vector<std::filesystem::path>{};
+  auto synopses = std::vector<std::filesystem::path>{};
+  for (auto& file : list_files(index_dir, problems)) {
+    if (file.filename() == "index.bin")
+      continue;
+    if (file.extension() == ".mdx")
+      synopses.push_back(std::move(file));
+    else
+      partitions.push_back(std::move(file));
+  }
+  auto stores = std::vector<std::filesystem::path>{};
+  for (auto& file : list_files(db_dir / "archive", problems))
+    if (file.extension() == ".store")
+      stores.push_back(std::move(file));
+  auto segments = list_files(db_dir / "archive" / "segments", problems);
+  // Check all partitions and legacy segments in parallel. The stores that
+  // belong to partitions are checked together with their partition.
+  auto reports = std::vector<file_report>(partitions.size() + segments.size());
+  auto jobs = options.check.jobs != 0
+                ? options.check.jobs
+                : std::max(std::thread::hardware_concurrency(), 1u);
+  parallel_for(reports.size(), jobs, [&](size_t i) {
+    auto& report = reports[i];
+    if (i < partitions.size()) {
+      report.path = partitions[i];
+      check_partition_file(db_dir, partitions[i], options, report);
+    } else {
+      report.path = segments[i - partitions.size()];
+      check_segment_file(report.path, report);
+    }
+  });
+  // Find inconsistencies between the files.
+  auto present = std::set<std::string>{};
+  auto referenced_stores = std::set<std::filesystem::path>{};
+  for (size_t i = 0; i < partitions.size(); ++i) {
+    auto name = partitions[i].filename().string();
+    present.insert(name);
+    if (!listed.contains(name))
+      problems.push_back(fmt::format("partition {} is not listed in index.bin",
+                                     name));
+    if (reports[i].store)
+      referenced_stores.insert(
+        (db_dir / *reports[i].store).lexically_normal());
+  }
+  for (const auto& name : listed)
+    if (!present.contains(name))
+      problems.push_back(
+        fmt::format("partition {} is listed in index.bin but missing", name));
+  for (const auto& synopsis : synopses)
+    if (!present.contains(synopsis.stem().string()))
+      problems.push_back(fmt::format("orphaned partition synopsis {}",
+                                     synopsis.filename().string()));
+  for (const auto& store : stores)
+    if (!referenced_stores.contains(store.lexically_normal()))
+      problems.push_back(
+        fmt::format("orphaned store {}", store.filename().string()));
+  // Merge the reports.
+  auto layouts = std::map<std::string, layout_stats>{};
+  auto columns = std::map<std::string, column_stats>{};
+  auto events = uint64_t{0};
+  auto bytes = size_t{0};
+  auto rebuilt = size_t{0};
+  for (size_t i = 0; i < reports.size(); ++i) {
+    auto& report = reports[i];
+    for (auto& problem : report.problems)
+      problems.push_back(
+        fmt::format("{}: {}", report.path.filename().string(), problem));
+    for (const auto& [name, stats] : report.layouts) {
+      layouts[name].events += stats.events;
+      layouts[name].store_bytes += stats.store_bytes;
+      layouts[name].index_bytes += stats.index_bytes;
+    }
+    for (const auto& [name, stats] : report.columns) {
+      columns[name].layout = stats.layout;
+      columns[name].bytes += stats.bytes;
+    }
+    // Legacy segments hold the events of the partitions that refer to the
+    // legacy archive, so only partitions count towards the total.
+    if (i < partitions.size())
+      events += report.events;
+    bytes += report.bytes;
+    rebuilt += report.rebuilt_synopsis;
+  }
+  // Print the summary.
+  indentation indent;
+  std::cout << indent << "Database " << db_dir.string() << "\n";
+  indented_scope _(indent);
+  std::cout << indent << "partitions: " << partitions.size() << "\n";
+  std::cout << indent << "stores: " << stores.size() << "\n";
+  std::cout << indent << "segments: " << segments.size() << "\n";
+  std::cout << indent << "events: " << events << "\n";
+  std::cout << indent << "bytes: " << print_bytesize(bytes, format) << "\n";
+  std::cout << indent << "Layouts\n";
+  {
+    indented_scope _(indent);
+    for (const auto& [name, stats] : layouts)
+      std::cout << indent << name << ": " << stats.events << " events, "
+                << print_bytesize(stats.store_bytes, format) << " store, "
+                << print_bytesize(stats.index_bytes, format) << " indexes\n";
+  }
+  if (format.verbosity >= output_verbosity::verbose) {
+    std::cout << indent << "Column Indexes\n";
+    indented_scope _(indent);
+    for (const auto& [name, stats] : columns)
+      std::cout << indent << name << ": "
+                << print_bytesize(stats.bytes, format) << "\n";
+  }
+  std::cout << indent << "Compression Opportunities\n";
+  {
+    indented_scope _(indent);
+    for (const auto& [name, stats] : columns) {
+      auto it = layouts.find(stats.layout);
+      if (it == layouts.end() || it->second.store_bytes == 0)
+        continue;
+      auto ratio = static_cast<double>(stats.bytes)
+                   / static_cast<double>(it->second.store_bytes);
+      if (ratio > index_heavy_ratio)
+        std::cout << indent << name << ": index is "
+                  << static_cast<int>(ratio * 100)
+                  << "% of the store size of " << stats.layout
+                  << "; consider #index=hash or #skip\n";
+    }
+  }
+  if (rebuilt > 0)
+    std::cout << indent << "rebuilt partition synopses: " << rebuilt << "\n";
+  std::cout << indent << "Problems: " << problems.size() << "\n";
+  {
+    indented_scope _(indent);
+    for (const auto& problem : problems)
+      std::cout << indent << problem << "\n";
+  }
+  return problems.empty() ? 0 : 1;
+}
+
+} // namespace lsvast
@@ -15,10 +15,12 @@
 #include <vast/fbs/segment.hpp>
 #include <vast/io/read.hpp>
 #include <vast/logger.hpp>
+#include <vast/synopsis_factory.hpp>
 
 #include <caf/expected.hpp>
 
 #include <iostream>
+#include <cstdlib>
 #include <map>
 
 #include "util.hpp"
@@ -146,6 +148,19 @@ int main(int argc, char** argv) {
         return 1;
       }
       options.partition.expand_indexes.emplace_back(argv[++i]);
+    } else if (arg == "--check") {
+      options.check.enabled = true;
+    } else if (arg == "--rebuild-synopses") {
+      options.check.enabled = true;
+      options.check.rebuild_synopses = true;
+    } else if (arg == "--force") {
+      options.check.force = true;
+    } else if (arg == "-j" || arg == "--jobs") {
+      if (i + 1 >= argc) {
+        std::cerr << "Missing argument for --jobs\n";
+        return 1;
+      }
+      options.check.jobs = std::strtoull(argv[++i], nullptr, 10);
     } else { // positional arg
       raw_path = arg;
     }
@@ -155,7 +170,11 @@ int main(int argc, char** argv) {
               << "Options:\n"
               << "  --verbose\n"
               << "  --print-bytesizes\n"
-              << "  --human-readable\n";
+              << "  --human-readable\n"
+              << "  --check\n"
+              << "  --rebuild-synopses\n"
+              << "  --force\n"
+              << "  --jobs <n>\n";
     return 1;
   }
   if (raw_path.back() == '/')
@@ -173,6 +192,25 @@ int main(int argc, char** argv) {
   }
   auto log_context
     = vast::create_log_context(vast::invocation{}, caf::settings{});
+  if (options.check.enabled) {
+    if (kind != Kind::DatabaseDir) {
+      std::cerr << "--check requires a database directory\n";
+      return 1;
+    }
+    // The node holds the PID lock while it runs, so rebuilding synopses could
+    // race with the node writing the same files.
+    if (options.check.rebuild_synopses && !options.check.force) {
+      auto err = std::error_code{};
+      if (std::filesystem::exists(path / "pid.lock", err) || err) {
+        std::cerr << "Found the PID lock " << (path / "pid.lock").string()
+                  << ", a VAST node may be running on the database; stop the "
+                     "node or pass --force to rebuild synopses anyway\n";
+        return 1;
+      }
+    }
+    vast::factory<vast::synopsis>::initialize();
+    return check_vast_db(path, options);
+  }
   struct indentation indent;
   auto printer = printers.at(*kind);
   printer(path, indent, options);
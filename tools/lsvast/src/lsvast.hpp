@@ -39,10 +39,22 @@ struct partition_options {
   std::vector<std::string> expand_indexes = {};
 };
 
+// Options specific to checking a database directory.
+struct check_options {
+  bool enabled = false;
+  // The number of worker threads, or 0 for one per core.
+  size_t jobs = 0;
+  // Recreate missing or corrupt partition synopses from their partitions.
+  bool rebuild_synopses = false;
+  // Rebuild synopses even if a VAST node may be running on the database.
+  bool force = false;
+};
+
 // Global options.
 struct options {
   formatting_options format = {};
   partition_options partition = {};
+  check_options check = {};
 };
 
 struct indentation;
@@ -57,4 +69,8 @@ void print_partition(const std::filesystem::path&, indentation&,
 void print_index(const std::filesystem::path&, indentation&, const options&);
 void print_segment(const std::filesystem::path&, indentation&, const options&);
 
+// Verifies all files in a database directory and prints aggregate statistics.
+// Returns 0 if no problems were found, and 1 otherwise.
+int check_vast_db(const std::filesystem::path&, const options&);
+
 } // namespace lsvast
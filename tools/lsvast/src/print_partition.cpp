@@ -15,6 +15,7 @@
 #include <vast/index/hash_index.hpp>
 #include <vast/legacy_type.hpp>
 #include <vast/qualified_record_field.hpp>
+#include <vast/system/passive_partition.hpp>
 #include <vast/type.hpp>
 #include <vast/value_index_factory.hpp>
 
@@ -72,7 +73,8 @@ void print_hash_index(const vast::value_index_ptr& ptr, indentation& indent,
 }
 
 void print_partition_legacy(
-  const vast::fbs::partition::LegacyPartition* partition, indentation& indent,
+  const vast::fbs::partition::LegacyPartition* partition,
+  std::span<const std::byte> file, indentation& indent,
   const options& options) {
   if (!partition) {
     std::cout << "(null)\n";
@@ -151,10 +153,16 @@ void print_partition_legacy(
       auto field = combined_layout.field(i);
       const auto* index = indexes->Get(i);
       auto name = field.name;
-      auto sz = index->index()->data()->size();
+      auto data = vast::system::value_index_bytes(file, *index->index());
+      if (!data) {
+        std::cout << indent << name << ": !! " << to_string(data.error())
+                  << "\n";
+        continue;
+      }
       std::cout << indent << name << ": " << fmt::to_string(field.type);
       if (options.format.print_bytesizes)
-        std::cout << " (" << print_bytesize(sz, options.format) << ")";
+        std::cout << " (" << print_bytesize(data->size(), options.format)
+                  << ")";
       std::cout << "\n";
       bool expand
         = std::find(expand_indexes.begin(), expand_indexes.end(), name)
@@ -162,10 +170,9 @@ void print_partition_legacy(
       if (expand) {
         vast::factory_traits<vast::value_index>::initialize();
         vast::value_index_ptr state_ptr;
-        if (auto error
-            = vast::fbs::deserialize_bytes(index->index()->data(), state_ptr)) {
-          std::cout << "!! failed to deserialize index" << to_string(error)
-                    << std::endl;
+        vast::detail::legacy_deserializer sink(*data);
+        if (!sink(state_ptr)) {
+          std::cout << "!! failed to deserialize index" << std::endl;
           continue;
         }
         const auto& type = state_ptr->type();
@@ -191,7 +198,8 @@ void print_partition(const std::filesystem::path& path, indentation& indent,
   }
   switch (partition->partition_type()) {
     case vast::fbs::partition::Partition::legacy:
-      print_partition_legacy(partition->partition_as_legacy(), indent,
+      print_partition_legacy(partition->partition_as_legacy(),
+                             partition.get_deleter().chunk_, indent,
                              formatting);
       break;
     default: